@@ -16,6 +16,8 @@ limitations under the License.
 
 #include "lullaby/base/blueprint.h"
 
+#include <algorithm>
+
 namespace lull {
 
 Blueprint::Blueprint() : mode_(kWriteMode) {}
@@ -24,11 +26,41 @@ Blueprint::Blueprint(size_t buffer_size) : mode_(kWriteMode) {
   buffer_.emplace(buffer_size);
 }
 
+Blueprint::Blueprint(InwardBufferPool* pool)
+    : pool_(pool), mode_(kWriteMode) {}
+
 Blueprint::Blueprint(ArrayAccessorFn accessor, size_t count)
     : accessor_(std::move(accessor)), mode_(kReadMode), count_(count) {
   Prepare();
 }
 
+Blueprint& Blueprint::operator=(Blueprint&& rhs) {
+  if (this != &rhs) {
+    ReleaseBuffer();
+    buffer_ = std::move(rhs.buffer_);
+    pool_ = rhs.pool_;
+    current_ = rhs.current_;
+    accessor_ = std::move(rhs.accessor_);
+    mode_ = rhs.mode_;
+    index_ = rhs.index_;
+    count_ = rhs.count_;
+  }
+  return *this;
+}
+
+Blueprint::~Blueprint() { ReleaseBuffer(); }
+
+void Blueprint::Reset() {
+  if (buffer_) {
+    buffer_->Reset();
+  }
+  current_ = TypedBlueprintData();
+  accessor_ = nullptr;
+  mode_ = kWriteMode;
+  index_ = 0;
+  count_ = 0;
+}
+
 void Blueprint::FinishWriting() {
   mode_ = kReadMode;
   index_ = 0;
@@ -86,9 +118,7 @@ const flatbuffers::Table* Blueprint::GetLegacyDefData() const {
 }
 
 void Blueprint::WriteCurrentObjectToBuffer() const {
-  if (!buffer_) {
-    buffer_.emplace(kDefaultBufferSize);
-  }
+  ReserveBuffer(0);
 
   // Unfortunately, serialization requires a non-const pointer, even though it
   // does not modify the object being serialized.
@@ -101,4 +131,30 @@ void Blueprint::WriteCurrentObjectToBuffer() const {
   current_.flatbuffer = flatbuffers::GetRoot<const flatbuffers::Table>(data);
 }
 
+void Blueprint::ReserveBuffer(size_t size) const {
+  if (!buffer_) {
+    const size_t capacity = std::max<size_t>(size, kDefaultBufferSize);
+    if (pool_) {
+      buffer_.emplace(pool_->Acquire(capacity));
+    } else {
+      buffer_.emplace(capacity);
+    }
+    return;
+  }
+
+  // Grow geometrically so that writing many objects does not reallocate the
+  // buffer for each one.
+  const size_t required = buffer_->FrontSize() + buffer_->BackSize() + size;
+  if (required > buffer_->Capacity()) {
+    buffer_->Reserve(std::max(required, 2 * buffer_->Capacity()));
+  }
+}
+
+void Blueprint::ReleaseBuffer() {
+  if (pool_ && buffer_) {
+    pool_->Release(std::move(*buffer_));
+  }
+  buffer_.reset();
+}
+
 }  // namespace lull
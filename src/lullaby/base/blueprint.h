@@ -21,6 +21,7 @@ limitations under the License.
 #include "lullaby/base/blueprint_type.h"
 #include "lullaby/util/flatbuffer_reader.h"
 #include "lullaby/util/flatbuffer_writer.h"
+#include "lullaby/util/inward_buffer_pool.h"
 #include "lullaby/util/logging.h"
 #include "lullaby/util/optional.h"
 #include "lullaby/util/span.h"
@@ -67,6 +68,11 @@ class Blueprint {
   // explicitly sized internal buffer.
   explicit Blueprint(size_t buffer_size);
 
+  // Creates an empty Blueprint (like the default constructor), but acquires its
+  // internal buffer from |pool| and returns the buffer to it when destroyed.
+  // The |pool| must outlive the Blueprint.
+  explicit Blueprint(InwardBufferPool* pool);
+
   // Creates a Blueprint that wraps a single object.  This Blueprint can only be
   // used for reading (by calling ForEach/Read).
   template <typename T>
@@ -78,6 +84,17 @@ class Blueprint {
   using ArrayAccessorFn = std::function<TypedFlatbuffer(size_t index)>;
   Blueprint(ArrayAccessorFn accessor_fn, size_t count);
 
+  Blueprint(Blueprint&& rhs) = default;
+  Blueprint& operator=(Blueprint&& rhs);
+
+  ~Blueprint();
+
+  // Empties the Blueprint and switches it back to write mode so that it can be
+  // used to build a new set of objects.  The internal buffer is kept, so
+  // building similar Blueprints repeatedly does not reallocate it.  Any data
+  // previously returned by Finalize is invalidated.
+  void Reset();
+
   // Returns the current type of the data in the blueprint (for reading).
   template <typename T>
   bool Is() const;
@@ -111,6 +128,10 @@ class Blueprint {
   const flatbuffers::Table* GetLegacyDefData() const;
   HashValue GetLegacyDefType() const;
 
+ protected:
+  // Returns the pool from which the internal buffer is acquired, if any.
+  InwardBufferPool* GetBufferPool() const { return pool_; }
+
  private:
   enum { kDefaultBufferSize = 256 };
 
@@ -145,9 +166,12 @@ class Blueprint {
   void PrepareFromBuffer();
   void PrepareFromAccessor();
   void WriteCurrentObjectToBuffer() const;
+  void ReserveBuffer(size_t size) const;
+  void ReleaseBuffer();
 
   // Buffer used to serialize objects into flatbuffer binaries.
   mutable lull::Optional<InwardBuffer> buffer_;
+  InwardBufferPool* pool_ = nullptr;  // The pool which owns buffer_ memory.
   mutable TypedBlueprintData current_;  // The "current" data to be read.
   ArrayAccessorFn accessor_;  // The function used to extract flatbuffers.
   Mode mode_ = kReadMode;  // The current mode of operation.
@@ -169,9 +193,9 @@ void Blueprint::Write(T* ptr) {
     LOG(DFATAL) << "Must be in kWriteMode to write.";
     return;
   }
-  if (!buffer_) {
-    buffer_.emplace(kDefaultBufferSize);
-  }
+  // Reserve enough space for the entire object up front rather than growing
+  // the buffer while it is being written.
+  ReserveBuffer(EstimateFlatbufferSize(ptr) + sizeof(Entry));
 
   WriteToBuffer<T>(ptr, buffer_.get());
   ++count_;
@@ -31,6 +31,8 @@ class BlueprintTree : public Blueprint {
 
   explicit BlueprintTree(size_t buffer_size) : Blueprint(buffer_size) {}
 
+  explicit BlueprintTree(InwardBufferPool* pool) : Blueprint(pool) {}
+
   template <typename T>
   explicit BlueprintTree(const T* ptr) : Blueprint(ptr) {}
 
@@ -39,11 +41,19 @@ class BlueprintTree : public Blueprint {
       : Blueprint(std::move(accessor_fn), count),
         children_(std::move(children)) {}
 
+  // Children acquire their buffers from the same pool as this tree (if any).
   BlueprintTree* NewChild() {
-    children_.emplace_back();
+    children_.emplace_back(GetBufferPool());
     return &children_.back();
   }
 
+  // Resets this Blueprint and removes all children.  Pooled buffers owned by
+  // the children are returned to the pool for reuse by new children.
+  void Reset() {
+    children_.clear();
+    Blueprint::Reset();
+  }
+
   std::list<BlueprintTree>* Children() { return &children_; }
 
  private:
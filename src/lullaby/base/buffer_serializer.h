@@ -62,14 +62,13 @@ class SaveToBuffer {
   }
 
   // Saves vector data to the buffer by copying the length and then serializing
-  // the individual elements to the buffer.
+  // the individual elements to the buffer.  Vectors of fundamental types are
+  // copied with a single memcpy.
   template <typename T, typename... Args>
   void operator()(const std::vector<T, Args...>* ptr, lull::HashValue key) {
     size_t size = ptr->size();
     Save(&size, sizeof(size));
-    for (size_t i = 0; i < size; ++i) {
-      Serialize(this, &(*ptr)[i], key);
-    }
+    SaveElements(ptr, key, detail::IsBulkSerializable<T>());
   }
 
   // Saves map data to the buffer by copying the count of elements and then
@@ -96,6 +95,22 @@ class SaveToBuffer {
   bool IsDestructive() const { return false; }
 
  private:
+  template <typename T, typename... Args>
+  void SaveElements(const std::vector<T, Args...>* ptr, lull::HashValue key,
+                    std::true_type) {
+    if (!ptr->empty()) {
+      Save(ptr->data(), ptr->size() * sizeof(T));
+    }
+  }
+
+  template <typename T, typename... Args>
+  void SaveElements(const std::vector<T, Args...>* ptr, lull::HashValue key,
+                    std::false_type) {
+    for (size_t i = 0; i < ptr->size(); ++i) {
+      Serialize(this, &(*ptr)[i], key);
+    }
+  }
+
   // The buffer being read from or written to.
   Buffer* buffer_ = nullptr;
 
@@ -112,7 +127,14 @@ class LoadFromBuffer {
   using Buffer = std::vector<uint8_t>;  // A Buffer is just a vector of bytes.
 
   explicit LoadFromBuffer(const Buffer* buffer)
-      : buffer_(CHECK_NOTNULL(buffer)), offset_(0) {
+      : data_(CHECK_NOTNULL(buffer)->data()), size_(buffer->size()),
+        offset_(0) {
+  }
+
+  // Reads directly from |size| bytes of |data| without copying them into a
+  // Buffer.  The data must outlive the serializer.
+  LoadFromBuffer(const uint8_t* data, size_t size)
+      : data_(data), size_(size), offset_(0) {
   }
 
   // Loads types like ints, floats, bools, etc.) from the buffer by directly
@@ -142,15 +164,14 @@ class LoadFromBuffer {
   }
 
   // Loads vector data from the buffer by copying the length and then
-  // serializing the individual elements to the buffer.
+  // serializing the individual elements to the buffer.  Vectors of fundamental
+  // types are copied with a single memcpy.
   template <typename T, typename... Args>
   void operator()(std::vector<T, Args...>* ptr, lull::HashValue key) {
     size_t size = 0;
     Load(&size, sizeof(size));
     ptr->resize(size);
-    for (size_t i = 0; i < size; ++i) {
-      Serialize(this, &(*ptr)[i], key);
-    }
+    LoadElements(ptr, key, detail::IsBulkSerializable<T>());
   }
 
   // Loads map data from the buffer by copying the count of elements and then
@@ -171,8 +192,8 @@ class LoadFromBuffer {
   // Advances the buffer by the specified number of bytes.  Returns the pointer
   // to the buffer at the location prior to the skipping.
   const uint8_t* Advance(size_t size) {
-    if (offset_ + size <= buffer_->size()) {
-      const uint8_t* ptr = buffer_->data() + offset_;
+    if (offset_ + size <= size_) {
+      const uint8_t* ptr = data_ + offset_;
       offset_ += size;
       return ptr;
     } else {
@@ -181,10 +202,29 @@ class LoadFromBuffer {
     }
   }
 
+  // Returns the number of bytes that have not been read yet.
+  size_t Remaining() const { return size_ - offset_; }
+
   // This serializer will write into the object, overwriting its current data.
   bool IsDestructive() const { return true; }
 
  private:
+  template <typename T, typename... Args>
+  void LoadElements(std::vector<T, Args...>* ptr, lull::HashValue key,
+                    std::true_type) {
+    if (!ptr->empty()) {
+      Load(ptr->data(), ptr->size() * sizeof(T));
+    }
+  }
+
+  template <typename T, typename... Args>
+  void LoadElements(std::vector<T, Args...>* ptr, lull::HashValue key,
+                    std::false_type) {
+    for (size_t i = 0; i < ptr->size(); ++i) {
+      Serialize(this, &(*ptr)[i], key);
+    }
+  }
+
   // Copies |size| bytes of data from the internal buffer to |ptr| and
   // increments the buffer pointer to after the copied bytes.
   void Load(void* ptr, size_t size) {
@@ -194,8 +234,11 @@ class LoadFromBuffer {
     }
   }
 
-  // The buffer being read from or written to.
-  const Buffer* buffer_ = nullptr;
+  // The data being read from.
+  const uint8_t* data_ = nullptr;
+
+  // The size of the data being read from.
+  size_t size_ = 0;
 
   // The read/write head of the buffer.
   size_t offset_ = 0;
@@ -45,6 +45,15 @@ struct IsSerializeFundamental {
       std::is_same<U, mathfu::mat4>::value;
 };
 
+// Determines if a contiguous array of |T| can be serialized as raw bytes.  This
+// excludes bool since std::vector<bool> does not store its elements as bools.
+template <typename T>
+struct IsBulkSerializable
+    : std::integral_constant<
+          bool, IsSerializeFundamental<T>::value &&
+                    !std::is_same<typename std::remove_cv<T>::type,
+                                  bool>::value> {};
+
 // Determines if |T| has a member function with the signature:
 // void T::Serialize(Archive).
 template <typename T, typename Archive>
@@ -16,15 +16,27 @@ limitations under the License.
 
 #include "lullaby/base/entity_factory.h"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
 #include "lullaby/base/asset_loader.h"
+#include "lullaby/base/buffer_serializer.h"
 #include "lullaby/util/file.h"
 #include "lullaby/util/logging.h"
 #include "lullaby/util/make_unique.h"
 
 namespace lull {
+namespace {
+
+// World snapshots begin with this identifier ("LSNP") and format version,
+// followed by the EntityFactory's own data and then a section for each System.
+// Each section is prefixed by the System's TypeId, its snapshot version, and
+// the size of its data so that unknown sections can be skipped.
+const uint32_t kSnapshotIdentifier = 0x504e534c;
+const uint32_t kSnapshotFormatVersion = 1;
+
+}  // namespace
 
 const char* const EntityFactory::kDefaultFileIdentifier = "ENTS";
 
@@ -285,6 +297,116 @@ void EntityFactory::DestroyQueuedEntities() {
   }
 }
 
+void EntityFactory::SaveSnapshot(std::vector<uint8_t>* buffer) {
+  buffer->clear();
+  SaveToBuffer serializer(buffer);
+
+  uint32_t identifier = kSnapshotIdentifier;
+  uint32_t format_version = kSnapshotFormatVersion;
+  Entity entity_generator = kNullEntity;
+  {
+    Lock lock(mutex_);
+    entity_generator = entity_generator_;
+  }
+  serializer(&identifier, 0);
+  serializer(&format_version, 0);
+  serializer(&entity_generator, 0);
+  serializer(&entity_to_blueprint_map_, 0);
+
+  // Sort the Systems so that the same world always produces the same snapshot.
+  std::vector<TypeId> types;
+  types.reserve(systems_.size());
+  for (const auto& iter : systems_) {
+    if (iter.second->GetSnapshotVersion() != 0) {
+      types.push_back(iter.first);
+    }
+  }
+  std::sort(types.begin(), types.end());
+
+  std::vector<uint8_t> section;
+  for (TypeId type : types) {
+    System* system = systems_[type];
+    section.clear();
+    SaveToBuffer section_serializer(&section);
+    system->SaveSnapshot(&section_serializer);
+
+    uint32_t version = system->GetSnapshotVersion();
+    uint64_t size = section.size();
+    serializer(&type, 0);
+    serializer(&version, 0);
+    serializer(&size, 0);
+    serializer.Save(section.data(), section.size());
+  }
+}
+
+bool EntityFactory::LoadSnapshot(Span<uint8_t> data) {
+  LoadFromBuffer serializer(data.data(), data.size());
+
+  uint32_t identifier = 0;
+  uint32_t format_version = 0;
+  const size_t kHeaderSize = sizeof(identifier) + sizeof(format_version);
+  if (data.size() >= kHeaderSize) {
+    serializer(&identifier, 0);
+    serializer(&format_version, 0);
+  }
+  if (identifier != kSnapshotIdentifier ||
+      format_version != kSnapshotFormatVersion) {
+    LOG(ERROR) << "Invalid world snapshot.";
+    return false;
+  }
+
+  Entity entity_generator = kNullEntity;
+  BlueprintMap blueprint_map;
+  serializer(&entity_generator, 0);
+  serializer(&blueprint_map, 0);
+  {
+    Lock lock(mutex_);
+    entity_generator_ = std::max(entity_generator_, entity_generator);
+  }
+  for (auto& iter : blueprint_map) {
+    entity_to_blueprint_map_[iter.first] = std::move(iter.second);
+  }
+
+  bool success = true;
+  while (serializer.Remaining() > 0) {
+    TypeId type = 0;
+    uint32_t version = 0;
+    uint64_t size = 0;
+    const size_t kSectionHeaderSize =
+        sizeof(type) + sizeof(version) + sizeof(size);
+    if (serializer.Remaining() < kSectionHeaderSize) {
+      LOG(ERROR) << "World snapshot is truncated.";
+      return false;
+    }
+    serializer(&type, 0);
+    serializer(&version, 0);
+    serializer(&size, 0);
+    if (size > serializer.Remaining()) {
+      LOG(ERROR) << "World snapshot is truncated.";
+      return false;
+    }
+    const uint8_t* section = serializer.Advance(static_cast<size_t>(size));
+
+    auto iter = systems_.find(type);
+    if (iter == systems_.end()) {
+      LOG(WARNING) << "Skipping snapshot data for unknown system: " << type;
+      continue;
+    }
+    System* system = iter->second;
+    if (version != system->GetSnapshotVersion()) {
+      LOG(WARNING) << "Skipping snapshot data for system " << type
+                   << " with version " << version;
+      continue;
+    }
+    LoadFromBuffer section_serializer(section, static_cast<size_t>(size));
+    if (!system->LoadSnapshot(&section_serializer)) {
+      LOG(ERROR) << "Could not load snapshot data for system: " << type;
+      success = false;
+    }
+  }
+  return success;
+}
+
 EntityFactory::FlatbufferConverter* EntityFactory::CreateFlatbufferConverter(
     string_view identifier) {
   // This needs to live in the cc file, since including make_unique in the
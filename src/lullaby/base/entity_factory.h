@@ -24,6 +24,7 @@ limitations under the License.
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "flatbuffers/flatbuffers.h"
 #include "lullaby/base/asset.h"
@@ -200,6 +201,20 @@ class EntityFactory {
   // created.
   const BlueprintMap& GetEntityToBlueprintMap() const;
 
+  // Writes a snapshot of the world into |buffer|, replacing its contents.  The
+  // snapshot contains the Entity IDs created so far, the name of the blueprint
+  // used to create each Entity, and the Component data of every System that
+  // supports snapshots (see System::GetSnapshotVersion).  Systems that do not
+  // support snapshots are skipped.
+  void SaveSnapshot(std::vector<uint8_t>* buffer);
+
+  // Restores a snapshot written by SaveSnapshot.  This is intended to replace
+  // creating the same Entities from their blueprints, so it should be called
+  // before any of the Entities in the snapshot are created.  Data for Systems
+  // that are missing or whose snapshot version has changed is skipped.
+  // Returns false if |data| is not a valid snapshot.
+  bool LoadSnapshot(Span<uint8_t> data);
+
   // Gets or loads off disk a blueprint asset with the given |name|.
   std::shared_ptr<SimpleAsset> GetBlueprintAsset(const std::string& name);
 
@@ -0,0 +1,282 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#ifndef LULLABY_BASE_FLAT_HASH_MAP_H_
+#define LULLABY_BASE_FLAT_HASH_MAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lull {
+
+// A map-like container of integral Key (eg. HashValue or Entity) to Value.
+//
+// The key-value pairs are stored contiguously in a single vector so that
+// creating, copying and iterating over the map is cheap.  Small maps (of up to
+// kMaxLinearSize pairs) are searched by a linear scan of the pairs.  Larger
+// maps also maintain an open-addressing (linear probing) index of the keys.
+//
+// The API is a subset of std::unordered_map, with a few differences:
+// - Iterators are pointers to std::pair<Key, Value>.  The key must not be
+//   modified through them.
+// - Inserting or removing pairs invalidates all iterators, pointers and
+//   references to pairs in the map.
+// - Pairs are removed by moving the last pair into their place, so erasing
+//   while iterating should use the iterator returned by erase().
+template <typename Key, typename Value>
+class FlatHashMap {
+ public:
+  static_assert(std::is_integral<Key>::value,
+                "FlatHashMap only supports integral keys.");
+
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<Key, Value>;
+  using size_type = size_t;
+  using iterator = value_type*;
+  using const_iterator = const value_type*;
+
+  // Maps with at most this many pairs are searched linearly.
+  static const size_t kMaxLinearSize = 8;
+
+  FlatHashMap() : shift_(0) {}
+
+  FlatHashMap(std::initializer_list<value_type> values) : FlatHashMap() {
+    reserve(values.size());
+    for (const value_type& value : values) {
+      insert(value);
+    }
+  }
+
+  iterator begin() { return entries_.data(); }
+  iterator end() { return entries_.data() + entries_.size(); }
+  const_iterator begin() const { return entries_.data(); }
+  const_iterator end() const { return entries_.data() + entries_.size(); }
+
+  // Returns the number of pairs in the map.
+  size_t size() const { return entries_.size(); }
+
+  // Returns true if the map has no pairs.
+  bool empty() const { return entries_.empty(); }
+
+  // Removes all pairs from the map.
+  void clear() {
+    entries_.clear();
+    slots_.clear();
+  }
+
+  // Allocates enough memory to store |count| pairs without reallocating.
+  void reserve(size_t count) {
+    entries_.reserve(count);
+    if (count > kMaxLinearSize && count * 2 > slots_.size()) {
+      Rehash(count);
+    }
+  }
+
+  // Returns an iterator to the pair with |key|, or end() if there is none.
+  iterator find(const Key& key) {
+    const size_t index = FindIndex(key);
+    return index != kNotFound ? begin() + index : end();
+  }
+  const_iterator find(const Key& key) const {
+    const size_t index = FindIndex(key);
+    return index != kNotFound ? begin() + index : end();
+  }
+
+  // Returns 1 if there is a pair with |key|, otherwise 0.
+  size_t count(const Key& key) const {
+    return FindIndex(key) != kNotFound ? 1 : 0;
+  }
+
+  // Adds a pair with |key| and a value constructed from |args|, if there is no
+  // pair with |key| already.  Returns an iterator to the pair with |key|, and
+  // whether it was added.
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(const Key& key, Args&&... args) {
+    const size_t index = FindIndex(key);
+    if (index != kNotFound) {
+      return std::make_pair(begin() + index, false);
+    }
+    entries_.emplace_back(std::piecewise_construct, std::forward_as_tuple(key),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+    AddToIndex(entries_.size() - 1);
+    return std::make_pair(end() - 1, true);
+  }
+
+  // Adds |value| if there is no pair with its key already.
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return emplace(value.first, value.second);
+  }
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return emplace(value.first, std::move(value.second));
+  }
+
+  // Returns the value with |key|, adding a default-constructed value if there
+  // is none.
+  Value& operator[](const Key& key) { return emplace(key).first->second; }
+
+  // Removes the pair with |key|, returning the number of pairs removed.
+  size_t erase(const Key& key) {
+    const size_t index = FindIndex(key);
+    if (index == kNotFound) {
+      return 0;
+    }
+    EraseIndex(index);
+    return 1;
+  }
+
+  // Removes the pair at |pos|, returning an iterator to the pair that replaced
+  // it (ie. the next pair to visit when iterating).
+  iterator erase(const_iterator pos) {
+    const size_t index = static_cast<size_t>(pos - begin());
+    EraseIndex(index);
+    return begin() + index;
+  }
+
+ private:
+  static const size_t kNotFound = static_cast<size_t>(-1);
+  static const uint32_t kEmptySlot = 0xffffffff;
+
+  // An entry in the index, which refers to a pair in |entries_|.  The key is
+  // duplicated here so that probing doesn't need to touch the pairs.
+  struct Slot {
+    Key key;
+    uint32_t index;
+  };
+
+  // Returns the preferred slot for |key| using Fibonacci hashing, which
+  // spreads out sequential keys (eg. Entities) as well as hashed ones.
+  size_t GetHomeSlot(const Key& key) const {
+    return static_cast<size_t>(
+        (static_cast<uint64_t>(key) * 0x9e3779b97f4a7c15ull) >> shift_);
+  }
+
+  size_t FindIndex(const Key& key) const {
+    if (slots_.empty()) {
+      for (size_t i = 0; i < entries_.size(); ++i) {
+        if (entries_[i].first == key) {
+          return i;
+        }
+      }
+      return kNotFound;
+    }
+    const size_t slot = FindSlot(key);
+    return slot != kNotFound ? slots_[slot].index : kNotFound;
+  }
+
+  size_t FindSlot(const Key& key) const {
+    const size_t mask = slots_.size() - 1;
+    for (size_t slot = GetHomeSlot(key);; slot = (slot + 1) & mask) {
+      if (slots_[slot].index == kEmptySlot) {
+        return kNotFound;
+      } else if (slots_[slot].key == key) {
+        return slot;
+      }
+    }
+  }
+
+  void InsertSlot(const Key& key, size_t index) {
+    const size_t mask = slots_.size() - 1;
+    size_t slot = GetHomeSlot(key);
+    while (slots_[slot].index != kEmptySlot) {
+      slot = (slot + 1) & mask;
+    }
+    slots_[slot].key = key;
+    slots_[slot].index = static_cast<uint32_t>(index);
+  }
+
+  // Empties |slot|, shifting back any following slots that would otherwise
+  // become unreachable.  This avoids the need for tombstones.
+  void RemoveSlot(size_t slot) {
+    const size_t mask = slots_.size() - 1;
+    size_t hole = slot;
+    for (size_t next = (hole + 1) & mask; slots_[next].index != kEmptySlot;
+         next = (next + 1) & mask) {
+      const size_t home = GetHomeSlot(slots_[next].key);
+      if (((next - home) & mask) >= ((next - hole) & mask)) {
+        slots_[hole] = slots_[next];
+        hole = next;
+      }
+    }
+    slots_[hole].index = kEmptySlot;
+  }
+
+  // Indexes the newly added pair at |index|, building or growing the index if
+  // needed.  The index is kept at most half full.
+  void AddToIndex(size_t index) {
+    if (slots_.empty()) {
+      if (entries_.size() > kMaxLinearSize) {
+        Rehash(entries_.size());
+      }
+    } else if (entries_.size() * 2 > slots_.size()) {
+      Rehash(entries_.size());
+    } else {
+      InsertSlot(entries_[index].first, index);
+    }
+  }
+
+  // Rebuilds the index with enough slots for at least |count| pairs.
+  void Rehash(size_t count) {
+    int bits = 4;
+    while ((size_t(1) << bits) < count * 2) {
+      ++bits;
+    }
+    Slot empty_slot;
+    empty_slot.key = Key();
+    empty_slot.index = kEmptySlot;
+    slots_.assign(size_t(1) << bits, empty_slot);
+    shift_ = 64 - bits;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+      InsertSlot(entries_[i].first, i);
+    }
+  }
+
+  void EraseIndex(size_t index) {
+    const size_t last = entries_.size() - 1;
+    if (!slots_.empty()) {
+      RemoveSlot(FindSlot(entries_[index].first));
+      if (index != last) {
+        slots_[FindSlot(entries_[last].first)].index =
+            static_cast<uint32_t>(index);
+      }
+    }
+    if (index != last) {
+      entries_[index] = std::move(entries_[last]);
+    }
+    entries_.pop_back();
+  }
+
+  std::vector<value_type> entries_;
+  std::vector<Slot> slots_;
+  int shift_;
+};
+
+template <typename Key, typename Value>
+const size_t FlatHashMap<Key, Value>::kMaxLinearSize;
+template <typename Key, typename Value>
+const size_t FlatHashMap<Key, Value>::kNotFound;
+template <typename Key, typename Value>
+const uint32_t FlatHashMap<Key, Value>::kEmptySlot;
+
+}  // namespace lull
+
+#endif  // LULLABY_BASE_FLAT_HASH_MAP_H_
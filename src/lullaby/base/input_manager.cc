@@ -75,14 +75,13 @@ InputManager::DeviceParams::DeviceParams()
       num_joysticks(0),
       num_buttons(0),
       num_eyes(0),
-      long_press_time(kDefaultLongPressTime) {}
+      long_press_time(kDefaultLongPressTime),
+      pose_prediction_time(Clock::duration::zero()) {}
 
 InputManager::InputManager() {}
 
 void InputManager::AdvanceFrame(Clock::duration delta_time) {
-  std::unique_lock<std::mutex> lock(mutex_);
   for (Device& device : devices_) {
-    // TODO(b/26692955): Update connected state in a thread-safe manner.
     device.Advance(delta_time);
   }
 }
@@ -94,8 +93,6 @@ void InputManager::ConnectDevice(DeviceType device,
     return;
   }
 
-  // TODO(b/26692955): Update connected state in a thread-safe manner.
-  std::unique_lock<std::mutex> lock(mutex_);
   devices_[device].Connect(params);
 }
 
@@ -105,8 +102,6 @@ void InputManager::DisconnectDevice(DeviceType device) {
     return;
   }
 
-  // TODO(b/26692955): Update connected state in a thread-safe manner.
-  std::unique_lock<std::mutex> lock(mutex_);
   devices_[device].Disconnect();
 }
 
@@ -116,38 +111,33 @@ void InputManager::UpdateKey(DeviceType device, const std::string& key,
 }
 
 void InputManager::KeyPressed(DeviceType device, const std::string& key) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  DeviceState* state = GetDeviceStateForWriteLocked(device);
+  const PinnedBuffer buffer(this, device);
+  DeviceState* state = GetDeviceStateForWrite(buffer.get());
   if (state == nullptr) {
     LOG(DFATAL) << "No state for device: " << GetDeviceName(device);
     return;
   }
 
   state->keys.push_back(key);
+
+  buffer->Publish();
 }
 
 void InputManager::UpdateButton(DeviceType device, ButtonId id, bool pressed,
                                 bool repeat) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  DeviceState* state = GetDeviceStateForWriteLocked(device);
+  const PinnedBuffer buffer(this, device);
+  DeviceState* state = GetDeviceStateForWrite(buffer.get());
   if (state == nullptr) {
     LOG(DFATAL) << "No state for device: " << GetDeviceName(device);
     return;
   }
 
   if (id < state->buttons.size()) {
-    state->buttons[id] = pressed;
-
-    const DataBuffer* buffer = GetDataBuffer(device);
-    if (buffer == nullptr) {
-      LOG(DFATAL) << "Invalid buffer for device: " << GetDeviceName(device);
-      return;
-    }
-
     // Update the press time if the button was just pressed.
-    if (pressed && !buffer->GetCurrent().buttons[id]) {
+    if (pressed && !state->buttons[id]) {
       state->button_press_times[id] = state->time_stamp;
     }
+    state->buttons[id] = pressed;
   } else {
     LOG(DFATAL) << "Invalid button [" << id
                 << "] for device: " << GetDeviceName(device);
@@ -159,12 +149,14 @@ void InputManager::UpdateButton(DeviceType device, ButtonId id, bool pressed,
     LOG(DFATAL) << "Invalid repeat button [" << id
                 << "] for device: " << GetDeviceName(device);
   }
+
+  buffer->Publish();
 }
 
 void InputManager::UpdateJoystick(DeviceType device, JoystickType joystick,
                                   const mathfu::vec2& value) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  DeviceState* state = GetDeviceStateForWriteLocked(device);
+  const PinnedBuffer buffer(this, device);
+  DeviceState* state = GetDeviceStateForWrite(buffer.get());
   if (state == nullptr) {
     LOG(DFATAL) << "No state for device: " << GetDeviceName(device);
     return;
@@ -176,29 +168,25 @@ void InputManager::UpdateJoystick(DeviceType device, JoystickType joystick,
     LOG(DFATAL) << "Invalid joystick [" << joystick
                 << "] for device: " << GetDeviceName(device);
   }
+
+  buffer->Publish();
 }
 
 void InputManager::UpdateTouch(DeviceType device, const mathfu::vec2& value,
                                bool valid) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  DeviceState* state = GetDeviceStateForWriteLocked(device);
+  const PinnedBuffer buffer(this, device);
+  DeviceState* state = GetDeviceStateForWrite(buffer.get());
   if (state == nullptr) {
     LOG(DFATAL) << "No state for device: " << GetDeviceName(device);
     return;
   }
 
-  DataBuffer* buffer = GetDataBuffer(device);
-  if (buffer == nullptr) {
-    LOG(DFATAL) << "Invalid buffer for device: " << GetDeviceName(device);
-    return;
-  }
-
   if (state->touch.size() != 1) {
     LOG(DFATAL) << "Touch not enabled for device: " << GetDeviceName(device);
     return;
   }
 
-  const TouchpadState& prev = buffer->GetCurrent().touch[0];
+  const TouchpadState& prev = buffer->GetLatched().touch[0];
   TouchpadState& touch = state->touch[0];
   if (valid) {
     touch.position = ClampVec2(value, 0.0f, 1.0f);
@@ -209,7 +197,6 @@ void InputManager::UpdateTouch(DeviceType device, const mathfu::vec2& value,
       const float kCutoffHz = 10.0f;
       const float kRc = static_cast<float>(1.0 / (2.0 * M_PI * kCutoffHz));
 
-      const TouchpadState& prev = buffer->GetCurrent().touch[0];
       const float delta_sec = SecondsFromDuration(touch.time - prev.time);
       const mathfu::vec2 instantaneous_velocity =
           (touch.position - prev.position) / delta_sec;
@@ -233,14 +220,16 @@ void InputManager::UpdateTouch(DeviceType device, const mathfu::vec2& value,
       touch.velocity = mathfu::kZeros2f;
     }
   }
+
+  buffer->Publish();
 }
 
 void InputManager::UpdateGesture(DeviceType device, GestureType type,
                                  GestureDirection direction,
                                  const mathfu::vec2& displacement,
                                  const mathfu::vec2& velocity) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  DeviceState* state = GetDeviceStateForWriteLocked(device);
+  const PinnedBuffer buffer(this, device);
+  DeviceState* state = GetDeviceStateForWrite(buffer.get());
   if (state == nullptr) {
     LOG(DFATAL) << "No state for device: " << GetDeviceName(device);
     return;
@@ -256,11 +245,13 @@ void InputManager::UpdateGesture(DeviceType device, GestureType type,
     LOG(DFATAL) << "Touch gestures not enabled for device: "
                 << GetDeviceName(device);
   }
+
+  buffer->Publish();
 }
 
 void InputManager::UpdateScroll(DeviceType device, int delta) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  DeviceState* state = GetDeviceStateForWriteLocked(device);
+  const PinnedBuffer buffer(this, device);
+  DeviceState* state = GetDeviceStateForWrite(buffer.get());
   if (state == nullptr) {
     LOG(DFATAL) << "No state for device: " << GetDeviceName(device);
     return;
@@ -272,12 +263,15 @@ void InputManager::UpdateScroll(DeviceType device, int delta) {
     LOG(DFATAL) << "Touch scroll not enabled for device: "
                 << GetDeviceName(device);
   }
+
+  buffer->Publish();
 }
 
 void InputManager::UpdatePosition(DeviceType device,
-                                  const mathfu::vec3& value) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  DeviceState* state = GetDeviceStateForWriteLocked(device);
+                                  const mathfu::vec3& value,
+                                  Clock::time_point sample_time) {
+  const PinnedBuffer buffer(this, device);
+  DeviceState* state = GetDeviceStateForWrite(buffer.get());
   if (state == nullptr) {
     LOG(DFATAL) << "No state for device: " << GetDeviceName(device);
     return;
@@ -285,16 +279,20 @@ void InputManager::UpdatePosition(DeviceType device,
 
   if (state->position.size() == 1) {
     state->position[0] = value;
+    RecordPose(buffer.get(), *state, sample_time);
   } else {
     LOG(DFATAL) << "Position DOF not enabled for device: "
                 << GetDeviceName(device);
   }
+
+  buffer->Publish();
 }
 
 void InputManager::UpdateRotation(DeviceType device,
-                                  const mathfu::quat& value) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  DeviceState* state = GetDeviceStateForWriteLocked(device);
+                                  const mathfu::quat& value,
+                                  Clock::time_point sample_time) {
+  const PinnedBuffer buffer(this, device);
+  DeviceState* state = GetDeviceStateForWrite(buffer.get());
   if (state == nullptr) {
     LOG(DFATAL) << "No state for device: " << GetDeviceName(device);
     return;
@@ -302,18 +300,21 @@ void InputManager::UpdateRotation(DeviceType device,
 
   if (state->rotation.size() == 1) {
     state->rotation[0] = value;
+    RecordPose(buffer.get(), *state, sample_time);
   } else {
     LOG(DFATAL) << "Rotation DOF not enabled for device: "
                 << GetDeviceName(device);
   }
+
+  buffer->Publish();
 }
 
 void InputManager::UpdateEye(DeviceType device, EyeType eye,
                              const mathfu::mat4& eye_from_head_matrix,
                              const mathfu::rectf& eye_fov,
                              const mathfu::recti& eye_viewport) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  DeviceState* state = GetDeviceStateForWriteLocked(device);
+  const PinnedBuffer buffer(this, device);
+  DeviceState* state = GetDeviceStateForWrite(buffer.get());
   if (state == nullptr) {
     LOG(DFATAL) << "No state for device: " << GetDeviceName(device);
     return;
@@ -339,6 +340,8 @@ void InputManager::UpdateEye(DeviceType device, EyeType eye,
     LOG(DFATAL) << "Invalid eye viewport [" << eye
                 << "] for device: " << GetDeviceName(device);
   }
+
+  buffer->Publish();
 }
 
 bool InputManager::IsConnected(DeviceType device) const {
@@ -788,6 +791,60 @@ mathfu::mat4 InputManager::GetDofWorldFromObjectMatrix(
   return CalculateTransformMatrix(pos, rot, mathfu::kOnes3f);
 }
 
+TimedPose InputManager::GetDofPredictedPose(DeviceType device,
+                                            Clock::time_point time) const {
+  const DataBuffer* buffer = GetConnectedDataBuffer(device);
+  if (buffer == nullptr) {
+    LOG(DFATAL) << "Invalid buffer for device: " << GetDeviceName(device);
+    return TimedPose();
+  }
+
+  const DeviceParams* params = GetDeviceParams(device);
+  if (!params || (!params->has_rotation_dof && !params->has_position_dof)) {
+    LOG(DFATAL) << "Pose not setup for device: " << GetDeviceName(device);
+    return TimedPose();
+  }
+
+  const PoseHistory& poses = buffer->GetCurrentPoses();
+  if (poses.Empty()) {
+    const DeviceState& state = buffer->GetCurrent();
+    TimedPose pose;
+    pose.time = time;
+    if (params->has_position_dof) {
+      pose.position = state.position[0];
+    }
+    if (params->has_rotation_dof) {
+      pose.rotation = state.rotation[0];
+    }
+    return pose;
+  }
+  return poses.Predict(time);
+}
+
+mathfu::mat4 InputManager::GetLatchedDofWorldFromObjectMatrix(
+    DeviceType device) {
+  // Pinning keeps the device's buffer alive even if it is disconnected while
+  // its poses are being read.  Nothing else is read from the buffer since this
+  // may be called from a thread other than the one calling AdvanceFrame.
+  const PinnedBuffer buffer(this, device);
+  if (buffer.get() == nullptr) {
+    return mathfu::mat4::Identity();
+  }
+
+  const PoseHistory& poses = buffer->LatchPoses();
+  if (poses.Empty()) {
+    return mathfu::mat4::Identity();
+  }
+
+  const Clock::duration prediction_time =
+      buffer->GetParams().pose_prediction_time;
+  const TimedPose pose = prediction_time > Clock::duration::zero()
+                             ? poses.Predict(Clock::now() + prediction_time)
+                             : poses.GetLatest();
+  return CalculateTransformMatrix(pose.position, pose.rotation,
+                                  mathfu::kOnes3f);
+}
+
 int InputManager::GetScrollDelta(DeviceType device) const {
   const DataBuffer* buffer = GetConnectedDataBuffer(device);
   if (buffer == nullptr) {
@@ -898,17 +955,18 @@ const InputManager::DeviceParams* InputManager::GetDeviceParams(
                                       : nullptr;
 }
 
-InputManager::DeviceState* InputManager::GetDeviceStateForWriteLocked(
-    DeviceType device) {
-  if (device == kMaxNumDeviceTypes) {
-    return nullptr;
-  }
+InputManager::DeviceState* InputManager::GetDeviceStateForWrite(
+    DataBuffer* buffer) {
+  return buffer ? &buffer->GetMutable() : nullptr;
+}
 
-  DataBuffer* buffer = devices_[device].GetDataBuffer();
-  if (buffer == nullptr) {
-    return nullptr;
-  }
-  return &buffer->GetMutable();
+void InputManager::RecordPose(DataBuffer* buffer, const DeviceState& state,
+                              Clock::time_point sample_time) {
+  const mathfu::vec3 position =
+      state.position.empty() ? mathfu::kZeros3f : state.position[0];
+  const mathfu::quat rotation =
+      state.rotation.empty() ? mathfu::quat::identity : state.rotation[0];
+  buffer->RecordPose(sample_time, position, rotation);
 }
 
 InputManager::ButtonState InputManager::GetButtonState(
@@ -950,13 +1008,27 @@ InputManager::ButtonState InputManager::GetButtonState(
   return state;
 }
 
-InputManager::Device::Device() : connected_(false) {}
+InputManager::PinnedBuffer::PinnedBuffer(InputManager* input_manager,
+                                         DeviceType device)
+    : device_(device != kMaxNumDeviceTypes ? &input_manager->devices_[device]
+                                           : nullptr),
+      buffer_(device_ ? device_->Pin() : nullptr) {}
 
-void InputManager::Device::Connect(const DeviceParams& params) {
-  DCHECK(!connected_) << "Device is already connected.";
-  connected_ = true;
-  params_ = params;
+InputManager::PinnedBuffer::~PinnedBuffer() {
+  if (device_) {
+    device_->Unpin();
+  }
+}
+
+InputManager::Device::Device()
+    : buffer_(nullptr), retired_(nullptr), num_pins_(0) {}
 
+InputManager::Device::~Device() {
+  delete buffer_.load();
+  CollectRetired();
+}
+
+void InputManager::Device::Connect(const DeviceParams& params) {
   DeviceState state;
   // state.keys;
   state.scroll.resize(params.has_scroll ? 1 : 0, 0);
@@ -975,51 +1047,173 @@ void InputManager::Device::Connect(const DeviceParams& params) {
   state.eye_from_head_matrix.resize(params.num_eyes, mathfu::mat4::Identity());
   state.eye_viewport.resize(params.num_eyes);
   state.eye_fov.resize(params.num_eyes);
-  buffer_.reset(new DataBuffer(state));
+  DataBuffer* previous = buffer_.exchange(new DataBuffer(state, params));
+  DCHECK(previous == nullptr) << "Device is already connected.";
+  Retire(previous);
 }
 
 void InputManager::Device::Disconnect() {
-  DCHECK(connected_) << "Device is not connected.";
-  params_ = DeviceParams();
-  connected_ = false;
-  buffer_.reset();
+  DataBuffer* previous = buffer_.exchange(nullptr);
+  DCHECK(previous != nullptr) << "Device is not connected.";
+  Retire(previous);
 }
 
 void InputManager::Device::Advance(Clock::duration delta_time) {
-  if (buffer_) {
-    buffer_->Advance(delta_time);
+  // A retired buffer may still be in use by a thread that pinned the device
+  // before the buffer was replaced.  Such a thread still holds its pin, so
+  // retired buffers can be freed once there are no pins.
+  CollectRetired();
+  if (!expired_.empty() && num_pins_.load() == 0) {
+    expired_.clear();
+  }
+
+  DataBuffer* buffer = GetDataBuffer();
+  if (buffer) {
+    buffer->Advance(delta_time);
   }
 }
 
-InputManager::DataBuffer::DataBuffer(
-    const InputManager::DeviceState& reference_state) {
-  curr_index_ = 0;
-  for (DeviceState& state : buffer_) {
-    state = reference_state;
+const InputManager::DeviceParams& InputManager::Device::GetDeviceParams()
+    const {
+  static const DeviceParams kDisconnectedParams;
+  const DataBuffer* buffer = GetDataBuffer();
+  return buffer ? buffer->GetParams() : kDisconnectedParams;
+}
+
+InputManager::DataBuffer* InputManager::Device::Pin() {
+  // The pin is counted before the buffer is read, so that Advance can't miss
+  // it once the buffer has been retired.
+  num_pins_.fetch_add(1);
+  return buffer_.load();
+}
+
+void InputManager::Device::Unpin() { num_pins_.fetch_sub(1); }
+
+void InputManager::Device::Retire(DataBuffer* buffer) {
+  if (buffer == nullptr) {
+    return;
+  }
+  RetiredBuffer* retired = new RetiredBuffer{
+      std::unique_ptr<DataBuffer>(buffer), retired_.load()};
+  while (!retired_.compare_exchange_weak(retired->next, retired)) {
   }
 }
 
+void InputManager::Device::CollectRetired() {
+  RetiredBuffer* retired = retired_.exchange(nullptr);
+  while (retired) {
+    RetiredBuffer* next = retired->next;
+    expired_.emplace_back(std::move(retired->buffer));
+    delete retired;
+    retired = next;
+  }
+}
+
+InputManager::DataBuffer::DataBuffer(
+    const InputManager::DeviceState& reference_state,
+    const DeviceParams& params)
+    : params_(params),
+      states_(PublishedState(reference_state)),
+      previous_(reference_state),
+      time_stamp_(reference_state.time_stamp.time_since_epoch().count()),
+      reported_key_count_(0),
+      pending_(reference_state),
+      latched_(reference_state),
+      pending_key_base_(0),
+      awaiting_latch_(false) {}
+
 void InputManager::DataBuffer::Advance(Clock::duration delta_time) {
-  DeviceState& prev = buffer_[curr_index_];
-  prev.time_stamp += delta_time;
-  curr_index_ = (curr_index_ + kBufferSize - 1) % kBufferSize;
-  DeviceState& state = buffer_[curr_index_];
-  state = prev;
-  state.keys.clear();
+  const Clock::time_point time_stamp =
+      states_.GetReadBuffer().state.time_stamp + delta_time;
+  previous_ = states_.GetReadBuffer().state;
+
+  // Take the most recently published state, if any.  Otherwise the current
+  // state carries over.
+  states_.Acquire();
+  poses_.Acquire();
+  current_poses_ = poses_.GetReadBuffer();
+
+  // Keys are only reported once, so remove any that have been reported by a
+  // previous state.
+  PublishedState& current = states_.GetReadBuffer();
+  std::vector<std::string>& keys = current.state.keys;
+  const uint64_t unreported =
+      current.key_count - reported_key_count_.load(std::memory_order_relaxed);
+  if (unreported < keys.size()) {
+    keys.erase(keys.begin(), keys.end() - static_cast<size_t>(unreported));
+  }
+  reported_key_count_.store(current.key_count, std::memory_order_release);
+
+  current.state.time_stamp = time_stamp;
+  time_stamp_.store(time_stamp.time_since_epoch().count(),
+                    std::memory_order_release);
 }
 
 InputManager::DeviceState& InputManager::DataBuffer::GetMutable() {
-  return buffer_[curr_index_];
+  // Drop the keys that have already been reported by the reader.
+  const uint64_t reported_key_count =
+      reported_key_count_.load(std::memory_order_acquire);
+  if (reported_key_count > pending_key_base_) {
+    const size_t count = static_cast<size_t>(std::min<uint64_t>(
+        reported_key_count - pending_key_base_, pending_.keys.size()));
+    pending_.keys.erase(pending_.keys.begin(), pending_.keys.begin() + count);
+    pending_key_base_ += count;
+  }
+
+  // Once the reader has taken the last published state, it becomes the
+  // writer's view of the current state.  If the reader takes a state while
+  // another is being written, this view lags by a frame until the next write.
+  if (awaiting_latch_ && !states_.HasPublishedValue()) {
+    latched_ = pending_;
+    awaiting_latch_ = false;
+  }
+  pending_.time_stamp = Clock::time_point(
+      Clock::duration(time_stamp_.load(std::memory_order_acquire)));
+  return pending_;
+}
+
+const InputManager::DeviceState& InputManager::DataBuffer::GetLatched() const {
+  return latched_;
+}
+
+void InputManager::DataBuffer::Publish() {
+  PublishedState& published = states_.GetWriteBuffer();
+  published.state = pending_;
+  published.key_count = pending_key_base_ + pending_.keys.size();
+  states_.Publish();
+  awaiting_latch_ = true;
+}
+
+void InputManager::DataBuffer::RecordPose(Clock::time_point time,
+                                          const mathfu::vec3& position,
+                                          const mathfu::quat& rotation) {
+  // Sensors may deliver position and rotation separately, so a sample may be
+  // older than one already recorded.  The history only moves forward.
+  if (!pending_poses_.Empty() && time < pending_poses_.GetLatest().time) {
+    return;
+  }
+  pending_poses_.Add(time, position, rotation);
+  poses_.GetWriteBuffer() = pending_poses_;
+  poses_.Publish();
+  late_poses_.GetWriteBuffer() = pending_poses_;
+  late_poses_.Publish();
 }
 
 const InputManager::DeviceState& InputManager::DataBuffer::GetCurrent() const {
-  const int index = (curr_index_ + 1) % kBufferSize;
-  return buffer_[index];
+  return states_.GetReadBuffer().state;
 }
 
 const InputManager::DeviceState& InputManager::DataBuffer::GetPrevious() const {
-  const int index = (curr_index_ + 2) % kBufferSize;
-  return buffer_[index];
+  return previous_;
+}
+
+const PoseHistory& InputManager::DataBuffer::GetCurrentPoses() const {
+  return current_poses_;
+}
+
+const PoseHistory& InputManager::DataBuffer::LatchPoses() {
+  late_poses_.Acquire();
+  return late_poses_.GetReadBuffer();
 }
 
 }  // namespace lull
@@ -17,8 +17,8 @@ limitations under the License.
 #ifndef LULLABY_BASE_INPUT_MANAGER_H_
 #define LULLABY_BASE_INPUT_MANAGER_H_
 
+#include <atomic>
 #include <memory>
-#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -26,6 +26,8 @@ limitations under the License.
 #include "mathfu/glsl_mappings.h"
 #include "lullaby/util/typeid.h"
 #include "lullaby/util/clock.h"
+#include "lullaby/util/pose_history.h"
+#include "lullaby/util/triple_buffer.h"
 
 namespace lull {
 
@@ -42,10 +44,15 @@ namespace lull {
 //
 // The AdvanceFrame function is used to update the buffer such that the "front"
 // state becomes the "current" state and a new "front" state is made available
-// for write operations.  The InputManager allows multiple threads to generate
-// input events by using a mutex.  State information is also safe to read from
-// multiple threads as they are read-only operations.  However, it is assumed
-// that no query operations will be performed during the AdvanceFrame call.
+// for write operations.  The write and read sides of each device's buffer are
+// exchanged using atomics rather than a lock, so input events for a device can
+// be generated from one thread (which may differ between devices) without ever
+// blocking, or being blocked by, the thread calling AdvanceFrame.  Connecting
+// or disconnecting a device replaces its buffer, and the old buffer is only
+// destroyed by a later AdvanceFrame once no other thread is still using it.
+// State information is also safe to read from multiple threads as they are
+// read-only operations.  However, it is assumed that no query operations will
+// be performed during the AdvanceFrame call.
 class InputManager {
  public:
   InputManager();
@@ -191,6 +198,20 @@ class InputManager {
   // those degrees of freedom).
   mathfu::mat4 GetDofWorldFromObjectMatrix(DeviceType device) const;
 
+  // Gets the pose of a |device| with a positional or rotational sensor at
+  // |time|, estimated from the poses received up to the current frame.  Times
+  // after the latest pose are predicted using the |device|'s recent velocity.
+  TimedPose GetDofPredictedPose(DeviceType device,
+                                Clock::time_point time) const;
+
+  // Gets a matrix composed of the most recent Position and Rotation received
+  // for the |device|, predicted ahead by its |pose_prediction_time|.  Unlike
+  // the other queries, this includes poses received since the last
+  // AdvanceFrame, so it should be called as late as possible before rendering
+  // (ie. "late-latching"), typically from the render thread.  Returns the
+  // identity matrix if the |device| is disconnected or has no poses yet.
+  mathfu::mat4 GetLatchedDofWorldFromObjectMatrix(DeviceType device);
+
   // Gets the delta value for a |device| with a scroll wheel.
   int GetScrollDelta(DeviceType device) const;
 
@@ -233,6 +254,9 @@ class InputManager {
     size_t num_buttons;
     size_t num_eyes;
     Clock::duration long_press_time;
+    // The expected time between the latest pose being received and it being
+    // displayed.  Latched poses are predicted this far ahead.
+    Clock::duration pose_prediction_time;
   };
 
   // Enables the |device| with the given |params|.
@@ -278,11 +302,17 @@ class InputManager {
   // Updates the scroll value for the |device|.
   void UpdateScroll(DeviceType device, int delta);
 
-  // Updates position of the |device|.
-  void UpdatePosition(DeviceType device, const mathfu::vec3& value);
+  // Updates position of the |device|, as sampled by its sensor at
+  // |sample_time|.  Samples older than the latest pose are not added to the
+  // pose history used for prediction.
+  void UpdatePosition(DeviceType device, const mathfu::vec3& value,
+                      Clock::time_point sample_time = Clock::now());
 
-  // Updates rotation of the |device|.
-  void UpdateRotation(DeviceType device, const mathfu::quat& value);
+  // Updates rotation of the |device|, as sampled by its sensor at
+  // |sample_time|.  Samples older than the latest pose are not added to the
+  // pose history used for prediction.
+  void UpdateRotation(DeviceType device, const mathfu::quat& value,
+                      Clock::time_point sample_time = Clock::now());
 
   // Updates the "eye from head", "field of view", and "viewport" settings for
   // the |device| and |eye|.
@@ -331,36 +361,102 @@ class InputManager {
     Clock::time_point time_stamp;
   };
 
-  // Buffer for holding DeviceState.
+  // Buffer for holding DeviceState.  The writer publishes its state through a
+  // single-writer/single-reader TripleBuffer and the reader takes the most
+  // recently published state when advancing, so that neither side ever waits.
+  // The writer's pose history is kept separately and published through a
+  // second TripleBuffer.  A DataBuffer lasts for a single connection of its
+  // device, whose |params| it holds.
   class DataBuffer {
    public:
     // Constructor that initializes all internal states in the buffer to the
     // provided |reference_state|.
-    explicit DataBuffer(const DeviceState& reference_state);
+    DataBuffer(const DeviceState& reference_state,
+               const DeviceParams& params);
+
+    // Get the parameters the device was connected with.
+    const DeviceParams& GetParams() const { return params_; }
 
-    // Update the write-state to now be the first (ie. current) read-only state
-    // and prepare a new write-state.
+    // Update the most recently published write-state to now be the first (ie.
+    // current) read-only state.  Only called by the reader.
     void Advance(Clock::duration delta_time);
 
-    // Get reference to writable state.
+    // Get reference to writable state.  Changes are not visible to the reader
+    // until Publish is called.  Only called by the writer.
     DeviceState& GetMutable();
 
+    // Get read-only reference to the write-state that was most recently taken
+    // by the reader, ie. the writer's view of the current state.  Only called
+    // by the writer.
+    const DeviceState& GetLatched() const;
+
+    // Makes the changes to the writable state available to the reader.  Only
+    // called by the writer.
+    void Publish();
+
+    // Adds a pose sampled at |time| to the writer's pose history and makes
+    // the history available to both Advance and LatchPoses.  Only called by
+    // the writer.
+    void RecordPose(Clock::time_point time, const mathfu::vec3& position,
+                    const mathfu::quat& rotation);
+
     // Get read-only reference to most recent state.
     const DeviceState& GetCurrent() const;
 
     // Get read-only reference to previous state.
     const DeviceState& GetPrevious() const;
 
+    // Get read-only reference to the pose history as of the most recent state.
+    const PoseHistory& GetCurrentPoses() const;
+
+    // Get read-only reference to the most recently published pose history.
+    // The reference remains valid until the next call to LatchPoses, which
+    // must not be called concurrently with itself.  This has its own buffer,
+    // so it may be called at the same time as Advance.
+    const PoseHistory& LatchPoses();
+
    private:
-    static const int kBufferSize = 3;
-    DeviceState buffer_[kBufferSize];
-    int curr_index_;
+    struct PublishedState {
+      PublishedState() {}
+      explicit PublishedState(const DeviceState& state) : state(state) {}
+
+      DeviceState state;
+      // The total number of keys pressed as of |state|.  This is used to
+      // report each key exactly once.
+      uint64_t key_count = 0;
+    };
+
+    const DeviceParams params_;
+    TripleBuffer<PublishedState> states_;
+    TripleBuffer<PoseHistory> poses_;
+    // The same poses as |poses_|, read by LatchPoses rather than Advance.
+    TripleBuffer<PoseHistory> late_poses_;
+    DeviceState previous_;
+    // A copy of the latched pose history taken when advancing, so that pose
+    // queries are consistent for the whole frame.
+    PoseHistory current_poses_;
+    // The time stamp of the current state, which is also given to any states
+    // published during this frame.
+    std::atomic<Clock::rep> time_stamp_;
+    // The total number of keys that have been reported by the reader.
+    std::atomic<uint64_t> reported_key_count_;
+
+    // Writer state.
+    DeviceState pending_;
+    DeviceState latched_;
+    PoseHistory pending_poses_;
+    uint64_t pending_key_base_;
+    bool awaiting_latch_;
   };
 
-  // Class representing a single input device.
+  // Class representing a single input device.  The device's DataBuffer is
+  // swapped atomically when connecting and disconnecting.  Replaced buffers are
+  // retired rather than destroyed, and freed by Advance once no thread has the
+  // device pinned.
   class Device {
    public:
     Device();
+    ~Device();
 
     void Connect(const DeviceParams& params);
 
@@ -368,18 +464,65 @@ class InputManager {
 
     void Advance(Clock::duration delta_time);
 
-    bool IsConnected() const { return connected_; }
+    bool IsConnected() const { return GetDataBuffer() != nullptr; }
+
+    // Gets the buffer of the current connection, if any.  The buffer stays
+    // valid until the next call to Advance, so this must only be used by the
+    // thread calling AdvanceFrame.
+    DataBuffer* GetDataBuffer() {
+      return buffer_.load(std::memory_order_acquire);
+    }
 
-    DataBuffer* GetDataBuffer() { return buffer_.get(); }
+    const DataBuffer* GetDataBuffer() const {
+      return buffer_.load(std::memory_order_acquire);
+    }
+
+    const DeviceParams& GetDeviceParams() const;
+
+    // Gets the buffer of the current connection, if any, and keeps it from
+    // being freed until Unpin is called.  Used by threads other than the one
+    // calling AdvanceFrame.
+    DataBuffer* Pin();
+
+    void Unpin();
+
+   private:
+    struct RetiredBuffer {
+      std::unique_ptr<DataBuffer> buffer;
+      RetiredBuffer* next;
+    };
+
+    // Adds |buffer| to the retired buffers.
+    void Retire(DataBuffer* buffer);
+
+    // Moves the retired buffers to |expired_|.
+    void CollectRetired();
+
+    std::atomic<DataBuffer*> buffer_;
+    // A lock-free stack of buffers replaced since the last Advance.
+    std::atomic<RetiredBuffer*> retired_;
+    // The number of threads that currently have the device pinned.
+    std::atomic<int> num_pins_;
+    // Retired buffers waiting for all pins to be released.  Only used by
+    // Advance.
+    std::vector<std::unique_ptr<DataBuffer>> expired_;
+  };
+
+  // Pins a device's DataBuffer for the duration of a write or late-latch.
+  class PinnedBuffer {
+   public:
+    PinnedBuffer(InputManager* input_manager, DeviceType device);
+    ~PinnedBuffer();
 
-    const DataBuffer* GetDataBuffer() const { return buffer_.get(); }
+    PinnedBuffer(const PinnedBuffer&) = delete;
+    PinnedBuffer& operator=(const PinnedBuffer&) = delete;
 
-    const DeviceParams& GetDeviceParams() const { return params_; }
+    DataBuffer* get() const { return buffer_; }
+    DataBuffer* operator->() const { return buffer_; }
 
    private:
-    bool connected_;
-    DeviceParams params_;
-    std::unique_ptr<DataBuffer> buffer_;
+    Device* device_;
+    DataBuffer* buffer_;
   };
 
   static const ButtonState kInvalidButtonState = 0;
@@ -394,10 +537,11 @@ class InputManager {
   const DataBuffer* GetDataBuffer(DeviceType device) const;
   const DataBuffer* GetConnectedDataBuffer(DeviceType device) const;
   const DeviceParams* GetDeviceParams(DeviceType device) const;
-  DeviceState* GetDeviceStateForWriteLocked(DeviceType device);
+  static DeviceState* GetDeviceStateForWrite(DataBuffer* buffer);
+  static void RecordPose(DataBuffer* buffer, const DeviceState& state,
+                         Clock::time_point sample_time);
   const TouchGesture* GetTouchGesturePtr(DeviceType device) const;
 
-  std::mutex mutex_;
   Device devices_[kMaxNumDeviceTypes];
 };
 
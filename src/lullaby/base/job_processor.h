@@ -17,8 +17,10 @@ limitations under the License.
 #ifndef LULLABY_BASE_JOB_PROCESSOR_H_
 #define LULLABY_BASE_JOB_PROCESSOR_H_
 
+#include <algorithm>
 #include <future>
 #include <utility>
+#include <vector>
 
 #include "lullaby/base/async_processor.h"
 #include "lullaby/util/logging.h"
@@ -45,6 +47,42 @@ std::future<void> RunJob(JobProcessor* processor, Func&& func) {
   return job;
 }
 
+// Splits the range [0, |count|) into at most |max_jobs| contiguous sub-ranges
+// of at least |min_range_size| elements and calls |fn(begin, end)| for each.
+// All but the last sub-range are queued on |processor|, while the last is run
+// on the calling thread.  Blocks until every sub-range has completed.  If
+// |processor| is null, the entire range is run on the calling thread.
+template <typename Func>
+void RunJobsForRange(JobProcessor* processor, size_t count,
+                     size_t min_range_size, size_t max_jobs, const Func& fn) {
+  if (count == 0) {
+    return;
+  }
+  if (min_range_size == 0) {
+    min_range_size = 1;
+  }
+  size_t num_jobs = std::min(count / min_range_size, max_jobs);
+  if (processor == nullptr || num_jobs <= 1) {
+    fn(size_t(0), count);
+    return;
+  }
+
+  const size_t range_size = (count + num_jobs - 1) / num_jobs;
+  std::vector<std::future<void>> jobs;
+  jobs.reserve(num_jobs - 1);
+  size_t begin = 0;
+  while (count - begin > range_size) {
+    const size_t end = begin + range_size;
+    jobs.emplace_back(RunJob(processor, [&fn, begin, end]() { fn(begin, end); }));
+    begin = end;
+  }
+  fn(begin, count);
+
+  for (auto& job : jobs) {
+    job.wait();
+  }
+}
+
 }  // namespace lull
 
 LULLABY_SETUP_TYPEID(lull::JobProcessor);
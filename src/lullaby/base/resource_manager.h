@@ -111,6 +111,7 @@ typename ResourceManager<T>::ObjectPtr ResourceManager<T>::Create(
       // If the cached shared_ptr was released, reacquire it.
       if (iter->second.object == nullptr) {
         iter->second.object = obj;
+        iter->second.handle = obj;
       }
     } else {
       objects_.emplace(key, ObjectCacheEntry(obj));
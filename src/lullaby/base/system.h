@@ -25,6 +25,9 @@ limitations under the License.
 
 namespace lull {
 
+class LoadFromBuffer;
+class SaveToBuffer;
+
 // System base-class for Lullaby's Entity-Component-System (ECS) architecture.
 //
 // Systems are responsible for storing the actual Component data instances
@@ -71,6 +74,20 @@ class System {
   // Disassociates all Component data from the Entity.
   virtual void Destroy(Entity e) {}
 
+  // Systems opt in to world snapshots (see EntityFactory::SaveSnapshot) by
+  // returning a non-zero version here and implementing the functions below.
+  // The version is stored alongside the System's data and should be bumped
+  // whenever the format written by SaveSnapshot changes; data with a different
+  // version is ignored when loading.
+  virtual uint32_t GetSnapshotVersion() const { return 0; }
+
+  // Writes the data of all Components to |serializer|.
+  virtual void SaveSnapshot(SaveToBuffer* serializer) {}
+
+  // Restores Components from data written by SaveSnapshot.  Returns false if
+  // the data could not be restored.
+  virtual bool LoadSnapshot(LoadFromBuffer* serializer) { return false; }
+
  protected:
   // Converts a flatbuffer::Table to a derived type for processing.
   template <typename T>
@@ -17,12 +17,17 @@ limitations under the License.
 #ifndef LULLABY_BASE_VARIANT_H_
 #define LULLABY_BASE_VARIANT_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <new>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
 #include "mathfu/glsl_mappings.h"
 #include "lullaby/base/detail/type_util.h"
+#include "lullaby/base/flat_hash_map.h"
 #include "lullaby/util/typeid.h"
 #include "lullaby/util/logging.h"
 
@@ -30,17 +35,19 @@ namespace lull {
 
 class Variant;
 using VariantArray = std::vector<Variant>;
-using VariantMap = std::unordered_map<HashValue, Variant>;
+using VariantMap = FlatHashMap<HashValue, Variant>;
 
 // Used to store an instance of any type that has a TypeId.
 //
 // This class is similar to C++17 std::any, but differs in the following ways:
 //
 // * Returns a Lullaby TypeId instead of the C++ RTTI type_info class.
-// * Does not do any dynamic allocations.  It is effectively just the
-//   "small-object optimization" (SOO) part of std::any.
-// * Stored objects are limited to 64 bytes and 16-byte alignment.  This is
-//   designed to store common types including std containers and mathfu types.
+// * The Variant itself is kept small (24 bytes on 64-bit platforms) so that
+//   containers of Variants stay compact.  Small objects (eg. scalars and
+//   vec2s) that are no-throw movable and fit in 16 bytes with at most 8-byte
+//   alignment are stored inline.  Larger or over-aligned objects (eg. strings,
+//   containers, mat4s, and SIMD-aligned mathfu types) are stored in a separate
+//   allocation, which is moved rather than copied when the Variant is moved.
 class Variant {
  private:
   // Helper for determining if U is actually a Variant.  This is used to ensure
@@ -56,11 +63,10 @@ class Variant {
       !detail::IsVector<typename std::decay<U>::type>::kValue ||
       std::is_same<typename std::decay<U>::type, VariantArray>::value>::type;
 
-  // Helper for determining if U is a map, but not a VariantMap.
+  // Helper for determining if U is a map.
   template <class U>
   using EnableIfNotMap = typename std::enable_if<
-      !detail::IsMap<typename std::decay<U>::type>::kValue ||
-      std::is_same<typename std::decay<U>::type, VariantMap>::value>::type;
+      !detail::IsMap<typename std::decay<U>::type>::kValue>::type;
 
   // Helper for determining if U is a optional
   template <class U>
@@ -69,20 +75,20 @@ class Variant {
 
  public:
   // Default constructor, no value set.
-  Variant() : type_(0), handler_(nullptr) {}
+  Variant() : handler_(nullptr) {}
 
   // Copy constructor, copies variant value stored in |rhs|.
-  Variant(const Variant& rhs) : type_(rhs.type_), handler_(rhs.handler_) {
+  Variant(const Variant& rhs) : handler_(rhs.handler_) {
     if (!rhs.Empty()) {
-      rhs.handler_(kCopy, Data(), rhs.Data(), nullptr);
+      rhs.handler_(kCopy, &storage_, &rhs.storage_, nullptr);
     }
   }
 
-  // Move constructor, copies variant value stored in |rhs|.
-  Variant(Variant&& rhs) : type_(rhs.type_), handler_(rhs.handler_) {
+  // Move constructor, moves variant value stored in |rhs|, leaving |rhs| empty.
+  Variant(Variant&& rhs) noexcept : handler_(rhs.handler_) {
     if (!rhs.Empty()) {
-      rhs.handler_(kMove, Data(), nullptr, rhs.Data());
-      rhs.Clear();
+      rhs.handler_(kMove, &storage_, nullptr, &rhs.storage_);
+      rhs.handler_ = nullptr;
     }
   }
 
@@ -101,23 +107,21 @@ class Variant {
     if (this != &rhs) {
       Clear();
       if (!rhs.Empty()) {
-        type_ = rhs.type_;
+        rhs.handler_(kCopy, &storage_, &rhs.storage_, nullptr);
         handler_ = rhs.handler_;
-        handler_(kCopy, Data(), rhs.Data(), nullptr);
       }
     }
     return *this;
   }
 
   // Moves variant value from |rhs| if a value is set.
-  Variant& operator=(Variant&& rhs) {
+  Variant& operator=(Variant&& rhs) noexcept {
     if (this != &rhs) {
       Clear();
       if (!rhs.Empty()) {
-        type_ = rhs.type_;
+        rhs.handler_(kMove, &storage_, nullptr, &rhs.storage_);
         handler_ = rhs.handler_;
-        handler_(kMove, Data(), nullptr, rhs.Data());
-        rhs.Clear();
+        rhs.handler_ = nullptr;
       }
     }
     return *this;
@@ -131,14 +135,14 @@ class Variant {
   }
 
   // Returns true if no value is set, false otherwise.
-  bool Empty() const { return type_ == 0 && handler_ == nullptr; }
+  bool Empty() const { return handler_ == nullptr; }
 
   // Resets the Variant back to an unset state, destroying any stored value.
   void Clear() {
     if (!Empty()) {
-      handler_(kDestroy, nullptr, nullptr, Data());
-      type_ = 0;
+      HandlerFn handler = handler_;
       handler_ = nullptr;
+      handler(kDestroy, nullptr, nullptr, &storage_);
     }
   }
 
@@ -217,8 +221,8 @@ class Variant {
 
  private:
   enum {
-    kStoreSize = 128,  // Large enough to store a mathfu::mat4.
-    kStoreAlign = 16,  // Aligned for mathfu types.
+    kInlineSize = 16,   // Large enough to store a mathfu::vec2 or a double.
+    kInlineAlign = 8,   // Aligned for 64-bit scalars and pointers.
   };
 
   // Type of operations that may be performed on the variant value.
@@ -229,49 +233,121 @@ class Variant {
     kDestroy,
   };
 
-  using InternalTypeId = uintptr_t;
-  using Buffer = std::aligned_storage<kStoreSize, kStoreAlign>::type;
-  using HandlerFn = TypeId (*)(Operation, void*, const void*, void*);
+  // The memory for the variant value: either the value itself, or a pointer to
+  // a separate allocation holding it.
+  union Storage {
+    std::aligned_storage<kInlineSize, kInlineAlign>::type buffer;
+    void* ptr;
+  };
+
+  using HandlerFn = TypeId (*)(Operation, Storage*, const Storage*, Storage*);
+
+  // Determines whether a value of |Type| is stored inline.  Values are moved
+  // between Variants using their move constructor, so inline values must not
+  // throw when moved.
+  template <typename Type>
+  struct IsInline {
+    static constexpr bool kValue =
+        sizeof(Type) <= kInlineSize && alignof(Type) <= kInlineAlign &&
+        std::is_nothrow_move_constructible<Type>::value;
+  };
+
+  // Allocates and frees memory for values that aren't stored inline, honoring
+  // alignments greater than those guaranteed by operator new.
+  template <typename Type>
+  static void* Allocate() {
+    if (alignof(Type) <= alignof(std::max_align_t)) {
+      return ::operator new(sizeof(Type));
+    }
+    // Over-allocate, and store the original pointer just before the aligned
+    // memory so that it can be freed.
+    const size_t kAlign = alignof(Type);
+    void* raw = ::operator new(sizeof(Type) + kAlign + sizeof(void*));
+    const uintptr_t start = reinterpret_cast<uintptr_t>(raw) + sizeof(void*);
+    void* aligned =
+        reinterpret_cast<void*>((start + kAlign - 1) & ~(kAlign - 1));
+    static_cast<void**>(aligned)[-1] = raw;
+    return aligned;
+  }
+
+  template <typename Type>
+  static void Free(void* ptr) {
+    if (alignof(Type) <= alignof(std::max_align_t)) {
+      ::operator delete(ptr);
+    } else {
+      ::operator delete(static_cast<void**>(ptr)[-1]);
+    }
+  }
+
+  // Returns a pointer to the value of |Type| in |storage|.
+  template <typename Type>
+  static Type* GetValue(Storage* storage) {
+    return IsInline<Type>::kValue
+               ? reinterpret_cast<Type*>(&storage->buffer)
+               : static_cast<Type*>(storage->ptr);
+  }
+  template <typename Type>
+  static const Type* GetValue(const Storage* storage) {
+    return IsInline<Type>::kValue
+               ? reinterpret_cast<const Type*>(&storage->buffer)
+               : static_cast<const Type*>(storage->ptr);
+  }
+
+  // Constructs a value of |Type| in |storage| from |args|.
+  template <typename Type, typename... Args>
+  static void Construct(Storage* storage, Args&&... args) {
+    if (IsInline<Type>::kValue) {
+      new (&storage->buffer) Type(std::forward<Args>(args)...);
+    } else {
+      void* ptr = Allocate<Type>();
+      new (ptr) Type(std::forward<Args>(args)...);
+      storage->ptr = ptr;
+    }
+  }
 
   // Performs the specified operation (copy, move, etc.) on the provided
-  // pointers.  Using a single function to handle all the various operations
+  // storage.  Using a single function to handle all the various operations
   // that can be performed on the variant type reduces the size of this class.
   // Returns the lull::TypeId of the the provided |Type|.
   // The parameters are dependent on the type of operation.  Specifically:
   //   kNone: all parameters are ignored.
-  //   kCopy: Object of |Type| is copied from |from| pointer to |to| pointer
+  //   kCopy: Object of |Type| is copied from |from| storage to |to| storage
   //          using copy constructor.
-  //   kMove: Object of |Type| is moved from |victim| pointer to |to| pointer
-  //          using move constructor.
-  //   kMove: Object of |Type| in |victim| is destroyed using destructor.
+  //   kMove: Object of |Type| is moved from |victim| storage to |to| storage,
+  //          leaving |victim| without a value.  Objects stored separately are
+  //          moved by transferring ownership of their allocation.
+  //   kDestroy: Object of |Type| in |victim| is destroyed using destructor.
   template <typename Type>
-  static TypeId HandlerImpl(Operation op, void* to, const void* from,
-                            void* victim) {
+  static TypeId HandlerImpl(Operation op, Storage* to, const Storage* from,
+                            Storage* victim) {
     switch (op) {
       case kNone:
         break;
       case kCopy:
-        new (to) Type(*static_cast<const Type*>(from));
+        Construct<Type>(to, *GetValue<Type>(from));
         break;
       case kMove:
-        new (to) Type(std::move(*static_cast<Type*>(victim)));
+        if (IsInline<Type>::kValue) {
+          Type* value = GetValue<Type>(victim);
+          new (&to->buffer) Type(std::move(*value));
+          value->~Type();
+        } else {
+          to->ptr = victim->ptr;
+          victim->ptr = nullptr;
+        }
         break;
-      case kDestroy:
-        static_cast<Type*>(victim)->~Type();
+      case kDestroy: {
+        Type* value = GetValue<Type>(victim);
+        value->~Type();
+        if (!IsInline<Type>::kValue) {
+          Free<Type>(value);
+        }
         break;
+      }
     }
     return lull::GetTypeId<Type>();
   }
 
-  // Returns a unique value for a given |Type|.
-  template <typename Type>
-  static InternalTypeId GetInternalTypeId() {
-    // This static variable isn't actually used, only its address, so there are
-    // no concurrency issues.
-    static char dummy_var;
-    return reinterpret_cast<InternalTypeId>(&dummy_var);
-  }
-
   // Returns a pointer to the value stored in the |variant| if it is of type
   // |Ret|, otherwise returns nullptr.  This function is used to provide a
   // single implementation for both the const and non-cost versions of the
@@ -279,13 +355,32 @@ class Variant {
   template <typename Ret, typename Self>
   static Ret* GetImpl(Self* variant) {
     using RetType = typename std::decay<Ret>::type;
-    const InternalTypeId type = GetInternalTypeId<RetType>();
-    if (type == variant->type_) {
-      return static_cast<Ret*>(variant->Data());
+    return GetImpl<Ret>(variant, IsStorable<RetType>());
+  }
+
+  template <typename Ret, typename Self>
+  static Ret* GetImpl(Self* variant, std::true_type) {
+    using RetType = typename std::decay<Ret>::type;
+    if (variant->handler_ == &HandlerImpl<RetType>) {
+      return GetValue<RetType>(&variant->storage_);
     }
     return nullptr;
   }
 
+  template <typename Ret, typename Self>
+  static Ret* GetImpl(Self* /*variant*/, std::false_type) {
+    return nullptr;
+  }
+
+  // Determines whether a value of type |U| can be stored in a Variant.
+  // Vectors, maps and optionals are converted to VariantArrays, VariantMaps
+  // and their values respectively, so are never stored directly.
+  template <class U>
+  using IsStorable = std::integral_constant<
+      bool, (!detail::IsVector<U>::kValue ||
+             std::is_same<U, VariantArray>::value) &&
+                !detail::IsMap<U>::kValue && !detail::IsOptional<U>::kValue>;
+
   // Sets the variant to the specified |value|.
   template <typename T, typename U = EnableIfNotVariant<T>,
             typename V = EnableIfNotVector<T>, typename W = EnableIfNotMap<T>,
@@ -296,14 +391,11 @@ class Variant {
 
   template <typename T>
   void SetImpl(T&& value) {
-    static_assert(sizeof(value) <= kStoreSize, "Variant size too small.");
-    static_assert(alignof(T) <= kStoreAlign, "Variant aligment too small.");
     using Type = typename std::decay<T>::type;
 
     Clear();
 
-    new (Data()) Type(std::forward<T>(value));
-    type_ = GetInternalTypeId<Type>();
+    Construct<Type>(&storage_, std::forward<T>(value));
     handler_ = &HandlerImpl<Type>;
   }
 
@@ -347,11 +439,11 @@ class Variant {
   }
 
   // Sets the variant to the specified map |value|, stored as a VariantMap.
-  template <typename T, typename U = EnableIfNotVariant<T>>
+  template <typename T>
   void Set(const std::unordered_map<HashValue, T>& value) {
     SetMap(value);
   }
-  template <typename T, typename U = EnableIfNotVariant<T>>
+  template <typename T>
   void Set(std::unordered_map<HashValue, T>&& value) {
     SetMap(std::move(value));
   }
@@ -367,21 +459,17 @@ class Variant {
   template <typename T>
   void SetMap(T&& value) {
     VariantMap out;
+    out.reserve(value.size());
     for (auto& kv : value) {
       out[kv.first] = std::move(kv.second);
     }
     SetImpl(std::move(out));
   }
 
-  // Returns a pointer to the internal buffer storage.
-  void* Data() { return &buffer_; }
-
-  // Returns a pointer to the internal buffer storage.
-  const void* Data() const { return &buffer_; }
-
-  InternalTypeId type_;  // TypeId of the stored value, or 0 if no value stored.
-  HandlerFn handler_;    // Function that will perform operations variant value.
-  Buffer buffer_;        // Memory buffer to hold variant value.
+  // Function that will perform operations on the variant value, which also
+  // identifies its type.  nullptr if no value is stored.
+  HandlerFn handler_;
+  Storage storage_;  // Memory to hold the variant value, or a pointer to it.
 };
 
 }  // namespace lull
@@ -0,0 +1,87 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_BASE_WORLD_SNAPSHOT_H_
+#define LULLABY_BASE_WORLD_SNAPSHOT_H_
+
+#include <string.h>
+#include <type_traits>
+
+#include "lullaby/base/buffer_serializer.h"
+#include "lullaby/base/component.h"
+#include "lullaby/util/logging.h"
+
+namespace lull {
+
+// Helpers for Systems implementing System::SaveSnapshot and LoadSnapshot.
+//
+// A world snapshot stores the data of every System that supports snapshots in
+// a single binary blob, which can be restored far faster than re-creating the
+// same Entities from their Blueprints.  Snapshots are a raw memory dump, so
+// they are only valid for the same build of the app on the same platform.
+
+// Writes all Components in |pool| to |serializer|.  The Components are copied
+// as raw bytes, so |T| must be trivially copyable (ie. contain no pointers,
+// strings, containers, etc.).
+template <typename T>
+void SaveComponentPool(SaveToBuffer* serializer, const ComponentPool<T>& pool) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Only trivially copyable components can be copied as bytes.");
+  size_t count = pool.Size();
+  serializer->Save(&count, sizeof(count));
+  for (const T& component : pool) {
+    const Entity entity = component.GetEntity();
+    serializer->Save(&entity, sizeof(entity));
+    serializer->Save(&component, sizeof(T));
+  }
+}
+
+// Restores Components written by SaveComponentPool into |pool|.  |T| must be
+// constructible from an Entity.  Returns false if the data is truncated or if
+// the pool already contains a Component for one of the Entities.
+template <typename T>
+bool LoadComponentPool(LoadFromBuffer* serializer, ComponentPool<T>* pool) {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "Only trivially copyable components can be copied as bytes.");
+  size_t count = 0;
+  const uint8_t* data = serializer->Advance(sizeof(count));
+  if (data == nullptr) {
+    return false;
+  }
+  memcpy(&count, data, sizeof(count));
+
+  const size_t kStride = sizeof(Entity) + sizeof(T);
+  if (count > serializer->Remaining() / kStride) {
+    LOG(DFATAL) << "Component pool data is truncated.";
+    return false;
+  }
+  data = serializer->Advance(count * kStride);
+  for (size_t i = 0; i < count; ++i, data += kStride) {
+    Entity entity = kNullEntity;
+    memcpy(&entity, data, sizeof(entity));
+    T* component = pool->Emplace(entity);
+    if (component == nullptr) {
+      LOG(DFATAL) << "Component already exists for entity: " << entity;
+      return false;
+    }
+    memcpy(static_cast<void*>(component), data + sizeof(entity), sizeof(T));
+  }
+  return true;
+}
+
+}  // namespace lull
+
+#endif  // LULLABY_BASE_WORLD_SNAPSHOT_H_
@@ -0,0 +1,223 @@
+// automatically generated by the FlatBuffers compiler, do not modify
+
+
+#ifndef FLATBUFFERS_GENERATED_QUANTIZEDANIMDEF_LULL_H_
+#define FLATBUFFERS_GENERATED_QUANTIZEDANIMDEF_LULL_H_
+
+#include "flatbuffers/flatbuffers.h"
+
+namespace lull {
+
+struct QuantizedSplineDef;
+
+struct QuantizedSplineAnimDef;
+
+/// A single animation curve stored as cubic Hermite keys quantized to 16 bits
+/// each.  See lullaby/util/quantized_spline.h for details of the encoding.
+struct QuantizedSplineDef FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  static FLATBUFFERS_CONSTEXPR const char *GetFullyQualifiedName() {
+    return "lull.QuantizedSplineDef";
+  }
+  enum {
+    VT_MIN_VALUE = 4,
+    VT_MAX_VALUE = 6,
+    VT_END_TIME = 8,
+    VT_TIMES = 10,
+    VT_VALUES = 12,
+    VT_ANGLES = 14
+  };
+  /// The range of values covered by the curve.
+  float min_value() const {
+    return GetField<float>(VT_MIN_VALUE, 0.0f);
+  }
+  float max_value() const {
+    return GetField<float>(VT_MAX_VALUE, 0.0f);
+  }
+  /// The time (in seconds) of the last key.  The first key is always at 0.
+  float end_time() const {
+    return GetField<float>(VT_END_TIME, 0.0f);
+  }
+  /// The time of each key as a fraction of end_time.
+  const flatbuffers::Vector<uint16_t> *times() const {
+    return GetPointer<const flatbuffers::Vector<uint16_t> *>(VT_TIMES);
+  }
+  /// The value of each key as a fraction of [min_value, max_value].
+  const flatbuffers::Vector<uint16_t> *values() const {
+    return GetPointer<const flatbuffers::Vector<uint16_t> *>(VT_VALUES);
+  }
+  /// The slope at each key, stored as an angle after normalizing the curve to
+  /// the unit square.
+  const flatbuffers::Vector<int16_t> *angles() const {
+    return GetPointer<const flatbuffers::Vector<int16_t> *>(VT_ANGLES);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<float>(verifier, VT_MIN_VALUE) &&
+           VerifyField<float>(verifier, VT_MAX_VALUE) &&
+           VerifyField<float>(verifier, VT_END_TIME) &&
+           VerifyOffset(verifier, VT_TIMES) &&
+           verifier.Verify(times()) &&
+           VerifyOffset(verifier, VT_VALUES) &&
+           verifier.Verify(values()) &&
+           VerifyOffset(verifier, VT_ANGLES) &&
+           verifier.Verify(angles()) &&
+           verifier.EndTable();
+  }
+};
+
+struct QuantizedSplineDefBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_min_value(float min_value) {
+    fbb_.AddElement<float>(QuantizedSplineDef::VT_MIN_VALUE, min_value, 0.0f);
+  }
+  void add_max_value(float max_value) {
+    fbb_.AddElement<float>(QuantizedSplineDef::VT_MAX_VALUE, max_value, 0.0f);
+  }
+  void add_end_time(float end_time) {
+    fbb_.AddElement<float>(QuantizedSplineDef::VT_END_TIME, end_time, 0.0f);
+  }
+  void add_times(flatbuffers::Offset<flatbuffers::Vector<uint16_t>> times) {
+    fbb_.AddOffset(QuantizedSplineDef::VT_TIMES, times);
+  }
+  void add_values(flatbuffers::Offset<flatbuffers::Vector<uint16_t>> values) {
+    fbb_.AddOffset(QuantizedSplineDef::VT_VALUES, values);
+  }
+  void add_angles(flatbuffers::Offset<flatbuffers::Vector<int16_t>> angles) {
+    fbb_.AddOffset(QuantizedSplineDef::VT_ANGLES, angles);
+  }
+  QuantizedSplineDefBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  QuantizedSplineDefBuilder &operator=(const QuantizedSplineDefBuilder &);
+  flatbuffers::Offset<QuantizedSplineDef> Finish() {
+    const auto end = fbb_.EndTable(start_, 6);
+    auto o = flatbuffers::Offset<QuantizedSplineDef>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<QuantizedSplineDef> CreateQuantizedSplineDef(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    float min_value = 0.0f,
+    float max_value = 0.0f,
+    float end_time = 0.0f,
+    flatbuffers::Offset<flatbuffers::Vector<uint16_t>> times = 0,
+    flatbuffers::Offset<flatbuffers::Vector<uint16_t>> values = 0,
+    flatbuffers::Offset<flatbuffers::Vector<int16_t>> angles = 0) {
+  QuantizedSplineDefBuilder builder_(_fbb);
+  builder_.add_angles(angles);
+  builder_.add_values(values);
+  builder_.add_times(times);
+  builder_.add_end_time(end_time);
+  builder_.add_max_value(max_value);
+  builder_.add_min_value(min_value);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<QuantizedSplineDef> CreateQuantizedSplineDefDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    float min_value = 0.0f,
+    float max_value = 0.0f,
+    float end_time = 0.0f,
+    const std::vector<uint16_t> *times = nullptr,
+    const std::vector<uint16_t> *values = nullptr,
+    const std::vector<int16_t> *angles = nullptr) {
+  return lull::CreateQuantizedSplineDef(
+      _fbb,
+      min_value,
+      max_value,
+      end_time,
+      times ? _fbb.CreateVector<uint16_t>(*times) : 0,
+      values ? _fbb.CreateVector<uint16_t>(*values) : 0,
+      angles ? _fbb.CreateVector<int16_t>(*angles) : 0);
+}
+
+/// A set of quantized curves, one for each dimension of an animation.  These
+/// files are generated from spline animation files by the quantize_anim tool
+/// and can be used anywhere a spline animation file can.
+struct QuantizedSplineAnimDef FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  static FLATBUFFERS_CONSTEXPR const char *GetFullyQualifiedName() {
+    return "lull.QuantizedSplineAnimDef";
+  }
+  enum {
+    VT_SPLINES = 4
+  };
+  const flatbuffers::Vector<flatbuffers::Offset<QuantizedSplineDef>> *splines() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<QuantizedSplineDef>> *>(VT_SPLINES);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_SPLINES) &&
+           verifier.Verify(splines()) &&
+           verifier.VerifyVectorOfTables(splines()) &&
+           verifier.EndTable();
+  }
+};
+
+struct QuantizedSplineAnimDefBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_splines(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<QuantizedSplineDef>>> splines) {
+    fbb_.AddOffset(QuantizedSplineAnimDef::VT_SPLINES, splines);
+  }
+  QuantizedSplineAnimDefBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  QuantizedSplineAnimDefBuilder &operator=(const QuantizedSplineAnimDefBuilder &);
+  flatbuffers::Offset<QuantizedSplineAnimDef> Finish() {
+    const auto end = fbb_.EndTable(start_, 1);
+    auto o = flatbuffers::Offset<QuantizedSplineAnimDef>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<QuantizedSplineAnimDef> CreateQuantizedSplineAnimDef(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<QuantizedSplineDef>>> splines = 0) {
+  QuantizedSplineAnimDefBuilder builder_(_fbb);
+  builder_.add_splines(splines);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<QuantizedSplineAnimDef> CreateQuantizedSplineAnimDefDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    const std::vector<flatbuffers::Offset<QuantizedSplineDef>> *splines = nullptr) {
+  return lull::CreateQuantizedSplineAnimDef(
+      _fbb,
+      splines ? _fbb.CreateVector<flatbuffers::Offset<QuantizedSplineDef>>(*splines) : 0);
+}
+
+inline const lull::QuantizedSplineAnimDef *GetQuantizedSplineAnimDef(const void *buf) {
+  return flatbuffers::GetRoot<lull::QuantizedSplineAnimDef>(buf);
+}
+
+inline const char *QuantizedSplineAnimDefIdentifier() {
+  return "LQSA";
+}
+
+inline bool QuantizedSplineAnimDefBufferHasIdentifier(const void *buf) {
+  return flatbuffers::BufferHasIdentifier(
+      buf, QuantizedSplineAnimDefIdentifier());
+}
+
+inline bool VerifyQuantizedSplineAnimDefBuffer(
+    flatbuffers::Verifier &verifier) {
+  return verifier.VerifyBuffer<lull::QuantizedSplineAnimDef>(QuantizedSplineAnimDefIdentifier());
+}
+
+inline const char *QuantizedSplineAnimDefExtension() {
+  return "lullanim";
+}
+
+inline void FinishQuantizedSplineAnimDefBuffer(
+    flatbuffers::FlatBufferBuilder &fbb,
+    flatbuffers::Offset<lull::QuantizedSplineAnimDef> root) {
+  fbb.Finish(root, QuantizedSplineAnimDefIdentifier());
+}
+
+}  // namespace lull
+
+#endif  // FLATBUFFERS_GENERATED_QUANTIZEDANIMDEF_LULL_H_
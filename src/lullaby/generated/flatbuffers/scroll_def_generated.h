@@ -18,6 +18,8 @@ struct ScrollSnapToGrandchildrenDef;
 
 struct ScrollContentLayoutDef;
 
+struct ScrollVirtualLayoutDef;
+
 /// Adds a scroll view to the entity.  Scroll views are controlled by touchpad
 /// input to change the position of children.
 struct ScrollDef FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -299,6 +301,105 @@ inline flatbuffers::Offset<ScrollContentLayoutDef> CreateScrollContentLayoutDef(
   return builder_.Finish();
 }
 
+/// If added to an Entity with a scroll view (see ScrollDef above), this will
+/// lay out a list of items along a single axis, only creating entities for the
+/// items that are visible in the scroll view.  The items themselves are
+/// supplied at runtime by a data source (see ScrollVirtualLayoutSystem).
+struct ScrollVirtualLayoutDef FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  static FLATBUFFERS_CONSTEXPR const char *GetFullyQualifiedName() {
+    return "lull.ScrollVirtualLayoutDef";
+  }
+  enum {
+    VT_CELL_BLUEPRINT = 4,
+    VT_HORIZONTAL = 6,
+    VT_SPACING = 8,
+    VT_MARGIN = 10
+  };
+  /// The blueprint used to create each visible cell.  Cells are reused for
+  /// other items as they scroll out of view.
+  const flatbuffers::String *cell_blueprint() const {
+    return GetPointer<const flatbuffers::String *>(VT_CELL_BLUEPRINT);
+  }
+  /// If true, items are laid out left to right.  Otherwise they are laid out
+  /// top to bottom.
+  bool horizontal() const {
+    return GetField<uint8_t>(VT_HORIZONTAL, 0) != 0;
+  }
+  /// The space between consecutive items.
+  float spacing() const {
+    return GetField<float>(VT_SPACING, 0.0f);
+  }
+  /// The distance beyond the scroll view's Aabb within which items are also
+  /// instantiated, so that cells are ready before they scroll into view.
+  float margin() const {
+    return GetField<float>(VT_MARGIN, 0.0f);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_CELL_BLUEPRINT) &&
+           verifier.Verify(cell_blueprint()) &&
+           VerifyField<uint8_t>(verifier, VT_HORIZONTAL) &&
+           VerifyField<float>(verifier, VT_SPACING) &&
+           VerifyField<float>(verifier, VT_MARGIN) &&
+           verifier.EndTable();
+  }
+};
+
+struct ScrollVirtualLayoutDefBuilder {
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_cell_blueprint(flatbuffers::Offset<flatbuffers::String> cell_blueprint) {
+    fbb_.AddOffset(ScrollVirtualLayoutDef::VT_CELL_BLUEPRINT, cell_blueprint);
+  }
+  void add_horizontal(bool horizontal) {
+    fbb_.AddElement<uint8_t>(ScrollVirtualLayoutDef::VT_HORIZONTAL, static_cast<uint8_t>(horizontal), 0);
+  }
+  void add_spacing(float spacing) {
+    fbb_.AddElement<float>(ScrollVirtualLayoutDef::VT_SPACING, spacing, 0.0f);
+  }
+  void add_margin(float margin) {
+    fbb_.AddElement<float>(ScrollVirtualLayoutDef::VT_MARGIN, margin, 0.0f);
+  }
+  ScrollVirtualLayoutDefBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ScrollVirtualLayoutDefBuilder &operator=(const ScrollVirtualLayoutDefBuilder &);
+  flatbuffers::Offset<ScrollVirtualLayoutDef> Finish() {
+    const auto end = fbb_.EndTable(start_, 4);
+    auto o = flatbuffers::Offset<ScrollVirtualLayoutDef>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<ScrollVirtualLayoutDef> CreateScrollVirtualLayoutDef(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<flatbuffers::String> cell_blueprint = 0,
+    bool horizontal = false,
+    float spacing = 0.0f,
+    float margin = 0.0f) {
+  ScrollVirtualLayoutDefBuilder builder_(_fbb);
+  builder_.add_margin(margin);
+  builder_.add_spacing(spacing);
+  builder_.add_cell_blueprint(cell_blueprint);
+  builder_.add_horizontal(horizontal);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<ScrollVirtualLayoutDef> CreateScrollVirtualLayoutDefDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    const char *cell_blueprint = nullptr,
+    bool horizontal = false,
+    float spacing = 0.0f,
+    float margin = 0.0f) {
+  return lull::CreateScrollVirtualLayoutDef(
+      _fbb,
+      cell_blueprint ? _fbb.CreateString(cell_blueprint) : 0,
+      horizontal,
+      spacing,
+      margin);
+}
+
 inline const lull::ScrollDef *GetScrollDef(const void *buf) {
   return flatbuffers::GetRoot<lull::ScrollDef>(buf);
 }
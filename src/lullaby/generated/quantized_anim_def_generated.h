@@ -0,0 +1,62 @@
+// Autogenerated code.  Do not edit.
+#ifndef _SRC_LULLABY_GENERATED_QUANTIZED_ANIM_DEF_GENERATED_H_
+#define _SRC_LULLABY_GENERATED_QUANTIZED_ANIM_DEF_GENERATED_H_
+
+#include <type_traits>
+#include <memory>
+#include "flatbuffers/quantized_anim_def_generated.h"
+#include "lullaby/base/common_types.h"
+#include "lullaby/base/typeid.h"
+#include "lullaby/util/color.h"
+#include "lullaby/util/math.h"
+#include "lullaby/util/optional.h"
+
+namespace lull {
+class QuantizedSplineDefT;
+class QuantizedSplineAnimDefT;
+class QuantizedSplineDefT {
+ public:
+  using FlatBufferType = QuantizedSplineDef;
+
+  float min_value = 0.0f;
+  float max_value = 0.0f;
+  float end_time = 0.0f;
+  std::vector<uint16_t> times;
+  std::vector<uint16_t> values;
+  std::vector<int16_t> angles;
+
+  template <typename Archive>
+  void SerializeFlatbuffer(Archive archive);
+};
+
+class QuantizedSplineAnimDefT {
+ public:
+  using FlatBufferType = QuantizedSplineAnimDef;
+
+  std::vector<lull::QuantizedSplineDefT> splines;
+
+  template <typename Archive>
+  void SerializeFlatbuffer(Archive archive);
+};
+
+template <typename Archive>
+void QuantizedSplineDefT::SerializeFlatbuffer(Archive archive) {
+  archive.VectorOfScalars(&times, 10);
+  archive.VectorOfScalars(&values, 12);
+  archive.VectorOfScalars(&angles, 14);
+  archive.Scalar(&min_value, 4, 0.0f);
+  archive.Scalar(&max_value, 6, 0.0f);
+  archive.Scalar(&end_time, 8, 0.0f);
+}
+
+template <typename Archive>
+void QuantizedSplineAnimDefT::SerializeFlatbuffer(Archive archive) {
+  archive.VectorOfTables(&splines, 4);
+}
+
+}  // namespace lull
+
+LULLABY_SETUP_TYPEID(lull::QuantizedSplineDefT);
+LULLABY_SETUP_TYPEID(lull::QuantizedSplineAnimDefT);
+
+#endif  // _SRC_LULLABY_GENERATED_QUANTIZED_ANIM_DEF_GENERATED_H_
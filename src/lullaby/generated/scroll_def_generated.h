@@ -17,6 +17,7 @@ class ScrollDefT;
 class ScrollSnapToGridDefT;
 class ScrollSnapToGrandchildrenDefT;
 class ScrollContentLayoutDefT;
+class ScrollVirtualLayoutDefT;
 class ScrollDefT {
  public:
   using FlatBufferType = ScrollDef;
@@ -65,6 +66,19 @@ class ScrollContentLayoutDefT {
   void SerializeFlatbuffer(Archive archive);
 };
 
+class ScrollVirtualLayoutDefT {
+ public:
+  using FlatBufferType = ScrollVirtualLayoutDef;
+
+  std::string cell_blueprint;
+  bool horizontal = 0;
+  float spacing = 0.0f;
+  float margin = 0.0f;
+
+  template <typename Archive>
+  void SerializeFlatbuffer(Archive archive);
+};
+
 template <typename Archive>
 void ScrollDefT::SerializeFlatbuffer(Archive archive) {
   archive.NativeStruct(&content_bounds, 4);
@@ -93,12 +107,21 @@ void ScrollContentLayoutDefT::SerializeFlatbuffer(Archive archive) {
   archive.Scalar(&bottom_padding, 10, 0.0f);
 }
 
+template <typename Archive>
+void ScrollVirtualLayoutDefT::SerializeFlatbuffer(Archive archive) {
+  archive.String(&cell_blueprint, 4);
+  archive.Scalar(&horizontal, 6, 0);
+  archive.Scalar(&spacing, 8, 0.0f);
+  archive.Scalar(&margin, 10, 0.0f);
+}
+
 }  // namespace lull
 
 LULLABY_SETUP_TYPEID(lull::ScrollDefT);
 LULLABY_SETUP_TYPEID(lull::ScrollSnapToGridDefT);
 LULLABY_SETUP_TYPEID(lull::ScrollSnapToGrandchildrenDefT);
 LULLABY_SETUP_TYPEID(lull::ScrollContentLayoutDefT);
+LULLABY_SETUP_TYPEID(lull::ScrollVirtualLayoutDefT);
 
 #endif  // _SRC_LULLABY_GENERATED_SCROLL_DEF_GENERATED_H_
 
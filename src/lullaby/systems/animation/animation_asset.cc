@@ -20,6 +20,7 @@ limitations under the License.
 #include "motive/io/flatbuffers.h"
 #include "lullaby/systems/animation/animation_system.h"
 #include "lullaby/util/logging.h"
+#include "lullaby/util/quantized_spline.h"
 
 namespace lull {
 namespace {
@@ -30,7 +31,12 @@ const int kAnimListIndex = 0;
 }  // namespace
 
 AnimationAsset::AnimationAsset()
-    : Asset(), rig_anim_(nullptr), anim_table_(nullptr), num_splines_(0) {}
+    : Asset(),
+      rig_anim_(nullptr),
+      anim_table_(nullptr),
+      num_splines_(0),
+      is_quantized_(false),
+      quantized_anim_(nullptr) {}
 
 void AnimationAsset::SetFilename(const std::string& filename) {
   filename_ = filename;
@@ -38,6 +44,8 @@ void AnimationAsset::SetFilename(const std::string& filename) {
     rig_anim_.reset(new motive::RigAnim());
   } else if (filename.find(".motivelist") != std::string::npos) {
     anim_table_.reset(new motive::AnimTable);
+  } else if (filename.find(".lullanim") != std::string::npos) {
+    is_quantized_ = true;
   }
 }
 
@@ -54,6 +62,18 @@ void AnimationAsset::OnFinalize(std::string* data) {
         LOG(ERROR) << "Failed to load anim table";
       }
     }
+  } else if (is_quantized_) {
+    if (!QuantizedSplineAnimDefBufferHasIdentifier(data->data())) {
+      LOG(DFATAL) << "Invalid quantized animation " << filename_;
+      return;
+    }
+    // The quantized data is decoded lazily, so keep it without copying.
+    quantized_data_ = std::move(*data);
+    quantized_anim_ = GetQuantizedSplineAnimDef(quantized_data_.data());
+    num_splines_ = quantized_anim_->splines()
+                       ? static_cast<int>(quantized_anim_->splines()->size())
+                       : 0;
+    decoded_splines_.resize(num_splines_);
   } else {
     const motive::CompactSplineAnimFloatFb* src =
         motive::GetCompactSplineAnimFloatFb(data->data());
@@ -139,7 +159,57 @@ motive::CompactSpline* AnimationAsset::CreateCompactSpline(
   return spline;
 }
 
+const motive::CompactSpline* AnimationAsset::GetQuantizedSpline(
+    int idx) const {
+  if (idx < 0 || idx >= num_splines_) {
+    return nullptr;
+  }
+  std::vector<uint8_t>& buffer = decoded_splines_[idx];
+  if (!buffer.empty()) {
+    return reinterpret_cast<const motive::CompactSpline*>(buffer.data());
+  }
+
+  const QuantizedSplineDef* src = quantized_anim_->splines()->Get(idx);
+  if (!src->times() || !src->values() || !src->angles()) {
+    return nullptr;
+  }
+  const unsigned int num_nodes = src->times()->size();
+  if (num_nodes == 0 || src->values()->size() != num_nodes ||
+      src->angles()->size() != num_nodes) {
+    LOG(DFATAL) << "Invalid quantized spline " << idx << " in " << filename_;
+    return nullptr;
+  }
+
+  const motive::Range range(src->min_value(), src->max_value());
+  const float motive_total_time = static_cast<float>(
+      AnimationSystem::GetMotiveTimeFromSeconds(src->end_time()));
+
+  // As with CreateCompactSpline, allow for spline smoothing.
+  const unsigned int max_nodes = num_nodes * 2;
+  buffer.resize(motive::CompactSpline::Size(static_cast<uint16_t>(max_nodes)));
+  motive::CompactSpline* spline = motive::CompactSpline::CreateInPlace(
+      static_cast<uint16_t>(max_nodes), buffer.data());
+  spline->Init(range,
+               motive::CompactSpline::RecommendXGranularity(motive_total_time));
+
+  for (unsigned int i = 0; i < num_nodes; ++i) {
+    const SplineNode node = DequantizeSplineNode(
+        src->min_value(), src->max_value(), src->end_time(),
+        src->times()->Get(i), src->values()->Get(i), src->angles()->Get(i));
+    const float x = static_cast<float>(
+        AnimationSystem::GetMotiveTimeFromSeconds(node.time));
+    const float derivative =
+        AnimationSystem::GetMotiveDerivativeFromSeconds(node.derivative);
+    spline->AddNode(x, node.value, derivative);
+  }
+  spline->Finalize();
+  return spline;
+}
+
 const motive::CompactSpline* AnimationAsset::GetCompactSpline(int idx) const {
+  if (quantized_anim_) {
+    return GetQuantizedSpline(idx);
+  }
   if (spline_buffer_.empty()) {
     return nullptr;
   }
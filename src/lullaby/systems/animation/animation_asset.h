@@ -23,6 +23,7 @@ limitations under the License.
 #include "motive/math/compact_spline.h"
 #include "motive/spline_anim_generated.h"
 #include "lullaby/base/asset.h"
+#include "lullaby/generated/quantized_anim_def_generated.h"
 
 namespace lull {
 
@@ -30,17 +31,20 @@ namespace lull {
 //
 // The raw data is converted into runtime motive::CompactSplines,
 // motive::RigAnim, or motive::AnimTable for use by the AnimationSystem.
+// Quantized (.lullanim) spline data is instead kept in its compact form and
+// each spline is only decoded the first time it is requested.
 class AnimationAsset : public Asset {
  public:
   explicit AnimationAsset();
 
   // Uses the filename to determine if the asset is a RigAnim, AnimTable, or
   // CompactSplines.  Specifically, .motiveanim and .motivelist files are
-  // assumed to be RigAnims and AnimTables, respectively.
+  // assumed to be RigAnims and AnimTables, respectively, and .lullanim files
+  // are assumed to be quantized CompactSplines.
   void SetFilename(const std::string& filename) override;
 
   // Converts and stores |data| as either a RigAnim or a vector of
-  // CompactSplines.
+  // CompactSplines.  Quantized data is moved into the asset as-is.
   void OnFinalize(std::string* data) override;
 
   // Returns the number of CompactSplines in the data.
@@ -79,10 +83,18 @@ class AnimationAsset : public Asset {
   motive::CompactSpline* CreateCompactSpline(
       const motive::CompactSplineFloatFb* src, uint8_t* buffer);
 
+  // Returns the Nth quantized spline, decoding it if needed.
+  const motive::CompactSpline* GetQuantizedSpline(int idx) const;
+
   std::unique_ptr<motive::RigAnim> rig_anim_;  // Rig animation data.
   std::unique_ptr<motive::AnimTable> anim_table_;  // Anim table data.
   std::vector<uint8_t> spline_buffer_;         // Buffer containing spline data.
   int num_splines_;  // Number of compact splines in the buffer.
+  bool is_quantized_;  // Whether the data is a QuantizedSplineAnimDef.
+  std::string quantized_data_;  // Raw QuantizedSplineAnimDef data.
+  const QuantizedSplineAnimDef* quantized_anim_;
+  // Buffers containing each quantized spline once it has been decoded.
+  mutable std::vector<std::vector<uint8_t>> decoded_splines_;
   std::string filename_;
 };
 
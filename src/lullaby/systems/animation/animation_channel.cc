@@ -74,39 +74,82 @@ bool AnimationChannel::Get(Entity entity, float* values, size_t len) const {
 }
 
 void AnimationChannel::Update(std::vector<AnimationId>* completed) {
-  // Track which animations need to be cancelled since we do not want to remove
-  // them during iteration.
-  std::vector<Entity> anims_to_cancel;
+  Evaluate();
+  Apply(completed);
+}
+
+void AnimationChannel::Evaluate() {
+  batch_entities_.clear();
+  batch_values_.clear();
+  rig_entities_.clear();
+  completed_entities_.clear();
+  completed_ids_.clear();
 
   anims_.ForEach([&](Animation& anim) {
     const Entity entity = anim.GetEntity();
 
     if (anim.rig_motivator.Valid()) {
-      // Update the Component data to match the motivator's transforms.
-      const int num_bones = anim.rig_motivator.DefiningAnim()->NumBones();
-      SetRig(entity, anim.rig_motivator.GlobalTransforms(), num_bones);
+      // The rig transforms are owned by the motivator, so only the Entity is
+      // recorded here and the transforms are fetched again in Apply.
+      rig_entities_.push_back(entity);
     } else if (anim.motivator.Valid()) {
-      // Update the Component data to match the motivator's current values.
-      float values[kMaxDimensions];
+      // Gather the motivator's current values to update the Component data.
       const float* anim_values = anim.motivator.Values();
+      batch_entities_.push_back(entity);
       for (int i = 0; i < dimensions_; ++i) {
-        values[i] = anim.base_offset[i] + (anim_values[i] * anim.multiplier[i]);
+        batch_values_.push_back(anim.base_offset[i] +
+                                (anim_values[i] * anim.multiplier[i]));
       }
-      Set(entity, values, dimensions_);
     } else {
       LOG(ERROR) << "Invalid motivator detected during playback!";
       anim.total_time = 0;
     }
 
+    // Track which animations need to be cancelled since we do not want to
+    // remove them during iteration.
     if (IsComplete(anim)) {
-      anims_to_cancel.push_back(anim.GetEntity());
-      completed->push_back(anim.id);
+      completed_entities_.push_back(entity);
+      completed_ids_.push_back(anim.id);
     }
   });
+}
+
+void AnimationChannel::Apply(std::vector<AnimationId>* completed) {
+  for (const Entity entity : rig_entities_) {
+    // The Animation may have been cancelled or replaced since Evaluate, and
+    // SetRig may modify |anims_|, so look it up again for each Entity.
+    const Animation* anim = anims_.Get(entity);
+    if (anim == nullptr || !anim->rig_motivator.Valid()) {
+      continue;
+    }
+    const int num_bones = anim->rig_motivator.DefiningAnim()->NumBones();
+    SetRig(entity, anim->rig_motivator.GlobalTransforms(),
+           static_cast<size_t>(num_bones));
+  }
+  rig_entities_.clear();
 
-  for (const Entity e : anims_to_cancel) {
+  if (!batch_entities_.empty()) {
+    SetBatch(batch_entities_.data(), batch_values_.data(),
+             batch_entities_.size());
+    batch_entities_.clear();
+    batch_values_.clear();
+  }
+
+  for (const Entity e : completed_entities_) {
     Cancel(e);
   }
+  completed->insert(completed->end(), completed_ids_.begin(),
+                    completed_ids_.end());
+  completed_entities_.clear();
+  completed_ids_.clear();
+}
+
+void AnimationChannel::SetBatch(const Entity* entities, const float* values,
+                                size_t count) {
+  const size_t stride = static_cast<size_t>(dimensions_);
+  for (size_t i = 0; i < count; ++i) {
+    Set(entities[i], values + i * stride, stride);
+  }
 }
 
 AnimationId AnimationChannel::Cancel(Entity entity) {
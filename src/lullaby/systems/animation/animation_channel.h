@@ -18,6 +18,8 @@ limitations under the License.
 #define LULLABY_SYSTEMS_ANIMATION_ANIMATION_CHANNEL_H_
 
 #include <memory>
+#include <vector>
+
 #include "motive/init.h"
 #include "motive/motivator.h"
 #include "motive/util.h"
@@ -33,10 +35,11 @@ namespace lull {
 // Responsible for mapping data between Components and a motive::Motivator.
 //
 // Each AnimationChannel stores a set of Animation objects which associate
-// Motivators with Entities.  Each frame, the current Motivator values are
-// passed to the AnimationChannel's virtual |Set| function which is overridden
-// such that the data is passed to the correct Component for the associated
-// Entity.
+// Motivators with Entities.  Each frame, the current Motivator values of all
+// the channel's animations are gathered into a single batch and passed to the
+// AnimationChannel's virtual |SetBatch| function, which by default passes each
+// Entity's values to the virtual |Set| function.  These are overridden such
+// that the data is passed to the correct Component for the associated Entity.
 class AnimationChannel {
  public:
   static const size_t kMaxDimensions = 4;
@@ -48,10 +51,25 @@ class AnimationChannel {
   // example a 3D position animation has 3 dimensions: x, y, and z.)
   size_t GetDimensions() const { return dimensions_; }
 
+  // Returns the number of Animations currently playing on this channel.
+  size_t GetNumAnimations() const { return anims_.Size(); }
+
   // Copies all the data from the Motivator into the Component.  Updates the
   // |completed| vector with information about Animations that have completed.
+  // Equivalent to calling Evaluate followed by Apply.
   void Update(std::vector<AnimationId>* completed);
 
+  // Gathers the current values of all the channel's Motivators and determines
+  // which Animations have completed, without modifying any Components.  Only
+  // touches state owned by this channel, so different channels can be
+  // evaluated concurrently once the MotiveEngine has been advanced.
+  void Evaluate();
+
+  // Passes the values gathered by the last call to Evaluate to the Components
+  // and cancels completed Animations, appending their ids to |completed|.  Must
+  // be called on the main thread.
+  void Apply(std::vector<AnimationId>* completed);
+
   // Plays a new animation (with the given |id|) on the |entity|.  The animation
   // sets the motivator to animate towards the specified |target_value| array
   // (of size |length|) over the given |time| duration.  Returns the AnimationId
@@ -134,6 +152,12 @@ class AnimationChannel {
   // the Entity.
   virtual void Set(Entity entity, const float* values, size_t len) = 0;
 
+  // Sets Component data for |count| entities at once.  |values| contains
+  // GetDimensions() floats for each entity, in the same order as |entities|.
+  // The default implementation calls Set for each entity.
+  virtual void SetBatch(const Entity* entities, const float* values,
+                        size_t count);
+
   // Sets the rig data associated with the Entity.  Valid only for rig channels.
   virtual void SetRig(Entity entity, const mathfu::AffineTransform* values,
                       size_t len);
@@ -141,6 +165,15 @@ class AnimationChannel {
   Registry* registry_;
   ComponentPool<Animation> anims_;
   int dimensions_;
+
+ private:
+  // Buffers filled by Evaluate and consumed by Apply, kept to reuse their
+  // memory.
+  std::vector<Entity> batch_entities_;
+  std::vector<float> batch_values_;
+  std::vector<Entity> rig_entities_;
+  std::vector<Entity> completed_entities_;
+  std::vector<AnimationId> completed_ids_;
 };
 
 using AnimationChannelPtr = std::unique_ptr<AnimationChannel>;
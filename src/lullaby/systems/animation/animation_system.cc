@@ -20,6 +20,7 @@ limitations under the License.
 #include "motive/spline_anim_generated.h"
 #include "lullaby/base/asset_loader.h"
 #include "lullaby/base/dispatcher.h"
+#include "lullaby/base/job_processor.h"
 #include "lullaby/events/animation_events.h"
 #include "lullaby/systems/dispatcher/event.h"
 #include "lullaby/util/logging.h"
@@ -32,6 +33,11 @@ namespace {
 const HashValue kAnimationDef = Hash("AnimationDef");
 const HashValue kAnimationResponseDef = Hash("AnimationResponseDef");
 constexpr const char* kMotiveListExtension = "motivelist";
+// Channels are only evaluated in parallel once there are enough animations
+// playing to outweigh the cost of queueing the jobs.
+constexpr size_t kMinAnimationsForParallelEvaluation = 256;
+constexpr size_t kMinChannelsPerJob = 1;
+constexpr size_t kMaxEvaluationJobs = 4;
 
 inline bool IsMotiveListFile(const std::string& filename, size_t start_pos,
                              size_t end_pos) {
@@ -118,9 +124,34 @@ void AnimationSystem::AdvanceFrame(Clock::duration delta_time) {
   const motive::MotiveTime timestep = GetMotiveTime(delta_time);
   engine_.AdvanceFrame(timestep);
 
-  std::vector<AnimationId> completed;
+  // Channels only read from the motivators and write to their own buffers
+  // while evaluating, so they can be evaluated in parallel.  The results are
+  // then applied to the Components on this thread in a fixed order.
+  // Idle channels have nothing to evaluate or apply, so they are skipped.
+  evaluating_channels_.clear();
+  size_t num_animations = 0;
   for (auto& channel : channels_) {
-    channel.second->Update(&completed);
+    const size_t channel_animations = channel.second->GetNumAnimations();
+    if (channel_animations > 0) {
+      evaluating_channels_.push_back(channel.second.get());
+      num_animations += channel_animations;
+    }
+  }
+  JobProcessor* processor =
+      num_animations >= kMinAnimationsForParallelEvaluation
+          ? registry_->Get<JobProcessor>()
+          : nullptr;
+  RunJobsForRange(processor, evaluating_channels_.size(), kMinChannelsPerJob,
+                  kMaxEvaluationJobs,
+                  [this](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                      evaluating_channels_[i]->Evaluate();
+                    }
+                  });
+
+  std::vector<AnimationId> completed;
+  for (AnimationChannel* channel : evaluating_channels_) {
+    channel->Apply(&completed);
   }
 
   for (const AnimationId id : completed) {
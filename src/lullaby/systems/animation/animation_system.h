@@ -20,6 +20,7 @@ limitations under the License.
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "motive/common.h"
 #include "motive/engine.h"
@@ -56,9 +57,11 @@ namespace lull {
 // process and evaluate animation curves.  Animation data is stored in
 // flatbuffers as either .motiveanim files (which are converted from FBX files
 // using motive's anim_pipeline) or .splienanim files (which are converted from
-// JSON files using flatbuffers flatc compiler.)  Alternatively, animations
-// can be driven towards arbitrary target values.  This is done by generating
-// the appropriate curves at runtime.
+// JSON files using flatbuffers flatc compiler.)  Spline animations can also be
+// stored as .lullanim files, which use 16-bit quantized keys and are generated
+// using the quantize_anim tool.  Alternatively, animations can be driven
+// towards arbitrary target values.  This is done by generating the appropriate
+// curves at runtime.
 class AnimationSystem : public System {
  public:
   explicit AnimationSystem(Registry* registry);
@@ -163,6 +166,8 @@ class AnimationSystem : public System {
   motive::MotiveEngine engine_;
   ResourceManager<AnimationAsset> assets_;
   std::unordered_map<HashValue, AnimationChannelPtr> channels_;
+  // Channels being evaluated during AdvanceFrame, kept to reuse its memory.
+  std::vector<AnimationChannel*> evaluating_channels_;
   std::unordered_map<AnimationId, AnimationSetEntry> external_id_to_entry_;
   std::unordered_map<AnimationId, AnimationId> internal_to_external_ids_;
 
@@ -16,6 +16,9 @@ limitations under the License.
 
 #include "lullaby/systems/collision/collision_system.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "lullaby/generated/collision_def_generated.h"
 #include "lullaby/events/entity_events.h"
 #include "lullaby/systems/dispatcher/event.h"
@@ -91,6 +94,86 @@ CollisionSystem::CollisionResult CollisionSystem::CheckForCollision(
   return result;
 }
 
+CollisionSystem::CollisionResult CollisionSystem::CheckForCollision(
+    const Ray& ray, const std::vector<Entity>& candidates) {
+  CollisionResult result = {kNullEntity, kNoHitDistance};
+
+  for (const Entity entity : candidates) {
+    if (!transform_system_->IsEnabled(entity) ||
+        !transform_system_->HasFlag(entity, collision_flag_)) {
+      continue;
+    }
+    const mathfu::mat4* world_from_entity_mat =
+        transform_system_->GetWorldFromEntityMatrix(entity);
+    const Aabb* box = transform_system_->GetAabb(entity);
+    if (!world_from_entity_mat || !box) {
+      continue;
+    }
+
+    const bool check_exit = transform_system_->HasFlag(entity, on_exit_flag_);
+    const float distance =
+        CheckRayOBBCollision(ray, *world_from_entity_mat, *box, check_exit);
+
+    if (distance != kNoHitDistance &&
+        (result.entity == kNullEntity || distance < result.distance)) {
+      result.entity = entity;
+      result.distance = distance;
+    }
+  }
+  return result;
+}
+
+std::vector<Entity> CollisionSystem::GetCollisionCandidates(
+    const Ray& ray, float max_angle, float max_distance) {
+  std::vector<Entity> candidates;
+  const float direction_length = ray.direction.Length();
+  if (direction_length <= kDefaultEpsilon) {
+    return candidates;
+  }
+
+  transform_system_->ForAll([&](Entity entity,
+                                const mathfu::mat4& world_from_entity_mat,
+                                const Aabb& box, Bits flags) {
+    if (!CheckBit(flags, collision_flag_)) {
+      return;
+    }
+
+    // Bound the entity by a sphere in world space, grown by |max_distance| to
+    // account for rays starting away from |ray|'s origin.
+    const mathfu::vec3 center =
+        world_from_entity_mat * (0.5f * (box.min + box.max));
+    const float scale =
+        std::max(world_from_entity_mat.GetColumn(0).xyz().Length(),
+                 std::max(world_from_entity_mat.GetColumn(1).xyz().Length(),
+                          world_from_entity_mat.GetColumn(2).xyz().Length()));
+    const float radius =
+        0.5f * (box.max - box.min).Length() * scale + max_distance;
+
+    const mathfu::vec3 to_center = center - ray.origin;
+    const float distance = to_center.Length();
+    if (distance <= radius) {
+      candidates.push_back(entity);
+      return;
+    }
+
+    // The sphere can be hit if the angle to its center is within |max_angle|
+    // plus the angle that the sphere subtends.
+    const float cos_angle = mathfu::Clamp(
+        mathfu::dot(to_center, ray.direction) / (distance * direction_length),
+        -1.f, 1.f);
+    const float angle = std::acos(cos_angle);
+    const float angular_radius = std::asin(radius / distance);
+    if (angle <= max_angle + angular_radius) {
+      candidates.push_back(entity);
+    }
+  });
+  return candidates;
+}
+
+uint32_t CollisionSystem::GetChangeCount() const {
+  return transform_system_->GetChangeCount(collision_flag_);
+}
+
 std::vector<Entity> CollisionSystem::CheckForPointCollisions(
     const mathfu::vec3& point) {
   std::vector<Entity> collisions;
@@ -48,6 +48,21 @@ class CollisionSystem : public System {
   // and the distance to the hit point from the ray's origin.
   CollisionResult CheckForCollision(const Ray& ray);
 
+  // Like CheckForCollision, but only tests the Entities in |candidates|.
+  CollisionResult CheckForCollision(const Ray& ray,
+                                    const std::vector<Entity>& candidates);
+
+  // Returns the collidable Entities that could be hit by a ray starting within
+  // |max_distance| of |ray|'s origin and pointing within |max_angle| radians of
+  // its direction.  The test is conservative, so the result may include
+  // Entities that no such ray actually hits.
+  std::vector<Entity> GetCollisionCandidates(const Ray& ray, float max_angle,
+                                             float max_distance);
+
+  // Returns a counter that changes whenever a collidable Entity is changed in
+  // a way that may affect the results of collision tests.
+  uint32_t GetChangeCount() const;
+
   // Returns a vector of entities that a point lies within
   std::vector<Entity> CheckForPointCollisions(const mathfu::vec3& point);
 
@@ -0,0 +1,105 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/systems/collision/raycast_cache.h"
+
+#include <cmath>
+
+#include "lullaby/util/trace.h"
+
+namespace lull {
+namespace {
+
+// Returns true if |a| starts within |max_distance| of |b| and points within
+// |max_angle| radians of it.
+bool IsRayNear(const Ray& a, const Ray& b, float max_angle,
+               float max_distance) {
+  if ((a.origin - b.origin).LengthSquared() > max_distance * max_distance) {
+    return false;
+  }
+  const float lengths = a.direction.Length() * b.direction.Length();
+  if (lengths <= kDefaultEpsilon) {
+    return false;
+  }
+  return mathfu::dot(a.direction, b.direction) >=
+         std::cos(max_angle) * lengths;
+}
+
+}  // namespace
+
+const float RaycastCache::kReuseAngle = 0.001f;
+const float RaycastCache::kReuseDistance = 0.001f;
+const float RaycastCache::kNarrowAngle = 5.f * kDegreesToRadians;
+const float RaycastCache::kNarrowDistance = 0.05f;
+
+RaycastCache::RaycastCache()
+    : has_result_(false),
+      has_candidates_(false),
+      change_count_(0),
+      result_ray_(mathfu::kZeros3f, -mathfu::kAxisZ3f),
+      result_({kNullEntity, kNoHitDistance}),
+      candidate_ray_(mathfu::kZeros3f, -mathfu::kAxisZ3f) {}
+
+CollisionSystem::CollisionResult RaycastCache::Raycast(
+    CollisionSystem* collision_system, const Ray& ray) {
+  LULLABY_CPU_TRACE_CALL();
+  ++stats_.num_raycasts;
+
+  const uint32_t change_count = collision_system->GetChangeCount();
+  if (change_count != change_count_) {
+    Clear();
+    change_count_ = change_count;
+  }
+
+  if (has_result_ &&
+      IsRayNear(ray, result_ray_, kReuseAngle, kReuseDistance)) {
+    ++stats_.num_reused;
+    return result_;
+  }
+
+  if (has_candidates_ &&
+      IsRayNear(ray, candidate_ray_, kNarrowAngle, kNarrowDistance)) {
+    ++stats_.num_narrowed;
+    result_ = collision_system->CheckForCollision(ray, candidates_);
+  } else {
+    result_ = collision_system->CheckForCollision(ray);
+    candidate_ray_ = ray;
+    candidates_ = collision_system->GetCollisionCandidates(ray, kNarrowAngle,
+                                                           kNarrowDistance);
+    has_candidates_ = true;
+  }
+  result_ray_ = ray;
+  has_result_ = true;
+  return result_;
+}
+
+void RaycastCache::Clear() {
+  has_result_ = false;
+  has_candidates_ = false;
+  candidates_.clear();
+}
+
+float RaycastCache::GetHitRate() const {
+  if (stats_.num_raycasts == 0) {
+    return 0.f;
+  }
+  return static_cast<float>(stats_.num_reused + stats_.num_narrowed) /
+         static_cast<float>(stats_.num_raycasts);
+}
+
+void RaycastCache::ResetStats() { stats_ = Stats(); }
+
+}  // namespace lull
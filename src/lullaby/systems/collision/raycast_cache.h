@@ -0,0 +1,93 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_SYSTEMS_COLLISION_RAYCAST_CACHE_H_
+#define LULLABY_SYSTEMS_COLLISION_RAYCAST_CACHE_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "lullaby/systems/collision/collision_system.h"
+#include "lullaby/util/math.h"
+
+namespace lull {
+
+// Caches the results of raycasts against the CollisionSystem across frames.
+// Rays from a pointing device usually move very little between frames, and
+// the scene is often static, so:
+// - If neither the ray nor any collidable Entity has changed noticeably since
+//   the last full or narrowed raycast, its result is reused.
+// - Otherwise, if the ray is still close to the ray used for the last full
+//   raycast, only the Entities near that ray (which includes the previous
+//   target) are tested.
+// - Otherwise, all collidable Entities are tested.
+class RaycastCache {
+ public:
+  struct Stats {
+    // The total number of raycasts.
+    uint64_t num_raycasts = 0;
+    // The number of raycasts that reused the previous result.
+    uint64_t num_reused = 0;
+    // The number of raycasts that only tested the Entities near the ray.
+    uint64_t num_narrowed = 0;
+  };
+
+  // The maximum change in ray direction (in radians) and origin for which the
+  // previous result is reused.
+  static const float kReuseAngle;
+  static const float kReuseDistance;
+
+  // The maximum change in ray direction (in radians) and origin for which only
+  // the Entities near the previous ray are tested.
+  static const float kNarrowAngle;
+  static const float kNarrowDistance;
+
+  RaycastCache();
+
+  // Returns the closest Entity hit by |ray| (if any) and the distance to the
+  // hit point from the ray's origin, exactly as
+  // CollisionSystem::CheckForCollision would.
+  CollisionSystem::CollisionResult Raycast(CollisionSystem* collision_system,
+                                           const Ray& ray);
+
+  // Discards all cached results, forcing the next raycast to test all
+  // Entities.
+  void Clear();
+
+  // Returns counts of how raycasts have been resolved.
+  const Stats& GetStats() const { return stats_; }
+
+  // Returns the fraction of raycasts that were resolved without testing all
+  // collidable Entities.
+  float GetHitRate() const;
+
+  // Resets the stats to zero.
+  void ResetStats();
+
+ private:
+  bool has_result_;
+  bool has_candidates_;
+  uint32_t change_count_;
+  Ray result_ray_;
+  CollisionSystem::CollisionResult result_;
+  Ray candidate_ray_;
+  std::vector<Entity> candidates_;
+  Stats stats_;
+};
+
+}  // namespace lull
+
+#endif  // LULLABY_SYSTEMS_COLLISION_RAYCAST_CACHE_H_
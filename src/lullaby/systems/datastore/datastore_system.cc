@@ -59,7 +59,15 @@ void DatastoreSystem::Create(Entity entity, HashValue type, const Def* def) {
     return;
   }
 
+  if (entity == kNullEntity) {
+    return;
+  }
+
+  // Fill the datastore directly rather than calling Set for each pair, which
+  // would look up the datastore again every time.
   const auto* pairs = data->key_value_pairs();
+  Datastore& store = stores_[entity];
+  store.reserve(store.size() + pairs->size());
   for (auto iter = pairs->begin(); iter != pairs->end(); ++iter) {
     const auto* key = iter->key();
     const void* variant_def = iter->value();
@@ -71,9 +79,12 @@ void DatastoreSystem::Create(Entity entity, HashValue type, const Def* def) {
     Variant var;
     if (VariantFromFbVariant(iter->value_type(), variant_def, &var)) {
       const HashValue key_hash = Hash(key->c_str());
-      Set(entity, key_hash, var);
+      store[key_hash] = std::move(var);
     }
   }
+  if (store.empty()) {
+    stores_.erase(entity);
+  }
 }
 
 void DatastoreSystem::Destroy(Entity entity) { stores_.erase(entity); }
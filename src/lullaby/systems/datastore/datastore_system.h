@@ -17,8 +17,8 @@ limitations under the License.
 #ifndef LULLABY_SYSTEMS_DATASTORE_DATASTORE_SYSTEM_H_
 #define LULLABY_SYSTEMS_DATASTORE_DATASTORE_SYSTEM_H_
 
-#include <unordered_map>
 #include "lullaby/base/component.h"
+#include "lullaby/base/flat_hash_map.h"
 #include "lullaby/base/system.h"
 #include "lullaby/base/variant.h"
 
@@ -29,6 +29,9 @@ namespace lull {
 // A Datastore is just a dictionary of a HashValue to a Variant.  Adding a
 // datastore to an Entity allows arbitrary key-value pairs to be associated with
 // the Entity.
+//
+// Datastores are flat maps, so setting or removing values on an Entity may
+// invalidate references previously returned by GetVariant() for that Entity.
 class DatastoreSystem : public System {
  public:
   explicit DatastoreSystem(Registry* registry);
@@ -61,8 +64,8 @@ class DatastoreSystem : public System {
   const Variant& GetVariant(Entity entity, HashValue key) const;
 
  private:
-  using Datastore = std::unordered_map<HashValue, Variant>;
-  using EntityMap = std::unordered_map<Entity, Datastore>;
+  using Datastore = VariantMap;
+  using EntityMap = FlatHashMap<Entity, Datastore>;
 
   EntityMap stores_;
   Variant empty_variant_;
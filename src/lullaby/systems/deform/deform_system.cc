@@ -17,6 +17,7 @@ limitations under the License.
 #include "lullaby/systems/deform/deform_system.h"
 
 #include "lullaby/base/dispatcher.h"
+#include "lullaby/base/job_processor.h"
 #include "lullaby/systems/render/render_system.h"
 #include "lullaby/systems/transform/transform_system.h"
 #include "lullaby/util/mathfu_fb_conversions.h"
@@ -28,6 +29,40 @@ const HashValue kDeformerHash = Hash("DeformerDef");
 const HashValue kWaypointDeformerHash = Hash("WaypointDeformerDef");
 const HashValue kDeformedHash = Hash("DeformedDef");
 
+// Meshes are only split across the JobProcessor (if one is registered) once
+// each job has at least this many vertices to deform.
+constexpr size_t kMinVerticesPerJob = 2048;
+constexpr size_t kMaxDeformJobs = 4;
+
+// Deformation keys are computed from parameters rounded to this many steps per
+// unit so that they are stable against floating point noise.
+constexpr float kDeformationKeyPrecision = 1.0e4f;
+
+// Deformation keys start with the kind of deformation, so that the parameters
+// of different kinds can't be confused.
+enum DeformationKeyType : uint8_t {
+  kCylinderBendDeformationKey = 1,
+  kGlobalCylinderDeformationKey = 2,
+  // Waypoint deformation doesn't modify meshes, so all of them can be shared.
+  kWaypointDeformationKey = 3,
+};
+
+void AppendQuantized(float value, std::vector<uint8_t>* key) {
+  const int64_t quantized =
+      static_cast<int64_t>(std::round(value * kDeformationKeyPrecision));
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&quantized);
+  key->insert(key->end(), bytes, bytes + sizeof(quantized));
+}
+
+// Appends the affine part of |mat|.
+void AppendQuantized(const mathfu::mat4& mat, std::vector<uint8_t>* key) {
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 4; ++col) {
+      AppendQuantized(mat(row, col), key);
+    }
+  }
+}
+
 // Returns the distance of the coordinate transform from the Y-axis.
 float GetRadius(const mathfu::mat4& mat) {
   return std::sqrt(mat(0, 3) * mat(0, 3) + mat(2, 3) * mat(2, 3));
@@ -132,10 +167,19 @@ void DeformSystem::SetDeformationFunction(Entity entity) {
   // system will see the deformation function and defer the mesh creation
   // until the first render call. We only need to set this function one time for
   // each entity.
-  registry_->Get<RenderSystem>()->SetDeformationFunction(
+  auto* render_system = registry_->Get<RenderSystem>();
+  render_system->SetDeformationFunction(
       entity, [this, entity](float* data, size_t len, size_t stride) {
         return DeformMesh(entity, data, len, stride);
       });
+  render_system->SetDeformationKeyFunction(
+      entity, [this, entity](const float* data, size_t len, size_t stride,
+                             std::vector<uint8_t>* key) {
+        // DeformMesh won't be called if a previously deformed mesh is shared,
+        // so the undeformed bounds have to be recorded here instead.
+        SetUndeformedBoundingBox(entity, data, len, stride);
+        return GetDeformationKey(entity, data, len, stride, key);
+      });
 }
 
 void DeformSystem::SetAsDeformed(Entity entity, string_view path_id) {
@@ -161,7 +205,9 @@ void DeformSystem::Destroy(Entity e) {
   if (deformed) {
     SetDeformerRecursive(deformed, nullptr /* deformer */);
   }
-  registry_->Get<RenderSystem>()->SetDeformationFunction(e, nullptr);
+  auto* render_system = registry_->Get<RenderSystem>();
+  render_system->SetDeformationFunction(e, nullptr);
+  render_system->SetDeformationKeyFunction(e, nullptr);
 
   deformers_.Destroy(e);
   deformed_.Destroy(e);
@@ -313,19 +359,108 @@ void DeformSystem::DeformMesh(Entity e, float* data, size_t len,
     }
   } else {
     const Deformer* deformer = deformers_.Get(e);
-    if (deformer != nullptr || deformer->mode != DeformMode_GlobalCylinder) {
+    if (deformer == nullptr || deformer->mode != DeformMode_GlobalCylinder) {
       LOG(ERROR) << "Invalid deformer, skipping deformation for entity: " << e;
       return;
     }
     const float current_radius = GetRadius(
         *registry_->Get<TransformSystem>()->GetWorldFromEntityMatrix(e));
     const mathfu::vec3 translation = current_radius * mathfu::kAxisZ3f;
-    ApplyDeformation(data, len, stride, [&](const mathfu::vec3& pos) {
-      return DeformPoint(pos - translation, deformer->radius) + translation;
-    });
+    ApplyCylinderBend(data, len, stride,
+                      mathfu::mat4::FromTranslationVector(-translation),
+                      deformer->radius,
+                      mathfu::mat4::FromTranslationVector(translation));
+  }
+}
+
+void DeformSystem::SetUndeformedBoundingBox(Entity e, const float* data,
+                                            size_t len, size_t stride) {
+  Deformed* deformed = deformed_.Get(e);
+  if (deformed) {
+    const Deformer* deformer = deformers_.Get(deformed->deformer);
+    if (deformer != nullptr && deformer->mode == DeformMode_CylinderBend) {
+      deformed->undeformed_aabb = GetBoundingBox(data, len, stride);
+    }
+  }
+}
+
+bool DeformSystem::GetDeformationKey(Entity e, const float* data, size_t len,
+                                     size_t stride,
+                                     std::vector<uint8_t>* key) const {
+  // This mirrors DeformMesh, returning false (ie. don't share the result) in
+  // all the cases where DeformMesh would fail.
+  const Deformed* deformed = deformed_.Get(e);
+  if (deformed) {
+    const Deformer* deformer = deformers_.Get(deformed->deformer);
+    if (deformer == nullptr) {
+      return false;
+    } else if (deformer->mode == DeformMode_Waypoint) {
+      key->push_back(kWaypointDeformationKey);
+      return true;
+    } else if (deformer->mode != DeformMode_CylinderBend ||
+               deformer->radius <= 0.f) {
+      return false;
+    }
+
+    mathfu::mat4 root_from_mesh;
+    mathfu::mat4 mesh_from_root;
+    if (!GetCylinderBendTransforms(*deformed, *deformer, &root_from_mesh,
+                                   &mesh_from_root)) {
+      return false;
+    }
+
+    // Moving a mesh around the cylinder (along x in root space) or along its
+    // axis (y) only rotates or translates the deformed result, so fold that
+    // offset into |mesh_from_root| to let identical meshes at different
+    // positions on the cylinder share a key.
+    const float angle = root_from_mesh(0, 3) / deformer->radius;
+    const float height = root_from_mesh(1, 3);
+    root_from_mesh(0, 3) = 0.f;
+    root_from_mesh(1, 3) = 0.f;
+    mesh_from_root =
+        mesh_from_root *
+        mathfu::mat4::FromRotationMatrix(
+            mathfu::quat::FromAngleAxis(-angle, mathfu::kAxisY3f)
+                .ToMatrix()) *
+        mathfu::mat4::FromTranslationVector(height * mathfu::kAxisY3f);
+
+    key->push_back(kCylinderBendDeformationKey);
+    AppendQuantized(deformer->radius, key);
+    AppendQuantized(root_from_mesh, key);
+    AppendQuantized(mesh_from_root, key);
+    return true;
+  } else {
+    const Deformer* deformer = deformers_.Get(e);
+    if (deformer == nullptr || deformer->mode != DeformMode_GlobalCylinder) {
+      return false;
+    }
+    const float current_radius = GetRadius(
+        *registry_->Get<TransformSystem>()->GetWorldFromEntityMatrix(e));
+    key->push_back(kGlobalCylinderDeformationKey);
+    AppendQuantized(deformer->radius, key);
+    AppendQuantized(current_radius, key);
+    return true;
   }
 }
 
+void DeformSystem::ApplyCylinderBend(float* data, size_t len, size_t stride,
+                                     const mathfu::mat4& deformed_from_mesh,
+                                     float radius,
+                                     const mathfu::mat4& mesh_from_deformed)
+    const {
+  if (stride == 0) {
+    return;
+  }
+  const size_t num_vertices = len / stride;
+  RunJobsForRange(registry_->Get<JobProcessor>(), num_vertices,
+                  kMinVerticesPerJob, kMaxDeformJobs,
+                  [=](size_t begin, size_t end) {
+                    ApplyCylinderBendDeformation(
+                        data + begin * stride, (end - begin) * stride, stride,
+                        deformed_from_mesh, radius, mesh_from_deformed);
+                  });
+}
+
 mathfu::mat4 DeformSystem::CalculateMatrixCylinderBend(
     Entity e, const Sqt& local_sqt,
     const mathfu::mat4* world_from_parent_mat) const {
@@ -397,6 +532,20 @@ mathfu::mat4 DeformSystem::CalculateWaypointTransformMatrix(
 void DeformSystem::CylinderBendDeformMesh(const Deformed& deformed,
                                           const Deformer& deformer, float* data,
                                           size_t len, size_t stride) const {
+  mathfu::mat4 root_from_entity_undeformed_space;
+  mathfu::mat4 entity_from_root_deformed_space;
+  if (GetCylinderBendTransforms(deformed, deformer,
+                                &root_from_entity_undeformed_space,
+                                &entity_from_root_deformed_space)) {
+    ApplyCylinderBend(data, len, stride, root_from_entity_undeformed_space,
+                      deformer.radius, entity_from_root_deformed_space);
+  }
+}
+
+bool DeformSystem::GetCylinderBendTransforms(
+    const Deformed& deformed, const Deformer& deformer,
+    mathfu::mat4* root_from_entity_undeformed_space,
+    mathfu::mat4* entity_from_root_deformed_space) const {
   const TransformSystem& transform_system = *registry_->Get<TransformSystem>();
   const mathfu::mat4* world_from_entity_deformed_space =
       transform_system.GetWorldFromEntityMatrix(deformed.GetEntity());
@@ -404,7 +553,7 @@ void DeformSystem::CylinderBendDeformMesh(const Deformed& deformed,
       transform_system.GetWorldFromEntityMatrix(deformer.GetEntity());
   if (!world_from_entity_deformed_space ||
       !world_from_deformer_deformed_space) {
-    return;
+    return false;
   }
 
   // To deform the mesh we first transform the vertices into the deformer root
@@ -412,22 +561,15 @@ void DeformSystem::CylinderBendDeformMesh(const Deformed& deformed,
   // z-axis. To get back out of root space, we have to use the deformed
   // transforms that we have set on the transform system.
   const float radius = deformer.radius;
-  const mathfu::mat4 root_from_entity_undeformed_space =
+  *root_from_entity_undeformed_space =
       mathfu::mat4::FromTranslationVector(-radius * mathfu::kAxisZ3f) *
       deformed.deformer_from_entity_undeformed_space;
 
-  const mathfu::mat4 entity_from_root_deformed_space =
+  *entity_from_root_deformed_space =
       world_from_entity_deformed_space->Inverse() *
       (*world_from_deformer_deformed_space) *
       mathfu::mat4::FromTranslationVector(radius * mathfu::kAxisZ3f);
-
-  ApplyDeformation(data, len, stride, [&radius,
-                                       &root_from_entity_undeformed_space,
-                                       &entity_from_root_deformed_space](
-                                          const mathfu::vec3& pos) {
-    return entity_from_root_deformed_space *
-           DeformPoint(root_from_entity_undeformed_space * pos, radius);
-  });
+  return true;
 }
 
 void DeformSystem::OnParentChanged(const ParentChangedEvent& ev) {
@@ -18,6 +18,7 @@ limitations under the License.
 #define LULLABY_SYSTEMS_DEFORM_DEFORM_SYSTEM_H_
 
 #include <unordered_map>
+#include <vector>
 
 #include "lullaby/generated/deform_def_generated.h"
 #include "lullaby/base/component.h"
@@ -144,6 +145,18 @@ class DeformSystem : public System {
   // entity.
   void DeformMesh(Entity e, float* data, size_t len, size_t stride);
 
+  // Records the bounds of the given undeformed vertex data, as DeformMesh
+  // would.
+  void SetUndeformedBoundingBox(Entity e, const float* data, size_t len,
+                                size_t stride);
+
+  // Appends the parameters that determine the result of DeformMesh for the
+  // given vertex data to |key|, so that the render system can share the
+  // deformed meshes of entities with identical meshes and deformations.
+  // Returns false if the result shouldn't be shared.
+  bool GetDeformationKey(Entity e, const float* data, size_t len,
+                         size_t stride, std::vector<uint8_t>* key) const;
+
   // Calculates the deformed world from entity transformation matrix for the
   // given entity. We expect this function to be called frequently by the
   // transformation system.
@@ -164,6 +177,20 @@ class DeformSystem : public System {
                               const Deformer& deformer, float* data, size_t len,
                               size_t stride) const;
 
+  // Calculates the transforms into and out of the deformer's root space used
+  // by CylinderBendDeformMesh.  Returns false if either entity is missing a
+  // transform.
+  bool GetCylinderBendTransforms(
+      const Deformed& deformed, const Deformer& deformer,
+      mathfu::mat4* root_from_entity_undeformed_space,
+      mathfu::mat4* entity_from_root_deformed_space) const;
+
+  // Applies ApplyCylinderBendDeformation() to the vertex data, splitting large
+  // meshes across the registry's JobProcessor if there is one.
+  void ApplyCylinderBend(float* data, size_t len, size_t stride,
+                         const mathfu::mat4& deformed_from_mesh, float radius,
+                         const mathfu::mat4& mesh_from_deformed) const;
+
   void OnParentChanged(const ParentChangedEvent& ev);
 
   // Recursively sets the deformer for all child entity's deformed components in
@@ -16,6 +16,10 @@ limitations under the License.
 
 #include "lullaby/systems/layout/layout_system.h"
 
+#include <algorithm>
+#include <functional>
+#include <utility>
+
 #include "lullaby/generated/layout_def_generated.h"
 #include "lullaby/base/dispatcher.h"
 #include "lullaby/base/entity_factory.h"
@@ -30,6 +34,10 @@ limitations under the License.
 #include "lullaby/util/mathfu_fb_conversions.h"
 
 namespace {
+bool AabbEquals(const lull::Aabb& lhs, const lull::Aabb& rhs) {
+  return lhs.min == rhs.min && lhs.max == rhs.max;
+}
+
 struct LayoutDirtyEvent {
   LayoutDirtyEvent() {}
 
@@ -274,7 +282,7 @@ void LayoutSystem::SetLayoutParams(Entity e, const LayoutParams& params) {
   auto layout = layouts_.Get(e);
   if (layout) {
     layout->layout.reset(new LayoutParams(params));
-    SetDirty(e, kOriginal);
+    SetParamsDirty(layout);
   }
 }
 
@@ -285,7 +293,7 @@ void LayoutSystem::SetCanvasSizeX(Entity e, float x) {
   }
 
   layout->layout->canvas_size.x = x;
-  SetDirty(e, kOriginal);
+  SetParamsDirty(layout);
 }
 
 void LayoutSystem::SetCanvasSizeY(Entity e, float y) {
@@ -295,7 +303,7 @@ void LayoutSystem::SetCanvasSizeY(Entity e, float y) {
   }
 
   layout->layout->canvas_size.y = y;
-  SetDirty(e, kOriginal);
+  SetParamsDirty(layout);
 }
 
 void LayoutSystem::SetSpacingX(Entity e, float x) {
@@ -305,7 +313,7 @@ void LayoutSystem::SetSpacingX(Entity e, float x) {
   }
 
   layout->layout->spacing.x = x;
-  SetDirty(e, kOriginal);
+  SetParamsDirty(layout);
 }
 
 void LayoutSystem::SetSpacingY(Entity e, float y) {
@@ -315,7 +323,7 @@ void LayoutSystem::SetSpacingY(Entity e, float y) {
   }
 
   layout->layout->spacing.y = y;
-  SetDirty(e, kOriginal);
+  SetParamsDirty(layout);
 }
 
 void LayoutSystem::SetFillOrder(Entity e, LayoutFillOrder fill_order) {
@@ -325,7 +333,7 @@ void LayoutSystem::SetFillOrder(Entity e, LayoutFillOrder fill_order) {
   }
 
   layout->layout->fill_order = fill_order;
-  SetDirty(e, kOriginal);
+  SetParamsDirty(layout);
 }
 
 void LayoutSystem::SetHorizontalAlignment(Entity e,
@@ -336,7 +344,7 @@ void LayoutSystem::SetHorizontalAlignment(Entity e,
   }
 
   layout->layout->horizontal_alignment = horizontal_alignment;
-  SetDirty(e, kOriginal);
+  SetParamsDirty(layout);
 }
 
 void LayoutSystem::SetVerticalAlignment(Entity e,
@@ -347,7 +355,7 @@ void LayoutSystem::SetVerticalAlignment(Entity e,
   }
 
   layout->layout->vertical_alignment = vertical_alignment;
-  SetDirty(e, kOriginal);
+  SetParamsDirty(layout);
 }
 
 void LayoutSystem::SetRowAlignment(Entity e,
@@ -358,7 +366,7 @@ void LayoutSystem::SetRowAlignment(Entity e,
   }
 
   layout->layout->row_alignment = row_alignment;
-  SetDirty(e, kOriginal);
+  SetParamsDirty(layout);
 }
 
 void LayoutSystem::SetColumnAlignment(Entity e,
@@ -369,7 +377,7 @@ void LayoutSystem::SetColumnAlignment(Entity e,
   }
 
   layout->layout->column_alignment = column_alignment;
-  SetDirty(e, kOriginal);
+  SetParamsDirty(layout);
 }
 
 void LayoutSystem::SetElementsPerWrap(Entity e, int elements_per_wrap) {
@@ -379,7 +387,7 @@ void LayoutSystem::SetElementsPerWrap(Entity e, int elements_per_wrap) {
   }
 
   layout->layout->elements_per_wrap = elements_per_wrap;
-  SetDirty(e, kOriginal);
+  SetParamsDirty(layout);
 }
 
 void LayoutSystem::SetMaxElements(Entity e, int max_elements) {
@@ -389,10 +397,14 @@ void LayoutSystem::SetMaxElements(Entity e, int max_elements) {
   }
 
   layout->max_elements = max_elements;
-  SetDirty(e, kOriginal);
+  SetParamsDirty(layout);
 }
 
 void LayoutSystem::Layout(Entity e) {
+  LayoutComponent* layout = layouts_.Get(e);
+  if (layout) {
+    layout->measurement.valid = false;
+  }
   LayoutImpl(DirtyLayout(e, kOriginal));
 }
 
@@ -467,6 +479,29 @@ void LayoutSystem::LayoutImpl(const DirtyLayout& dirty_layout) {
         params.canvas_size.y = *y;
       }
     }
+
+    // Nothing has changed since the previous pass, so it doesn't need to be
+    // applied again.
+    if (IsMeasurementCurrent(*layout, params, elements, dirty_layout)) {
+      SendEvent(registry_, e, LayoutChangedEvent(e));
+      return;
+    }
+
+    // Record the inputs before applying the layout, since applying it can
+    // cause its children to change immediately.
+    LayoutMeasurement measurement;
+    const bool measured = MeasureElements(elements, &measurement.elements);
+    measurement.canvas_size = params.canvas_size;
+    measurement.set_actual_box = dirty_layout.ShouldSetActualBox();
+    measurement.desired_source = dirty_layout.GetChildrensDesiredSource();
+    measurement.actual_source = dirty_layout.GetActualSource();
+    layout->measurement.valid = false;
+    if (layout->passes_in_progress > 0) {
+      layout->pass_interrupted = true;
+    }
+    ++layout->passes_in_progress;
+    ++layout_pass_count_;
+
     const Aabb aabb = ApplyLayout(registry_, params, elements,
                                   dirty_layout.GetChildrensDesiredSource());
     transform_system->SetAabb(e, aabb);
@@ -476,6 +511,30 @@ void LayoutSystem::LayoutImpl(const DirtyLayout& dirty_layout) {
     } else {
       layout_box_system->SetOriginalBox(e, aabb);
     }
+
+    // Applying the layout may have created other layouts, so get it again.
+    layout = layouts_.Get(e);
+    if (layout == nullptr) {
+      return;
+    }
+    --layout->passes_in_progress;
+    if (layout->passes_in_progress == 0) {
+      std::vector<ElementMeasurement> results;
+      if (measured && !layout->pass_interrupted &&
+          MeasureElements(elements, &results)) {
+        for (size_t i = 0; i < results.size(); ++i) {
+          ElementMeasurement& element = measurement.elements[i];
+          element.translation = results[i].translation;
+          element.enabled = results[i].enabled;
+          element.desired_size_x = results[i].desired_size_x;
+          element.desired_size_y = results[i].desired_size_y;
+        }
+        measurement.aabb = aabb;
+        measurement.valid = true;
+        layout->measurement = std::move(measurement);
+      }
+      layout->pass_interrupted = false;
+    }
   } else if (layout->radial_layout) {
     ApplyRadialLayout(registry_, *children, *layout->radial_layout);
   } else {
@@ -497,17 +556,122 @@ LayoutElement LayoutSystem::GetLayoutElement(Entity e) {
   }
 }
 
+bool LayoutSystem::MeasureElements(
+    const std::vector<LayoutElement>& elements,
+    std::vector<ElementMeasurement>* measurements) const {
+  const auto* transform_system = registry_->Get<TransformSystem>();
+  const auto* layout_box_system = registry_->Get<LayoutBoxSystem>();
+  measurements->clear();
+  measurements->reserve(elements.size());
+  for (const LayoutElement& element : elements) {
+    const Sqt* sqt = transform_system->GetSqt(element.entity);
+    const Aabb* original_box =
+        layout_box_system->GetOriginalBox(element.entity);
+    const Aabb* actual_box = layout_box_system->GetActualBox(element.entity);
+    if (sqt == nullptr || original_box == nullptr || actual_box == nullptr) {
+      return false;
+    }
+    measurements->emplace_back(element);
+    ElementMeasurement& measurement = measurements->back();
+    measurement.original_box = *original_box;
+    measurement.actual_box = *actual_box;
+    measurement.translation = sqt->translation;
+    measurement.enabled = transform_system->IsEnabled(element.entity);
+    measurement.desired_size_x =
+        layout_box_system->GetDesiredSizeX(element.entity);
+    measurement.desired_size_y =
+        layout_box_system->GetDesiredSizeY(element.entity);
+  }
+  return true;
+}
+
+bool LayoutSystem::IsMeasurementCurrent(
+    const LayoutComponent& layout, const LayoutParams& params,
+    const std::vector<LayoutElement>& elements,
+    const DirtyLayout& dirty_layout) {
+  const LayoutMeasurement& measurement = layout.measurement;
+  if (!measurement.valid || layout.passes_in_progress > 0 ||
+      measurement.canvas_size != params.canvas_size ||
+      measurement.set_actual_box != dirty_layout.ShouldSetActualBox() ||
+      measurement.desired_source !=
+          dirty_layout.GetChildrensDesiredSource() ||
+      measurement.actual_source != dirty_layout.GetActualSource() ||
+      measurement.elements.size() != elements.size()) {
+    return false;
+  }
+
+  // The layout's own box must still be the one set by the previous pass.
+  const Entity e = layout.GetEntity();
+  const Aabb* aabb = registry_->Get<TransformSystem>()->GetAabb(e);
+  const Aabb* box = registry_->Get<LayoutBoxSystem>()->GetActualBox(e);
+  if (aabb == nullptr || box == nullptr ||
+      !AabbEquals(*aabb, measurement.aabb) ||
+      !AabbEquals(*box, measurement.aabb)) {
+    return false;
+  }
+
+  std::vector<ElementMeasurement> current;
+  if (!MeasureElements(elements, &current)) {
+    return false;
+  }
+  for (size_t i = 0; i < current.size(); ++i) {
+    const ElementMeasurement& lhs = current[i];
+    const ElementMeasurement& rhs = measurement.elements[i];
+    if (lhs.element.entity != rhs.element.entity ||
+        lhs.element.horizontal_weight != rhs.element.horizontal_weight ||
+        lhs.element.vertical_weight != rhs.element.vertical_weight ||
+        !AabbEquals(lhs.original_box, rhs.original_box) ||
+        !AabbEquals(lhs.actual_box, rhs.actual_box) ||
+        lhs.translation != rhs.translation || lhs.enabled != rhs.enabled ||
+        lhs.desired_size_x != rhs.desired_size_x ||
+        lhs.desired_size_y != rhs.desired_size_y) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void LayoutSystem::ProcessDirty() {
   // Copy dirty layouts in case the Dispatcher is not Queued.
-  std::unordered_map<Entity, DirtyLayout> dirty_layouts_copy;
+  std::unordered_map<Entity, DirtyLayout> sweep;
   using std::swap;
-  swap(dirty_layouts_copy, dirty_layouts_);
-  for (const auto& pair : dirty_layouts_copy) {
-    LayoutImpl(pair.second);
+  swap(sweep, dirty_layouts_);
+
+  // Process the deepest layouts first, so that nested layouts are measured
+  // before the layouts that contain them use their sizes.
+  std::vector<std::pair<size_t, Entity>> order;
+  order.reserve(sweep.size());
+  for (const auto& pair : sweep) {
+    order.emplace_back(GetDepth(pair.first), pair.first);
+  }
+  std::sort(order.begin(), order.end(),
+            std::greater<std::pair<size_t, Entity>>());
+
+  // Layouts that are dirtied by the sweep before they've been processed are
+  // merged into the sweep instead of needing another pass.
+  std::unordered_map<Entity, DirtyLayout>* previous_sweep = current_sweep_;
+  current_sweep_ = &sweep;
+  for (const auto& entry : order) {
+    auto iter = sweep.find(entry.second);
+    if (iter == sweep.end()) {
+      continue;
+    }
+    const DirtyLayout dirty_layout = iter->second;
+    sweep.erase(iter);
+    LayoutImpl(dirty_layout);
   }
+  current_sweep_ = previous_sweep;
 }
 
 void LayoutSystem::SetDirty(Entity e, LayoutPass pass, Entity source) {
+  if (current_sweep_) {
+    auto iter = current_sweep_->find(e);
+    if (iter != current_sweep_->end()) {
+      iter->second.Update(registry_, pass, source);
+      return;
+    }
+  }
+
   const bool was_clean = dirty_layouts_.empty();
   // Insert this before sending event in case the Dispatcher is not Queued.
   auto iter = dirty_layouts_.find(e);
@@ -522,6 +686,21 @@ void LayoutSystem::SetDirty(Entity e, LayoutPass pass, Entity source) {
   }
 }
 
+void LayoutSystem::SetParamsDirty(LayoutComponent* layout) {
+  layout->measurement.valid = false;
+  SetDirty(layout->GetEntity(), kOriginal);
+}
+
+size_t LayoutSystem::GetDepth(Entity e) const {
+  const auto* transform_system = registry_->Get<TransformSystem>();
+  size_t depth = 0;
+  for (Entity parent = transform_system->GetParent(e); parent != kNullEntity;
+       parent = transform_system->GetParent(parent)) {
+    ++depth;
+  }
+  return depth;
+}
+
 void LayoutSystem::SetParentDirty(Entity e, LayoutPass pass, Entity source) {
   auto transform_system = registry_->Get<TransformSystem>();
   Entity parent = transform_system->GetParent(e);
@@ -19,12 +19,14 @@ limitations under the License.
 
 #include <queue>
 #include <unordered_set>
+#include <vector>
 
 #include "lullaby/base/component.h"
 #include "lullaby/base/system.h"
 #include "lullaby/events/entity_events.h"
 #include "lullaby/events/layout_events.h"
 #include "lullaby/util/layout.h"
+#include "lullaby/util/optional.h"
 
 namespace lull {
 
@@ -67,7 +69,38 @@ class LayoutSystem : public System {
   // automatically be updated on the next AdvanceFrame.
   void Layout(Entity e);
 
+  // Returns the total number of layout passes that have been applied.  Passes
+  // that are skipped because nothing has changed since the previous pass are
+  // not counted.  Sample this once per frame to get the passes per frame.
+  size_t GetLayoutPassCount() const { return layout_pass_count_; }
+
  private:
+  // The state of a child that affects, or is set by, a layout pass.
+  struct ElementMeasurement {
+    explicit ElementMeasurement(const LayoutElement& element)
+        : element(element) {}
+
+    LayoutElement element;
+    Aabb original_box;
+    Aabb actual_box;
+    mathfu::vec3 translation = mathfu::kZeros3f;
+    bool enabled = true;
+    Optional<float> desired_size_x;
+    Optional<float> desired_size_y;
+  };
+
+  // The inputs and results of the last pass of a (non-radial) layout.  If none
+  // of these have changed, another pass would have no effect.
+  struct LayoutMeasurement {
+    bool valid = false;
+    mathfu::vec2 canvas_size = mathfu::kZeros2f;
+    bool set_actual_box = false;
+    Entity desired_source = kNullEntity;
+    Entity actual_source = kNullEntity;
+    Aabb aabb;
+    std::vector<ElementMeasurement> elements;
+  };
+
   struct LayoutComponent : Component {
     explicit LayoutComponent(Entity e);
     std::unique_ptr<LayoutParams> layout = nullptr;
@@ -75,6 +108,12 @@ class LayoutSystem : public System {
     size_t max_elements = 0;
     std::string empty_blueprint = "";
     std::queue<Entity> empty_placeholders;
+    LayoutMeasurement measurement;
+    // Number of passes of this layout in progress, and whether a pass was
+    // started while another was in progress.  The measurement of a pass that
+    // was interrupted by another pass is not reliable, so it isn't recorded.
+    int passes_in_progress = 0;
+    bool pass_interrupted = false;
   };
 
   // The processing done by the LayoutSystem is catagorized into different
@@ -142,6 +181,22 @@ class LayoutSystem : public System {
   LayoutElement GetLayoutElement(Entity e);
   void ProcessDirty();
   void SetDirty(Entity e, LayoutPass pass, Entity source = kNullEntity);
+  // Invalidates the measurement of a layout whose params have been modified
+  // and marks it dirty.
+  void SetParamsDirty(LayoutComponent* layout);
+  // Returns the number of ancestors of |e|.
+  size_t GetDepth(Entity e) const;
+
+  // Measures the current state of the |elements| into |measurements|.  Returns
+  // false if any of the elements can't be measured.
+  bool MeasureElements(const std::vector<LayoutElement>& elements,
+                       std::vector<ElementMeasurement>* measurements) const;
+  // Returns true if applying |params| to |elements| would have no effect since
+  // it matches the layout's previous pass.
+  bool IsMeasurementCurrent(const LayoutComponent& layout,
+                            const LayoutParams& params,
+                            const std::vector<LayoutElement>& elements,
+                            const DirtyLayout& dirty_layout);
   void SetParentDirty(Entity e, LayoutPass pass, Entity source = kNullEntity);
 
   // All of these events can trigger passes, which are labeled alongside.
@@ -157,6 +212,10 @@ class LayoutSystem : public System {
   ComponentPool<LayoutComponent> layouts_;
   std::unordered_map<Entity, LayoutElement> layout_elements_;
   std::unordered_map<Entity, DirtyLayout> dirty_layouts_;
+  // The layouts remaining in the sweep currently being processed by
+  // ProcessDirty, if any.
+  std::unordered_map<Entity, DirtyLayout>* current_sweep_ = nullptr;
+  size_t layout_pass_count_ = 0;
 
   LayoutSystem(const LayoutSystem&) = delete;
   LayoutSystem& operator=(const LayoutSystem&) = delete;
@@ -27,11 +27,41 @@ const char* kEmptyString = "";
 const HashValue kNameDefHash = Hash("NameDef");
 }  // namespace
 
+NameSystem::Path::Path(string_view path) {
+  size_t start = 0;
+  for (size_t i = 0; i <= path.size(); ++i) {
+    if (i == path.size() || path[i] == '/') {
+      if (i > start) {
+        hashes_.push_back(Hash(path.data() + start, i - start));
+      }
+      start = i + 1;
+    }
+  }
+}
+
 NameSystem::NameSystem(Registry* registry, bool allow_duplicate_names)
     : System(registry), allow_duplicate_names_(allow_duplicate_names) {
   RegisterDef(this, kNameDefHash);
 }
 
+NameSystem::~NameSystem() {
+  auto* transform_system = registry_->Get<TransformSystem>();
+  if (transform_system) {
+    transform_system->RemoveParentChangedFuncs(this);
+  }
+}
+
+void NameSystem::Initialize() {
+  // The index is updated as soon as the hierarchy changes, rather than when
+  // the (possibly queued) ParentChangedEvent is dispatched, so that lookups
+  // never need to check it against the hierarchy.
+  auto* transform_system = registry_->Get<TransformSystem>();
+  if (transform_system) {
+    transform_system->AddParentChangedFunc(
+        this, [this](Entity child) { OnParentChanged(child); });
+  }
+}
+
 void NameSystem::Create(Entity entity, HashValue type, const Def* def) {
   if (type != kNameDefHash) {
     LOG(DFATAL) << "Invalid def type, expecting NameDef.";
@@ -50,6 +80,7 @@ void NameSystem::Create(Entity entity, HashValue type, const Def* def) {
 void NameSystem::Destroy(Entity entity) {
   auto iter = entity_to_hash_.find(entity);
   if (iter != entity_to_hash_.end()) {
+    UnindexEntity(entity, iter->second);
     hash_to_entity_.erase(iter->second);
     entity_to_hash_.erase(iter);
   }
@@ -80,8 +111,14 @@ void NameSystem::SetName(Entity entity, const std::string& name) {
     hash_to_entity_.erase(Hash(existing_name.c_str()));
     hash_to_entity_[hash] = entity;
   }
+
+  const auto iter = entity_to_hash_.find(entity);
+  if (iter != entity_to_hash_.end()) {
+    UnindexEntity(entity, iter->second);
+  }
   entity_to_name_[entity] = name;
   entity_to_hash_[entity] = hash;
+  IndexEntity(entity, hash);
 }
 
 std::string NameSystem::GetName(Entity entity) const {
@@ -93,12 +130,7 @@ std::string NameSystem::GetName(Entity entity) const {
 Entity NameSystem::FindEntity(const std::string& name) const {
   const auto hash = Hash(name.c_str());
   if (allow_duplicate_names_) {
-    for (const auto& entry : entity_to_hash_) {
-      if (entry.second == hash) {
-        return entry.first;
-      }
-    }
-    return kNullEntity;
+    return FindIndexed(kNullEntity, hash);
   } else {
     const auto iter = hash_to_entity_.find(hash);
     return iter != hash_to_entity_.end() ? iter->second : kNullEntity;
@@ -110,46 +142,104 @@ Entity NameSystem::FindDescendant(Entity root, const std::string& name) const {
     LOG(DFATAL) << "root cannot be kNullEntity in FindDescendant()";
     return kNullEntity;
   }
+  return FindIndexed(root, Hash(name.c_str()));
+}
 
-  auto* transform_system = registry_->Get<TransformSystem>();
-  if (!transform_system) {
-    LOG(DFATAL) << "TransformSystem is required.";
+Entity NameSystem::FindPath(Entity root, const Path& path) const {
+  if (root == kNullEntity) {
+    LOG(DFATAL) << "root cannot be kNullEntity in FindPath()";
     return kNullEntity;
   }
 
-  const HashValue hash = Hash(name.c_str());
-  if (allow_duplicate_names_) {
-    return FindDescendantWithDuplicateNames(transform_system, root, hash);
-  } else {
-    const auto iter = hash_to_entity_.find(hash);
-    if (iter != hash_to_entity_.end()) {
-      const Entity entity = iter->second;
-      if (root == entity || transform_system->IsAncestorOf(root, entity)) {
-        return entity;
-      }
+  Entity entity = root;
+  Entity exclude = kNullEntity;
+  for (const HashValue hash : path.hashes_) {
+    entity = FindIndexed(entity, hash, exclude);
+    if (entity == kNullEntity) {
+      break;
     }
-    return kNullEntity;
+    // Names after the first must belong to a strict descendant.
+    exclude = entity;
   }
+  return entity;
+}
+
+Entity NameSystem::FindPath(Entity root, string_view path) const {
+  return FindPath(root, Path(path));
 }
 
-Entity NameSystem::FindDescendantWithDuplicateNames(
-    TransformSystem* transform_system, Entity root, HashValue hash) const {
-  const auto iter = entity_to_hash_.find(root);
-  if (iter != entity_to_hash_.end() && iter->second == hash) {
-    return root;
+void NameSystem::IndexEntity(Entity entity, HashValue hash) {
+  std::vector<Entity>& ancestors = indexed_ancestors_[entity];
+  ancestors.clear();
+  ancestors.push_back(entity);
+
+  const auto* transform_system = registry_->Get<TransformSystem>();
+  if (transform_system) {
+    for (Entity parent = transform_system->GetParent(entity);
+         parent != kNullEntity; parent = transform_system->GetParent(parent)) {
+      ancestors.push_back(parent);
+    }
   }
+  ancestors.push_back(kNullEntity);
 
-  const auto* children = transform_system->GetChildren(root);
-  if (children) {
-    for (Entity child : *children) {
-      const Entity result =
-          FindDescendantWithDuplicateNames(transform_system, child, hash);
-      if (result != kNullEntity) {
-        return result;
+  for (const Entity ancestor : ancestors) {
+    descendants_[ancestor].emplace(hash, entity);
+  }
+}
+
+void NameSystem::UnindexEntity(Entity entity, HashValue hash) {
+  const auto iter = indexed_ancestors_.find(entity);
+  if (iter == indexed_ancestors_.end()) {
+    return;
+  }
+
+  for (const Entity ancestor : iter->second) {
+    const auto by_hash = descendants_.find(ancestor);
+    if (by_hash == descendants_.end()) {
+      continue;
+    }
+    const auto range = by_hash->second.equal_range(hash);
+    for (auto entry = range.first; entry != range.second; ++entry) {
+      if (entry->second == entity) {
+        by_hash->second.erase(entry);
+        break;
       }
     }
+    if (by_hash->second.empty()) {
+      descendants_.erase(by_hash);
+    }
   }
+  indexed_ancestors_.erase(iter);
+}
 
+void NameSystem::OnParentChanged(Entity child) {
+  const auto* transform_system = registry_->Get<TransformSystem>();
+  if (!transform_system) {
+    return;
+  }
+
+  transform_system->ForAllDescendants(child, [this](Entity entity) {
+    const auto iter = entity_to_hash_.find(entity);
+    if (iter != entity_to_hash_.end()) {
+      UnindexEntity(entity, iter->second);
+      IndexEntity(entity, iter->second);
+    }
+  });
+}
+
+Entity NameSystem::FindIndexed(Entity ancestor, HashValue hash,
+                               Entity exclude) const {
+  const auto by_hash = descendants_.find(ancestor);
+  if (by_hash == descendants_.end()) {
+    return kNullEntity;
+  }
+
+  const auto range = by_hash->second.equal_range(hash);
+  for (auto entry = range.first; entry != range.second; ++entry) {
+    if (entry->second != exclude) {
+      return entry->second;
+    }
+  }
   return kNullEntity;
 }
 
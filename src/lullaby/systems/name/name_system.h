@@ -18,22 +18,44 @@ limitations under the License.
 #define LULLABY_SYSTEMS_NAME_NAME_SYSTEM_H_
 
 #include <unordered_map>
+#include <vector>
 
 #include "lullaby/base/component.h"
 #include "lullaby/base/system.h"
 #include "lullaby/systems/transform/transform_system.h"
 #include "lullaby/util/hash.h"
+#include "lullaby/util/string_view.h"
 
 namespace lull {
 
 // Associates a name with an entity.
 class NameSystem : public System {
  public:
+  // A path of names separated by '/', eg. "panel/list/item3", parsed and
+  // hashed ahead of time so that it can be looked up repeatedly with FindPath.
+  class Path {
+   public:
+    explicit Path(string_view path);
+
+    // Returns the number of names in the path.
+    size_t Size() const { return hashes_.size(); }
+
+   private:
+    friend class NameSystem;
+    std::vector<HashValue> hashes_;
+  };
+
   // If |allow_duplicate_names| is true, multiple entities are allowed to be
   // associated with the same name.
   NameSystem(Registry* registry, bool allow_duplicate_names);
   explicit NameSystem(Registry* registry) : NameSystem(registry, false) {}
 
+  ~NameSystem() override;
+
+  // Keeps the index of named descendants in sync with the TransformSystem, if
+  // there is one.
+  void Initialize() override;
+
   // Associates |entity| with a name. Removes any existing name associated
   // with this entity.
   void Create(Entity entity, HashValue type, const Def* def) override;
@@ -53,26 +75,53 @@ class NameSystem : public System {
   // is found.
   // If |allow_duplicate_names| is true and more than one entity with the name
   // is present, which of those entities will be returned is not well defined.
-  // The use of this method is discouraged when |allow_duplicate_names| is true
-  // since it involves a linear search across all entities. Use |FindDescendant|
-  // instead.
   Entity FindEntity(const std::string& name) const;
 
   // Finds the entity associated with |name| within the descendants of |root|,
   // including |root|. Returns kNullEntity if no entity is found.
+  // Named entities are indexed by each of their ancestors, so this does not
+  // search the hierarchy.
   // If |allow_duplicate_names| is true and more than one entity with the name
   // is present, which of those entities will be returned is not well defined.
   Entity FindDescendant(Entity root, const std::string& name) const;
 
+  // Finds the entity at |path| relative to |root|.  The first name in the path
+  // is found within the descendants of |root| (including |root|), and each
+  // following name is found within the descendants of the entity found for
+  // the previous name.  Returns |root| if the path is empty, or kNullEntity if
+  // any name is not found.
+  // If |allow_duplicate_names| is true and more than one entity matches a name,
+  // which of those entities will be used is not well defined.
+  Entity FindPath(Entity root, const Path& path) const;
+
+  // Same as above, but parses |path| first.  Prefer compiling a Path once if
+  // the same path is looked up repeatedly.
+  Entity FindPath(Entity root, string_view path) const;
+
  private:
+  using EntitiesByHash = std::unordered_multimap<HashValue, Entity>;
+
+  // Adds |entity| to the index under each of its ancestors (and itself).
+  void IndexEntity(Entity entity, HashValue hash);
+  // Removes |entity| from the index.
+  void UnindexEntity(Entity entity, HashValue hash);
+  // Reindexes all named entities in the subtree of the reparented |child|.
+  void OnParentChanged(Entity child);
+  // Finds an entity named |hash| within the descendants of |ancestor|
+  // (including |ancestor|), excluding |exclude|.
+  Entity FindIndexed(Entity ancestor, HashValue hash,
+                     Entity exclude = kNullEntity) const;
+
   std::unordered_map<Entity, std::string> entity_to_name_;
   std::unordered_map<Entity, HashValue> entity_to_hash_;
   // Only used when |allow_duplicate_names| is false.
   std::unordered_map<HashValue, Entity> hash_to_entity_;
+  // Named entities by the hash of their names, for each of their ancestors and
+  // themselves.  All named entities are also indexed under kNullEntity.
+  std::unordered_map<Entity, EntitiesByHash> descendants_;
+  // The entities under which each named entity is indexed in |descendants_|.
+  std::unordered_map<Entity, std::vector<Entity>> indexed_ancestors_;
   bool allow_duplicate_names_;
-
-  Entity FindDescendantWithDuplicateNames(
-      TransformSystem* transform_system, Entity root, HashValue hash) const;
 };
 
 }  // namespace lull
@@ -17,6 +17,10 @@ limitations under the License.
 #ifndef LULLABY_SYSTEMS_RENDER_DETAIL_DISPLAY_LIST_H_
 #define LULLABY_SYSTEMS_RENDER_DETAIL_DISPLAY_LIST_H_
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 #include "mathfu/constants.h"
 #include "mathfu/glsl_mappings.h"
 #include "lullaby/systems/render/detail/render_pool.h"
@@ -40,12 +44,19 @@ class DisplayList {
   };
 
   struct Entry {
-    explicit Entry(Entity e) : entity(e), component(nullptr) {}
+    explicit Entry(Entity e)
+        : entity(e), component(nullptr), screen_size(0.f), lod(0) {}
 
     Entity entity;
     const Component* component;
     mathfu::mat4 world_from_entity_matrix;
     SortKey sort_key;
+    // The largest fraction of any view's height covered by the entity's
+    // bounding sphere, used for level-of-detail selection.
+    float screen_size;
+    // The level-of-detail to render: 0 is the full detail mesh, and N selects
+    // the component's lod_meshes[N - 1].
+    size_t lod;
   };
 
   explicit DisplayList(Registry* registry) : registry_(registry) {}
@@ -54,16 +65,33 @@ class DisplayList {
   const std::vector<Entry>* GetContents() const { return &list_; }
 
   // Populates the list using |pool|.  |views| is used for camera-based sort
-  // modes.
+  // modes and for selecting each component's level-of-detail.
   void Populate(const RenderPool<Component>& pool, const View* views,
                 size_t num_views);
 
+  // Returns the fraction of the height of the view that a sphere at |center|
+  // with |radius| covers, using the largest value amongst the |views|.  If
+  // there are no views, the sphere is treated as filling the view so that the
+  // full detail LOD is selected.
+  static float CalculateScreenSize(const mathfu::vec3& center, float radius,
+                                   const View* views, size_t num_views);
+
+  // Returns the level-of-detail to use given a list of decreasing
+  // |lod_screen_sizes|, where entry i is the screen size below which LOD i + 1
+  // should be used instead of LOD i.
+  static size_t SelectLod(const std::vector<float>& lod_screen_sizes,
+                          float screen_size);
+
  private:
   void GetComponentsUnsorted(const RenderPool<Component>& pool);
   void GetComponentsWithSortOrder(const RenderPool<Component>& pool);
   void GetComponentsWithWorldSpaceZ(const RenderPool<Component>& pool);
   void GetComponentsWithAverageSpaceZ(const RenderPool<Component>& pool,
                                       const View* views, size_t num_views);
+  void SelectLods();
+
+  // Returns the largest scale factor applied by |mat| along any local axis.
+  static float GetMaxScale(const mathfu::mat4& mat);
 
   void SortDecreasingFloat();
   void SortIncreasingFloat();
@@ -141,6 +169,63 @@ void DisplayList<Component>::GetComponentsWithWorldSpaceZ(
   }
 }
 
+template <typename Component>
+float DisplayList<Component>::CalculateScreenSize(const mathfu::vec3& center,
+                                                  float radius,
+                                                  const View* views,
+                                                  size_t num_views) {
+  if (num_views == 0) {
+    return std::numeric_limits<float>::infinity();
+  }
+  float screen_size = 0.f;
+  for (size_t i = 0; i < num_views; ++i) {
+    const mathfu::mat4& world_from_eye = views[i].world_from_eye_matrix;
+    const mathfu::vec3 eye_pos = world_from_eye.TranslationVector3D();
+    // -z is forward.
+    const mathfu::vec3 forward = -GetMatrixColumn3D(world_from_eye, 2);
+    const float distance =
+        mathfu::vec3::DotProduct(center - eye_pos, forward.Normalized());
+    if (distance <= radius) {
+      // The eye is inside (or just behind) the sphere, so it fills the view.
+      return std::numeric_limits<float>::infinity();
+    }
+    // The [1][1] element of a projection matrix is cot(fov_y / 2), so this is
+    // the projected radius in normalized device coordinates, which span 2
+    // units vertically; ie. the fraction of the view height the diameter
+    // covers.
+    const float projected =
+        radius * views[i].clip_from_eye_matrix(1, 1) / distance;
+    screen_size = std::max(screen_size, projected);
+  }
+  return screen_size;
+}
+
+template <typename Component>
+float DisplayList<Component>::GetMaxScale(const mathfu::mat4& mat) {
+  return std::max(GetMatrixColumn3D(mat, 0).Length(),
+                  std::max(GetMatrixColumn3D(mat, 1).Length(),
+                           GetMatrixColumn3D(mat, 2).Length()));
+}
+
+template <typename Component>
+size_t DisplayList<Component>::SelectLod(
+    const std::vector<float>& lod_screen_sizes, float screen_size) {
+  size_t lod = 0;
+  while (lod < lod_screen_sizes.size() && screen_size < lod_screen_sizes[lod]) {
+    ++lod;
+  }
+  return lod;
+}
+
+template <typename Component>
+void DisplayList<Component>::SelectLods() {
+  for (auto& info : list_) {
+    if (info.component && !info.component->lod_screen_sizes.empty()) {
+      info.lod = SelectLod(info.component->lod_screen_sizes, info.screen_size);
+    }
+  }
+}
+
 template <typename Component>
 void DisplayList<Component>::SortDecreasingFloat() {
   std::sort(list_.begin(), list_.end(), [](const Entry& a, const Entry& b) {
@@ -190,6 +275,13 @@ void DisplayList<Component>::Populate(const RenderPool<Component>& pool,
           // TODO(b/28213394) Don't copy transforms.
           Entry info(e);
           info.world_from_entity_matrix = world_from_entity_mat;
+          const float radius = (box.max - box.min).Length() * 0.5f *
+                               GetMaxScale(world_from_entity_mat);
+          const mathfu::vec3 center =
+              world_from_entity_mat *
+              mathfu::vec3::Lerp(box.min, box.max, 0.5f);
+          info.screen_size =
+              CalculateScreenSize(center, radius, views, num_views);
           list_.push_back(info);
         });
   } else {
@@ -226,6 +318,9 @@ void DisplayList<Component>::Populate(const RenderPool<Component>& pool,
           for (size_t i = 0; i < num_views; i++) {
             if (CheckSphereInFrustum(center, radius,
                                      frustum_clipping_planes[i])) {
+              info.screen_size = CalculateScreenSize(
+                  center, radius * GetMaxScale(world_from_entity_mat), views,
+                  num_views);
               list_.push_back(info);
               break;
             }
@@ -261,6 +356,8 @@ void DisplayList<Component>::Populate(const RenderPool<Component>& pool,
                                          << static_cast<int>(sort_mode);
     GetComponentsUnsorted(pool);
   }
+
+  SelectLods();
 }
 
 }  // namespace detail
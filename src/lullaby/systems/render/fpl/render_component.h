@@ -50,6 +50,10 @@ struct RenderComponent : Component {
 
   mathfu::vec4 default_color = mathfu::vec4(1, 1, 1, 1);
   MeshPtr mesh = nullptr;
+  // Optional lower level-of-detail replacements for |mesh|.  lod_meshes[i] is
+  // drawn when the entity covers less than lod_screen_sizes[i] of the view.
+  std::vector<MeshPtr> lod_meshes;
+  std::vector<float> lod_screen_sizes;
   std::unique_ptr<MeshData> dynamic_mesh;
   ShaderPtr shader = nullptr;
   std::map<int, TexturePtr> textures;
@@ -24,7 +24,10 @@ limitations under the License.
 #include "lullaby/systems/render/fpl/shader.h"
 #include "lullaby/systems/render/fpl/texture.h"
 #include "lullaby/util/file.h"
+#include "lullaby/util/image_util.h"
 #include "lullaby/util/math.h"
+#include "lullaby/util/texture_container.h"
+#include "lullaby/util/texture_pipeline.h"
 #include "lullaby/util/trace.h"
 
 namespace lull {
@@ -129,10 +132,18 @@ bool RenderFactory::IsTextureValid(const TexturePtr& texture) const {
 TexturePtr RenderFactory::LoadTexture(const std::string& filename,
                                       bool create_mips) {
   const HashValue key = Hash(filename.c_str());
+  // Texture containers store their own mips, so |create_mips| is ignored.
+  const bool is_container = EndsWith(filename, kTextureContainerExtension);
   TexturePtr texture = textures_.Create(key, [&]() {
+    if (is_container) {
+      TexturePtr container_texture = LoadTextureContainer(filename);
+      if (container_texture) {
+        return container_texture;
+      }
+    }
     return TexturePtr(new Texture(LoadFplTexture(filename, create_mips)));
   });
-  if (texture->HasMips() != create_mips) {
+  if (!is_container && texture->HasMips() != create_mips) {
     LOG(WARNING) << "Texture mip conflict on " << filename << ": has? "
                  << texture->HasMips() << ", wants? " << create_mips;
   }
@@ -337,6 +348,70 @@ Texture::TextureImplPtr RenderFactory::LoadFplTexture(const std::string& name,
       });
 }
 
+TexturePtr RenderFactory::LoadTextureContainer(const std::string& name) {
+  LULLABY_CPU_TRACE_CALL();
+  AssetLoader* asset_loader = registry_->Get<AssetLoader>();
+  if (!asset_loader) {
+    return TexturePtr();
+  }
+  auto asset = asset_loader->LoadNow<SimpleAsset>(name);
+  if (!asset || asset->GetSize() == 0) {
+    return TexturePtr();
+  }
+  TextureContainer container;
+  const Span<uint8_t> data(static_cast<const uint8_t*>(asset->GetData()),
+                           asset->GetSize());
+  if (!ParseTextureContainer(data, &container)) {
+    LOG(ERROR) << "Could not parse texture container: " << name;
+    return TexturePtr();
+  }
+  if (!IsTextureContainerUploadable(container)) {
+    LOG(ERROR) << "Unsupported texture container: " << name;
+    return TexturePtr();
+  }
+
+  // The levels are already in the GPU's format, so they are uploaded as is.
+  GLuint texture_id = 0;
+  GL_CALL(glGenTextures(1, &texture_id));
+  GL_CALL(glBindTexture(GL_TEXTURE_2D, texture_id));
+  mathfu::vec2i size = container.size;
+  for (size_t i = 0; i < container.levels.size(); ++i) {
+    const Span<uint8_t>& level = container.levels[i];
+    if (container.IsCompressed()) {
+      GL_CALL(glCompressedTexImage2D(
+          GL_TEXTURE_2D, static_cast<GLint>(i), container.gl_internal_format,
+          size.x, size.y, 0, static_cast<GLsizei>(level.size()),
+          level.data()));
+    } else {
+      GL_CALL(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i),
+                           container.gl_internal_format, size.x, size.y, 0,
+                           container.gl_format, container.gl_type,
+                           level.data()));
+    }
+    size = GetHalvedImageSize(size);
+  }
+
+  const bool has_mips = container.levels.size() > 1;
+  GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                          has_mips ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
+  GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+  // Allow containers with a partial mip chain.
+  GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL,
+                          static_cast<GLint>(container.levels.size() - 1)));
+
+  // Record the size and mips on the fplbase::Texture, so that GetDimensions and
+  // HasMips describe the uploaded levels.
+  Texture::TextureImplPtr texture(
+      new fplbase::Texture(name.c_str(), fplbase::kFormatAuto,
+                           GetTextureFlags(has_mips)),
+      [](const fplbase::Texture* tex) { delete tex; });
+  texture->SetTextureId(fplbase::TextureTargetFromGl(GL_TEXTURE_2D),
+                        fplbase::TextureHandleFromGl(texture_id));
+  texture->set_size(container.size);
+  texture->set_original_size(container.size);
+  return TexturePtr(new Texture(std::move(texture)));
+}
+
 Texture::AtlasImplPtr RenderFactory::LoadFplTextureAtlas(
     const std::string& name, bool create_mips) {
   auto atlas = fpl_asset_manager_->LoadTextureAtlas(
@@ -62,6 +62,8 @@ class RenderFactory {
   ShaderPtr LoadShader(const std::string& filename);
 
   // Loads the texture with the given |filename| and optionally creates mips.
+  // Texture containers (.ktx files, see texture_pipeline.h) are uploaded
+  // without decoding, using the mips stored in the file.
   TexturePtr LoadTexture(const std::string& filename, bool create_mips);
 
   // Loads the texture atlas with the given |filename| and optionally creates
@@ -116,6 +118,9 @@ class RenderFactory {
   Shader::ShaderImplPtr LoadFplShader(const std::string& name);
   Texture::TextureImplPtr LoadFplTexture(const std::string& name,
                                          bool create_mips);
+  // Loads a texture container (see texture_container.h), uploading its levels
+  // directly to GL.  Returns null if the file could not be loaded or parsed.
+  TexturePtr LoadTextureContainer(const std::string& name);
   Texture::AtlasImplPtr LoadFplTextureAtlas(const std::string& name,
                                             bool create_mips);
   Texture::TextureImplPtr CreateFplTexture(const mathfu::vec2i& size,
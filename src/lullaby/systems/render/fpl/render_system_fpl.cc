@@ -86,6 +86,8 @@ void DrawDynamicMesh(const MeshData* mesh) {
 
 }  // namespace
 
+constexpr size_t RenderSystemFpl::kMinDeformedMeshSweepSize;
+
 RenderSystemFpl::RenderSystemFpl(Registry* registry)
     : System(registry),
       render_component_pools_(registry),
@@ -307,6 +309,7 @@ void RenderSystemFpl::Destroy(Entity e) {
   SetStencilMode(e, StencilMode::kDisabled, 0);
   render_component_pools_.DestroyComponent(e);
   deformations_.erase(e);
+  deformation_keys_.erase(e);
   sort_order_manager_.Destroy(e);
 }
 
@@ -332,8 +335,7 @@ void RenderSystemFpl::CreateDeferredMeshes() {
         SetQuadImpl(defer.e, defer.quad);
         break;
       case DeferredMesh::kMesh:
-        DeformMesh(defer.e, &defer.mesh);
-        SetMesh(defer.e, defer.mesh);
+        SetMesh(defer.e, CreateDeformedMesh(defer.e, &defer.mesh));
         break;
     }
     deferred_meshes_.pop();
@@ -675,6 +677,28 @@ void RenderSystemFpl::SetMesh(Entity e, const std::string& file) {
   SetMesh(e, factory_->LoadMesh(file));
 }
 
+void RenderSystemFpl::SetMeshLods(Entity entity,
+                                  const std::vector<MeshData>& lods,
+                                  const std::vector<float>& screen_sizes) {
+  auto* render_component = render_component_pools_.GetComponent(entity);
+  if (!render_component) {
+    LOG(WARNING) << "Missing RenderComponent, "
+                 << "skipping mesh lod update for entity: " << entity;
+    return;
+  }
+  if (lods.size() != screen_sizes.size()) {
+    LOG(DFATAL) << "Each mesh lod must have a screen size.";
+    return;
+  }
+
+  render_component->lod_meshes.clear();
+  render_component->lod_meshes.reserve(lods.size());
+  for (const MeshData& lod : lods) {
+    render_component->lod_meshes.emplace_back(factory_->CreateMesh(lod));
+  }
+  render_component->lod_screen_sizes = screen_sizes;
+}
+
 RenderSystemFpl::SortOrderOffset RenderSystemFpl::GetSortOrderOffset(
     Entity entity) const {
   return sort_order_manager_.GetOffset(entity);
@@ -769,6 +793,8 @@ void RenderSystemFpl::SetMesh(Entity e, MeshPtr mesh) {
   }
 
   render_component->mesh = std::move(mesh);
+  render_component->lod_meshes.clear();
+  render_component->lod_screen_sizes.clear();
   if (render_component->mesh) {
     auto& transform_system = *registry_->Get<TransformSystem>();
     transform_system.SetAabb(e, render_component->mesh->GetAabb());
@@ -832,15 +858,97 @@ MeshPtr RenderSystemFpl::CreateQuad(Entity e, const Quad& quad) {
   mesh.SetQuad(quad.size.x, quad.size.y, quad.verts.x, quad.verts.y,
                quad.corner_radius, quad.corner_verts, quad.corner_mask);
 
-  DeformMesh<Vertex>(e, &mesh);
-
   if (quad.id != 0) {
+    DeformMesh<Vertex>(e, &mesh);
     return factory_->CreateMesh(quad.id, mesh);
   } else {
-    return factory_->CreateMesh(mesh);
+    return CreateDeformedMesh<Vertex>(e, &mesh);
   }
 }
 
+template <typename Vertex>
+MeshPtr RenderSystemFpl::CreateDeformedMesh(Entity entity,
+                                            TriangleMesh<Vertex>* mesh) {
+  std::vector<uint8_t> key;
+  if (!GetDeformedMeshKey(entity, *mesh, &key)) {
+    DeformMesh(entity, mesh);
+    return factory_->CreateMesh(*mesh);
+  }
+
+  const HashValue hash = HashBytes(key.data(), key.size());
+  DeformedMeshEntry& entry = deformed_meshes_[hash];
+  MeshPtr result = entry.mesh.lock();
+  if (result && entry.key == key) {
+    return result;
+  }
+
+  DeformMesh(entity, mesh);
+  MeshPtr deformed_mesh = factory_->CreateMesh(*mesh);
+  // If a different mesh with the same hash is still alive, it keeps its entry
+  // and this mesh simply isn't shared.
+  if (!result) {
+    entry.key = std::move(key);
+    entry.mesh = deformed_mesh;
+  }
+  if (deformed_meshes_.size() >= next_deformed_mesh_sweep_size_) {
+    ReleaseExpiredDeformedMeshes();
+  }
+  return deformed_mesh;
+}
+
+template <typename Vertex>
+bool RenderSystemFpl::GetDeformedMeshKey(Entity entity,
+                                         const TriangleMesh<Vertex>& mesh,
+                                         std::vector<uint8_t>* key) const {
+  auto iter = deformation_keys_.find(entity);
+  if (iter == deformation_keys_.end() || !iter->second ||
+      sizeof(Vertex) % sizeof(float) != 0) {
+    return false;
+  }
+
+  const std::vector<Vertex>& vertices = mesh.GetVertices();
+  const std::vector<typename TriangleMesh<Vertex>::Index>& indices =
+      mesh.GetIndices();
+  if (vertices.empty()) {
+    return false;
+  }
+
+  const size_t stride = sizeof(Vertex) / sizeof(float);
+  if (!iter->second(reinterpret_cast<const float*>(vertices.data()),
+                    vertices.size() * stride, stride, key)) {
+    return false;
+  }
+
+  // Record the sizes of each part so that different splits of the same bytes
+  // produce different keys.
+  const uint32_t sizes[] = {static_cast<uint32_t>(key->size()),
+                            static_cast<uint32_t>(sizeof(Vertex)),
+                            static_cast<uint32_t>(vertices.size())};
+  const uint8_t* sizes_ptr = reinterpret_cast<const uint8_t*>(sizes);
+  const uint8_t* vertices_ptr =
+      reinterpret_cast<const uint8_t*>(vertices.data());
+  const uint8_t* indices_ptr = reinterpret_cast<const uint8_t*>(indices.data());
+  key->insert(key->end(), sizes_ptr, sizes_ptr + sizeof(sizes));
+  key->insert(key->end(), vertices_ptr,
+              vertices_ptr + vertices.size() * sizeof(Vertex));
+  key->insert(key->end(), indices_ptr,
+              indices_ptr + indices.size() * sizeof(indices[0]));
+  return true;
+}
+
+void RenderSystemFpl::ReleaseExpiredDeformedMeshes() {
+  for (auto iter = deformed_meshes_.begin();
+       iter != deformed_meshes_.end();) {
+    if (iter->second.mesh.expired()) {
+      iter = deformed_meshes_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  next_deformed_mesh_sweep_size_ =
+      std::max(kMinDeformedMeshSweepSize, 2 * deformed_meshes_.size());
+}
+
 void RenderSystemFpl::SetStencilMode(Entity e, StencilMode mode, int value) {
   auto* render_component = render_component_pools_.GetComponent(e);
   if (!render_component || render_component->stencil_mode == mode) {
@@ -854,12 +962,21 @@ void RenderSystemFpl::SetStencilMode(Entity e, StencilMode mode, int value) {
 void RenderSystemFpl::SetDeformationFunction(Entity e,
                                              const Deformation& deform) {
   if (deform) {
-    deformations_.emplace(e, deform);
+    deformations_[e] = deform;
   } else {
     deformations_.erase(e);
   }
 }
 
+void RenderSystemFpl::SetDeformationKeyFunction(Entity e,
+                                                const DeformationKey& key) {
+  if (key) {
+    deformation_keys_[e] = key;
+  } else {
+    deformation_keys_.erase(e);
+  }
+}
+
 void RenderSystemFpl::Hide(Entity e) {
   auto* render_component = render_component_pools_.GetComponent(e);
   bool newly_hidden = false;
@@ -1068,7 +1185,7 @@ void RenderSystemFpl::SetViewUniforms(const View& view) {
 
 void RenderSystemFpl::RenderAt(const RenderComponent* component,
                                const mathfu::mat4& world_from_entity_matrix,
-                               const View& view) {
+                               size_t lod, const View& view) {
   LULLABY_CPU_TRACE_CALL();
   if (!component->shader || (!component->mesh && !component->dynamic_mesh)) {
     return;
@@ -1118,12 +1235,13 @@ void RenderSystemFpl::RenderAt(const RenderComponent* component,
   }
 
   BindStencilMode(component->stencil_mode, component->stencil_value);
-  DrawMeshFromComponent(component);
+  DrawMeshFromComponent(component, lod);
 }
 
 void RenderSystemFpl::RenderAtMultiview(
     const RenderComponent* component,
-    const mathfu::mat4& world_from_entity_matrix, const View* views) {
+    const mathfu::mat4& world_from_entity_matrix, size_t lod,
+    const View* views) {
   LULLABY_CPU_TRACE_CALL();
   if (!component->shader || (!component->mesh && !component->dynamic_mesh)) {
     return;
@@ -1178,7 +1296,7 @@ void RenderSystemFpl::RenderAtMultiview(
   }
 
   BindStencilMode(component->stencil_mode, component->stencil_value);
-  DrawMeshFromComponent(component);
+  DrawMeshFromComponent(component, lod);
 }
 
 void RenderSystemFpl::SetShaderUniforms(const UniformMap& uniforms) {
@@ -1211,13 +1329,17 @@ void RenderSystemFpl::SetShaderUniforms(const UniformMap& uniforms) {
   }
 }
 
-void RenderSystemFpl::DrawMeshFromComponent(const RenderComponent* component) {
-  if (component->mesh) {
-    component->mesh->Render(&renderer_, blend_mode_);
+void RenderSystemFpl::DrawMeshFromComponent(const RenderComponent* component,
+                                            size_t lod) {
+  const MeshPtr& mesh = (lod > 0 && lod <= component->lod_meshes.size())
+                            ? component->lod_meshes[lod - 1]
+                            : component->mesh;
+  if (mesh) {
+    mesh->Render(&renderer_, blend_mode_);
     detail::Profiler* profiler = registry_->Get<detail::Profiler>();
     if (profiler) {
-      profiler->RecordDraw(component->shader, component->mesh->GetNumVertices(),
-                           component->mesh->GetNumTriangles());
+      profiler->RecordDraw(component->shader, mesh->GetNumVertices(),
+                           mesh->GetNumTriangles());
     }
   }
 
@@ -1250,7 +1372,7 @@ void RenderSystemFpl::RenderDisplayList(const View& view,
                 [&](const DisplayList::Entry& info) {
                   if (info.component) {
                     RenderAt(info.component, info.world_from_entity_matrix,
-                             view);
+                             info.lod, view);
                   }
                 });
 }
@@ -1263,7 +1385,8 @@ void RenderSystemFpl::RenderDisplayListMultiview(
                 [&](const DisplayList::Entry& info) {
                   if (info.component) {
                     RenderAtMultiview(info.component,
-                                      info.world_from_entity_matrix, views);
+                                      info.world_from_entity_matrix, info.lod,
+                                      views);
                   }
                 });
 }
@@ -1323,13 +1446,17 @@ void RenderSystemFpl::Render(const View* views, size_t num_views,
     }
   }
 
-  bool reset_state = true;
-  auto* config = registry_->Get<Config>();
-  if (config) {
-    static const HashValue kRenderResetStateHash =
-        Hash("lull.Render.ResetState");
-    reset_state = config->Get(kRenderResetStateHash, reset_state);
+  if (!reset_state_config_) {
+    auto* config = registry_->Get<Config>();
+    if (config) {
+      static const HashValue kRenderResetStateHash =
+          Hash("lull.Render.ResetState");
+      reset_state_config_.reset(
+          new Config::Handle<bool>(config, kRenderResetStateHash, true));
+    }
   }
+  const bool reset_state =
+      reset_state_config_ ? reset_state_config_->Get() : true;
 
   switch (pass) {
     case RenderPass_Pano: {
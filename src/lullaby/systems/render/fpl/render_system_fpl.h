@@ -17,6 +17,7 @@ limitations under the License.
 #ifndef LULLABY_SYSTEMS_RENDER_FPL_RENDER_SYSTEM_FPL_H_
 #define LULLABY_SYSTEMS_RENDER_FPL_RENDER_SYSTEM_FPL_H_
 
+#include <memory>
 #include <queue>
 #include <string>
 #include <unordered_map>
@@ -36,6 +37,7 @@ limitations under the License.
 #include "lullaby/systems/text/html_tags.h"
 #include "lullaby/systems/text/text_system.h"
 #include "lullaby/systems/transform/transform_system.h"
+#include "lullaby/util/config.h"
 #include "lullaby/util/mesh_data.h"
 #include "lullaby/util/triangle_mesh.h"
 #include "lullaby/util/vertex.h"
@@ -48,6 +50,7 @@ class RenderSystemFpl : public System {
  public:
   using CullMode = RenderSystem::CullMode;
   using Deformation = RenderSystem::Deformation;
+  using DeformationKey = RenderSystem::DeformationKey;
   using PrimitiveType = RenderSystem::PrimitiveType;
   using Quad = RenderSystem::Quad;
   using SortMode = RenderSystem::SortMode;
@@ -131,6 +134,9 @@ class RenderSystemFpl : public System {
 
   void SetMesh(Entity e, const std::string& file);
 
+  void SetMeshLods(Entity entity, const std::vector<MeshData>& lods,
+                   const std::vector<float>& screen_sizes);
+
   ShaderPtr GetShader(Entity entity) const;
   void SetShader(Entity e, const ShaderPtr& shader);
 
@@ -153,6 +159,7 @@ class RenderSystemFpl : public System {
   bool IsHidden(Entity e) const;
 
   void SetDeformationFunction(Entity e, const Deformation& deform);
+  void SetDeformationKeyFunction(Entity e, const DeformationKey& key);
 
   void Hide(Entity e);
   void Show(Entity e);
@@ -236,10 +243,11 @@ class RenderSystemFpl : public System {
 
   void CreateRenderComponentFromDef(Entity e, const RenderDef& data);
   void RenderAt(const RenderComponent* component,
-                const mathfu::mat4& world_from_entity_matrix, const View& view);
+                const mathfu::mat4& world_from_entity_matrix, size_t lod,
+                const View& view);
   void RenderAtMultiview(const RenderComponent* component,
                          const mathfu::mat4& world_from_entity_matrix,
-                         const View* views);
+                         size_t lod, const View* views);
   void RenderComponentsInPass(const View* views, size_t num_views,
                               RenderPass pass);
   void RenderDisplayList(const View& view, const DisplayList& display_list);
@@ -252,6 +260,17 @@ class RenderSystemFpl : public System {
   MeshPtr CreateQuad(Entity e, const Quad& quad);
   template <typename Vertex>
   void DeformMesh(Entity entity, TriangleMesh<Vertex>* mesh);
+  // Deforms |mesh| and creates a MeshPtr from it, sharing a previously
+  // deformed mesh if one exists with the same source data and deformation key.
+  template <typename Vertex>
+  MeshPtr CreateDeformedMesh(Entity entity, TriangleMesh<Vertex>* mesh);
+  // Writes the undeformed |mesh| data and |entity|'s deformation key into
+  // |key|.  Returns false if the deformed mesh shouldn't be shared.
+  template <typename Vertex>
+  bool GetDeformedMeshKey(Entity entity, const TriangleMesh<Vertex>& mesh,
+                          std::vector<uint8_t>* key) const;
+  // Removes cached deformed meshes that are no longer used by any entity.
+  void ReleaseExpiredDeformedMeshes();
   void BindStencilMode(StencilMode mode, int ref);
   void BindVertexArray(uint32_t ref);
   void ClearSamplers();
@@ -270,7 +289,7 @@ class RenderSystemFpl : public System {
                        const TexturePtr& texture);
   bool IsReadyToRenderImpl(const RenderComponent& component) const;
   void SetShaderUniforms(const UniformMap& uniforms);
-  void DrawMeshFromComponent(const RenderComponent* component);
+  void DrawMeshFromComponent(const RenderComponent* component, size_t lod);
 
   // Thread-specific render API. Holds rendering context.
   // In multi-threaded rendering, every thread should have one of these classes.
@@ -282,6 +301,17 @@ class RenderSystemFpl : public System {
   int max_texture_unit_ = 0;
 
   std::unordered_map<Entity, Deformation> deformations_;
+  std::unordered_map<Entity, DeformationKey> deformation_keys_;
+  // Deformed meshes are only weakly held so that they are destroyed when no
+  // entities reference them.  The full key is stored with each mesh and
+  // compared on lookup, so that hash collisions never share the wrong mesh.
+  static constexpr size_t kMinDeformedMeshSweepSize = 64;
+  struct DeformedMeshEntry {
+    std::vector<uint8_t> key;
+    std::weak_ptr<Mesh> mesh;
+  };
+  std::unordered_map<HashValue, DeformedMeshEntry> deformed_meshes_;
+  size_t next_deformed_mesh_sweep_size_ = kMinDeformedMeshSweepSize;
   std::queue<DeferredMesh> deferred_meshes_;
 
   std::vector<mathfu::AffineTransform> shader_transforms_;
@@ -295,6 +325,10 @@ class RenderSystemFpl : public System {
   // render pass.
   bool known_state_ = false;
 
+  // The "lull.Render.ResetState" config value, which is read every pass.
+  // Created once the Config is available.
+  std::unique_ptr<Config::Handle<bool>> reset_state_config_;
+
   // This lets us know if the current render call is being done for the right
   // eye instead of the left eye.
   bool rendering_right_eye_ = false;
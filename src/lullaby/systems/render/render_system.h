@@ -19,6 +19,7 @@ limitations under the License.
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "mathfu/glsl_mappings.h"
 #include "lullaby/generated/render_def_generated.h"
@@ -27,6 +28,7 @@ limitations under the License.
 #include "lullaby/systems/render/texture.h"
 #include "lullaby/systems/text/html_tags.h"
 #include "lullaby/systems/text/text_system.h"
+#include "lullaby/util/hash.h"
 #include "lullaby/util/mesh_data.h"
 #include "lullaby/util/render_view.h"
 #include "lullaby/util/triangle_mesh.h"
@@ -93,6 +95,13 @@ class RenderSystem : public System {
   using Deformation =
       std::function<void(float* data, size_t len, size_t stride)>;
 
+  // Appends the parameters that determine the result of applying a
+  // Deformation to the given (undeformed) vertex data to |key|.  Returns false
+  // if the result shouldn't be cached.
+  using DeformationKey =
+      std::function<bool(const float* data, size_t len, size_t stride,
+                         std::vector<uint8_t>* key)>;
+
   using TextureProcessor = std::function<void(const TexturePtr out_texture)>;
 
   explicit RenderSystem(Registry* registry);
@@ -286,6 +295,15 @@ class RenderSystem : public System {
   // Loads and attaches a mesh to the specified Entity.
   void SetMesh(Entity e, const std::string& file);
 
+  // Attaches a chain of lower level-of-detail meshes to |entity| which replace
+  // its mesh as it gets smaller on screen: |lods[i]| is drawn when the entity's
+  // bounding sphere covers less than |screen_sizes[i]| of the view's height.
+  // |screen_sizes| must be decreasing and the same length as |lods|.  Setting
+  // a new mesh on |entity| clears its LODs.  See GenerateMeshLods() in
+  // mesh_simplification.h for creating |lods|.
+  void SetMeshLods(Entity entity, const std::vector<MeshData>& lods,
+                   const std::vector<float>& screen_sizes);
+
   // Returns |entity|'s shader, or nullptr if it isn't known to RenderSystem.
   ShaderPtr GetShader(Entity entity) const;
 
@@ -334,6 +352,14 @@ class RenderSystem : public System {
   // deformation function.
   void SetDeformationFunction(Entity e, const Deformation& deform);
 
+  // Specifies a function used to identify the result of |e|'s deformation.
+  // Dynamically generated meshes that have the same undeformed vertices and
+  // indices and the same deformation key share a single deformed mesh instead
+  // of each being deformed separately.  The key must change whenever the
+  // deformation function would produce different results.  Keys are compared
+  // in full, so they only need to be unique, not well distributed.
+  void SetDeformationKeyFunction(Entity e, const DeformationKey& key);
+
   // Stops rendering the entity.
   void Hide(Entity e);
 
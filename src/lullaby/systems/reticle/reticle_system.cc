@@ -197,6 +197,7 @@ void ReticleSystem::PostCreateInit(Entity entity, HashValue type,
 void ReticleSystem::Destroy(Entity entity) {
   if (reticle_ && reticle_->GetEntity() == entity) {
     reticle_.reset();
+    raycast_cache_.Clear();
   }
 
   reticle_behaviours_.Destroy(entity);
@@ -254,7 +255,7 @@ void ReticleSystem::AdvanceFrame(const Clock::duration& delta_time) {
   if (reticle_->locked_target == kNullEntity) {
     // Not locked on to a target, so collision check and set reticle position.
     const auto collision =
-        collision_system->CheckForCollision(reticle_->collision_ray);
+        raycast_cache_.Raycast(collision_system, reticle_->collision_ray);
     const float depth = collision.distance;
     targeted_entity = collision.entity;
 
@@ -25,6 +25,7 @@ limitations under the License.
 #include "lullaby/base/component.h"
 #include "lullaby/base/input_manager.h"
 #include "lullaby/base/system.h"
+#include "lullaby/systems/collision/raycast_cache.h"
 #include "lullaby/util/clock.h"
 #include "lullaby/util/math.h"
 
@@ -80,6 +81,10 @@ class ReticleSystem : public System {
   /// Pass kNullEntity to return ReticleSystem to normal behavior.
   void LockOn(Entity entity, const mathfu::vec3& offset);
 
+  /// Returns the cache used for the reticle's raycasts, eg. to monitor its hit
+  /// rate.
+  const RaycastCache& GetRaycastCache() const { return raycast_cache_; }
+
  private:
   struct Reticle : Component {
     explicit Reticle(Entity entity);
@@ -152,6 +157,7 @@ class ReticleSystem : public System {
   bool IsInsideEntityDeadZone(Entity collided_entity) const;
   std::unique_ptr<Reticle> reticle_;
   ComponentPool<ReticleBehaviour> reticle_behaviours_;
+  RaycastCache raycast_cache_;
 };
 
 }  // namespace lull
@@ -0,0 +1,284 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/systems/scroll/scroll_virtual_layout_system.h"
+
+#include <algorithm>
+
+#include "lullaby/generated/scroll_def_generated.h"
+#include "lullaby/base/dispatcher.h"
+#include "lullaby/events/scroll_events.h"
+#include "lullaby/systems/scroll/scroll_system.h"
+#include "lullaby/systems/transform/transform_system.h"
+
+namespace lull {
+namespace {
+
+const HashValue kScrollVirtualLayoutDefHash = Hash("ScrollVirtualLayoutDef");
+
+// Returns the position of the leading (top or left) edge of the view and the
+// length of the view along the layout axis.
+void GetViewSpan(const Aabb* aabb, bool horizontal, float* lead,
+                 float* length) {
+  if (aabb == nullptr) {
+    *lead = 0.f;
+    *length = 0.f;
+  } else if (horizontal) {
+    *lead = aabb->min.x;
+    *length = aabb->max.x - aabb->min.x;
+  } else {
+    *lead = aabb->max.y;
+    *length = aabb->max.y - aabb->min.y;
+  }
+}
+
+// Returns the distance the view has scrolled along the layout axis.
+float GetScrollPosition(const mathfu::vec2& view_offset, bool horizontal) {
+  return horizontal ? view_offset.x : -view_offset.y;
+}
+
+}  // namespace
+
+ScrollVirtualLayoutSystem::ScrollVirtualLayoutSystem(Registry* registry)
+    : System(registry), layouts_(4) {
+  RegisterDef(this, kScrollVirtualLayoutDefHash);
+  RegisterDependency<ScrollSystem>(this);
+  RegisterDependency<TransformSystem>(this);
+
+  Dispatcher* dispatcher = registry_->Get<Dispatcher>();
+  dispatcher->Connect(this, [this](const ScrollOffsetChanged& event) {
+    VirtualLayout* layout = layouts_.Get(event.target);
+    if (layout) {
+      UpdateCells(layout, event.new_offset);
+    }
+  });
+}
+
+ScrollVirtualLayoutSystem::~ScrollVirtualLayoutSystem() {
+  Dispatcher* dispatcher = registry_->Get<Dispatcher>();
+  dispatcher->DisconnectAll(this);
+}
+
+void ScrollVirtualLayoutSystem::Create(Entity entity, HashValue type,
+                                       const Def* def) {
+  if (type != kScrollVirtualLayoutDefHash) {
+    LOG(DFATAL)
+        << "Invalid type passed to Create. Expecting ScrollVirtualLayoutDef!";
+    return;
+  }
+  const auto* data = ConvertDef<ScrollVirtualLayoutDef>(def);
+
+  VirtualLayout* layout = layouts_.Emplace(entity);
+  if (data->cell_blueprint()) {
+    layout->cell_blueprint = data->cell_blueprint()->c_str();
+  }
+  layout->horizontal = data->horizontal();
+  layout->spacing = data->spacing();
+  layout->margin = data->margin();
+}
+
+void ScrollVirtualLayoutSystem::Destroy(Entity entity) {
+  layouts_.Destroy(entity);
+}
+
+void ScrollVirtualLayoutSystem::SetDataSource(Entity entity,
+                                              DataSource source) {
+  VirtualLayout* layout = layouts_.Get(entity);
+  if (layout == nullptr) {
+    LOG(DFATAL) << "No virtual layout for entity: " << entity;
+    return;
+  }
+  layout->source = std::move(source);
+  NotifyDataChanged(entity);
+}
+
+void ScrollVirtualLayoutSystem::NotifyDataChanged(Entity entity) {
+  VirtualLayout* layout = layouts_.Get(entity);
+  if (layout == nullptr) {
+    return;
+  }
+
+  // Item positions may have changed, so unbind every cell and start over.
+  for (const auto& iter : layout->bound_cells) {
+    RecycleCell(layout, iter.second);
+  }
+  layout->bound_cells.clear();
+
+  UpdateItems(layout);
+
+  const ScrollSystem* scroll_system = registry_->Get<ScrollSystem>();
+  UpdateCells(layout, scroll_system->GetViewOffset(entity));
+}
+
+Entity ScrollVirtualLayoutSystem::GetCell(Entity entity, size_t index) const {
+  const VirtualLayout* layout = layouts_.Get(entity);
+  if (layout == nullptr) {
+    return kNullEntity;
+  }
+  const auto iter = layout->bound_cells.find(index);
+  return iter != layout->bound_cells.end() ? iter->second : kNullEntity;
+}
+
+size_t ScrollVirtualLayoutSystem::GetNumCells(Entity entity) const {
+  const VirtualLayout* layout = layouts_.Get(entity);
+  return layout ? layout->num_cells : 0;
+}
+
+void ScrollVirtualLayoutSystem::UpdateItems(VirtualLayout* layout) {
+  const DataSource& source = layout->source;
+  layout->starts.resize(source.count);
+  layout->extents.resize(source.count);
+
+  float length = 0.f;
+  for (size_t i = 0; i < source.count; ++i) {
+    const float extent = source.get_extent ? source.get_extent(i) : 0.f;
+    if (i > 0) {
+      length += layout->spacing;
+    }
+    layout->starts[i] = length;
+    layout->extents[i] = std::max(extent, 0.f);
+    length += layout->extents[i];
+  }
+
+  const Entity entity = layout->GetEntity();
+  const TransformSystem* transform_system = registry_->Get<TransformSystem>();
+  float lead = 0.f;
+  float view_length = 0.f;
+  GetViewSpan(transform_system->GetAabb(entity), layout->horizontal, &lead,
+              &view_length);
+
+  // Allow scrolling until the end of the last item reaches the trailing edge
+  // of the view.
+  const float scroll_length = std::max(length - view_length, 0.f);
+  Aabb bounds;
+  if (layout->horizontal) {
+    bounds.max.x = scroll_length;
+  } else {
+    bounds.min.y = -scroll_length;
+  }
+  ScrollSystem* scroll_system = registry_->Get<ScrollSystem>();
+  scroll_system->SetContentBounds(entity, bounds);
+}
+
+void ScrollVirtualLayoutSystem::UpdateCells(VirtualLayout* layout,
+                                            const mathfu::vec2& view_offset) {
+  const TransformSystem* transform_system = registry_->Get<TransformSystem>();
+  float lead = 0.f;
+  float view_length = 0.f;
+  GetViewSpan(transform_system->GetAabb(layout->GetEntity()),
+              layout->horizontal, &lead, &view_length);
+
+  const float position = GetScrollPosition(view_offset, layout->horizontal);
+  const float begin = position - layout->margin;
+  const float end = position + view_length + layout->margin;
+
+  // Items are sorted by their start, so the visible items are those starting
+  // before |end|, less those that also finish before |begin|.
+  const auto& starts = layout->starts;
+  size_t first = static_cast<size_t>(
+      std::upper_bound(starts.begin(), starts.end(), begin) - starts.begin());
+  if (first > 0) {
+    --first;
+  }
+  if (first < starts.size() &&
+      starts[first] + layout->extents[first] <= begin) {
+    ++first;
+  }
+  const size_t last = static_cast<size_t>(
+      std::lower_bound(starts.begin(), starts.end(), end) - starts.begin());
+
+  for (auto iter = layout->bound_cells.begin();
+       iter != layout->bound_cells.end();) {
+    if (iter->first < first || iter->first >= last) {
+      RecycleCell(layout, iter->second);
+      iter = layout->bound_cells.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  for (size_t i = first; i < last; ++i) {
+    if (layout->bound_cells.count(i) != 0) {
+      continue;
+    }
+    const Entity cell = AcquireCell(layout);
+    if (cell == kNullEntity) {
+      break;
+    }
+    layout->bound_cells.emplace(i, cell);
+    PlaceCell(layout, cell, i);
+    if (layout->source.bind) {
+      layout->source.bind(cell, i);
+    }
+  }
+}
+
+void ScrollVirtualLayoutSystem::RecycleCell(VirtualLayout* layout,
+                                            Entity cell) {
+  TransformSystem* transform_system = registry_->Get<TransformSystem>();
+  transform_system->Disable(cell);
+  layout->free_cells.push_back(cell);
+}
+
+Entity ScrollVirtualLayoutSystem::AcquireCell(VirtualLayout* layout) {
+  TransformSystem* transform_system = registry_->Get<TransformSystem>();
+  if (!layout->free_cells.empty()) {
+    const Entity cell = layout->free_cells.back();
+    layout->free_cells.pop_back();
+    transform_system->Enable(cell);
+    return cell;
+  }
+
+  const Entity cell = transform_system->CreateChild(layout->GetEntity(),
+                                                    layout->cell_blueprint);
+  if (cell == kNullEntity) {
+    LOG(WARNING) << "Could not create cell from blueprint: "
+                 << layout->cell_blueprint;
+    return kNullEntity;
+  }
+  ++layout->num_cells;
+  return cell;
+}
+
+void ScrollVirtualLayoutSystem::PlaceCell(const VirtualLayout* layout,
+                                          Entity cell, size_t index) {
+  const Entity entity = layout->GetEntity();
+  TransformSystem* transform_system = registry_->Get<TransformSystem>();
+  const Sqt* cell_sqt = transform_system->GetSqt(cell);
+  if (cell_sqt == nullptr) {
+    return;
+  }
+  float lead = 0.f;
+  float view_length = 0.f;
+  GetViewSpan(transform_system->GetAabb(entity), layout->horizontal, &lead,
+              &view_length);
+
+  // The scroll view translates its children by the negative of the view
+  // offset that it has applied so far, so new cells must be placed likewise.
+  const ScrollSystem* scroll_system = registry_->Get<ScrollSystem>();
+  const mathfu::vec2 view_offset = scroll_system->GetViewOffset(entity);
+  const float center = layout->starts[index] + 0.5f * layout->extents[index];
+
+  Sqt sqt = *cell_sqt;
+  if (layout->horizontal) {
+    sqt.translation.x = lead + center - view_offset.x;
+  } else {
+    sqt.translation.y = lead - center - view_offset.y;
+  }
+  transform_system->SetSqt(cell, sqt);
+}
+
+}  // namespace lull
@@ -0,0 +1,122 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_SYSTEMS_SCROLL_SCROLL_VIRTUAL_LAYOUT_SYSTEM_H_
+#define LULLABY_SYSTEMS_SCROLL_SCROLL_VIRTUAL_LAYOUT_SYSTEM_H_
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "lullaby/base/component.h"
+#include "lullaby/base/system.h"
+#include "lullaby/util/math.h"
+
+namespace lull {
+
+// Extends the ScrollSystem with a virtualized list.  Instead of requiring an
+// entity for every item (as the LayoutSystem and ScrollContentLayoutSystem
+// do), the items are described by a DataSource and entities ("cells") are only
+// created for the items that intersect the scroll view's Aabb plus a margin.
+// Cells that scroll out of view are disabled and reused for the next item that
+// scrolls into view, so the number of entities is bounded by the size of the
+// view rather than the number of items.
+//
+// Items are laid out along a single axis starting at the top (or left) edge of
+// the scroll view's Aabb, and the scroll view's content bounds are set to fit
+// them.  Each cell is positioned such that its origin is at the center of its
+// item.
+class ScrollVirtualLayoutSystem : public System {
+ public:
+  // Describes the items shown by a virtual layout.
+  struct DataSource {
+    // The number of items.
+    size_t count = 0;
+
+    // Returns the extent of the item at |index| along the layout axis.
+    std::function<float(size_t index)> get_extent;
+
+    // Called whenever |cell| is assigned to show the item at |index|, eg. to
+    // set its text or texture.
+    std::function<void(Entity cell, size_t index)> bind;
+  };
+
+  explicit ScrollVirtualLayoutSystem(Registry* registry);
+  ~ScrollVirtualLayoutSystem() override;
+
+  void Create(Entity entity, HashValue type, const Def* def) override;
+  void Destroy(Entity entity) override;
+
+  // Sets the |source| of the items shown by |entity|'s virtual layout.
+  void SetDataSource(Entity entity, DataSource source);
+
+  // Updates |entity|'s virtual layout after the number or extents of the items
+  // in its data source have changed.  All visible cells are rebound.
+  void NotifyDataChanged(Entity entity);
+
+  // Returns the cell showing the item at |index| in |entity|'s virtual layout,
+  // or kNullEntity if the item is not currently instantiated.
+  Entity GetCell(Entity entity, size_t index) const;
+
+  // Returns the number of cells (both bound and recycled) that have been
+  // created for |entity|'s virtual layout.
+  size_t GetNumCells(Entity entity) const;
+
+ private:
+  struct VirtualLayout : Component {
+    explicit VirtualLayout(Entity entity) : Component(entity) {}
+
+    std::string cell_blueprint;
+    bool horizontal = false;
+    float spacing = 0.f;
+    float margin = 0.f;
+    DataSource source;
+
+    // The start and extent of each item along the layout axis.
+    std::vector<float> starts;
+    std::vector<float> extents;
+
+    // The cells currently bound to items, keyed by item index.
+    std::unordered_map<size_t, Entity> bound_cells;
+
+    // Disabled cells that are waiting to be bound to another item.
+    std::vector<Entity> free_cells;
+
+    size_t num_cells = 0;
+  };
+
+  using VirtualLayoutPool = ComponentPool<VirtualLayout>;
+
+  // Recomputes the item positions and the scroll view's content bounds.
+  void UpdateItems(VirtualLayout* layout);
+
+  // Binds cells to the items that are visible at |view_offset| and recycles
+  // the cells of the items that are not.
+  void UpdateCells(VirtualLayout* layout, const mathfu::vec2& view_offset);
+
+  void RecycleCell(VirtualLayout* layout, Entity cell);
+  Entity AcquireCell(VirtualLayout* layout);
+  void PlaceCell(const VirtualLayout* layout, Entity cell, size_t index);
+
+  VirtualLayoutPool layouts_;
+};
+
+}  // namespace lull
+
+LULLABY_SETUP_TYPEID(lull::ScrollVirtualLayoutSystem);
+
+#endif  // LULLABY_SYSTEMS_SCROLL_SCROLL_VIRTUAL_LAYOUT_SYSTEM_H_
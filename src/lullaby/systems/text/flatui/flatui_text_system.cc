@@ -55,6 +55,9 @@ constexpr const char* kTextureSizeUniform = "texture_size";
 
 constexpr float kMetersFromMillimeters = .001f;
 
+// Maximum estimated size of unused text layouts kept for reuse.
+constexpr size_t kMaxTextBufferCacheBytes = 1024 * 1024;
+
 // Flatui sdf textures have white glyphs.
 constexpr float kSdfDistOffset = 0.0f;
 constexpr float kSdfDistScale = 1.0f;
@@ -114,7 +117,9 @@ static int32_t GetGlyphSizeForTextSize(int32_t size) {
 }
 
 FlatuiTextSystem::FlatuiTextSystem(Registry* registry)
-    : TextSystemImpl(registry), components_(kDefaultPoolSize) {
+    : TextSystemImpl(registry),
+      components_(kDefaultPoolSize),
+      text_buffer_cache_(kMaxTextBufferCacheBytes) {
   // Initialize the renderer so it knows the device capabilities for flatui's
   // texture creation.
   renderer_.Initialize(/* window_size = */ mathfu::kZeros2i,
@@ -147,6 +152,7 @@ FlatuiTextSystem::~FlatuiTextSystem() {
   for (auto& component : components_) {
     component.buffer.reset();
   }
+  text_buffer_cache_.Clear();
 
   // As commented above, explicitly release completed tasks so that TextBuffers
   // are release before flatui::FontManager is destroyed implicitly upon leaving
@@ -344,6 +350,10 @@ void FlatuiTextSystem::ProcessTasks() {
   while (task_queue_.Dequeue(&task)) {
     --num_pending_tasks_;
     task->Finalize();
+    if (!task->GetCacheKey().data.empty() && !task->IsFromCache()) {
+      text_buffer_cache_.Insert(task->GetCacheKey(),
+                                task->GetOutputTextBuffer());
+    }
     const Entity entity = task->GetTarget();
     TextComponent* component = components_.Get(entity);
     if (component && task->GetOutputTextBuffer()) {
@@ -352,6 +362,9 @@ void FlatuiTextSystem::ProcessTasks() {
       // is ready.  We can't rely just on OutputTextBuffer()->IsReady(), as that
       // doesn't assure that the texture has been assigned an ID yet.
       completed_tasks_.push_back(task);
+    } else if (component) {
+      // Generation failed, so there is no buffer to wait for.
+      component->loading_buffer = false;
     }
   }
 
@@ -438,8 +451,20 @@ void FlatuiTextSystem::GenerateText(Entity entity, Entity desired_size_source) {
       params.bounds.y = *y;
     }
   }
+
+  // Reuse an identical layout if there is one.  It still goes through the task
+  // queue so that it can't be overtaken by a previously queued task for this
+  // entity.
+  TextBufferCacheKey cache_key;
+  TextBufferPtr cached_buffer;
+  if (component->font) {
+    cache_key =
+        GetTextBufferCacheKey(*component->font, processed_text, params);
+    cached_buffer = text_buffer_cache_.Find(cache_key);
+  }
   EnqueueTask(TaskPtr(new GenerateTextBufferTask(
-      entity, desired_size_source, component->font, processed_text, params)));
+      entity, desired_size_source, component->font, processed_text, params,
+      cache_key, std::move(cached_buffer))));
 }
 
 void FlatuiTextSystem::SetFontSize(Entity entity, float size) {
@@ -804,16 +829,23 @@ void FlatuiTextSystem::OnDesiredSizeChanged(
 
 FlatuiTextSystem::GenerateTextBufferTask::GenerateTextBufferTask(
     Entity target_entity, Entity desired_size_source, const FontPtr& font,
-    const std::string& text, const TextBufferParams& params)
+    const std::string& text, const TextBufferParams& params,
+    const TextBufferCacheKey& cache_key, TextBufferPtr cached_text_buffer)
     : target_entity_(target_entity),
       desired_size_source_(desired_size_source),
       font_(font),
       text_(text),
       params_(params),
+      cache_key_(cache_key),
+      from_cache_(cached_text_buffer != nullptr),
       text_buffer_(nullptr),
-      output_text_buffer_(nullptr) {}
+      output_text_buffer_(std::move(cached_text_buffer)) {}
 
 void FlatuiTextSystem::GenerateTextBufferTask::Process() {
+  if (output_text_buffer_) {
+    // A finalized buffer was provided by the cache.
+    return;
+  }
   if (font_ && font_->Bind()) {
     TextBufferPtr buffer =
         TextBuffer::Create(font_->GetFontManager(), text_, params_);
@@ -828,7 +860,7 @@ void FlatuiTextSystem::GenerateTextBufferTask::Finalize() {
   if (text_buffer_) {
     // TODO(b/33705855) Remove Finalize.
     text_buffer_->Finalize();
+    output_text_buffer_ = std::move(text_buffer_);
   }
-  output_text_buffer_ = text_buffer_;
 }
 }  // namespace lull
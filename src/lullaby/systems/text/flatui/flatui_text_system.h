@@ -25,6 +25,7 @@ limitations under the License.
 #include "lullaby/base/async_processor.h"
 #include "lullaby/events/layout_events.h"
 #include "lullaby/systems/text/flatui/text_buffer.h"
+#include "lullaby/systems/text/flatui/text_buffer_cache.h"
 #include "lullaby/systems/text/flatui/text_component.h"
 #include "lullaby/systems/text/text_system.h"
 #include "lullaby/generated/text_def_generated.h"
@@ -80,13 +81,24 @@ class FlatuiTextSystem : public TextSystemImpl {
    public:
     GenerateTextBufferTask(Entity target_entity, Entity desired_size_source,
                            const FontPtr& font, const std::string& text,
-                           const TextBufferParams& params);
+                           const TextBufferParams& params,
+                           const TextBufferCacheKey& cache_key,
+                           TextBufferPtr cached_text_buffer);
 
     Entity GetTarget() const { return target_entity_; }
 
     Entity GetDesiredSizeSource() const { return desired_size_source_; }
 
-    // Called on a worker thread, this initializes the text buffer.
+    // Returns the TextBufferCache key of the output, or an empty key if it
+    // isn't cached.
+    const TextBufferCacheKey& GetCacheKey() const { return cache_key_; }
+
+    // Returns true if the output was found in the TextBufferCache rather than
+    // generated by this task.
+    bool IsFromCache() const { return from_cache_; }
+
+    // Called on a worker thread, this initializes the text buffer unless a
+    // cached one was provided.
     void Process();
 
     // Called on the host thread, this performs post-processing such as
@@ -103,6 +115,8 @@ class FlatuiTextSystem : public TextSystemImpl {
     FontPtr font_;
     std::string text_;
     TextBufferParams params_;
+    TextBufferCacheKey cache_key_;
+    bool from_cache_;
     TextBufferPtr text_buffer_;
     TextBufferPtr output_text_buffer_;
   };
@@ -150,6 +164,11 @@ class FlatuiTextSystem : public TextSystemImpl {
   // array because internally it holds on to flatui::FontBuffers, for example.
   flatui::FontManager font_manager_;
 
+  // Recently generated text buffers, shared between entities with identical
+  // text and layout parameters.  Declared after font_manager_ so that it is
+  // destroyed first.
+  TextBufferCache text_buffer_cache_;
+
   // List of text buffer generation tasks.
   TaskQueue task_queue_;
 
@@ -54,8 +54,11 @@ Font::Font(flatui::FontManager* manager,
 
   // Build list of char*s which point to font_name_list_.
   cstr_names_.reserve(font_name_list_.size());
+  hash_ = kHashOffsetBasis;
   for (const auto& name : font_name_list_) {
     cstr_names_.emplace_back(name.c_str());
+    // Include the terminator so that the list of names is unambiguous.
+    hash_ = HashBytes(name.c_str(), name.size() + 1, hash_);
   }
 }
 
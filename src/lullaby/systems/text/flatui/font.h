@@ -21,6 +21,7 @@ limitations under the License.
 #include <vector>
 
 #include "flatui/font_manager.h"
+#include "lullaby/util/hash.h"
 #include "lullaby/util/typeid.h"
 
 namespace lull {
@@ -35,6 +36,13 @@ class Font {
 
   bool IsEmpty() const { return font_name_list_.empty(); }
 
+  // Returns the prioritized list of font names.
+  const std::vector<std::string>& GetNames() const { return font_name_list_; }
+
+  // Returns a hash of the font names, which identifies the glyphs this font
+  // will produce.
+  HashValue GetHash() const { return hash_; }
+
   // Makes this font active in the FontManager.  All text buffers created after
   // this call will use this font.
   bool Bind();
@@ -49,6 +57,8 @@ class Font {
   // Flatui takes a vector of char*, not std::string.
   std::vector<const char*> cstr_names_;
 
+  HashValue hash_ = 0;
+
   Font(const Font& rhs) = delete;
   Font& operator=(const Font& rhs) = delete;
 };
@@ -126,6 +126,18 @@ TextBuffer::TextBuffer(flatui::FontManager* manager,
 
 TextBuffer::~TextBuffer() { font_manager_->ReleaseBuffer(font_buffer_); }
 
+size_t TextBuffer::GetSizeInBytes() const {
+  // The FontBuffer holds its own copy of the glyph vertices as well as the
+  // per-slice indices, which is roughly the same size as our vertices.
+  size_t size = sizeof(*this) + 2 * vertices_.size() * sizeof(VertexPT);
+  size += underline_vertices_.size() * sizeof(VertexPT);
+  size += caret_positions_.size() * sizeof(mathfu::vec3);
+  for (const LinkTag& link : links_) {
+    size += link.href.size() + link.aabbs.size() * sizeof(Aabb);
+  }
+  return size;
+}
+
 bool TextBuffer::IsReady() const {
   return font_manager_->GetFontBufferStatus(*font_buffer_) ==
          flatui::kFontBufferStatusReady;
@@ -88,6 +88,10 @@ class TextBuffer {
 
   const std::vector<LinkTag>& GetLinks() { return links_; }
 
+  // Returns an estimate of the memory used by this buffer, including the
+  // underlying flatui::FontBuffer.
+  size_t GetSizeInBytes() const;
+
  private:
   TextBuffer(flatui::FontManager* manager, flatui::FontBuffer* buffer,
              const TextBufferParams& params);
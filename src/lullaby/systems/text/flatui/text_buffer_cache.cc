@@ -0,0 +1,60 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/systems/text/flatui/text_buffer_cache.h"
+
+namespace lull {
+namespace {
+
+template <typename T>
+void AppendField(const T& value, std::string* data) {
+  data->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendField(const std::string& value, std::string* data) {
+  // Include the length so that adjacent strings are unambiguous.
+  AppendField(value.size(), data);
+  data->append(value);
+}
+
+}  // namespace
+
+TextBufferCacheKey GetTextBufferCacheKey(const Font& font,
+                                         const std::string& text,
+                                         const TextBufferParams& params) {
+  TextBufferCacheKey key;
+  const std::vector<std::string>& font_names = font.GetNames();
+  AppendField(font_names.size(), &key.data);
+  for (const std::string& name : font_names) {
+    AppendField(name, &key.data);
+  }
+  AppendField(text, &key.data);
+  AppendField(params.ellipsis, &key.data);
+  AppendField(params.bounds.x, &key.data);
+  AppendField(params.bounds.y, &key.data);
+  AppendField(params.font_size, &key.data);
+  AppendField(params.line_height_scale, &key.data);
+  AppendField(params.kerning_scale, &key.data);
+  AppendField(params.horizontal_align, &key.data);
+  AppendField(params.vertical_align, &key.data);
+  AppendField(params.direction, &key.data);
+  AppendField(params.html_mode, &key.data);
+  AppendField(params.wrap_mode, &key.data);
+  key.hash = HashBytes(key.data.data(), key.data.size());
+  return key;
+}
+
+}  // namespace lull
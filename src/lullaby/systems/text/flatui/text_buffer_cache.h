@@ -0,0 +1,183 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_SYSTEMS_TEXT_FLATUI_TEXT_BUFFER_CACHE_H_
+#define LULLABY_SYSTEMS_TEXT_FLATUI_TEXT_BUFFER_CACHE_H_
+
+#include <iterator>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "lullaby/systems/text/flatui/font.h"
+#include "lullaby/systems/text/flatui/text_buffer.h"
+#include "lullaby/util/hash.h"
+
+namespace lull {
+
+// Identifies the layout of a string.  |data| holds the font names, text and
+// layout parameters, and |hash| is a hash of |data|.  The cache is indexed by
+// |hash| but compares |data| on lookup, so that hash collisions never share
+// the wrong layout.
+struct TextBufferCacheKey {
+  HashValue hash = 0;
+  std::string data;
+};
+
+// Returns the key identifying the layout of |text| using |font| and |params|.
+TextBufferCacheKey GetTextBufferCacheKey(const Font& font,
+                                         const std::string& text,
+                                         const TextBufferParams& params);
+
+// Caches finalized TextBuffers so that entities displaying the same string
+// with the same font and layout parameters (eg. list items or recycled scroll
+// cells) share a single layout instead of each re-shaping the text.
+//
+// TextBuffers are reference counted, so a buffer remains alive as long as any
+// component uses it.  The cache additionally keeps recently used buffers alive
+// after their last user releases them, evicting the least recently used unused
+// buffers once the total estimated size exceeds |max_bytes|.  All functions
+// must be called on the same thread.
+//
+// |Buffer| must provide GetSizeInBytes() and IsReady(), as TextBuffer does.
+template <typename Buffer>
+class BasicTextBufferCache {
+ public:
+  using BufferPtr = std::shared_ptr<Buffer>;
+
+  explicit BasicTextBufferCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+  // Returns the buffer associated with |key| and marks it as recently used, or
+  // nullptr if there is none.  Buffers whose glyphs are no longer available in
+  // the font manager's texture atlas are dropped instead of returned.
+  BufferPtr Find(const TextBufferCacheKey& key);
+
+  // Associates a newly generated |buffer|, which must already be finalized,
+  // with |key|, then evicts buffers as needed to stay within the size limit.
+  // Buffers returned by Find() don't need to be inserted again.
+  // If a buffer with a different key but the same hash is already cached, it
+  // is replaced.
+  void Insert(const TextBufferCacheKey& key, const BufferPtr& buffer);
+
+  // Releases all buffers held by the cache.
+  void Clear();
+
+  // Returns the estimated size of all buffers held by the cache.
+  size_t GetSizeInBytes() const { return num_bytes_; }
+
+  // Returns the number of buffers held by the cache.
+  size_t Size() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    TextBufferCacheKey key;
+    BufferPtr buffer;
+    size_t num_bytes;
+  };
+  using EntryList = std::list<Entry>;
+
+  void Erase(typename EntryList::iterator iter);
+  void Evict();
+
+  // Entries in most to least recently used order.
+  EntryList entries_;
+  std::unordered_map<HashValue, typename EntryList::iterator> index_;
+  size_t max_bytes_;
+  size_t num_bytes_ = 0;
+
+  BasicTextBufferCache(const BasicTextBufferCache&) = delete;
+  BasicTextBufferCache& operator=(const BasicTextBufferCache&) = delete;
+};
+
+using TextBufferCache = BasicTextBufferCache<TextBuffer>;
+
+template <typename Buffer>
+typename BasicTextBufferCache<Buffer>::BufferPtr
+BasicTextBufferCache<Buffer>::Find(const TextBufferCacheKey& key) {
+  auto iter = index_.find(key.hash);
+  if (iter == index_.end()) {
+    return nullptr;
+  }
+
+  const typename EntryList::iterator entry = iter->second;
+  if (entry->key.data != key.data) {
+    return nullptr;
+  }
+  if (!entry->buffer->IsReady()) {
+    Erase(entry);
+    return nullptr;
+  }
+
+  entries_.splice(entries_.begin(), entries_, entry);
+  return entry->buffer;
+}
+
+template <typename Buffer>
+void BasicTextBufferCache<Buffer>::Insert(const TextBufferCacheKey& key,
+                                          const BufferPtr& buffer) {
+  if (!buffer) {
+    return;
+  }
+
+  auto iter = index_.find(key.hash);
+  if (iter != index_.end()) {
+    Erase(iter->second);
+  }
+
+  Entry entry;
+  entry.key = key;
+  entry.buffer = buffer;
+  entry.num_bytes = buffer->GetSizeInBytes();
+  num_bytes_ += entry.num_bytes;
+  entries_.push_front(std::move(entry));
+  index_[key.hash] = entries_.begin();
+
+  Evict();
+}
+
+template <typename Buffer>
+void BasicTextBufferCache<Buffer>::Clear() {
+  index_.clear();
+  entries_.clear();
+  num_bytes_ = 0;
+}
+
+template <typename Buffer>
+void BasicTextBufferCache<Buffer>::Erase(typename EntryList::iterator iter) {
+  num_bytes_ -= iter->num_bytes;
+  index_.erase(iter->key.hash);
+  entries_.erase(iter);
+}
+
+template <typename Buffer>
+void BasicTextBufferCache<Buffer>::Evict() {
+  // Buffers that are still in use elsewhere cost nothing extra to keep, so
+  // only evict the ones that are held by the cache alone.
+  auto iter = entries_.end();
+  while (num_bytes_ > max_bytes_ && iter != entries_.begin()) {
+    --iter;
+    if (iter->buffer.use_count() == 1) {
+      const typename EntryList::iterator next = std::next(iter);
+      Erase(iter);
+      iter = next;
+    }
+  }
+}
+
+}  // namespace lull
+
+#endif  // LULLABY_SYSTEMS_TEXT_FLATUI_TEXT_BUFFER_CACHE_H_
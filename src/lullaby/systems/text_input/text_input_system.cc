@@ -26,6 +26,7 @@ limitations under the License.
 #include "lullaby/systems/dispatcher/dispatcher_system.h"
 #include "lullaby/systems/dispatcher/event.h"
 #include "lullaby/systems/render/render_system.h"
+#include "lullaby/systems/text/text_system.h"
 #include "lullaby/systems/transform/transform_system.h"
 #include "lullaby/util/logging.h"
 #include "lullaby/util/math.h"
@@ -104,6 +105,12 @@ void TextInputSystem::Create(Entity e, HashValue type, const Def* def) {
   SetComposingIndices(e, 0, 0);
 
   auto text_ready_handler = [this](const TextReadyEvent& event) {
+    auto* input = inputs_.Get(event.target);
+    if (input) {
+      input->layout_pending = false;
+    }
+    // Lay out any edits made while the previous layout was in progress.
+    LayoutText(event.target);
     UpdateCaret(event.target);
     UpdateComposingIndicator(event.target);
   };
@@ -127,6 +134,11 @@ void TextInputSystem::Create(Entity e, HashValue type, const Def* def) {
     if (!input || input->text.empty()) {
       return;
     }
+    // The caret positions belong to an older version of the text, so they
+    // can't be mapped to an index in the current one.
+    if (!IsLayoutCurrent(*input)) {
+      return;
+    }
     const std::vector<mathfu::vec3>* positions =
         registry_->Get<RenderSystem>()->GetCaretPositions(event.target);
     const size_t caret_index_from_position =
@@ -195,6 +207,20 @@ void TextInputSystem::Deactivate() {
 }
 
 void TextInputSystem::AdvanceFrame(const Clock::duration& delta_time) {
+  const auto* text_system = registry_->Get<TextSystem>();
+  for (TextInput& input : inputs_) {
+    const Entity e = input.GetEntity();
+    if (input.needs_layout) {
+      LayoutText(e);
+    } else if (input.layout_pending && text_system &&
+               text_system->IsTextReady(e)) {
+      // The layout finished without a TextReadyEvent, eg. because it failed.
+      input.layout_pending = false;
+      UpdateCaret(e);
+      UpdateComposingIndicator(e);
+    }
+  }
+
   auto input_manager = registry_->Get<InputManager>();
   if (!input_manager->IsConnected(InputManager::kKeyboard)) {
     return;
@@ -269,8 +295,10 @@ void TextInputSystem::SetText(Entity e, const std::string& text) {
 
   if (input->text.str() != text) {
     input->text.SetText(text);
-    SetCaretIndex(e, input->text.CharSize());
+    // Send the text for layout first, so the caret isn't placed using the
+    // caret positions of the old text.
     UpdateText(e);
+    SetCaretIndex(e, input->text.CharSize());
   }
 }
 
@@ -368,7 +396,7 @@ void TextInputSystem::UpdateComposingIndicator(Entity e) {
     return;
   }
 
-  if (input->composing_entity == kNullEntity) {
+  if (input->composing_entity == kNullEntity || !IsLayoutCurrent(*input)) {
     return;
   }
 
@@ -389,7 +417,7 @@ void TextInputSystem::UpdateComposingIndicator(Entity e) {
       const std::vector<mathfu::vec3>* caret_positions =
           render_system->GetCaretPositions(e);
 
-      if (!caret_positions) {
+      if (!caret_positions || end_index >= caret_positions->size()) {
         return;
       }
 
@@ -459,6 +487,28 @@ void TextInputSystem::UpdateText(Entity e) {
     }
   }
 
+  input->needs_layout = true;
+  LayoutText(e);
+}
+
+void TextInputSystem::LayoutText(Entity e) {
+  TextInput* input = inputs_.Get(e);
+  if (!input || !input->needs_layout) {
+    return;
+  }
+
+  // Laying out long text can take longer than a frame, so only keep one layout
+  // in flight.  Edits made in the meantime are laid out together once it
+  // completes, rather than queueing a layout per keystroke.
+  const auto* text_system = registry_->Get<TextSystem>();
+  if (text_system && !text_system->IsTextReady(e)) {
+    return;
+  }
+  input->needs_layout = false;
+  // Set before sending the text, since the TextReadyEvent may be sent before
+  // SetText returns.
+  input->layout_pending = text_system != nullptr;
+
   auto render_system = registry_->Get<RenderSystem>();
   // Show hint if the text is empty.
   if (input->text.empty()) {
@@ -477,6 +527,10 @@ void TextInputSystem::UpdateText(Entity e) {
   }
 }
 
+bool TextInputSystem::IsLayoutCurrent(const TextInput& input) {
+  return !input.needs_layout && !input.layout_pending;
+}
+
 void TextInputSystem::SetCaretIndex(Entity e, size_t index) {
   TextInput* input = inputs_.Get(e);
   if (!input) {
@@ -498,6 +552,11 @@ void TextInputSystem::UpdateCaret(Entity e) {
     return;
   }
 
+  // The caret is placed once the current text has been laid out.
+  if (!IsLayoutCurrent(*input)) {
+    return;
+  }
+
   auto* render_system = registry_->Get<RenderSystem>();
   const std::vector<mathfu::vec3>* caret_positions =
       render_system->GetCaretPositions(e);
@@ -148,12 +148,22 @@ class TextInputSystem : public System {
     float composing_distance = 0.f;
     float composing_thickness = 0.f;
     bool is_clipped = false;
+    // Set when the text has changed since it was last sent for layout.
+    bool needs_layout = false;
+    // Set while the text sent for layout is still being laid out.
+    bool layout_pending = false;
     Dispatcher::ScopedConnection text_ready_connection;
     Dispatcher::ScopedConnection aabb_changed_connection;
   };
 
   void SendTextChangedEvent();
   void UpdateText(Entity e);
+  // Sends the current text (or hint) to the render system if it has changed
+  // and the previous layout has completed.
+  void LayoutText(Entity e);
+  // Returns true if the caret positions from the render system match the
+  // current text, ie. no edits are waiting for or undergoing layout.
+  static bool IsLayoutCurrent(const TextInput& input);
   void SetCaretIndex(Entity e, size_t index);
   void UpdateCaret(Entity e);
   void UpdateComposingIndicator(Entity e);
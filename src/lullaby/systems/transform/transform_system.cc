@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "lullaby/systems/transform/transform_system.h"
 
+#include "lullaby/base/buffer_serializer.h"
 #include "lullaby/base/dispatcher.h"
 #include "lullaby/base/entity_factory.h"
 #include "lullaby/events/entity_events.h"
@@ -23,6 +24,7 @@ limitations under the License.
 #include "lullaby/util/function_binder.h"
 #include "lullaby/util/logging.h"
 #include "lullaby/util/mathfu_fb_conversions.h"
+#include "lullaby/util/trace.h"
 #include "lullaby/generated/transform_def_generated.h"
 
 namespace {
@@ -53,12 +55,22 @@ const TransformSystem::TransformFlags TransformSystem::kInvalidFlag = 0;
 const TransformSystem::TransformFlags TransformSystem::kAllFlags = ~0;
 const HashValue kTransformDefHash = Hash("TransformDef");
 
+// The version of the data written by TransformSystem::SaveSnapshot.
+const uint32_t kSnapshotVersion = 1;
+
+// The size of each Entity's data in a snapshot, excluding its children.
+const size_t kSnapshotEntrySize =
+    2 * sizeof(Entity) + 6 * sizeof(mathfu::vec3) + sizeof(mathfu::quat) +
+    2 * sizeof(bool) + sizeof(Bits) + sizeof(mathfu::mat4) + sizeof(size_t);
+
 TransformSystem::TransformSystem(Registry* registry)
     : System(registry),
       nodes_(16),
       world_transforms_(16),
       disabled_transforms_(16),
-      reserved_flags_(0) {
+      reserved_flags_(0),
+      change_counts_(),
+      subtree_index_enabled_(false) {
   RegisterDef(this, kTransformDefHash);
 
   EntityFactory* entity_factory = registry_->Get<EntityFactory>();
@@ -274,22 +286,131 @@ void TransformSystem::Destroy(Entity e) {
     }
 
     nodes_.Destroy(e);
+    UpdateSubtreeIndex();
+  }
+  const auto transform = GetWorldTransform(e);
+  if (transform) {
+    MarkChanged(transform->flags);
   }
   world_transforms_.Destroy(e);
   disabled_transforms_.Destroy(e);
 }
 
+uint32_t TransformSystem::GetSnapshotVersion() const {
+  return kSnapshotVersion;
+}
+
+void TransformSystem::SaveSnapshot(SaveToBuffer* serializer) {
+  // Make sure the saved world transforms match the local ones.
+  UpdateDeferredTransforms();
+
+  const WorldTransform kNoWorldTransform(kNullEntity);
+  size_t count = nodes_.Size();
+  (*serializer)(&count, 0);
+  for (const GraphNode& node : nodes_) {
+    const Entity entity = node.GetEntity();
+    const bool enabled = world_transforms_.Get(entity) != nullptr;
+    const WorldTransform* world_transform = GetWorldTransform(entity);
+    if (world_transform == nullptr) {
+      world_transform = &kNoWorldTransform;
+    }
+
+    (*serializer)(&entity, 0);
+    (*serializer)(&node.parent, 0);
+    (*serializer)(&node.local_sqt.translation, 0);
+    (*serializer)(&node.local_sqt.rotation, 0);
+    (*serializer)(&node.local_sqt.scale, 0);
+    (*serializer)(&node.aabb_padding.min, 0);
+    (*serializer)(&node.aabb_padding.max, 0);
+    (*serializer)(&node.enable_self, 0);
+    (*serializer)(&enabled, 0);
+    (*serializer)(&world_transform->flags, 0);
+    (*serializer)(&world_transform->world_from_entity_mat, 0);
+    (*serializer)(&world_transform->box.min, 0);
+    (*serializer)(&world_transform->box.max, 0);
+    (*serializer)(&node.children, 0);
+  }
+}
+
+bool TransformSystem::LoadSnapshot(LoadFromBuffer* serializer) {
+  size_t count = 0;
+  if (serializer->Remaining() < sizeof(count)) {
+    LOG(ERROR) << "Transform snapshot is truncated.";
+    return false;
+  }
+  (*serializer)(&count, 0);
+
+  bool success = true;
+  for (size_t i = 0; i < count; ++i) {
+    if (serializer->Remaining() < kSnapshotEntrySize) {
+      LOG(ERROR) << "Transform snapshot is truncated.";
+      success = false;
+      break;
+    }
+
+    Entity entity = kNullEntity;
+    (*serializer)(&entity, 0);
+    GraphNode* node = nodes_.Emplace(entity);
+    if (node == nullptr) {
+      LOG(DFATAL) << "Transform already exists for entity: " << entity;
+      success = false;
+      break;
+    }
+    node->world_from_entity_matrix_function = CalculateWorldFromEntityMatrix;
+    (*serializer)(&node->parent, 0);
+    (*serializer)(&node->local_sqt.translation, 0);
+    (*serializer)(&node->local_sqt.rotation, 0);
+    (*serializer)(&node->local_sqt.scale, 0);
+    (*serializer)(&node->aabb_padding.min, 0);
+    (*serializer)(&node->aabb_padding.max, 0);
+    (*serializer)(&node->enable_self, 0);
+
+    bool enabled = true;
+    (*serializer)(&enabled, 0);
+    auto& world_transforms = enabled ? world_transforms_ : disabled_transforms_;
+    WorldTransform* world_transform = world_transforms.Emplace(entity);
+    if (world_transform == nullptr) {
+      LOG(DFATAL) << "Transform already exists for entity: " << entity;
+      nodes_.Destroy(entity);
+      success = false;
+      break;
+    }
+    (*serializer)(&world_transform->flags, 0);
+    (*serializer)(&world_transform->world_from_entity_mat, 0);
+    (*serializer)(&world_transform->box.min, 0);
+    (*serializer)(&world_transform->box.max, 0);
+    MarkChanged(world_transform->flags);
+
+    size_t num_children = 0;
+    (*serializer)(&num_children, 0);
+    if (num_children > serializer->Remaining() / sizeof(Entity)) {
+      LOG(ERROR) << "Transform snapshot is truncated.";
+      success = false;
+      break;
+    }
+    node->children.resize(num_children);
+    for (Entity& child : node->children) {
+      (*serializer)(&child, 0);
+    }
+  }
+
+  UpdateSubtreeIndex();
+  return success;
+}
+
 void TransformSystem::SetFlag(Entity e, TransformFlags flag) {
   auto transform = GetWorldTransform(e);
-  if (transform) {
+  if (transform && !CheckBit(transform->flags, flag)) {
     transform->flags = SetBit(transform->flags, flag);
+    MarkChanged(flag);
   }
 }
 
 void TransformSystem::ClearFlag(Entity e, TransformFlags flag) {
   auto transform = GetWorldTransform(e);
-  if (transform) {
+  if (transform && CheckBit(transform->flags, flag)) {
     transform->flags = ClearBit(transform->flags, flag);
+    MarkChanged(flag);
   }
 }
 
@@ -308,6 +429,7 @@ void TransformSystem::SetAabb(Entity e, Aabb box) {
       transform->box.min += node->aabb_padding.min;
       transform->box.max += node->aabb_padding.max;
     }
+    MarkChanged(transform->flags);
   }
 
   SendEvent(registry_, e, AabbChangedEvent(e));
@@ -328,6 +450,7 @@ void TransformSystem::SetAabbPadding(Entity e, const Aabb& padding) {
   if (transform) {
     transform->box.min += -node->aabb_padding.min + padding.min;
     transform->box.max += -node->aabb_padding.max + padding.max;
+    MarkChanged(transform->flags);
   }
 
   node->aabb_padding = padding;
@@ -362,6 +485,52 @@ void TransformSystem::SetSqt(Entity e, const Sqt& sqt) {
   }
 }
 
+void TransformSystem::SetSqtDeferred(Entity e, const Sqt& sqt) {
+  auto node = nodes_.Get(e);
+  if (node) {
+    node->local_sqt = sqt;
+    if (!node->deferred_update) {
+      node->deferred_update = true;
+      deferred_updates_.push_back(e);
+    }
+  }
+}
+
+void TransformSystem::UpdateDeferredTransforms() {
+  // Only update the entities that don't have an ancestor that is also pending,
+  // since updating that ancestor will update the entire subtree anyway.
+  std::vector<Entity> roots;
+  for (const Entity e : deferred_updates_) {
+    const GraphNode* node = nodes_.Get(e);
+    if (!node || !node->deferred_update) {
+      continue;
+    }
+    bool has_pending_ancestor = false;
+    for (const GraphNode* ancestor = nodes_.Get(node->parent); ancestor;
+         ancestor = nodes_.Get(ancestor->parent)) {
+      if (ancestor->deferred_update) {
+        has_pending_ancestor = true;
+        break;
+      }
+    }
+    if (!has_pending_ancestor) {
+      roots.push_back(e);
+    }
+  }
+
+  for (const Entity e : deferred_updates_) {
+    GraphNode* node = nodes_.Get(e);
+    if (node) {
+      node->deferred_update = false;
+    }
+  }
+  deferred_updates_.clear();
+
+  for (const Entity e : roots) {
+    UpdateTransforms(e);
+  }
+}
+
 const Sqt* TransformSystem::GetSqt(Entity e) const {
   auto node = nodes_.Get(e);
   return node ? &node->local_sqt : nullptr;
@@ -485,6 +654,8 @@ bool TransformSystem::AddChildNoEvent(Entity parent, Entity child) {
   if (parent_node && child_node) {
     parent_node->children.emplace_back(child);
     child_node->parent = parent;
+    UpdateSubtreeIndex();
+    NotifyParentChanged(child);
     UpdateTransforms(child);
     const bool parent_enabled = IsEnabled(parent);
     UpdateEnabled(child, parent_enabled);
@@ -571,6 +742,7 @@ void TransformSystem::MoveChild(Entity child, int index) {
 
   const size_t new_index = RoundAndClampIndex(index, num_children);
   children.insert(children.begin() + new_index, child);
+  UpdateSubtreeIndex();
 }
 
 void TransformSystem::RemoveParentNoEvent(Entity child) {
@@ -584,6 +756,8 @@ void TransformSystem::RemoveParentNoEvent(Entity child) {
           parent_node->children.end());
     }
     child_node->parent = kNullEntity;
+    UpdateSubtreeIndex();
+    NotifyParentChanged(child);
   }
 }
 
@@ -596,6 +770,30 @@ void TransformSystem::RemoveParent(Entity child) {
   }
 }
 
+void TransformSystem::AddParentChangedFunc(const void* owner,
+                                           ParentChangedFunc func) {
+  if (!func) {
+    LOG(DFATAL) << "Invalid ParentChangedFunc.";
+    return;
+  }
+  parent_changed_funcs_.emplace_back(owner, std::move(func));
+}
+
+void TransformSystem::RemoveParentChangedFuncs(const void* owner) {
+  using Entry = std::pair<const void*, ParentChangedFunc>;
+  parent_changed_funcs_.erase(
+      std::remove_if(
+          parent_changed_funcs_.begin(), parent_changed_funcs_.end(),
+          [owner](const Entry& entry) { return entry.first == owner; }),
+      parent_changed_funcs_.end());
+}
+
+void TransformSystem::NotifyParentChanged(Entity child) {
+  for (const auto& entry : parent_changed_funcs_) {
+    entry.second(child);
+  }
+}
+
 void TransformSystem::DestroyChildren(Entity parent) {
   const std::vector<Entity>* children = GetChildren(parent);
   if (!children) {
@@ -648,6 +846,18 @@ size_t TransformSystem::GetChildIndex(Entity child) const {
 }
 
 bool TransformSystem::IsAncestorOf(Entity ancestor, Entity target) const {
+  if (subtree_index_enabled_) {
+    const auto ancestor_iter = subtree_intervals_.find(ancestor);
+    const auto target_iter = subtree_intervals_.find(target);
+    if (ancestor_iter == subtree_intervals_.end() ||
+        target_iter == subtree_intervals_.end()) {
+      return false;
+    }
+    const SubtreeInterval& outer = ancestor_iter->second;
+    const SubtreeInterval& inner = target_iter->second;
+    return outer.begin < inner.begin && inner.begin < outer.end;
+  }
+
   auto node = nodes_.Get(target);
   while (node && node->parent != kNullEntity) {
     if (node->parent == ancestor) {
@@ -658,6 +868,73 @@ bool TransformSystem::IsAncestorOf(Entity ancestor, Entity target) const {
   return false;
 }
 
+void TransformSystem::SetSubtreeIndexEnabled(bool enabled) {
+  if (enabled == subtree_index_enabled_) {
+    return;
+  }
+  subtree_index_enabled_ = enabled;
+  if (enabled) {
+    UpdateSubtreeIndex();
+  } else {
+    ReleaseSubtreeIndex();
+  }
+}
+
+void TransformSystem::GetDescendants(Entity parent,
+                                     std::vector<Entity>* descendants) const {
+  if (subtree_index_enabled_) {
+    const auto iter = subtree_intervals_.find(parent);
+    if (iter != subtree_intervals_.end()) {
+      descendants->insert(descendants->end(),
+                          subtree_order_.begin() + iter->second.begin,
+                          subtree_order_.begin() + iter->second.end);
+      return;
+    }
+  }
+
+  descendants->push_back(parent);
+  const auto* const children = GetChildren(parent);
+  if (children) {
+    for (const Entity child : *children) {
+      GetDescendants(child, descendants);
+    }
+  }
+}
+
+void TransformSystem::UpdateSubtreeIndex() {
+  if (!subtree_index_enabled_) {
+    return;
+  }
+  LULLABY_CPU_TRACE_CALL();
+  subtree_order_.clear();
+  subtree_order_.reserve(nodes_.Size());
+  subtree_intervals_.clear();
+  subtree_intervals_.reserve(nodes_.Size());
+  for (const GraphNode& node : nodes_) {
+    if (node.parent == kNullEntity) {
+      AddToSubtreeIndex(node.GetEntity());
+    }
+  }
+}
+
+void TransformSystem::AddToSubtreeIndex(Entity e) {
+  const size_t begin = subtree_order_.size();
+  subtree_order_.push_back(e);
+  const auto* node = nodes_.Get(e);
+  if (node) {
+    for (const Entity child : node->children) {
+      AddToSubtreeIndex(child);
+    }
+  }
+  subtree_intervals_[e] = {begin, subtree_order_.size()};
+}
+
+void TransformSystem::ReleaseSubtreeIndex() {
+  subtree_order_.clear();
+  subtree_order_.shrink_to_fit();
+  subtree_intervals_.clear();
+}
+
 mathfu::mat4 TransformSystem::CalculateWorldFromEntityMatrix(
     const Sqt& local_sqt, const mathfu::mat4* world_from_parent_mat) {
   mathfu::mat4 parent_from_local_mat = CalculateTransformMatrix(local_sqt);
@@ -675,6 +952,7 @@ void TransformSystem::UpdateTransforms(Entity child) {
   world_transform->world_from_entity_mat =
       node->world_from_entity_matrix_function(
           node->local_sqt, GetWorldFromEntityMatrix(node->parent));
+  MarkChanged(world_transform->flags);
   for (auto& grand_child : node->children) {
     UpdateTransforms(grand_child);
   }
@@ -701,6 +979,7 @@ void TransformSystem::UpdateEnabled(Entity e, bool parent_enabled) {
   if (transform) {
     if (!enabled || !parent_enabled) {
       changed = true;
+      MarkChanged(transform->flags);
       disabled_transforms_.Emplace(std::move(*transform));
       world_transforms_.Destroy(e);
       SendEvent(registry_, e, OnDisabledEvent(e));
@@ -710,6 +989,7 @@ void TransformSystem::UpdateEnabled(Entity e, bool parent_enabled) {
     if (transform) {
       if (enabled && parent_enabled) {
         changed = true;
+        MarkChanged(transform->flags);
         world_transforms_.Emplace(std::move(*transform));
         disabled_transforms_.Destroy(e);
         SendEvent(registry_, e, OnEnabledEvent(e));
@@ -762,4 +1042,23 @@ void TransformSystem::ReleaseFlag(TransformFlags flag) {
   reserved_flags_ = ClearBit(reserved_flags_, flag);
 }
 
+uint32_t TransformSystem::GetChangeCount(TransformFlags flag) const {
+  const int kNumBits = 8 * sizeof(TransformFlags);
+  for (int i = 0; i < kNumBits; ++i) {
+    if (flag == (static_cast<TransformFlags>(1) << i)) {
+      return change_counts_[i];
+    }
+  }
+  LOG(DFATAL) << "GetChangeCount requires a single flag.";
+  return 0;
+}
+
+void TransformSystem::MarkChanged(Bits flags) {
+  for (int i = 0; flags != 0; ++i, flags >>= 1) {
+    if ((flags & 1) != 0) {
+      ++change_counts_[i];
+    }
+  }
+}
+
 }  // namespace lull
@@ -17,6 +17,10 @@ limitations under the License.
 #ifndef LULLABY_SYSTEMS_TRANSFORM_TRANSFORM_SYSTEM_H_
 #define LULLABY_SYSTEMS_TRANSFORM_TRANSFORM_SYSTEM_H_
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "mathfu/constants.h"
 #include "mathfu/glsl_mappings.h"
 #include "lullaby/util/bits.h"
@@ -43,6 +47,8 @@ class TransformSystem : public System {
   typedef std::function<mathfu::mat4(const Sqt&, const mathfu::mat4*)>
       CalculateWorldFromEntityMatrixFunc;
 
+  typedef std::function<void(Entity child)> ParentChangedFunc;
+
   explicit TransformSystem(Registry* registry);
 
   ~TransformSystem() override;
@@ -60,6 +66,19 @@ class TransformSystem : public System {
   /// Removes the transform from the Entity.
   void Destroy(Entity e) override;
 
+  /// Returns the version of the data written by SaveSnapshot.
+  uint32_t GetSnapshotVersion() const override;
+
+  /// Writes the hierarchy, transforms, Aabbs, flags and enabled state of every
+  /// Entity to |serializer|.  Functions set by SetWorldFromEntityMatrixFunction
+  /// are not saved, so their owners need to set them again after loading.
+  void SaveSnapshot(SaveToBuffer* serializer) override;
+
+  /// Restores the transforms written by SaveSnapshot without sending any
+  /// events.  Returns false if the data is truncated or if any of the Entities
+  /// already has a transform.
+  bool LoadSnapshot(LoadFromBuffer* serializer) override;
+
   /// Sets the specified transform to be included when calling foreach with the
   /// provided flag.
   void SetFlag(Entity e, TransformFlags flag);
@@ -106,6 +125,15 @@ class TransformSystem : public System {
   /// Set the specified entity to the given position, rotation, and scale.
   void SetSqt(Entity e, const Sqt& sqt);
 
+  /// Like SetSqt, but the world transforms of the entity and its descendants
+  /// aren't updated until the next call to UpdateDeferredTransforms.  This
+  /// allows several changes to the same entity, or to entities in the same
+  /// hierarchy, to be propagated through the hierarchy once.
+  void SetSqtDeferred(Entity e, const Sqt& sqt);
+
+  /// Updates the world transforms of all entities changed by SetSqtDeferred.
+  void UpdateDeferredTransforms();
+
   /// Gets the SQT for the specified entity (or NULL if it does not have a
   /// transform).
   const Sqt* GetSqt(Entity e) const;
@@ -182,6 +210,15 @@ class TransformSystem : public System {
   /// Break a child's connection to its parent.
   void RemoveParent(Entity child);
 
+  /// Registers a |func| that is called as soon as an entity's parent changes,
+  /// before the corresponding ParentChangedEvent is sent (which may be queued).
+  /// This allows systems that index the hierarchy to keep their indices in
+  /// sync with it.  The |func| must not change the hierarchy.
+  void AddParentChangedFunc(const void* owner, ParentChangedFunc func);
+
+  /// Unregisters all functions added by |owner| with AddParentChangedFunc.
+  void RemoveParentChangedFuncs(const void* owner);
+
   /// Retrieve the list of children of an Entity
   const std::vector<Entity>* GetChildren(Entity parent) const;
 
@@ -199,6 +236,15 @@ class TransformSystem : public System {
   /// Returns true if |ancestor| is in the parent chain of |target|.
   bool IsAncestorOf(Entity ancestor, Entity target) const;
 
+  /// Enables or disables the subtree index, which is disabled by default.
+  /// When enabled, the system records the pre-order position of each entity
+  /// and the extent of its subtree, so IsAncestorOf takes constant time and
+  /// ForAllDescendants copies a contiguous range instead of recursing.  Every
+  /// change to the hierarchy rebuilds the index, which takes linear time, so
+  /// only enable it for hierarchies that are queried far more often than they
+  /// change (eg. after a scene has finished loading).
+  void SetSubtreeIndexEnabled(bool enabled);
+
   /// Returns a unique flag that can be used to iterate via ForEach.
   TransformFlags RequestFlag();
 
@@ -206,6 +252,12 @@ class TransformSystem : public System {
   /// kInvalidFlag.
   void ReleaseFlag(TransformFlags flag);
 
+  /// Returns a counter that changes whenever an Entity with |flag| set has its
+  /// world transform, Aabb, or enabled state changed, is destroyed, or has
+  /// |flag| itself set or cleared.  This can be used to cheaply detect that
+  /// nothing relevant to |flag| has changed since some earlier point.
+  uint32_t GetChangeCount(TransformFlags flag) const;
+
   /// Calls the provided function with every Transform and provides the
   /// TransformFlags.
   template <typename Fn>
@@ -242,15 +294,15 @@ class TransformSystem : public System {
   }
 
   /// Calls the provided function on the provided entity and all of it's
-  /// descendants.
+  /// descendants, in depth-first pre-order.  The descendants are collected
+  /// before |fn| is first called, so if |fn| changes the hierarchy, the
+  /// descendants at the time of the call are still the ones visited.
   template <typename Fn>
   void ForAllDescendants(Entity parent, Fn fn) const {
-    fn(parent);
-    const auto* const children = GetChildren(parent);
-    if (children) {
-      for (const lull::Entity& child : *children) {
-        ForAllDescendants(child, fn);
-      }
+    std::vector<Entity> descendants;
+    GetDescendants(parent, &descendants);
+    for (const Entity entity : descendants) {
+      fn(entity);
     }
   }
 
@@ -260,7 +312,8 @@ class TransformSystem : public System {
         : Component(e),
           local_sqt(mathfu::kZeros3f, mathfu::quat::identity, mathfu::kOnes3f),
           parent(kNullEntity),
-          enable_self(true) {}
+          enable_self(true),
+          deferred_update(false) {}
 
     Sqt local_sqt;
     Aabb aabb_padding;
@@ -268,6 +321,7 @@ class TransformSystem : public System {
     std::vector<Entity> children;
     Entity parent;
     bool enable_self;
+    bool deferred_update;
   };
 
   struct WorldTransform : Component {
@@ -279,11 +333,28 @@ class TransformSystem : public System {
     Aabb box;
   };
 
+  // The range of an Entity and its descendants in |subtree_order_|.
+  struct SubtreeInterval {
+    size_t begin;
+    size_t end;
+  };
+
+  // Appends |parent| and all of its descendants, in depth-first pre-order, to
+  // |descendants|.
+  void GetDescendants(Entity parent, std::vector<Entity>* descendants) const;
+  // Rebuilds the subtree index after a change to the hierarchy, if it is
+  // enabled.
+  void UpdateSubtreeIndex();
+  void AddToSubtreeIndex(Entity e);
+  void ReleaseSubtreeIndex();
+
   static mathfu::mat4 CalculateWorldFromEntityMatrix(
       const Sqt& local_sqt, const mathfu::mat4* world_from_parent_mat);
   void UpdateTransforms(Entity child);
   void SetEnabled(Entity e, bool enabled);
   void UpdateEnabled(Entity e, bool parent_enabled);
+  // Increments the change count of every flag in |flags|.
+  void MarkChanged(Bits flags);
   const WorldTransform* GetWorldTransform(Entity e) const;
   WorldTransform* GetWorldTransform(Entity e);
 
@@ -294,15 +365,32 @@ class TransformSystem : public System {
   // sending any events.
   bool AddChildNoEvent(Entity parent, Entity child);
 
+  // Calls the functions registered with AddParentChangedFunc.
+  void NotifyParentChanged(Entity child);
+
   ComponentPool<GraphNode> nodes_;
   ComponentPool<WorldTransform> world_transforms_;
   ComponentPool<WorldTransform> disabled_transforms_;
   uint32_t reserved_flags_;
+  uint32_t change_counts_[8 * sizeof(TransformFlags)];
+
+  // The subtree index: every Entity in depth-first pre-order, and the range of
+  // each Entity's subtree within that order.  Both are only changed by
+  // non-const functions, so const queries never write to them.
+  bool subtree_index_enabled_;
+  std::vector<Entity> subtree_order_;
+  std::unordered_map<Entity, SubtreeInterval> subtree_intervals_;
+
+  // Entities changed by SetSqtDeferred since the last UpdateDeferredTransforms.
+  std::vector<Entity> deferred_updates_;
 
   // A map of parent/child relationships requested by CreateChild, which need to
   // be handled during Create().
   std::unordered_map<Entity, Entity> pending_children_;
 
+  // Functions added by AddParentChangedFunc, along with their owners.
+  std::vector<std::pair<const void*, ParentChangedFunc>> parent_changed_funcs_;
+
   TransformSystem(const TransformSystem&);
   TransformSystem& operator=(const TransformSystem&);
 };
@@ -21,13 +21,103 @@ limitations under the License.
 
 namespace lull {
 
+Config::Config()
+    : snapshot_(std::make_shared<Database>()),
+      version_(0),
+      next_listener_id_(1) {}
+
+void Config::Set(HashValue key, Variant value) {
+  Snapshot snapshot;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto database = std::make_shared<Database>(*snapshot_);
+    (*database)[key] = std::move(value);
+    snapshot = database;
+    Publish(std::move(database));
+  }
+  NotifyListeners(key, snapshot);
+}
+
+void Config::SetValues(const VariantMap& values) {
+  if (values.empty()) {
+    return;
+  }
+
+  Snapshot snapshot;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto database = std::make_shared<Database>(*snapshot_);
+    database->reserve(database->size() + values.size());
+    for (const auto& iter : values) {
+      (*database)[iter.first] = iter.second;
+    }
+    snapshot = database;
+    Publish(std::move(database));
+  }
+  for (const auto& iter : values) {
+    NotifyListeners(iter.first, snapshot);
+  }
+}
+
+void Config::Remove(HashValue key) {
+  Snapshot snapshot;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (snapshot_->count(key) == 0) {
+      return;
+    }
+    auto database = std::make_shared<Database>(*snapshot_);
+    database->erase(key);
+    snapshot = database;
+    Publish(std::move(database));
+  }
+  NotifyListeners(key, snapshot);
+}
+
+void Config::Publish(std::shared_ptr<Database> database) {
+  std::atomic_store(&snapshot_, Snapshot(std::move(database)));
+  version_.fetch_add(1, std::memory_order_release);
+}
+
+int Config::AddListener(HashValue key, ListenerFn fn) {
+  std::unique_lock<std::recursive_mutex> lock(listeners_mutex_);
+  const int id = next_listener_id_++;
+  Listener listener;
+  listener.id = id;
+  listener.fn = std::move(fn);
+  listeners_.emplace(key, std::move(listener));
+  return id;
+}
+
+void Config::RemoveListener(HashValue key, int id) {
+  std::unique_lock<std::recursive_mutex> lock(listeners_mutex_);
+  auto range = listeners_.equal_range(key);
+  for (auto iter = range.first; iter != range.second; ++iter) {
+    if (iter->second.id == id) {
+      listeners_.erase(iter);
+      return;
+    }
+  }
+}
+
+void Config::NotifyListeners(HashValue key, const Snapshot& snapshot) {
+  std::unique_lock<std::recursive_mutex> lock(listeners_mutex_);
+  auto range = listeners_.equal_range(key);
+  if (range.first == range.second) {
+    return;
+  }
+  const auto value = snapshot->find(key);
+  const Variant* ptr = value != snapshot->end() ? &value->second : nullptr;
+  for (auto iter = range.first; iter != range.second; ++iter) {
+    iter->second.fn(ptr);
+  }
+}
+
 void SetConfigFromVariantMap(Config* config, const VariantMap* variant_map) {
   if (!config || !variant_map) {
     return;
   }
-  for (const auto& iter : *variant_map) {
-    config->Set(iter.first, iter.second);
-  }
+  config->SetValues(*variant_map);
 }
 
 void SetConfigFromFlatbuffer(Config* config, const ConfigDef* config_def) {
@@ -40,6 +130,8 @@ void SetConfigFromFlatbuffer(Config* config, const ConfigDef* config_def) {
     return;
   }
 
+  VariantMap map;
+  map.reserve(values->size());
   for (auto iter = values->begin(); iter != values->end(); ++iter) {
     const auto* key = iter->key();
     const void* variant_def = iter->value();
@@ -51,9 +143,10 @@ void SetConfigFromFlatbuffer(Config* config, const ConfigDef* config_def) {
     Variant var;
     if (VariantFromFbVariant(iter->value_type(), variant_def, &var)) {
       const HashValue key_hash = Hash(key->c_str());
-      config->Set(key_hash, var);
+      map[key_hash] = std::move(var);
     }
   }
+  config->SetValues(map);
 }
 
 void LoadConfigFromFile(Registry* registry, Config* config,
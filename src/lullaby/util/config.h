@@ -17,6 +17,10 @@ limitations under the License.
 #ifndef LULLABY_UTIL_CONFIG_H_
 #define LULLABY_UTIL_CONFIG_H_
 
+#include <stdint.h>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 #include "lullaby/generated/config_def_generated.h"
@@ -31,8 +35,19 @@ namespace lull {
 //
 // Generally, a single instance of this class will be made available in the
 // registry to allow for app-wide configuration settings.
+//
+// Configs are read far more often than they are written, so the values are
+// kept in an immutable snapshot.  Writers copy the snapshot, modify the copy
+// and then publish it, while readers just grab the latest snapshot without
+// waiting on the writers.  Values that are read repeatedly (eg. every frame)
+// should use a Handle, which only looks up its value again after a change.
 class Config {
  public:
+  template <typename T>
+  class Handle;
+
+  Config();
+
   // Associates the |value| with the |key|.
   template <typename T>
   void Set(HashValue key, const T& value);
@@ -40,6 +55,10 @@ class Config {
   // Associates the |value| with the |key|.
   void Set(HashValue key, Variant value);
 
+  // Associates each of the |values| with its key.  The values are published
+  // together, which is much cheaper than setting them individually.
+  void SetValues(const VariantMap& values);
+
   // Returns the value associated with the |key| if it is of type |T|.  If no
   // such value exists, returns the specified |default_value| instead.
   template <typename T>
@@ -49,31 +68,129 @@ class Config {
   void Remove(HashValue key);
 
  private:
-  using Database = std::unordered_map<HashValue, Variant>;
-  mutable std::mutex mutex_;
-  Database values_;
+  using Database = VariantMap;
+  using Snapshot = std::shared_ptr<const Database>;
+  using ListenerFn = std::function<void(const Variant* value)>;
+
+  struct Listener {
+    int id;
+    ListenerFn fn;
+  };
+
+  // Returns the latest snapshot of the values.
+  Snapshot GetSnapshot() const { return std::atomic_load(&snapshot_); }
+
+  // Returns the number of times a snapshot has been published.
+  uint32_t GetVersion() const {
+    return version_.load(std::memory_order_acquire);
+  }
+
+  // Publishes the |database| as the latest snapshot.  Must be called with
+  // |mutex_| locked.
+  void Publish(std::shared_ptr<Database> database);
+
+  // Calls the |fn| whenever the value associated with the |key| is set or
+  // removed.  The |fn| is passed the new value, or nullptr if it was removed.
+  // Returns an id for RemoveListener.
+  int AddListener(HashValue key, ListenerFn fn);
+
+  // Removes the listener with the |id| from the |key|.
+  void RemoveListener(HashValue key, int id);
+
+  // Calls the listeners for the |key| with its value in the |snapshot|.
+  void NotifyListeners(HashValue key, const Snapshot& snapshot);
+
+  // Serializes writers.
+  std::mutex mutex_;
+  Snapshot snapshot_;
+  std::atomic<uint32_t> version_;
+
+  // Listeners may set values (and so notify other listeners) from their
+  // callbacks, so this mutex is recursive.
+  std::recursive_mutex listeners_mutex_;
+  std::unordered_multimap<HashValue, Listener> listeners_;
+  int next_listener_id_;
 };
 
+// Provides cheap, repeated access to the value associated with a key in a
+// Config.  The value is only looked up again after the Config has changed, so
+// reading it is just an atomic load in the common case.
+//
+// An optional |on_change| callback is called whenever the value associated
+// with the key is set or removed, with the new value (or the default value if
+// the new value is missing or of another type).  The callback is called on the
+// thread that changed the value, and must not create or destroy Handles.
+//
+// Handles themselves aren't thread-safe: each Handle should only be used by a
+// single thread.  The Config must outlive its Handles.
 template <typename T>
-void Config::Set(HashValue key, const T& value) {
-  Set(key, Variant(value));
-}
+class Config::Handle {
+ public:
+  using ChangeFn = std::function<void(const T& value)>;
+
+  Handle(Config* config, HashValue key, const T& default_value,
+         ChangeFn on_change = nullptr)
+      : config_(config),
+        key_(key),
+        default_value_(default_value),
+        value_(default_value),
+        version_(0),
+        listener_id_(0),
+        on_change_(std::move(on_change)) {
+    Refresh();
+    if (on_change_) {
+      listener_id_ = config_->AddListener(key_, [this](const Variant* value) {
+        const T* ptr = value ? value->Get<T>() : nullptr;
+        on_change_(ptr ? *ptr : default_value_);
+      });
+    }
+  }
 
-inline void Config::Set(HashValue key, Variant value) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  values_[key] = std::move(value);
-}
+  ~Handle() {
+    if (on_change_) {
+      config_->RemoveListener(key_, listener_id_);
+    }
+  }
+
+  Handle(const Handle&) = delete;
+  Handle& operator=(const Handle&) = delete;
+
+  // Returns the value associated with the key if it is of type |T|, otherwise
+  // returns the default value.
+  const T& Get() const {
+    if (version_ != config_->GetVersion()) {
+      Refresh();
+    }
+    return value_;
+  }
 
-inline void Config::Remove(HashValue key) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  values_.erase(key);
+ private:
+  void Refresh() const {
+    // Read the version before the snapshot, so that a concurrent change is
+    // picked up again by the next call to Get rather than being missed.
+    version_ = config_->GetVersion();
+    value_ = config_->Get(key_, default_value_);
+  }
+
+  Config* config_;
+  HashValue key_;
+  T default_value_;
+  mutable T value_;
+  mutable uint32_t version_;
+  int listener_id_;
+  ChangeFn on_change_;
+};
+
+template <typename T>
+void Config::Set(HashValue key, const T& value) {
+  Set(key, Variant(value));
 }
 
 template <typename T>
 T Config::Get(HashValue key, const T& default_value) const {
-  std::unique_lock<std::mutex> lock(mutex_);
-  auto iter = values_.find(key);
-  if (iter == values_.end()) {
+  const Snapshot snapshot = GetSnapshot();
+  auto iter = snapshot->find(key);
+  if (iter == snapshot->end()) {
     return default_value;
   }
   const T* ptr = iter->second.Get<T>();
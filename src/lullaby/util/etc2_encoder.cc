@@ -0,0 +1,369 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/etc2_encoder.h"
+
+#include <limits.h>
+#include <string.h>
+#include <algorithm>
+
+#include "lullaby/util/logging.h"
+
+namespace lull {
+namespace {
+
+constexpr int kBlockDimension = 4;
+constexpr int kPixelsPerBlock = kBlockDimension * kBlockDimension;
+constexpr size_t kBytesPerColorBlock = 8;
+constexpr size_t kBytesPerAlphaBlock = 8;
+
+// Rows of blocks are only split across jobs if each job gets at least this
+// many blocks.
+constexpr size_t kMinBlocksPerJob = 256;
+constexpr size_t kMaxEncodeJobs = 4;
+
+// The ETC1 intensity modifier tables.  Each table has a small and a large
+// modifier, which are also used negated.
+const int kColorModifiers[8][2] = {
+    {2, 8},   {5, 17},  {9, 29},  {13, 42},
+    {18, 60}, {24, 80}, {33, 106}, {47, 183},
+};
+
+// The EAC alpha modifier tables.
+const int kAlphaModifiers[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14},  {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12},  {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11},  {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10},  {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},   {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},   {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},   {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},    {-3, -5, -7, -9, 2, 4, 6, 8},
+};
+
+// The alpha table and modifier index which encode a constant alpha exactly.
+constexpr int kConstantAlphaTable = 13;
+constexpr int kConstantAlphaIndex = 4;
+
+// A block of pixels, stored in the column-major order used by ETC: pixel
+// (x, y) is at index x * 4 + y.
+struct Block {
+  uint8_t pixels[kPixelsPerBlock][4];
+};
+
+// The ETC1 encoding of a block's color.
+struct ColorEncoding {
+  bool flip = false;
+  bool differential = false;
+  // The quantized base color of each subblock, with 4 bits per channel in
+  // individual mode or 5 bits per channel in differential mode.
+  int colors[2][3];
+  int tables[2];
+  uint8_t indices[kPixelsPerBlock];
+  int error = INT_MAX;
+};
+
+inline int Clamp255(int value) { return std::min(std::max(value, 0), 255); }
+
+inline int Square(int value) { return value * value; }
+
+// Returns the modifier selected by a 2-bit pixel index.  The index's low bit
+// selects the large modifier, and its high bit negates the modifier.
+inline int GetColorModifier(int table, int index) {
+  const int modifier = kColorModifiers[table][index & 1];
+  return (index & 2) ? -modifier : modifier;
+}
+
+// Returns which subblock (0 or 1) the pixel at |index| belongs to.  Without
+// |flip| the subblocks are the left and right halves of the block, otherwise
+// they are the top and bottom halves.
+inline int GetSubblock(int index, bool flip) {
+  return flip ? (index % kBlockDimension) / 2 : index / (2 * kBlockDimension);
+}
+
+void LoadBlock(const uint8_t* rgba, const mathfu::vec2i& size, int block_x,
+               int block_y, Block* block) {
+  for (int x = 0; x < kBlockDimension; ++x) {
+    const int src_x = std::min(block_x * kBlockDimension + x, size.x - 1);
+    for (int y = 0; y < kBlockDimension; ++y) {
+      const int src_y = std::min(block_y * kBlockDimension + y, size.y - 1);
+      memcpy(block->pixels[x * kBlockDimension + y],
+             rgba + 4 * (static_cast<size_t>(src_y) * size.x + src_x), 4);
+    }
+  }
+}
+
+// Chooses the modifier table and pixel indices which best encode the pixels
+// of |subblock| relative to the 8-bit |color|.  Returns the squared error.
+int EncodeSubblock(const Block& block, bool flip, int subblock,
+                   const int color[3], int* out_table, uint8_t* indices) {
+  int best_error = INT_MAX;
+  for (int table = 0; table < 8; ++table) {
+    uint8_t table_indices[kPixelsPerBlock];
+    int error = 0;
+    for (int i = 0; i < kPixelsPerBlock && error < best_error; ++i) {
+      if (GetSubblock(i, flip) != subblock) {
+        continue;
+      }
+      const uint8_t* pixel = block.pixels[i];
+      int best_pixel_error = INT_MAX;
+      for (int index = 0; index < 4; ++index) {
+        const int modifier = GetColorModifier(table, index);
+        const int pixel_error =
+            Square(Clamp255(color[0] + modifier) - pixel[0]) +
+            Square(Clamp255(color[1] + modifier) - pixel[1]) +
+            Square(Clamp255(color[2] + modifier) - pixel[2]);
+        if (pixel_error < best_pixel_error) {
+          best_pixel_error = pixel_error;
+          table_indices[i] = static_cast<uint8_t>(index);
+        }
+      }
+      error += best_pixel_error;
+    }
+    if (error < best_error) {
+      best_error = error;
+      *out_table = table;
+      for (int i = 0; i < kPixelsPerBlock; ++i) {
+        if (GetSubblock(i, flip) == subblock) {
+          indices[i] = table_indices[i];
+        }
+      }
+    }
+  }
+  return best_error;
+}
+
+// Encodes |block| using the base colors already set in |encoding|, which are
+// expanded to 8 bits using |bits| per channel.
+void EncodeSubblocks(const Block& block, int bits, ColorEncoding* encoding) {
+  encoding->error = 0;
+  for (int subblock = 0; subblock < 2; ++subblock) {
+    int color[3];
+    for (int c = 0; c < 3; ++c) {
+      const int value = encoding->colors[subblock][c];
+      color[c] = (value << (8 - bits)) | (value >> (2 * bits - 8));
+    }
+    encoding->error +=
+        EncodeSubblock(block, encoding->flip, subblock, color,
+                       &encoding->tables[subblock], encoding->indices);
+  }
+}
+
+ColorEncoding EncodeColor(const Block& block) {
+  ColorEncoding best;
+  for (int flip = 0; flip < 2; ++flip) {
+    int sums[2][3] = {{0, 0, 0}, {0, 0, 0}};
+    for (int i = 0; i < kPixelsPerBlock; ++i) {
+      const int subblock = GetSubblock(i, flip != 0);
+      for (int c = 0; c < 3; ++c) {
+        sums[subblock][c] += block.pixels[i][c];
+      }
+    }
+
+    // Try differential mode, where the second base color is stored as a 3-bit
+    // offset from the first.  The offset must not overflow, as overflows
+    // select other modes in ETC2.
+    ColorEncoding encoding;
+    encoding.flip = (flip != 0);
+    encoding.differential = true;
+    bool fits = true;
+    for (int c = 0; c < 3; ++c) {
+      for (int subblock = 0; subblock < 2; ++subblock) {
+        // Rounds the average of the 8 pixels, scaled from 8 to 5 bits.
+        encoding.colors[subblock][c] =
+            (sums[subblock][c] * 31 + 4 * 255) / (8 * 255);
+      }
+      const int delta = encoding.colors[1][c] - encoding.colors[0][c];
+      fits = fits && delta >= -4 && delta <= 3;
+    }
+    if (fits) {
+      EncodeSubblocks(block, 5, &encoding);
+      if (encoding.error < best.error) {
+        best = encoding;
+      }
+    }
+
+    // Try individual mode, with two 4-bit base colors.
+    encoding.differential = false;
+    for (int c = 0; c < 3; ++c) {
+      for (int subblock = 0; subblock < 2; ++subblock) {
+        encoding.colors[subblock][c] =
+            (sums[subblock][c] * 15 + 4 * 255) / (8 * 255);
+      }
+    }
+    EncodeSubblocks(block, 4, &encoding);
+    if (encoding.error < best.error) {
+      best = encoding;
+    }
+  }
+  return best;
+}
+
+uint64_t PackColorBlock(const ColorEncoding& encoding) {
+  uint64_t bits = 0;
+  if (encoding.differential) {
+    for (int c = 0; c < 3; ++c) {
+      const int delta = encoding.colors[1][c] - encoding.colors[0][c];
+      const int shift = 59 - 8 * c;
+      bits |= static_cast<uint64_t>(encoding.colors[0][c]) << shift;
+      bits |= static_cast<uint64_t>(delta & 7) << (shift - 3);
+    }
+    bits |= uint64_t(1) << 33;
+  } else {
+    for (int c = 0; c < 3; ++c) {
+      const int shift = 60 - 8 * c;
+      bits |= static_cast<uint64_t>(encoding.colors[0][c]) << shift;
+      bits |= static_cast<uint64_t>(encoding.colors[1][c]) << (shift - 4);
+    }
+  }
+  bits |= static_cast<uint64_t>(encoding.tables[0]) << 37;
+  bits |= static_cast<uint64_t>(encoding.tables[1]) << 34;
+  if (encoding.flip) {
+    bits |= uint64_t(1) << 32;
+  }
+  for (int i = 0; i < kPixelsPerBlock; ++i) {
+    const uint64_t index = encoding.indices[i];
+    bits |= (index >> 1) << (16 + i);
+    bits |= (index & 1) << i;
+  }
+  return bits;
+}
+
+uint64_t EncodeAlphaBlock(const Block& block) {
+  int min_alpha = 255;
+  int max_alpha = 0;
+  for (int i = 0; i < kPixelsPerBlock; ++i) {
+    min_alpha = std::min(min_alpha, static_cast<int>(block.pixels[i][3]));
+    max_alpha = std::max(max_alpha, static_cast<int>(block.pixels[i][3]));
+  }
+
+  int best_base = min_alpha;
+  int best_multiplier = 1;
+  int best_table = kConstantAlphaTable;
+  uint8_t best_indices[kPixelsPerBlock];
+  std::fill(best_indices, best_indices + kPixelsPerBlock, kConstantAlphaIndex);
+
+  if (min_alpha != max_alpha) {
+    int best_error = INT_MAX;
+    for (int table = 0; table < 16; ++table) {
+      // Only try the multipliers which stretch the table's range to roughly
+      // cover the block's range, centering the range around the base.
+      const int* modifiers = kAlphaModifiers[table];
+      const int table_range = modifiers[7] - modifiers[3];
+      const int table_center = modifiers[3] + modifiers[7];
+      const int multiplier_guess = std::min(
+          (max_alpha - min_alpha + table_range / 2) / table_range, 15);
+      for (int multiplier = std::max(multiplier_guess - 1, 1);
+           multiplier <= std::min(multiplier_guess + 1, 15); ++multiplier) {
+        const int base = Clamp255(
+            (max_alpha + min_alpha - multiplier * table_center + 1) / 2);
+        uint8_t indices[kPixelsPerBlock];
+        int error = 0;
+        for (int i = 0; i < kPixelsPerBlock && error < best_error; ++i) {
+          const int alpha = block.pixels[i][3];
+          int best_pixel_error = INT_MAX;
+          for (int index = 0; index < 8; ++index) {
+            const int pixel_error =
+                Square(Clamp255(base + modifiers[index] * multiplier) - alpha);
+            if (pixel_error < best_pixel_error) {
+              best_pixel_error = pixel_error;
+              indices[i] = static_cast<uint8_t>(index);
+            }
+          }
+          error += best_pixel_error;
+        }
+        if (error < best_error) {
+          best_error = error;
+          best_base = base;
+          best_multiplier = multiplier;
+          best_table = table;
+          memcpy(best_indices, indices, sizeof(indices));
+        }
+      }
+    }
+  }
+
+  uint64_t bits = static_cast<uint64_t>(best_base) << 56;
+  bits |= static_cast<uint64_t>(best_multiplier) << 52;
+  bits |= static_cast<uint64_t>(best_table) << 48;
+  for (int i = 0; i < kPixelsPerBlock; ++i) {
+    bits |= static_cast<uint64_t>(best_indices[i]) << (45 - 3 * i);
+  }
+  return bits;
+}
+
+// ETC blocks are stored as big-endian 64-bit words.
+void StoreBigEndian(uint64_t bits, uint8_t* out) {
+  for (int i = 7; i >= 0; --i) {
+    out[i] = static_cast<uint8_t>(bits);
+    bits >>= 8;
+  }
+}
+
+mathfu::vec2i GetNumBlocks(const mathfu::vec2i& size) {
+  return mathfu::vec2i((size.x + kBlockDimension - 1) / kBlockDimension,
+                       (size.y + kBlockDimension - 1) / kBlockDimension);
+}
+
+}  // namespace
+
+size_t GetEtc2ImageSize(const mathfu::vec2i& size, bool has_alpha) {
+  if (size.x <= 0 || size.y <= 0) {
+    return 0;
+  }
+  const mathfu::vec2i num_blocks = GetNumBlocks(size);
+  const size_t bytes_per_block =
+      kBytesPerColorBlock + (has_alpha ? kBytesPerAlphaBlock : 0);
+  return static_cast<size_t>(num_blocks.x) * num_blocks.y * bytes_per_block;
+}
+
+void EncodeEtc2(const uint8_t* rgba_ptr, const mathfu::vec2i& size,
+                bool has_alpha, uint8_t* out_ptr, JobProcessor* processor) {
+  if (!rgba_ptr || !out_ptr) {
+    LOG(DFATAL) << "Failed to encode ETC2 image.";
+    return;
+  }
+  if (size.x <= 0 || size.y <= 0) {
+    return;
+  }
+
+  const mathfu::vec2i num_blocks = GetNumBlocks(size);
+  const size_t bytes_per_block =
+      kBytesPerColorBlock + (has_alpha ? kBytesPerAlphaBlock : 0);
+  const size_t min_rows =
+      std::max(kMinBlocksPerJob / static_cast<size_t>(num_blocks.x),
+               size_t(1));
+  RunJobsForRange(
+      processor, static_cast<size_t>(num_blocks.y), min_rows, kMaxEncodeJobs,
+      [=](size_t begin, size_t end) {
+        Block block;
+        uint8_t* out = out_ptr + begin * num_blocks.x * bytes_per_block;
+        for (size_t y = begin; y < end; ++y) {
+          for (int x = 0; x < num_blocks.x; ++x) {
+            LoadBlock(rgba_ptr, size, x, static_cast<int>(y), &block);
+            // In the RGBA8 format, the alpha block precedes the color block.
+            if (has_alpha) {
+              StoreBigEndian(EncodeAlphaBlock(block), out);
+              out += kBytesPerAlphaBlock;
+            }
+            StoreBigEndian(PackColorBlock(EncodeColor(block)), out);
+            out += kBytesPerColorBlock;
+          }
+        }
+      });
+}
+
+}  // namespace lull
@@ -0,0 +1,52 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_UTIL_ETC2_ENCODER_H_
+#define LULLABY_UTIL_ETC2_ENCODER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mathfu/glsl_mappings.h"
+#include "lullaby/base/job_processor.h"
+
+namespace lull {
+
+// A software encoder for ETC2 compressed textures, which are supported by all
+// OpenGL ES 3.0 devices.  Images are compressed in blocks of 4x4 pixels.  The
+// encoder favors speed over quality: colors are encoded using only the ETC1
+// compatible modes, which are a subset of ETC2.
+
+// The GL internal formats of the encoded data.
+constexpr uint32_t kGlCompressedRgb8Etc2 = 0x9274;
+constexpr uint32_t kGlCompressedRgba8Etc2Eac = 0x9278;
+
+// Returns the number of bytes needed to store an image of |size| encoded as
+// ETC2.  If |has_alpha| is true, the RGBA8 format (ETC2 color plus EAC alpha)
+// is used, otherwise the RGB8 format.
+size_t GetEtc2ImageSize(const mathfu::vec2i& size, bool has_alpha);
+
+// Encodes |size|.x() x |size|.y() RGBA pixels at |rgba_ptr| into
+// GetEtc2ImageSize(|size|, |has_alpha|) bytes at |out_ptr|.  Images whose size
+// is not a multiple of 4 are padded by repeating their last row and column.  If
+// |processor| is provided, rows of blocks are encoded in parallel.
+void EncodeEtc2(const uint8_t* rgba_ptr, const mathfu::vec2i& size,
+                bool has_alpha, uint8_t* out_ptr,
+                JobProcessor* processor = nullptr);
+
+}  // namespace lull
+
+#endif  // LULLABY_UTIL_ETC2_ENCODER_H_
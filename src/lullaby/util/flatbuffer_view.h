@@ -0,0 +1,108 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_UTIL_FLATBUFFER_VIEW_H_
+#define LULLABY_UTIL_FLATBUFFER_VIEW_H_
+
+#include <stddef.h>
+#include "flatbuffers/flatbuffers.h"
+#include "lullaby/util/span.h"
+#include "lullaby/util/string_view.h"
+
+namespace lull {
+
+// Helpers used by the "View" classes generated by the Lullaby flatc code
+// generator.  A View wraps a pointer into a flatbuffer and reads its fields on
+// demand, so no data is copied out of the buffer.  As such, a View is only
+// valid for as long as the underlying buffer.
+
+// Returns a string_view referencing the characters of |str|, or an empty
+// string_view if |str| is null.
+inline string_view FlatbufferStringView(const flatbuffers::String* str) {
+  return str ? string_view(str->c_str(), str->size()) : string_view();
+}
+
+// Returns a Span referencing the elements of a vector of scalars or structs,
+// or an empty Span if |vec| is null.  Flatbuffer vectors are stored in
+// little-endian order, which matches all of Lullaby's target platforms.
+template <typename T>
+Span<T> FlatbufferSpan(const flatbuffers::Vector<T>* vec) {
+  return vec ? Span<T>(vec->data(), vec->size()) : Span<T>();
+}
+
+// Vectors of structs store the structs themselves (not pointers to them), so
+// their raw data can be referenced directly.
+template <typename T>
+Span<T> FlatbufferSpan(const flatbuffers::Vector<const T*>* vec) {
+  return vec ? Span<T>(reinterpret_cast<const T*>(vec->Data()), vec->size())
+             : Span<T>();
+}
+
+// Wraps a flatbuffer vector of tables, returning each element as a |ViewType|.
+template <typename ViewType>
+class FlatbufferTableVectorView {
+ public:
+  using FlatBufferType = typename ViewType::FlatBufferType;
+  using VectorType =
+      flatbuffers::Vector<flatbuffers::Offset<FlatBufferType>>;
+
+  FlatbufferTableVectorView() : vec_(nullptr) {}
+  explicit FlatbufferTableVectorView(const VectorType* vec) : vec_(vec) {}
+
+  // Returns the number of elements in the vector.
+  size_t size() const { return vec_ ? vec_->size() : 0; }
+
+  // Returns whether the vector is empty.
+  bool empty() const { return size() == 0; }
+
+  // Returns a view of an element.  Does not do bounds checking.
+  ViewType operator[](size_t i) const {
+    return ViewType(vec_->Get(static_cast<flatbuffers::uoffset_t>(i)));
+  }
+
+ private:
+  const VectorType* vec_;
+};
+
+// Wraps a flatbuffer vector of strings, returning each element as a
+// string_view.
+class FlatbufferStringVectorView {
+ public:
+  using VectorType = flatbuffers::Vector<flatbuffers::Offset<
+      flatbuffers::String>>;
+
+  FlatbufferStringVectorView() : vec_(nullptr) {}
+  explicit FlatbufferStringVectorView(const VectorType* vec) : vec_(vec) {}
+
+  // Returns the number of elements in the vector.
+  size_t size() const { return vec_ ? vec_->size() : 0; }
+
+  // Returns whether the vector is empty.
+  bool empty() const { return size() == 0; }
+
+  // Returns an element.  Does not do bounds checking.
+  string_view operator[](size_t i) const {
+    return FlatbufferStringView(
+        vec_->Get(static_cast<flatbuffers::uoffset_t>(i)));
+  }
+
+ private:
+  const VectorType* vec_;
+};
+
+}  // namespace lull
+
+#endif  // LULLABY_UTIL_FLATBUFFER_VIEW_H_
@@ -17,7 +17,10 @@ limitations under the License.
 #ifndef LULLABY_UTIL_FLATBUFFER_WRITER_H_
 #define LULLABY_UTIL_FLATBUFFER_WRITER_H_
 
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <vector>
 #include "flatbuffers/flatbuffers.h"
 #include "lullaby/util/flatbuffer_native_types.h"
 #include "lullaby/util/inward_buffer.h"
@@ -472,6 +475,8 @@ class FlatbufferWriter {
     }
   }
 
+  friend class FlatbufferSizeEstimator;
+
   struct Field {
     uint16_t index = 0;
     uint8_t size = 0;
@@ -482,11 +487,223 @@ class FlatbufferWriter {
   InwardBuffer* buffer_ = nullptr;
 };
 
+// Computes an upper bound on the amount of InwardBuffer memory that the
+// FlatbufferWriter needs to serialize an object.  Like the FlatbufferWriter, it
+// is passed as the archive to the object's SerializeFlatbuffer function, but it
+// only tallies the sizes of the data that would be written.  Reserving the
+// estimated size up front allows an object to be written without the buffer
+// being reallocated (and copied) as it grows.
+class FlatbufferSizeEstimator {
+ public:
+  // Returns the estimated number of bytes needed to write |obj| as a root
+  // table, including the temporary data written to the front of the buffer.
+  template <typename T>
+  static size_t EstimateObject(T* obj) {
+    State state;
+    FlatbufferSizeEstimator estimator(&state);
+    estimator.AddTable(obj);
+    state.back += sizeof(uint32_t);  // Reference to the root table.
+    return state.back + state.max_front;
+  }
+
+  template <typename T, typename U>
+  void Scalar(T* value, uint16_t offset, U default_value) {
+    AddValueField(offset, sizeof(T), alignof(T));
+  }
+
+  void String(std::string* value, uint16_t offset) {
+    state_->back += GetStringSize(*value);
+    AddReferenceField(offset);
+  }
+
+  template <typename T>
+  void Struct(T* value, uint16_t offset) {
+    AddValueField(offset, sizeof(T), alignof(T));
+  }
+
+  template <typename T>
+  void Struct(lull::Optional<T>* value, uint16_t offset) {
+    if (value->get()) {
+      Struct(value->get(), offset);
+    }
+  }
+
+  template <typename T>
+  void NativeStruct(T* value, uint16_t offset) {
+    AddValueField(offset, FlatbufferNativeType<T>::kFlatbufferStructSize,
+                  FlatbufferNativeType<T>::kFlatbufferStructAlignment);
+  }
+
+  template <typename T>
+  void NativeStruct(lull::Optional<T>* value, uint16_t offset) {
+    if (value->get()) {
+      NativeStruct(value->get(), offset);
+    }
+  }
+
+  template <typename T>
+  void Table(T* value, uint16_t offset) {
+    AddTable(value);
+    AddReferenceField(offset);
+  }
+
+  template <typename T>
+  void Table(lull::Optional<T>* value, uint16_t offset) {
+    if (value->get()) {
+      Table(value->get(), offset);
+    }
+  }
+
+  template <typename T>
+  void Table(std::shared_ptr<T>* value, uint16_t offset) {
+    if (value->get()) {
+      Table(value->get(), offset);
+    }
+  }
+
+  template <typename T, typename U>
+  void Union(T* value, uint16_t offset, U default_type_value) {
+    const auto type = value->type();
+    AddValueField(static_cast<uint16_t>(offset - 2), sizeof(type),
+                  alignof(decltype(type)));
+    if (type != 0) {
+      const size_t start = StartTable();
+      value->SerializeFlatbuffer(type, *this);
+      EndTable(start);
+    }
+    AddReferenceField(offset);
+  }
+
+  template <typename T, typename U = T>
+  void VectorOfScalars(std::vector<T>* value, uint16_t offset) {
+    AddVector(value->size(), sizeof(U));
+    AddReferenceField(offset);
+  }
+
+  void VectorOfStrings(std::vector<std::string>* value, uint16_t offset) {
+    for (const std::string& str : *value) {
+      state_->back += GetStringSize(str);
+    }
+    // The references to the strings are held in the front of the buffer until
+    // the vector is finished.
+    const size_t start = state_->front;
+    AddFront(value->size() * sizeof(uint32_t));
+    state_->front = start;
+    AddVector(value->size(), sizeof(uint32_t));
+    AddReferenceField(offset);
+  }
+
+  template <typename T>
+  void VectorOfStructs(std::vector<T>* value, uint16_t offset) {
+    AddVector(value->size(), sizeof(T));
+    AddReferenceField(offset);
+  }
+
+  template <typename T>
+  void VectorOfNativeStructs(std::vector<T>* value, uint16_t offset) {
+    AddVector(value->size(), FlatbufferNativeType<T>::kFlatbufferStructSize);
+    AddReferenceField(offset);
+  }
+
+  template <typename T>
+  void VectorOfTables(std::vector<T>* value, uint16_t offset) {
+    const size_t start = state_->front;
+    for (T& table : *value) {
+      AddTable(&table);
+      AddFront(sizeof(uint32_t));
+    }
+    state_->front = start;
+    AddVector(value->size(), sizeof(uint32_t));
+    AddReferenceField(offset);
+  }
+
+  // Informs objects that this serializer will not overwrite data.
+  bool IsDestructive() const { return false; }
+
+ private:
+  // The tallied sizes.  Objects take their archive by value, so the state is
+  // shared by all copies of the estimator.
+  struct State {
+    size_t back = 0;
+    size_t front = 0;
+    size_t max_front = 0;
+    std::vector<size_t> table_max_index;
+  };
+
+  explicit FlatbufferSizeEstimator(State* state) : state_(state) {}
+
+  template <typename T>
+  void AddTable(T* value) {
+    const size_t start = StartTable();
+    value->SerializeFlatbuffer(*this);
+    EndTable(start);
+  }
+
+  size_t StartTable() {
+    const size_t start = state_->front;
+    state_->table_max_index.push_back(2);
+    return start;
+  }
+
+  void EndTable(size_t start) {
+    // The offset to the vtable followed by the vtable itself.
+    const size_t max_index = state_->table_max_index.back();
+    state_->table_max_index.pop_back();
+    state_->back += sizeof(int32_t) + (max_index + 1) * sizeof(uint16_t);
+    state_->front = start;
+  }
+
+  void AddValueField(uint16_t offset, size_t size, size_t align) {
+    // Values may be padded to their alignment.
+    state_->back += size + align - 1;
+    AddField(offset);
+  }
+
+  void AddReferenceField(uint16_t offset) {
+    // References are written to the table when it is finished.
+    state_->back += sizeof(uint32_t);
+    AddField(offset);
+  }
+
+  void AddField(uint16_t offset) {
+    size_t& max_index = state_->table_max_index.back();
+    max_index = std::max<size_t>(max_index, offset / 2);
+    AddFront(sizeof(FlatbufferWriter::Field));
+  }
+
+  void AddVector(size_t num, size_t element_size) {
+    // Empty vectors are written as null references.
+    if (num > 0) {
+      state_->back += num * element_size + sizeof(uint32_t);
+    }
+  }
+
+  void AddFront(size_t size) {
+    state_->front += size;
+    state_->max_front = std::max(state_->max_front, state_->front);
+  }
+
+  static size_t GetStringSize(const std::string& str) {
+    // Empty strings are written as null references.  Otherwise, the length is
+    // followed by the characters and a null terminator.
+    return str.empty() ? 0 : sizeof(uint32_t) + str.length() + 1;
+  }
+
+  State* state_ = nullptr;
+};
+
 template <typename T>
 inline void* WriteFlatbuffer(T* obj, InwardBuffer* buffer) {
   return FlatbufferWriter::SerializeObject(obj, buffer);
 }
 
+// Returns an upper bound on the number of bytes needed to write |obj| into an
+// InwardBuffer using WriteFlatbuffer.
+template <typename T>
+inline size_t EstimateFlatbufferSize(T* obj) {
+  return FlatbufferSizeEstimator::EstimateObject(obj);
+}
+
 }  // namespace lull
 
 #endif  // LULLABY_UTIL_FLATBUFFER_WRITER_H_
@@ -18,6 +18,9 @@ limitations under the License.
 #define LULLABY_UTIL_FUNCTION_REGISTRY_H_
 
 #include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
 
 #include "lullaby/base/common_types.h"
@@ -30,6 +33,85 @@ limitations under the License.
 
 namespace lull {
 
+template <typename Signature>
+class TypedFunctionHandle;
+
+namespace detail {
+
+// The canonical form of the signature of a function object's |MemFn| call
+// operator: the decayed return type, with all arguments taken by const
+// reference.  Functions with different, but compatible, argument passing (eg.
+// by value versus by const reference) share a canonical signature.
+template <typename MemFn>
+struct CanonicalSignature;
+
+template <typename Fn, typename Return, typename... Args>
+struct CanonicalSignature<Return (Fn::*)(Args...) const> {
+  using Type = typename std::decay<Return>::type(
+      const typename std::decay<Args>::type&...);
+};
+
+template <typename Return, typename... Args>
+struct CanonicalSignature<Return(Args...)> {
+  using Type = typename std::decay<Return>::type(
+      const typename std::decay<Args>::type&...);
+};
+
+template <bool... Values>
+struct BoolPack {};
+
+// True if all of the |Values| are true.
+template <bool... Values>
+struct AllTrue : std::is_same<BoolPack<true, Values...>,
+                              BoolPack<Values..., true>> {};
+
+// True if an argument of type |T| can be passed as a const reference to its
+// decayed type, ie. it is taken by value or by const reference, and the
+// decayed type can be copied.
+template <typename T>
+struct IsCanonicalArg
+    : std::integral_constant<
+          bool,
+          (std::is_same<typename std::remove_cv<T>::type,
+                        typename std::decay<T>::type>::value ||
+           std::is_same<T, const typename std::decay<T>::type&>::value) &&
+              std::is_copy_constructible<
+                  typename std::decay<T>::type>::value> {};
+
+// True if a return value of type |T| can be returned as its decayed type.
+template <typename T>
+struct IsCanonicalReturn
+    : std::integral_constant<
+          bool, std::is_void<T>::value ||
+                    std::is_constructible<typename std::decay<T>::type,
+                                          T>::value> {};
+
+// True if the function object's |MemFn| call operator can be called through
+// its canonical signature.
+template <typename MemFn>
+struct HasCanonicalSignature : std::false_type {};
+
+template <typename Fn, typename Return, typename... Args>
+struct HasCanonicalSignature<Return (Fn::*)(Args...) const>
+    : std::integral_constant<
+          bool, IsCanonicalReturn<Return>::value &&
+                    AllTrue<IsCanonicalArg<Args>::value...>::value> {};
+
+// Wraps a reference to a function object in a std::function with the given
+// canonical |Signature|.
+template <typename Signature>
+struct TypedCallback;
+
+template <typename Return, typename... Args>
+struct TypedCallback<Return(Args...)> {
+  template <typename Fn>
+  static std::function<Return(Args...)> Create(const Fn& fn) {
+    return [&fn](Args... args) -> Return { return fn(args...); };
+  }
+};
+
+}  // namespace detail
+
 // A FunctionCall bundles up the name of the function to call, and the arguments
 // as an array of Variants.
 struct FunctionCall {
@@ -83,12 +165,43 @@ class FunctionRegistry {
   FunctionCall Bundle(string_view name, Args... args) const;
 
  private:
+  template <typename Signature>
+  friend class TypedFunctionHandle;
+
   struct FunctionInfo {
     std::string name;
     std::function<Variant(const FunctionCall&)> callback;
+    // A std::function with the function's canonical signature, which is
+    // identified by |signature|.  Used by TypedFunctionHandle to call the
+    // function without converting its arguments to and from Variants.
+    std::shared_ptr<void> typed_callback;
+    const void* signature;
   };
   std::unordered_map<HashValue, FunctionInfo> functions_;
 
+  // Incremented whenever a function is registered or unregistered, so that
+  // TypedFunctionHandles know when to resolve their function again.
+  int generation_ = 0;
+
+  // Returns a unique id for the canonical |Signature|.
+  template <typename Signature>
+  static const void* GetSignatureId() {
+    static const char id = 0;
+    return &id;
+  }
+
+  // Sets the typed callback of |info| to call |fn| through its canonical
+  // signature.
+  template <typename Fn>
+  static void SetTypedCallback(const Fn& fn, FunctionInfo* info,
+                               std::true_type);
+
+  // Functions taking arguments by non-const reference, or arguments that can't
+  // be copied, can only be called through Variants.
+  template <typename Fn>
+  static void SetTypedCallback(const Fn& fn, FunctionInfo* info,
+                               std::false_type) {}
+
   // Used by CallNativeFunction to perform the actual invocation of a function
   // by extracting args and providing storage for a return value.
   struct Context {
@@ -243,12 +356,28 @@ void FunctionRegistry::RegisterFunction(string_view name, const Fn& fn) {
     CallNativeFunction(&context, call.name.data(), fn);
     return context.return_value;
   };
-  functions_.emplace(id, FunctionInfo{ name.to_string(), callback });
+  FunctionInfo info{name.to_string(), callback, nullptr, nullptr};
+  SetTypedCallback(
+      fn, &info,
+      detail::HasCanonicalSignature<decltype(&Fn::operator())>());
+  functions_.emplace(id, std::move(info));
+  ++generation_;
+}
+
+template <typename Fn>
+void FunctionRegistry::SetTypedCallback(const Fn& fn, FunctionInfo* info,
+                                        std::true_type) {
+  using Signature =
+      typename detail::CanonicalSignature<decltype(&Fn::operator())>::Type;
+  info->typed_callback = std::make_shared<std::function<Signature>>(
+      detail::TypedCallback<Signature>::Create(fn));
+  info->signature = GetSignatureId<Signature>();
 }
 
 inline void FunctionRegistry::UnregisterFunction(string_view name) {
   const HashValue id = Hash(name.data(), name.size());
   functions_.erase(id);
+  ++generation_;
 }
 
 inline bool FunctionRegistry::IsFunctionRegistered(string_view name) const {
@@ -318,6 +447,111 @@ inline bool FunctionRegistry::Context::CheckNumArgs(const char* name,
   return true;
 }
 
+// A TypedFunctionHandle calls a function in a FunctionRegistry with native
+// arguments.  The function is looked up once (and again only if functions are
+// registered or unregistered).  If the registered function's signature matches
+// |Return(Args...)|, ignoring whether arguments are passed by value or by const
+// reference, it is called directly.  Otherwise, the call falls back to
+// converting the arguments and return value to and from Variants.
+//
+// For example:
+//   TypedFunctionHandle<std::string(const std::string&, const std::string&)>
+//       concat(function_registry, "Concat");
+//   std::string result = concat.Call(a, b);
+template <typename Return, typename... Args>
+class TypedFunctionHandle<Return(Args...)> {
+ public:
+  static_assert(!std::is_reference<Return>::value,
+                "TypedFunctionHandle functions must return by value.");
+
+  TypedFunctionHandle(FunctionRegistry* registry, string_view name)
+      : registry_(registry),
+        id_(Hash(name.data(), name.size())),
+        name_(name.to_string()) {}
+
+  // Returns true if the function is registered.
+  bool IsValid() const { return registry_->IsFunctionRegistered(id_); }
+
+  // Returns true if the function is registered and will be called directly,
+  // without any conversion to Variants.
+  bool IsTyped() {
+    Resolve();
+    return typed_callback_ != nullptr;
+  }
+
+  // Calls the function with the |args|.  Returns a default-constructed value if
+  // the function isn't registered or returns a value of the wrong type.
+  Return Call(Args... args) {
+    Resolve();
+    if (typed_callback_) {
+      return (*typed_callback_)(args...);
+    }
+    return CallVariant(args...);
+  }
+
+ private:
+  using Signature =
+      typename detail::CanonicalSignature<Return(Args...)>::Type;
+  using ReturnType = typename std::decay<Return>::type;
+
+  void Resolve() {
+    if (generation_ == registry_->generation_) {
+      return;
+    }
+    generation_ = registry_->generation_;
+    typed_callback_ = nullptr;
+    const auto iter = registry_->functions_.find(id_);
+    if (iter != registry_->functions_.end() &&
+        iter->second.signature ==
+            FunctionRegistry::GetSignatureId<Signature>()) {
+      typed_callback_ = static_cast<const std::function<Signature>*>(
+          iter->second.typed_callback.get());
+    }
+  }
+
+  template <typename R = Return>
+  typename std::enable_if<std::is_void<R>::value, R>::type CallVariant(
+      const Args&... args) {
+    registry_->Call(Bundle(args...));
+  }
+
+  template <typename R = Return>
+  typename std::enable_if<!std::is_void<R>::value, ReturnType>::type
+  CallVariant(const Args&... args) {
+    const Variant result = registry_->Call(Bundle(args...));
+    ReturnType value = ReturnType();
+    if (!result.Empty() && !ResultToNative(result, &value)) {
+      LOG(ERROR) << name_ << " is expected to return "
+                 << FunctionRegistry::Convert<ReturnType>::GetTypeName();
+    }
+    return value;
+  }
+
+  static bool ResultToNative(const Variant& result, Variant* value) {
+    *value = result;
+    return true;
+  }
+
+  template <typename T>
+  static bool ResultToNative(const Variant& result, T* value) {
+    return FunctionRegistry::Convert<T>::VariantToNative(result, value);
+  }
+
+  FunctionCall Bundle(const Args&... args) const {
+    FunctionCall call(id_, name_);
+    int dummy[] = {0, (call.AddArg(args), 0)...};
+    (void)dummy;
+    return call;
+  }
+
+  FunctionRegistry* registry_;
+  HashValue id_;
+  std::string name_;
+  // The registry generation when the function was last resolved.
+  int generation_ = -1;
+  const std::function<Signature>* typed_callback_ = nullptr;
+};
+
 }  // namespace lull
 
 LULLABY_SETUP_TYPEID(lull::FunctionRegistry);
@@ -16,44 +16,156 @@ limitations under the License.
 
 #include "lullaby/util/hash.h"
 #include <ctype.h>
+#include <string.h>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "lullaby/util/logging.h"
 
 namespace lull {
+namespace {
 
-HashValue Hash(const char* str) {
-  const size_t npos = -1;
-  return Hash(str, npos);
+#if LULLABY_HASH_64 || LULLABY_HASH_DETECT_COLLISIONS
+// Returns the length of |str|, stopping at the first null terminator or after
+// |len| characters, whichever comes first.
+size_t StringLength(const char* str, size_t len) {
+  if (len == static_cast<size_t>(-1)) {
+    return strlen(str);
+  }
+  const void* end = memchr(str, 0, len);
+  return end ? static_cast<size_t>(static_cast<const char*>(end) - str) : len;
 }
+#endif
 
-HashValue Hash(const char* str, size_t len) {
+#if LULLABY_HASH_64
+// Reads |count| (at most 8) bytes as a little-endian word, converting each
+// byte with |convert|.  This must match detail::ConstHashLoadWord.
+template <typename Convert>
+uint64_t LoadWord(const char* str, size_t count, const Convert& convert) {
+  uint64_t word = 0;
+  for (size_t i = 0; i < count; ++i) {
+    word |= static_cast<uint64_t>(convert(static_cast<unsigned char>(str[i])))
+            << (8 * i);
+  }
+  return word;
+}
+
+// Byte conversions for case-sensitive and case-insensitive hashing.
+struct IdentityByte {
+  unsigned char operator()(unsigned char c) const { return c; }
+};
+
+struct LowerCaseByte {
+  unsigned char operator()(unsigned char c) const {
+    return static_cast<unsigned char>(tolower(c));
+  }
+};
+
+// Reads a whole word.  Without conversion, this is a single unaligned load on
+// little-endian platforms.
+inline uint64_t LoadWholeWord(const char* str, const IdentityByte&) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ || \
+    defined(_M_IX86) || defined(_M_X64) || defined(_M_ARM)
+  uint64_t word;
+  memcpy(&word, str, sizeof(word));
+  return word;
+#else
+  return LoadWord(str, 8, IdentityByte());
+#endif
+}
+
+inline uint64_t LoadWholeWord(const char* str, const LowerCaseByte& convert) {
+  return LoadWord(str, 8, convert);
+}
+
+// Computes the word-at-a-time hash of |len| bytes of |str|.  This must match
+// detail::ConstHash.
+template <typename Convert>
+HashValue HashWords(const char* str, size_t len, const Convert& convert) {
+  HashValue value = kHashOffsetBasis;
+  size_t remaining = len;
+  while (remaining >= 8) {
+    value = detail::HashWord(value, LoadWholeWord(str, convert));
+    str += 8;
+    remaining -= 8;
+  }
+  value = detail::HashWord(value, LoadWord(str, remaining, convert));
+  return detail::HashFinalize(value, len);
+}
+#endif
+
+HashValue HashString(const char* str, size_t len, bool case_insensitive) {
   if (str == nullptr || *str == 0 || len == 0) {
     return 0;
   }
 
+#if LULLABY_HASH_64
+  const size_t length = StringLength(str, len);
+  if (case_insensitive) {
+    return HashWords(str, length, LowerCaseByte());
+  } else {
+    return HashWords(str, length, IdentityByte());
+  }
+#else
   // A quick good hash, from:
   // https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
   size_t count = 0;
   HashValue value = kHashOffsetBasis;
   while (*str && count < len) {
-    value = (value ^ static_cast<unsigned char>(*str++)) * kHashPrimeMultiplier;
+    const unsigned char c = static_cast<unsigned char>(*str++);
+    value = (value ^ (case_insensitive ? tolower(c) : c)) *
+            kHashPrimeMultiplier;
     ++count;
   }
   return value;
+#endif
 }
 
-HashValue Hash(string_view str) { return Hash(str.data(), str.length()); }
+}  // namespace
 
-HashValue HashCaseInsensitive(const char* str, size_t len) {
-  if (str == nullptr || *str == 0 || len == 0) {
-    return 0;
+HashValue Hash(const char* str) {
+  const size_t npos = -1;
+  return Hash(str, npos);
+}
+
+HashValue Hash(const char* str, size_t len) {
+  const HashValue value = HashString(str, len, false);
+#if LULLABY_HASH_DETECT_COLLISIONS
+  if (value != 0) {
+    RegisterHash(value, string_view(str, StringLength(str, len)));
   }
-  size_t count = 0;
-  HashValue value = kHashOffsetBasis;
-  while (*str && count < len) {
-    value = (value ^ static_cast<unsigned char>(tolower(*str++))) *
-            kHashPrimeMultiplier;
-    ++count;
+#endif
+  return value;
+}
+
+HashValue Hash(string_view str) { return Hash(str.data(), str.length()); }
+
+HashValue HashBytes(const void* data, size_t len, HashValue basis) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  HashValue value = basis;
+  for (size_t i = 0; i < len; ++i) {
+    value = (value ^ bytes[i]) * kHashPrimeMultiplier;
   }
   return value;
 }
 
+HashValue HashCaseInsensitive(const char* str, size_t len) {
+  return HashString(str, len, true);
+}
+
+void RegisterHash(HashValue value, string_view str) {
+  static std::mutex mutex;
+  static auto* registry = new std::unordered_map<HashValue, std::string>();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto iter = registry->find(value);
+  if (iter == registry->end()) {
+    registry->emplace(value, str.to_string());
+  } else if (string_view(iter->second) != str) {
+    LOG(DFATAL) << "Hash collision: \"" << iter->second << "\" and \"" << str
+                << "\" both hash to " << value;
+  }
+}
+
 }  // namespace lull
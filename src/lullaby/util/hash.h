@@ -22,27 +22,126 @@ limitations under the License.
 
 #include "lullaby/util/string_view.h"
 
-// String hashing function used by various parts of Lullaby.  It uses the
-// following algorithm:
+// String hashing function used by various parts of Lullaby.  By default, it
+// uses the following 32-bit algorithm:
 // https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
 //
-// Note: The has algorithm is implemented twice: once in Hash and once in
+// Defining LULLABY_HASH_64 to 1 makes HashValue 64 bits wide and switches Hash
+// to an algorithm that consumes the string 8 bytes at a time (with a
+// MurmurHash3-style mix and finalizer).  This greatly reduces the chance of
+// two names colliding in large content sets.  Note that hashes stored in data
+// (eg. as 32-bit fields in flatbuffers) must be regenerated when switching.
+//
+// Defining LULLABY_HASH_DETECT_COLLISIONS to 1 records every string passed to
+// Hash in a global registry and reports (via LOG(DFATAL)) any two different
+// strings that produce the same value.  This is intended for debug builds only
+// as it retains a copy of every hashed string.
+//
+// Note: The hash algorithm is implemented twice: once in Hash and once in
 // ConstHash.  It is important to keep both implementations the same if a
 // new algorithm is ever chosen.
+
+#ifndef LULLABY_HASH_64
+#define LULLABY_HASH_64 0
+#endif
+
+#ifndef LULLABY_HASH_DETECT_COLLISIONS
+#define LULLABY_HASH_DETECT_COLLISIONS 0
+#endif
+
 namespace lull {
 
+#if LULLABY_HASH_64
+using HashValue = uint64_t;
+
+constexpr HashValue kHashOffsetBasis = 0xcbf29ce484222325;
+constexpr HashValue kHashPrimeMultiplier = 0x00000100000001b3;
+#else
 using HashValue = unsigned int;
 
 constexpr HashValue kHashOffsetBasis = 0x84222325;
 constexpr HashValue kHashPrimeMultiplier = 0x000001b3;
+#endif
 
 HashValue Hash(const char* str);
 HashValue Hash(const char* str, size_t len);
 HashValue Hash(string_view str);
 HashValue HashCaseInsensitive(const char* str, size_t len);
 
+// Hashes |len| bytes of arbitrary binary |data| (which, unlike the string
+// functions above, may contain zeros).  Passing a previous result as |basis|
+// allows several buffers to be combined into a single hash.  This is always
+// computed a byte at a time (using FNV-1a at the width of HashValue) so that
+// the combined result does not depend on how the data is split.
+HashValue HashBytes(const void* data, size_t len,
+                    HashValue basis = kHashOffsetBasis);
+
+// Records that |str| hashes to |value| in the global collision registry,
+// reporting an error if a different string was previously recorded with the
+// same value.  Hash calls this automatically if LULLABY_HASH_DETECT_COLLISIONS
+// is enabled, but it can also be called directly (eg. for strings that are
+// only hashed with ConstHash).
+void RegisterHash(HashValue value, string_view str);
+
 namespace detail {
 
+#if LULLABY_HASH_64
+constexpr uint64_t kHashWordMultiplier1 = 0x87c37b91114253d5;
+constexpr uint64_t kHashWordMultiplier2 = 0x4cf5ad432745937f;
+constexpr uint64_t kHashFinalMultiplier1 = 0xff51afd7ed558ccd;
+constexpr uint64_t kHashFinalMultiplier2 = 0xc4ceb9fe1a85ec53;
+
+inline constexpr uint64_t HashRotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+// Mixes an 8-byte word of the string into the hash.
+inline constexpr uint64_t HashWord(uint64_t hash, uint64_t word) {
+  return HashRotateLeft(
+             hash ^ (HashRotateLeft(word * kHashWordMultiplier1, 31) *
+                     kHashWordMultiplier2),
+             27) *
+             5 +
+         0x52dce729;
+}
+
+inline constexpr uint64_t HashShift(uint64_t hash) {
+  return hash ^ (hash >> 33);
+}
+
+// Avalanches the bits of the hash once the whole string has been mixed in.
+inline constexpr uint64_t HashFinalize(uint64_t hash, size_t len) {
+  return HashShift(
+      HashShift(HashShift(hash ^ len) * kHashFinalMultiplier1) *
+      kHashFinalMultiplier2);
+}
+
+// Reads |count| (at most 8) bytes starting at |start| as a little-endian word.
+template <std::size_t N>
+inline constexpr uint64_t ConstHashLoadWord(const char (&str)[N],
+                                            std::size_t start,
+                                            std::size_t count) {
+  return count == 0
+             ? 0
+             : static_cast<uint64_t>(static_cast<unsigned char>(str[start])) |
+                   (ConstHashLoadWord(str, start + 1, count - 1) << 8);
+}
+
+// Helper function for performing the recursion for the compile time hash.
+// Each step consumes a whole word; the final (possibly empty) partial word is
+// always mixed in before finalizing.
+template <std::size_t N>
+inline constexpr HashValue ConstHash(const char (&str)[N], std::size_t start,
+                                     HashValue hash) {
+  return (N - 1 - start) >= 8
+             ? ConstHash(str, start + 8,
+                         HashWord(hash, ConstHashLoadWord(str, start, 8)))
+             : HashFinalize(
+                   HashWord(hash,
+                            ConstHashLoadWord(str, start, N - 1 - start)),
+                   N - 1);
+}
+#else
 // Helper function for performing the recursion for the compile time hash.
 template <std::size_t N>
 inline constexpr HashValue ConstHash(const char (&str)[N], int start,
@@ -57,6 +156,7 @@ inline constexpr HashValue ConstHash(const char (&str)[N], int start,
                        (hash ^ static_cast<unsigned char>(str[start])) *
                        static_cast<uint64_t>(kHashPrimeMultiplier)));
 }
+#endif
 
 }  // namespace detail
 
@@ -16,25 +16,361 @@ limitations under the License.
 
 #include "lullaby/util/image_util.h"
 
+#include <string.h>
+#include <algorithm>
+
 #include "lullaby/util/logging.h"
+#include "lullaby/util/simd.h"
+
+#if LULLABY_SIMD_SSE2 && defined(__SSSE3__)
+#define LULLABY_IMAGE_UTIL_SSSE3 1
+#include <tmmintrin.h>
+#endif
 
 namespace lull {
+namespace {
+
+// Images are only split across jobs if each job gets at least this many
+// pixels.
+constexpr size_t kMinPixelsPerJob = 64 * 1024;
+constexpr size_t kMaxImageJobs = 4;
+
+// Calls |fn(begin, end)| for ranges of rows in [0, |num_rows|), running the
+// ranges in parallel on |processor| if the rows are large enough.
+template <typename Func>
+void ForEachRowRange(JobProcessor* processor, int num_rows, int row_width,
+                     const Func& fn) {
+  if (num_rows <= 0 || row_width <= 0) {
+    return;
+  }
+  const size_t min_rows =
+      std::max(kMinPixelsPerJob / static_cast<size_t>(row_width), size_t(1));
+  RunJobsForRange(processor, static_cast<size_t>(num_rows), min_rows,
+                  kMaxImageJobs, fn);
+}
+
+void ConvertRgbToRgba(const uint8_t* src, uint8_t* dst, size_t count) {
+  size_t i = 0;
+#if LULLABY_SIMD_NEON
+  for (; i + 16 <= count; i += 16) {
+    const uint8x16x3_t rgb = vld3q_u8(src + 3 * i);
+    uint8x16x4_t rgba;
+    rgba.val[0] = rgb.val[0];
+    rgba.val[1] = rgb.val[1];
+    rgba.val[2] = rgb.val[2];
+    rgba.val[3] = vdupq_n_u8(255);
+    vst4q_u8(dst + 4 * i, rgba);
+  }
+#elif LULLABY_IMAGE_UTIL_SSSE3
+  // Converts 16 pixels (48 bytes) at a time by shuffling each group of 4 RGB
+  // pixels into place and setting the alpha bytes.
+  const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8,
+                                        -128, 9, 10, 11, -128);
+  const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000));
+  for (; i + 16 <= count; i += 16) {
+    const uint8_t* in = src + 3 * i;
+    __m128i* out = reinterpret_cast<__m128i*>(dst + 4 * i);
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16));
+    const __m128i c =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 32));
+    const __m128i p0 = a;
+    const __m128i p1 = _mm_alignr_epi8(b, a, 12);
+    const __m128i p2 = _mm_alignr_epi8(c, b, 8);
+    const __m128i p3 = _mm_srli_si128(c, 4);
+    _mm_storeu_si128(out, _mm_or_si128(_mm_shuffle_epi8(p0, shuffle), alpha));
+    _mm_storeu_si128(out + 1,
+                     _mm_or_si128(_mm_shuffle_epi8(p1, shuffle), alpha));
+    _mm_storeu_si128(out + 2,
+                     _mm_or_si128(_mm_shuffle_epi8(p2, shuffle), alpha));
+    _mm_storeu_si128(out + 3,
+                     _mm_or_si128(_mm_shuffle_epi8(p3, shuffle), alpha));
+  }
+#elif LULLABY_SIMD_SSE2
+  // SSE2 has no byte shuffle, so instead convert 4 pixels at a time using
+  // 32-bit words (x86 is always little-endian).
+  const uint32_t alpha = 0xff000000;
+  for (; i + 4 <= count; i += 4) {
+    uint32_t rgb[3];
+    memcpy(rgb, src + 3 * i, sizeof(rgb));
+    const uint32_t rgba[4] = {
+        rgb[0] | alpha,
+        (rgb[0] >> 24) | (rgb[1] << 8) | alpha,
+        (rgb[1] >> 16) | (rgb[2] << 16) | alpha,
+        (rgb[2] >> 8) | alpha,
+    };
+    memcpy(dst + 4 * i, rgba, sizeof(rgba));
+  }
+#endif
+  for (; i < count; ++i) {
+    dst[4 * i + 0] = src[3 * i + 0];
+    dst[4 * i + 1] = src[3 * i + 1];
+    dst[4 * i + 2] = src[3 * i + 2];
+    dst[4 * i + 3] = 255;
+  }
+}
+
+void SwapRedAndBlue(const uint8_t* src, uint8_t* dst, size_t count) {
+  size_t i = 0;
+#if LULLABY_SIMD_NEON
+  for (; i + 16 <= count; i += 16) {
+    uint8x16x4_t pixels = vld4q_u8(src + 4 * i);
+    const uint8x16_t red = pixels.val[0];
+    pixels.val[0] = pixels.val[2];
+    pixels.val[2] = red;
+    vst4q_u8(dst + 4 * i, pixels);
+  }
+#elif LULLABY_SIMD_SSE2
+  // Red and blue are the low bytes of each 16-bit half of a pixel, so they can
+  // be swapped by rotating each pixel's masked red and blue bytes by 16 bits.
+  const __m128i green_alpha = _mm_set1_epi32(static_cast<int>(0xff00ff00));
+  const __m128i red_blue = _mm_set1_epi32(0x00ff00ff);
+  for (; i + 4 <= count; i += 4) {
+    const __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i));
+    const __m128i rb = _mm_and_si128(pixels, red_blue);
+    const __m128i br = _mm_or_si128(_mm_slli_epi32(rb, 16),
+                                    _mm_srli_epi32(rb, 16));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i),
+                     _mm_or_si128(_mm_and_si128(pixels, green_alpha), br));
+  }
+#endif
+  for (; i < count; ++i) {
+    const uint8_t red = src[4 * i + 0];
+    dst[4 * i + 0] = src[4 * i + 2];
+    dst[4 * i + 1] = src[4 * i + 1];
+    dst[4 * i + 2] = red;
+    dst[4 * i + 3] = src[4 * i + 3];
+  }
+}
+
+// Returns |color| * |alpha| / 255, rounded to the nearest integer.
+inline uint8_t MultiplyByAlpha(uint8_t color, uint8_t alpha) {
+  const uint32_t value = color * alpha + 128;
+  return static_cast<uint8_t>((value + (value >> 8)) >> 8);
+}
+
+#if LULLABY_SIMD_NEON
+inline uint8x16_t MultiplyByAlpha(uint8x16_t color, uint8x16_t alpha) {
+  const uint16x8_t lo = vmull_u8(vget_low_u8(color), vget_low_u8(alpha));
+  const uint16x8_t hi = vmull_u8(vget_high_u8(color), vget_high_u8(alpha));
+  return vcombine_u8(vraddhn_u16(lo, vrshrq_n_u16(lo, 8)),
+                     vraddhn_u16(hi, vrshrq_n_u16(hi, 8)));
+}
+#elif LULLABY_SIMD_SSE2
+// Premultiplies 2 pixels stored as 16-bit channels.
+inline __m128i MultiplyByAlpha(__m128i pixels) {
+  const __m128i alpha_mask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+  const __m128i alpha = _mm_shufflehi_epi16(
+      _mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)),
+      _MM_SHUFFLE(3, 3, 3, 3));
+  __m128i value = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha),
+                                _mm_set1_epi16(128));
+  value = _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+  return _mm_or_si128(_mm_andnot_si128(alpha_mask, value),
+                      _mm_and_si128(alpha_mask, pixels));
+}
+#endif
+
+void PremultiplyAlpha(const uint8_t* src, uint8_t* dst, size_t count) {
+  size_t i = 0;
+#if LULLABY_SIMD_NEON
+  for (; i + 16 <= count; i += 16) {
+    uint8x16x4_t pixels = vld4q_u8(src + 4 * i);
+    pixels.val[0] = MultiplyByAlpha(pixels.val[0], pixels.val[3]);
+    pixels.val[1] = MultiplyByAlpha(pixels.val[1], pixels.val[3]);
+    pixels.val[2] = MultiplyByAlpha(pixels.val[2], pixels.val[3]);
+    vst4q_u8(dst + 4 * i, pixels);
+  }
+#elif LULLABY_SIMD_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 4 <= count; i += 4) {
+    const __m128i pixels =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i));
+    const __m128i lo = MultiplyByAlpha(_mm_unpacklo_epi8(pixels, zero));
+    const __m128i hi = MultiplyByAlpha(_mm_unpackhi_epi8(pixels, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i),
+                     _mm_packus_epi16(lo, hi));
+  }
+#endif
+  for (; i < count; ++i) {
+    const uint8_t alpha = src[4 * i + 3];
+    dst[4 * i + 0] = MultiplyByAlpha(src[4 * i + 0], alpha);
+    dst[4 * i + 1] = MultiplyByAlpha(src[4 * i + 1], alpha);
+    dst[4 * i + 2] = MultiplyByAlpha(src[4 * i + 2], alpha);
+    dst[4 * i + 3] = alpha;
+  }
+}
+
+// Averages 2x2 blocks of pixels from |row0| and |row1| (which are |in_width|
+// pixels wide) into |out_width| pixels at |dst|.
+void HalveRow(const uint8_t* row0, const uint8_t* row1, size_t in_width,
+              uint8_t* dst, size_t out_width) {
+  size_t x = 0;
+  // The vector loops read the 4 input pixels for each pair of output pixels,
+  // which are always in bounds when the input is at least 2 pixels wide.
+#if LULLABY_SIMD_NEON
+  for (; x + 2 <= out_width; x += 2) {
+    const uint8x16_t a = vld1q_u8(row0 + 8 * x);
+    const uint8x16_t b = vld1q_u8(row1 + 8 * x);
+    const uint16x8_t lo = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+    const uint16x8_t hi = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+    const uint16x8_t sum =
+        vcombine_u16(vadd_u16(vget_low_u16(lo), vget_high_u16(lo)),
+                     vadd_u16(vget_low_u16(hi), vget_high_u16(hi)));
+    vst1_u8(dst + 4 * x, vrshrn_n_u16(sum, 2));
+  }
+#elif LULLABY_SIMD_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i two = _mm_set1_epi16(2);
+  for (; x + 2 <= out_width; x += 2) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 8 * x));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 8 * x));
+    __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero),
+                               _mm_unpacklo_epi8(b, zero));
+    __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero),
+                               _mm_unpackhi_epi8(b, zero));
+    lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+    hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+    const __m128i sum =
+        _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), two), 2);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + 4 * x),
+                     _mm_packus_epi16(sum, sum));
+  }
+#endif
+  for (; x < out_width; ++x) {
+    const size_t x0 = 4 * (2 * x);
+    const size_t x1 = 4 * std::min(2 * x + 1, in_width - 1);
+    for (size_t c = 0; c < 4; ++c) {
+      const int sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] +
+                      row1[x1 + c] + 2;
+      dst[4 * x + c] = static_cast<uint8_t>(sum >> 2);
+    }
+  }
+}
+
+}  // namespace
 
 void ConvertRgb888ToRgba8888(const uint8_t* rgb_ptr, const mathfu::vec2i& size,
-                             uint8_t* out_rgba_ptr) {
+                             uint8_t* out_rgba_ptr, JobProcessor* processor) {
   if (!rgb_ptr || !out_rgba_ptr) {
     LOG(DFATAL) << "Failed to convert RGB to RGBA.";
     return;
   }
 
-  const int num_pixels = size.x * size.y;
-  const uint8_t* src_ptr = rgb_ptr;
-  uint8_t* dst_ptr = out_rgba_ptr;
-  for (int i = 0; i < num_pixels; ++i) {
-    *dst_ptr++ = *src_ptr++;
-    *dst_ptr++ = *src_ptr++;
-    *dst_ptr++ = *src_ptr++;
-    *dst_ptr++ = 255;
+  const size_t width = static_cast<size_t>(std::max(size.x, 0));
+  ForEachRowRange(processor, size.y, size.x, [=](size_t begin, size_t end) {
+    ConvertRgbToRgba(rgb_ptr + 3 * width * begin,
+                     out_rgba_ptr + 4 * width * begin, width * (end - begin));
+  });
+}
+
+void ConvertBgra8888ToRgba8888(const uint8_t* bgra_ptr,
+                               const mathfu::vec2i& size,
+                               uint8_t* out_rgba_ptr,
+                               JobProcessor* processor) {
+  if (!bgra_ptr || !out_rgba_ptr) {
+    LOG(DFATAL) << "Failed to convert BGRA to RGBA.";
+    return;
+  }
+
+  const size_t width = static_cast<size_t>(std::max(size.x, 0));
+  ForEachRowRange(processor, size.y, size.x, [=](size_t begin, size_t end) {
+    SwapRedAndBlue(bgra_ptr + 4 * width * begin,
+                   out_rgba_ptr + 4 * width * begin, width * (end - begin));
+  });
+}
+
+void PremultiplyAlphaRgba8888(const uint8_t* rgba_ptr,
+                              const mathfu::vec2i& size,
+                              uint8_t* out_rgba_ptr,
+                              JobProcessor* processor) {
+  if (!rgba_ptr || !out_rgba_ptr) {
+    LOG(DFATAL) << "Failed to premultiply alpha.";
+    return;
+  }
+
+  const size_t width = static_cast<size_t>(std::max(size.x, 0));
+  ForEachRowRange(processor, size.y, size.x, [=](size_t begin, size_t end) {
+    PremultiplyAlpha(rgba_ptr + 4 * width * begin,
+                     out_rgba_ptr + 4 * width * begin, width * (end - begin));
+  });
+}
+
+size_t GetRgbaImageSize(const mathfu::vec2i& size) {
+  return static_cast<size_t>(size.x) * static_cast<size_t>(size.y) * 4;
+}
+
+mathfu::vec2i GetHalvedImageSize(const mathfu::vec2i& size) {
+  return mathfu::vec2i(std::max(size.x / 2, 1), std::max(size.y / 2, 1));
+}
+
+void HalveRgba8888(const uint8_t* rgba_ptr, const mathfu::vec2i& size,
+                   uint8_t* out_rgba_ptr, JobProcessor* processor) {
+  if (!rgba_ptr || !out_rgba_ptr) {
+    LOG(DFATAL) << "Failed to halve image.";
+    return;
+  }
+  if (size.x <= 0 || size.y <= 0) {
+    return;
+  }
+
+  const mathfu::vec2i out_size = GetHalvedImageSize(size);
+  const size_t in_width = static_cast<size_t>(size.x);
+  const size_t out_width = static_cast<size_t>(out_size.x);
+  const size_t in_stride = 4 * in_width;
+  const size_t row_offset = size.y > 1 ? in_stride : 0;
+  ForEachRowRange(processor, out_size.y, out_size.x,
+                  [=](size_t begin, size_t end) {
+    for (size_t y = begin; y < end; ++y) {
+      const uint8_t* row0 = rgba_ptr + 2 * y * in_stride;
+      HalveRow(row0, row0 + row_offset, in_width,
+               out_rgba_ptr + 4 * out_width * y, out_width);
+    }
+  });
+}
+
+int GetNumMipLevels(const mathfu::vec2i& size) {
+  if (size.x <= 0 || size.y <= 0) {
+    return 0;
+  }
+  int levels = 1;
+  for (int dimension = std::max(size.x, size.y); dimension > 1;
+       dimension /= 2) {
+    ++levels;
+  }
+  return levels;
+}
+
+void GenerateMipmapsRgba8888(const uint8_t* rgba_ptr,
+                             const mathfu::vec2i& size,
+                             std::vector<uint8_t>* out_mips,
+                             JobProcessor* processor) {
+  if (!rgba_ptr || !out_mips) {
+    LOG(DFATAL) << "Failed to generate mipmaps.";
+    return;
+  }
+
+  const int num_levels = GetNumMipLevels(size);
+  size_t num_bytes = 0;
+  mathfu::vec2i level_size = size;
+  for (int level = 1; level < num_levels; ++level) {
+    level_size = GetHalvedImageSize(level_size);
+    num_bytes += 4 * static_cast<size_t>(level_size.x * level_size.y);
+  }
+  out_mips->resize(num_bytes);
+
+  const uint8_t* src = rgba_ptr;
+  uint8_t* dst = out_mips->data();
+  level_size = size;
+  for (int level = 1; level < num_levels; ++level) {
+    HalveRgba8888(src, level_size, dst, processor);
+    level_size = GetHalvedImageSize(level_size);
+    src = dst;
+    dst += 4 * static_cast<size_t>(level_size.x * level_size.y);
   }
 }
 
@@ -18,15 +18,75 @@ limitations under the License.
 #define LULLABY_UTIL_IMAGE_UTIL_H_
 
 #include <stdint.h>
+#include <vector>
 
 #include "mathfu/glsl_mappings.h"
+#include "lullaby/base/job_processor.h"
 
 namespace lull {
 
+// The functions below operate on tightly packed images with 8 bits per
+// channel, using SSE2 or NEON where available.  If a |processor| is given,
+// large images are split into ranges of rows which are processed in parallel
+// on its worker threads.
+
 // Converts |size|.x() x |size|.y() RGB pixels at |rgb_ptr| into 4 byte RGBA
 // pixels at |out_rgba_ptr|.  The alpha values are set to 255.
 void ConvertRgb888ToRgba8888(const uint8_t* rgb_ptr, const mathfu::vec2i& size,
-                             uint8_t* out_rgba_ptr);
+                             uint8_t* out_rgba_ptr,
+                             JobProcessor* processor = nullptr);
+
+// Converts |size|.x() x |size|.y() BGRA pixels at |bgra_ptr| into RGBA pixels
+// at |out_rgba_ptr| by swapping the red and blue channels.  As the conversion
+// is symmetric, this also converts RGBA to BGRA.  The input and output may be
+// the same buffer.
+void ConvertBgra8888ToRgba8888(const uint8_t* bgra_ptr,
+                               const mathfu::vec2i& size,
+                               uint8_t* out_rgba_ptr,
+                               JobProcessor* processor = nullptr);
+
+inline void ConvertRgba8888ToBgra8888(const uint8_t* rgba_ptr,
+                                      const mathfu::vec2i& size,
+                                      uint8_t* out_bgra_ptr,
+                                      JobProcessor* processor = nullptr) {
+  ConvertBgra8888ToRgba8888(rgba_ptr, size, out_bgra_ptr, processor);
+}
+
+// Multiplies the color channels of |size|.x() x |size|.y() RGBA pixels at
+// |rgba_ptr| by their alpha, writing the result to |out_rgba_ptr|.  The result
+// is rounded to the nearest value.  The input and output may be the same
+// buffer.
+void PremultiplyAlphaRgba8888(const uint8_t* rgba_ptr,
+                              const mathfu::vec2i& size,
+                              uint8_t* out_rgba_ptr,
+                              JobProcessor* processor = nullptr);
+
+// Returns the number of bytes in a |size|.x() x |size|.y() RGBA image.
+size_t GetRgbaImageSize(const mathfu::vec2i& size);
+
+// Returns the size of an image downsampled by HalveRgba8888: half of |size|
+// rounded down, but no less than 1 in either dimension.
+mathfu::vec2i GetHalvedImageSize(const mathfu::vec2i& size);
+
+// Downsamples |size|.x() x |size|.y() RGBA pixels at |rgba_ptr| to half
+// resolution by averaging each 2x2 block of pixels, writing
+// GetHalvedImageSize(|size|) pixels to |out_rgba_ptr|.  For odd sizes, the
+// last row or column is dropped.
+void HalveRgba8888(const uint8_t* rgba_ptr, const mathfu::vec2i& size,
+                   uint8_t* out_rgba_ptr, JobProcessor* processor = nullptr);
+
+// Returns the number of levels in a full mipmap chain for an image of |size|,
+// including the base level.
+int GetNumMipLevels(const mathfu::vec2i& size);
+
+// Generates the mipmap levels below the |size|.x() x |size|.y() RGBA image at
+// |rgba_ptr| using a box filter.  Levels 1 to GetNumMipLevels(|size|) - 1 are
+// stored consecutively in |out_mips|, each level being GetHalvedImageSize() of
+// the level above it.
+void GenerateMipmapsRgba8888(const uint8_t* rgba_ptr,
+                             const mathfu::vec2i& size,
+                             std::vector<uint8_t>* out_mips,
+                             JobProcessor* processor = nullptr);
 
 }  // namespace lull
 
@@ -63,13 +63,22 @@ size_t InwardBuffer::EnsureAligned(size_t capacity) {
   return min_capacity & mask;
 }
 
-void InwardBuffer::DoReallocate(size_t requested) {
-  const size_t num_bytes_back = BackSize();
-  const size_t num_bytes_front = FrontSize();
+void InwardBuffer::Reserve(size_t capacity) {
+  if (capacity > capacity_) {
+    Reallocate(EnsureAligned(capacity));
+  }
+}
 
+void InwardBuffer::DoReallocate(size_t requested) {
   // Calculate the required size for the new buffer which should at least be
   // large enough to accomodate the requested allocation size.
-  capacity_ = EnsureAligned(capacity_ + std::max(requested, capacity_));
+  Reallocate(EnsureAligned(capacity_ + std::max(requested, capacity_)));
+}
+
+void InwardBuffer::Reallocate(size_t capacity) {
+  const size_t num_bytes_back = BackSize();
+  const size_t num_bytes_front = FrontSize();
+  capacity_ = capacity;
 
   // Allocate the new buffer, copy the commited front and back blocks of
   // memory from the current buffer to the new buffer, and deallocate the
@@ -50,6 +50,16 @@ class InwardBuffer {
   // Resets both the front and back write-heads to the ends of the buffer.
   void Reset();
 
+  // Returns the total size (in bytes) of the memory owned by the buffer.
+  size_t Capacity() const;
+
+  // Grows the buffer so that its capacity is at least |capacity| bytes,
+  // preserving any data already written to the front and back.  Does nothing
+  // if the buffer is already large enough.  Reserving up front avoids the
+  // repeated reallocations and copies of growing the buffer one write at a
+  // time.
+  void Reserve(size_t capacity);
+
   // Returns the size (in bytes) that has been written to the front of the
   // buffer.
   size_t FrontSize() const;
@@ -117,6 +127,8 @@ class InwardBuffer {
 
   void DoReallocate(size_t requested);
 
+  void Reallocate(size_t capacity);
+
   std::unique_ptr<uint8_t[]> mem_;
   uint8_t* back_ = nullptr;
   uint8_t* front_ = nullptr;
@@ -128,6 +140,8 @@ inline void InwardBuffer::Reset() {
   back_ = mem_.get() + capacity_;
 }
 
+inline size_t InwardBuffer::Capacity() const { return capacity_; }
+
 inline size_t InwardBuffer::FrontSize() const {
   return static_cast<size_t>(front_ - mem_.get());
 }
@@ -0,0 +1,90 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/inward_buffer_pool.h"
+
+namespace lull {
+
+InwardBufferPool::InwardBufferPool(size_t max_buffers)
+    : max_buffers_(max_buffers) {
+  buffers_.reserve(max_buffers_);
+}
+
+InwardBuffer InwardBufferPool::Acquire(size_t capacity) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (buffers_.empty()) {
+    lock.unlock();
+    return InwardBuffer(capacity);
+  }
+
+  // Prefer the smallest buffer that fits.  If none fit, grow the largest one
+  // so that the reallocation replaces the biggest existing allocation.
+  size_t best = 0;
+  for (size_t i = 1; i < buffers_.size(); ++i) {
+    const size_t size = buffers_[i].Capacity();
+    const size_t best_size = buffers_[best].Capacity();
+    if (size >= capacity) {
+      if (best_size < capacity || size < best_size) {
+        best = i;
+      }
+    } else if (best_size < capacity && size > best_size) {
+      best = i;
+    }
+  }
+
+  InwardBuffer buffer = std::move(buffers_[best]);
+  buffers_[best] = std::move(buffers_.back());
+  buffers_.pop_back();
+  lock.unlock();
+
+  buffer.Reset();
+  buffer.Reserve(capacity);
+  return buffer;
+}
+
+void InwardBufferPool::Release(InwardBuffer buffer) {
+  if (buffer.Capacity() == 0 || max_buffers_ == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (buffers_.size() < max_buffers_) {
+    buffers_.emplace_back(std::move(buffer));
+    return;
+  }
+
+  size_t smallest = 0;
+  for (size_t i = 1; i < buffers_.size(); ++i) {
+    if (buffers_[i].Capacity() < buffers_[smallest].Capacity()) {
+      smallest = i;
+    }
+  }
+  if (buffers_[smallest].Capacity() < buffer.Capacity()) {
+    buffers_[smallest] = std::move(buffer);
+  }
+}
+
+size_t InwardBufferPool::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return buffers_.size();
+}
+
+void InwardBufferPool::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffers_.clear();
+}
+
+}  // namespace lull
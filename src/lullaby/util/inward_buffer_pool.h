@@ -0,0 +1,65 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_UTIL_INWARD_BUFFER_POOL_H_
+#define LULLABY_UTIL_INWARD_BUFFER_POOL_H_
+
+#include <mutex>
+#include <vector>
+#include "lullaby/util/inward_buffer.h"
+
+namespace lull {
+
+// A pool of InwardBuffers that can be reused across builds.
+//
+// Building a flatbuffer (eg. finalizing a Blueprint) grows an InwardBuffer
+// until it is large enough to hold the entire flatbuffer.  When many similar
+// flatbuffers are built at runtime (eg. for procedurally generated entities),
+// acquiring the buffers from a pool means that the memory grown for one build
+// is reused by the next, rather than being allocated and copied again.
+class InwardBufferPool {
+ public:
+  // Creates a pool that holds on to at most |max_buffers| released buffers.
+  explicit InwardBufferPool(size_t max_buffers = kDefaultMaxBuffers);
+
+  InwardBufferPool(const InwardBufferPool&) = delete;
+  InwardBufferPool& operator=(const InwardBufferPool&) = delete;
+
+  // Returns an empty buffer with a capacity of at least |capacity| bytes.  The
+  // smallest pooled buffer that is large enough is reused if possible.
+  InwardBuffer Acquire(size_t capacity);
+
+  // Returns |buffer| to the pool so that its memory can be reused by a later
+  // call to Acquire.  If the pool is full, the smallest buffer is dropped.
+  void Release(InwardBuffer buffer);
+
+  // Returns the number of buffers currently held by the pool.
+  size_t Size() const;
+
+  // Frees all buffers held by the pool.
+  void Clear();
+
+ private:
+  enum { kDefaultMaxBuffers = 4 };
+
+  mutable std::mutex mutex_;
+  std::vector<InwardBuffer> buffers_;
+  size_t max_buffers_;
+};
+
+}  // namespace lull
+
+#endif  // LULLABY_UTIL_INWARD_BUFFER_POOL_H_
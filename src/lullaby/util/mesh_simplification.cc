@@ -0,0 +1,387 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/mesh_simplification.h"
+
+#include <string.h>
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+
+#include "mathfu/glsl_mappings.h"
+#include "lullaby/util/logging.h"
+
+namespace lull {
+namespace {
+
+using Index = MeshData::Index;
+
+// Boundary edges are constrained by a plane perpendicular to the adjacent
+// face, scaled by this factor so that open edges and seams are collapsed last.
+constexpr double kBoundaryWeight = 1000.0;
+
+// Symmetric 4x4 matrix representing the sum of squared distances to a set of
+// planes.  Only the upper triangle is stored.
+struct Quadric {
+  Quadric() { std::fill(m, m + 10, 0.0); }
+
+  // Adds the plane (a, b, c, d), with a unit normal, scaled by |weight|.
+  void AddPlane(double a, double b, double c, double d, double weight) {
+    m[0] += weight * a * a;
+    m[1] += weight * a * b;
+    m[2] += weight * a * c;
+    m[3] += weight * a * d;
+    m[4] += weight * b * b;
+    m[5] += weight * b * c;
+    m[6] += weight * b * d;
+    m[7] += weight * c * c;
+    m[8] += weight * c * d;
+    m[9] += weight * d * d;
+  }
+
+  Quadric& operator+=(const Quadric& rhs) {
+    for (int i = 0; i < 10; ++i) {
+      m[i] += rhs.m[i];
+    }
+    return *this;
+  }
+
+  // Returns v^T Q v for the homogeneous point (p, 1).
+  double Evaluate(const mathfu::vec3& p) const {
+    const double x = p.x;
+    const double y = p.y;
+    const double z = p.z;
+    return m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z +
+           2.0 * m[3] * x + m[4] * y * y + 2.0 * m[5] * y * z +
+           2.0 * m[6] * y + m[7] * z * z + 2.0 * m[8] * z + m[9];
+  }
+
+  double m[10];
+};
+
+struct Triangle {
+  Index v[3];
+  bool removed = false;
+};
+
+// A candidate collapse of vertex |from| onto vertex |to|.  The stamps record
+// the vertices' versions when the cost was computed, so stale entries can be
+// discarded lazily when they are popped.
+struct Collapse {
+  double cost;
+  Index from;
+  Index to;
+  uint32_t from_stamp;
+  uint32_t to_stamp;
+
+  bool operator>(const Collapse& rhs) const { return cost > rhs.cost; }
+};
+
+uint32_t EdgeKey(Index a, Index b) {
+  if (a > b) {
+    std::swap(a, b);
+  }
+  return (static_cast<uint32_t>(a) << 16) | static_cast<uint32_t>(b);
+}
+
+class Simplifier {
+ public:
+  explicit Simplifier(const MeshData& mesh);
+
+  void Run(size_t target_num_triangles, double max_error);
+
+  MeshData BuildMesh() const;
+
+ private:
+  mathfu::vec3 GetFaceNormal(const Triangle& tri) const;
+  void PushCollapses(Index a, Index b);
+  bool IsCollapseValid(Index from, Index to) const;
+  void ApplyCollapse(Index from, Index to);
+
+  const MeshData& mesh_;
+  std::vector<mathfu::vec3> positions_;
+  std::vector<Quadric> quadrics_;
+  std::vector<uint32_t> stamps_;
+  std::vector<bool> removed_;
+  std::vector<Triangle> triangles_;
+  std::vector<std::vector<size_t>> vertex_triangles_;
+  std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>>
+      queue_;
+  size_t num_triangles_ = 0;
+};
+
+Simplifier::Simplifier(const MeshData& mesh) : mesh_(mesh) {
+  const size_t num_vertices = mesh.GetNumVertices();
+  positions_.reserve(num_vertices);
+  ForEachVertexPosition(
+      mesh.GetVertexBytes(), num_vertices, mesh.GetVertexFormat(),
+      [this](const mathfu::vec3& p) { positions_.push_back(p); });
+  quadrics_.resize(num_vertices);
+  stamps_.resize(num_vertices, 0);
+  removed_.resize(num_vertices, false);
+  vertex_triangles_.resize(num_vertices);
+
+  const Index* indices = mesh.GetIndexData();
+  const size_t num_indices = mesh.GetNumIndices() - mesh.GetNumIndices() % 3;
+  triangles_.reserve(num_indices / 3);
+  std::unordered_map<uint32_t, int> edge_counts;
+  for (size_t i = 0; i < num_indices; i += 3) {
+    Triangle tri;
+    tri.v[0] = indices[i];
+    tri.v[1] = indices[i + 1];
+    tri.v[2] = indices[i + 2];
+    if (tri.v[0] == tri.v[1] || tri.v[1] == tri.v[2] ||
+        tri.v[2] == tri.v[0]) {
+      continue;
+    }
+    for (int j = 0; j < 3; ++j) {
+      vertex_triangles_[tri.v[j]].push_back(triangles_.size());
+      ++edge_counts[EdgeKey(tri.v[j], tri.v[(j + 1) % 3])];
+    }
+    triangles_.push_back(tri);
+  }
+  num_triangles_ = triangles_.size();
+
+  for (const Triangle& tri : triangles_) {
+    const mathfu::vec3& p0 = positions_[tri.v[0]];
+    const mathfu::vec3 cross =
+        mathfu::vec3::CrossProduct(positions_[tri.v[1]] - p0,
+                                   positions_[tri.v[2]] - p0);
+    const float length = cross.Length();
+    if (length <= 0.f) {
+      continue;
+    }
+    // Weight each plane by the triangle's area so that small slivers don't
+    // dominate the error of a vertex.
+    const mathfu::vec3 n = cross / length;
+    const double area = 0.5 * length;
+    const double d = -mathfu::vec3::DotProduct(n, p0);
+    for (int j = 0; j < 3; ++j) {
+      quadrics_[tri.v[j]].AddPlane(n.x, n.y, n.z, d, area);
+    }
+
+    for (int j = 0; j < 3; ++j) {
+      const Index a = tri.v[j];
+      const Index b = tri.v[(j + 1) % 3];
+      if (edge_counts[EdgeKey(a, b)] != 1) {
+        continue;
+      }
+      const mathfu::vec3 edge = positions_[b] - positions_[a];
+      mathfu::vec3 side = mathfu::vec3::CrossProduct(edge, n);
+      const float side_length = side.Length();
+      if (side_length <= 0.f) {
+        continue;
+      }
+      side /= side_length;
+      const double side_d = -mathfu::vec3::DotProduct(side, positions_[a]);
+      const double weight = kBoundaryWeight * edge.LengthSquared();
+      quadrics_[a].AddPlane(side.x, side.y, side.z, side_d, weight);
+      quadrics_[b].AddPlane(side.x, side.y, side.z, side_d, weight);
+    }
+  }
+
+  for (const auto& pair : edge_counts) {
+    PushCollapses(static_cast<Index>(pair.first >> 16),
+                  static_cast<Index>(pair.first & 0xffff));
+  }
+}
+
+mathfu::vec3 Simplifier::GetFaceNormal(const Triangle& tri) const {
+  const mathfu::vec3& p0 = positions_[tri.v[0]];
+  return mathfu::vec3::CrossProduct(positions_[tri.v[1]] - p0,
+                                    positions_[tri.v[2]] - p0);
+}
+
+void Simplifier::PushCollapses(Index a, Index b) {
+  Quadric q = quadrics_[a];
+  q += quadrics_[b];
+  const double cost_onto_a = q.Evaluate(positions_[a]);
+  const double cost_onto_b = q.Evaluate(positions_[b]);
+  queue_.push({cost_onto_b, a, b, stamps_[a], stamps_[b]});
+  queue_.push({cost_onto_a, b, a, stamps_[b], stamps_[a]});
+}
+
+bool Simplifier::IsCollapseValid(Index from, Index to) const {
+  for (size_t t : vertex_triangles_[from]) {
+    const Triangle& tri = triangles_[t];
+    if (tri.removed || tri.v[0] == to || tri.v[1] == to || tri.v[2] == to) {
+      continue;
+    }
+    Triangle moved = tri;
+    for (Index& v : moved.v) {
+      if (v == from) {
+        v = to;
+      }
+    }
+    // Reject collapses which would flip or fully degenerate a triangle.
+    const mathfu::vec3 before = GetFaceNormal(tri);
+    const mathfu::vec3 after = GetFaceNormal(moved);
+    if (mathfu::vec3::DotProduct(before, after) <= 0.f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Simplifier::ApplyCollapse(Index from, Index to) {
+  for (size_t t : vertex_triangles_[from]) {
+    Triangle& tri = triangles_[t];
+    if (tri.removed) {
+      continue;
+    }
+    if (tri.v[0] == to || tri.v[1] == to || tri.v[2] == to) {
+      tri.removed = true;
+      --num_triangles_;
+      continue;
+    }
+    for (Index& v : tri.v) {
+      if (v == from) {
+        v = to;
+      }
+    }
+    vertex_triangles_[to].push_back(t);
+  }
+  vertex_triangles_[from].clear();
+  removed_[from] = true;
+  quadrics_[to] += quadrics_[from];
+  ++stamps_[to];
+
+  // Drop dead triangles from |to| and requeue its edges using the new quadric.
+  auto& tris = vertex_triangles_[to];
+  tris.erase(std::remove_if(tris.begin(), tris.end(),
+                            [this](size_t t) { return triangles_[t].removed; }),
+             tris.end());
+  std::vector<Index> neighbors;
+  for (size_t t : tris) {
+    for (Index v : triangles_[t].v) {
+      if (v != to) {
+        neighbors.push_back(v);
+      }
+    }
+  }
+  std::sort(neighbors.begin(), neighbors.end());
+  neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                  neighbors.end());
+  for (Index v : neighbors) {
+    PushCollapses(to, v);
+  }
+}
+
+void Simplifier::Run(size_t target_num_triangles, double max_error) {
+  while (num_triangles_ > target_num_triangles && !queue_.empty()) {
+    const Collapse collapse = queue_.top();
+    queue_.pop();
+    if (removed_[collapse.from] || removed_[collapse.to] ||
+        stamps_[collapse.from] != collapse.from_stamp ||
+        stamps_[collapse.to] != collapse.to_stamp) {
+      continue;
+    }
+    if (collapse.cost > max_error) {
+      break;
+    }
+    if (!IsCollapseValid(collapse.from, collapse.to)) {
+      continue;
+    }
+    ApplyCollapse(collapse.from, collapse.to);
+  }
+}
+
+MeshData Simplifier::BuildMesh() const {
+  const VertexFormat& format = mesh_.GetVertexFormat();
+  const size_t vertex_size = format.GetVertexSize();
+
+  std::vector<Index> remap(positions_.size(), MeshData::kInvalidIndex);
+  std::vector<Index> indices;
+  indices.reserve(num_triangles_ * 3);
+  size_t num_vertices = 0;
+  for (const Triangle& tri : triangles_) {
+    if (tri.removed) {
+      continue;
+    }
+    for (Index v : tri.v) {
+      if (remap[v] == MeshData::kInvalidIndex) {
+        remap[v] = static_cast<Index>(num_vertices++);
+      }
+      indices.push_back(remap[v]);
+    }
+  }
+
+  std::vector<uint8_t> vertices(num_vertices * vertex_size);
+  const uint8_t* src = mesh_.GetVertexBytes();
+  for (size_t i = 0; i < remap.size(); ++i) {
+    if (remap[i] != MeshData::kInvalidIndex) {
+      memcpy(vertices.data() + remap[i] * vertex_size, src + i * vertex_size,
+             vertex_size);
+    }
+  }
+
+  MeshData result(
+      MeshData::kTriangles, format,
+      DataContainer::CreateHeapDataContainer(vertices.size()),
+      DataContainer::CreateHeapDataContainer(indices.size() * sizeof(Index)));
+  result.AddVertices(vertices.data(), num_vertices, vertex_size);
+  result.AddIndices(indices.data(), indices.size());
+  return result;
+}
+
+}  // namespace
+
+MeshData SimplifyMesh(const MeshData& mesh, size_t target_num_triangles,
+                      float max_error) {
+  if (mesh.GetPrimitiveType() != MeshData::kTriangles) {
+    LOG(DFATAL) << "Can only simplify triangle lists.";
+    return MeshData();
+  }
+  if (!mesh.GetVertexBytes() || !mesh.GetIndexData()) {
+    LOG(DFATAL) << "Can't simplify a mesh without read access or indices.";
+    return MeshData();
+  }
+  if (mesh.GetVertexFormat().GetAttributeAt(0).usage !=
+      VertexAttribute::kPosition) {
+    LOG(DFATAL) << "Vertex format missing position attribute";
+    return MeshData();
+  }
+
+  Simplifier simplifier(mesh);
+  simplifier.Run(target_num_triangles, max_error);
+  return simplifier.BuildMesh();
+}
+
+std::vector<MeshData> GenerateMeshLods(const MeshData& mesh, size_t num_lods,
+                                       float triangle_ratio) {
+  std::vector<MeshData> lods;
+  if (triangle_ratio <= 0.f || triangle_ratio >= 1.f) {
+    LOG(DFATAL) << "Triangle ratio must be in the range (0, 1).";
+    return lods;
+  }
+
+  lods.reserve(num_lods);
+  const MeshData* source = &mesh;
+  for (size_t i = 0; i < num_lods; ++i) {
+    const size_t num_triangles = source->GetNumIndices() / 3;
+    const size_t target = static_cast<size_t>(
+        static_cast<float>(num_triangles) * triangle_ratio);
+    MeshData lod = SimplifyMesh(*source, target);
+    if (lod.GetNumIndices() == 0 || lod.GetNumIndices() / 3 >= num_triangles) {
+      break;
+    }
+    lods.emplace_back(std::move(lod));
+    source = &lods.back();
+  }
+  return lods;
+}
+
+}  // namespace lull
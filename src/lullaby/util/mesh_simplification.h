@@ -0,0 +1,51 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_UTIL_MESH_SIMPLIFICATION_H_
+#define LULLABY_UTIL_MESH_SIMPLIFICATION_H_
+
+#include <limits>
+#include <vector>
+
+#include "lullaby/util/mesh_data.h"
+
+namespace lull {
+
+// Reduces |mesh| to at most |target_num_triangles| triangles using quadric
+// error metric edge collapses, stopping early if the next collapse would
+// introduce an error greater than |max_error| (measured as squared distance).
+// Collapses are restricted to existing vertices so that all non-position
+// attributes are preserved as-is, and edges on open boundaries (including UV
+// seams, which are boundaries in the index topology) are heavily penalized.
+//
+// |mesh| must be a readable, indexed kTriangles mesh with the position as its
+// first attribute.  Returns a heap MeshData with the same vertex format
+// containing only the vertices still referenced, or an empty mesh (with a
+// DFATAL) if |mesh| isn't supported.
+MeshData SimplifyMesh(
+    const MeshData& mesh, size_t target_num_triangles,
+    float max_error = std::numeric_limits<float>::infinity());
+
+// Generates a chain of |num_lods| progressively simpler versions of |mesh|.
+// Each level is simplified from the previous one to |triangle_ratio| (in the
+// range (0, 1)) of its triangle count.  The returned list does not include
+// |mesh| itself, and stops early if a level fails to remove any triangles.
+std::vector<MeshData> GenerateMeshLods(const MeshData& mesh, size_t num_lods,
+                                       float triangle_ratio);
+
+}  // namespace lull
+
+#endif  // LULLABY_UTIL_MESH_SIMPLIFICATION_H_
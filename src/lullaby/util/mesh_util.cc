@@ -19,6 +19,7 @@ limitations under the License.
 #include "mathfu/glsl_mappings.h"
 #include "lullaby/util/logging.h"
 #include "lullaby/util/math.h"
+#include "lullaby/util/simd.h"
 
 namespace lull {
 
@@ -214,6 +215,75 @@ void ApplyDeformation(float* vertices, size_t len, size_t stride,
   }
 }
 
+void ApplyCylinderBendDeformation(float* vertices, size_t len, size_t stride,
+                                  const mathfu::mat4& deformed_from_mesh,
+                                  float radius,
+                                  const mathfu::mat4& mesh_from_deformed) {
+  const size_t kLanes = Float4::kNumLanes;
+  const size_t num_vertices = stride > 0 ? len / stride : 0;
+  const size_t num_batched = num_vertices - (num_vertices % kLanes);
+
+  // Only the top 3 rows of the affine matrices are needed.
+  Float4 pre[3][4];
+  Float4 post[3][4];
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 4; ++col) {
+      pre[row][col] = Float4::Splat(deformed_from_mesh(row, col));
+      post[row][col] = Float4::Splat(mesh_from_deformed(row, col));
+    }
+  }
+  const Float4 inv_radius = Float4::Splat(1.f / radius);
+  const Float4 zero = Float4::Splat(0.f);
+
+  float xs[kLanes];
+  float ys[kLanes];
+  float zs[kLanes];
+  for (size_t vertex = 0; vertex < num_batched; vertex += kLanes) {
+    float* base = vertices + vertex * stride;
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      const float* position = base + lane * stride;
+      xs[lane] = position[0];
+      ys[lane] = position[1];
+      zs[lane] = position[2];
+    }
+    const Float4 x = Float4::Load(xs);
+    const Float4 y = Float4::Load(ys);
+    const Float4 z = Float4::Load(zs);
+
+    const Float4 px = pre[0][0] * x + pre[0][1] * y + pre[0][2] * z + pre[0][3];
+    const Float4 py = pre[1][0] * x + pre[1][1] * y + pre[1][2] * z + pre[1][3];
+    const Float4 pz = pre[2][0] * x + pre[2][1] * y + pre[2][2] * z + pre[2][3];
+
+    Float4 sin_angle;
+    Float4 cos_angle;
+    SinCos(px * inv_radius, &sin_angle, &cos_angle);
+    const Float4 dx = zero - pz * sin_angle;
+    const Float4 dy = py;
+    const Float4 dz = pz * cos_angle;
+
+    (post[0][0] * dx + post[0][1] * dy + post[0][2] * dz + post[0][3])
+        .Store(xs);
+    (post[1][0] * dx + post[1][1] * dy + post[1][2] * dz + post[1][3])
+        .Store(ys);
+    (post[2][0] * dx + post[2][1] * dy + post[2][2] * dz + post[2][3])
+        .Store(zs);
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+      float* position = base + lane * stride;
+      position[0] = xs[lane];
+      position[1] = ys[lane];
+      position[2] = zs[lane];
+    }
+  }
+
+  // Finish off any remaining vertices one at a time.
+  const size_t offset = num_batched * stride;
+  ApplyDeformation(vertices + offset, len - offset, stride,
+                   [&](const mathfu::vec3& pos) {
+                     return mesh_from_deformed *
+                            DeformPoint(deformed_from_mesh * pos, radius);
+                   });
+}
+
 // TODO(b/38379841) Reduce complexity of deformations.
 void ApplyDeformationToMesh(MeshData* mesh,
                             const VertexListDeformation& deform) {
@@ -63,6 +63,15 @@ std::vector<uint16_t> CalculateTesselatedQuadIndices(int num_verts_x,
 void ApplyDeformation(float* vertices, size_t len, size_t stride,
                       const PositionDeformation& deform);
 
+// Bends the positions of |len| floats of vertex data with |stride| floats per
+// vertex around a cylinder.  This is equivalent to ApplyDeformation() with:
+//   mesh_from_deformed * DeformPoint(deformed_from_mesh * pos, radius)
+// but processes multiple vertices per iteration using SIMD where available.
+void ApplyCylinderBendDeformation(float* vertices, size_t len, size_t stride,
+                                  const mathfu::mat4& deformed_from_mesh,
+                                  float radius,
+                                  const mathfu::mat4& mesh_from_deformed);
+
 // Deforms |mesh| in-place by applying |deform| to each of its vertices. Fails
 // with a DFATAL if |mesh| doesn't have read+write access.
 // TODO(b/38379841) Reduce complexity of deformations.
@@ -0,0 +1,137 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/pose_history.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "lullaby/util/logging.h"
+#include "lullaby/util/math.h"
+#include "lullaby/util/time.h"
+
+namespace lull {
+
+const size_t PoseHistory::kCapacity;
+const Clock::duration PoseHistory::kMinVelocityInterval =
+    std::chrono::milliseconds(4);
+const Clock::duration PoseHistory::kMaxPredictionTime =
+    std::chrono::milliseconds(100);
+
+PoseHistory::PoseHistory() : size_(0), latest_(0) {}
+
+void PoseHistory::Add(Clock::time_point time, const mathfu::vec3& position,
+                      const mathfu::quat& rotation) {
+  if (size_ > 0 && time <= samples_[latest_].time) {
+    if (time < samples_[latest_].time) {
+      LOG(DFATAL) << "Pose samples must be added in order of time.";
+      return;
+    }
+  } else {
+    latest_ = (latest_ + 1) % kCapacity;
+    size_ = std::min(size_ + 1, kCapacity);
+  }
+
+  TimedPose& sample = samples_[latest_];
+  sample.time = time;
+  sample.position = position;
+  sample.rotation = rotation;
+}
+
+void PoseHistory::Clear() {
+  size_ = 0;
+  latest_ = 0;
+}
+
+const TimedPose& PoseHistory::GetLatest() const {
+  DCHECK(size_ > 0) << "No pose samples.";
+  return samples_[latest_];
+}
+
+const TimedPose& PoseHistory::Get(size_t age) const {
+  return samples_[(latest_ + kCapacity - age) % kCapacity];
+}
+
+TimedPose PoseHistory::Predict(Clock::time_point time) const {
+  TimedPose result;
+  result.time = time;
+  if (size_ == 0) {
+    return result;
+  }
+
+  const TimedPose& latest = Get(0);
+  if (time <= latest.time) {
+    // Interpolate between the samples on either side of |time|.
+    for (size_t age = 1; age < size_; ++age) {
+      const TimedPose& older = Get(age);
+      if (older.time <= time) {
+        const TimedPose& newer = Get(age - 1);
+        const float t = SecondsFromDuration(time - older.time) /
+                        SecondsFromDuration(newer.time - older.time);
+        result.position = mathfu::Lerp(older.position, newer.position, t);
+        result.rotation =
+            mathfu::quat::Slerp(older.rotation, newer.rotation, t);
+        return result;
+      }
+    }
+    const TimedPose& oldest = Get(size_ - 1);
+    result.position = oldest.position;
+    result.rotation = oldest.rotation;
+    return result;
+  }
+
+  result.position = latest.position;
+  result.rotation = latest.rotation;
+
+  // Measure the velocity from the latest sample back to the newest sample that
+  // is at least kMinVelocityInterval older, or the oldest sample if none are.
+  size_t age = 1;
+  while (age + 1 < size_ &&
+         latest.time - Get(age).time < kMinVelocityInterval) {
+    ++age;
+  }
+  if (age >= size_) {
+    return result;
+  }
+  const TimedPose& reference = Get(age);
+  const float interval = SecondsFromDuration(latest.time - reference.time);
+  if (interval <= 0.f) {
+    return result;
+  }
+  const float lead =
+      SecondsFromDuration(std::min(time - latest.time, kMaxPredictionTime)) /
+      interval;
+
+  result.position += (latest.position - reference.position) * lead;
+
+  // Extrapolate the rotation from |reference| to |latest| along the shortest
+  // arc.
+  mathfu::quat delta = latest.rotation * reference.rotation.Inverse();
+  if (delta.scalar() < 0.f) {
+    delta = mathfu::quat(-delta.scalar(), -delta.vector());
+  }
+  const float sin_half_angle = delta.vector().Length();
+  if (sin_half_angle > kDefaultEpsilon) {
+    const float angle = 2.f * std::atan2(sin_half_angle, delta.scalar());
+    const mathfu::vec3 axis = delta.vector() / sin_half_angle;
+    result.rotation =
+        mathfu::quat::FromAngleAxis(angle * lead, axis) * latest.rotation;
+    result.rotation.Normalize();
+  }
+  return result;
+}
+
+}  // namespace lull
@@ -0,0 +1,86 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_UTIL_POSE_HISTORY_H_
+#define LULLABY_UTIL_POSE_HISTORY_H_
+
+#include <stddef.h>
+
+#include "mathfu/constants.h"
+#include "mathfu/glsl_mappings.h"
+#include "lullaby/util/clock.h"
+
+namespace lull {
+
+// A pose (position and rotation) sampled at a point in time.
+struct TimedPose {
+  Clock::time_point time;
+  mathfu::vec3 position = mathfu::kZeros3f;
+  mathfu::quat rotation = mathfu::quat::identity;
+};
+
+// A fixed-size ring of the most recent poses of a tracked device, which can be
+// used to estimate the device's pose at any point in time.  Times between
+// samples are interpolated, and times after the latest sample are predicted
+// using the velocity of the device over its recent samples.
+class PoseHistory {
+ public:
+  // The number of samples kept.
+  static const size_t kCapacity = 8;
+
+  // Velocities are measured over at least this long, which avoids amplifying
+  // noise between samples taken in quick succession (eg. separate position and
+  // rotation updates).
+  static const Clock::duration kMinVelocityInterval;
+
+  // Predictions are limited to this far past the latest sample.
+  static const Clock::duration kMaxPredictionTime;
+
+  PoseHistory();
+
+  // Adds a sample.  Samples must be added in order of time.  A sample with the
+  // same time as the latest sample replaces it.
+  void Add(Clock::time_point time, const mathfu::vec3& position,
+           const mathfu::quat& rotation);
+
+  // Removes all samples.
+  void Clear();
+
+  // Returns the number of samples.
+  size_t Size() const { return size_; }
+
+  // Returns true if there are no samples.
+  bool Empty() const { return size_ == 0; }
+
+  // Returns the most recent sample.  Must not be called if empty.
+  const TimedPose& GetLatest() const;
+
+  // Returns the estimated pose at |time|.  Times before the oldest sample
+  // return the oldest sample.  Returns the identity pose if empty.
+  TimedPose Predict(Clock::time_point time) const;
+
+ private:
+  // Returns the sample taken |age| samples before the latest sample.
+  const TimedPose& Get(size_t age) const;
+
+  TimedPose samples_[kCapacity];
+  size_t size_;
+  size_t latest_;
+};
+
+}  // namespace lull
+
+#endif  // LULLABY_UTIL_POSE_HISTORY_H_
@@ -0,0 +1,213 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/quantized_spline.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "lullaby/util/logging.h"
+#include "lullaby/util/math.h"
+
+namespace lull {
+namespace {
+
+constexpr float kMaxTime = 65535.f;
+constexpr float kMaxValue = 65535.f;
+// Angles of +/-90 degrees have infinite slopes, so stop just short of them.
+constexpr float kMaxAngle = 32766.f;
+constexpr float kHalfPi = kPi * 0.5f;
+
+// Returns the factor that converts derivatives into slopes of the spline
+// normalized to the unit square.
+float GetSlopeScale(float min_value, float max_value, float end_time) {
+  const float range = max_value - min_value;
+  if (range <= 0.f || end_time <= 0.f) {
+    return 1.f;
+  }
+  return end_time / range;
+}
+
+uint16_t QuantizeUnit(float value, float min, float max, float quantum) {
+  if (max <= min) {
+    return 0;
+  }
+  const float unit = mathfu::Clamp((value - min) / (max - min), 0.f, 1.f);
+  return static_cast<uint16_t>(std::round(unit * quantum));
+}
+
+float EvaluateHermite(const SplineNode& a, const SplineNode& b, float time) {
+  const float h = b.time - a.time;
+  if (h <= 0.f) {
+    return a.value;
+  }
+  const float u = (time - a.time) / h;
+  const float u2 = u * u;
+  const float u3 = u2 * u;
+  return (2.f * u3 - 3.f * u2 + 1.f) * a.value +
+         (u3 - 2.f * u2 + u) * h * a.derivative +
+         (-2.f * u3 + 3.f * u2) * b.value + (u3 - u2) * h * b.derivative;
+}
+
+// Returns true if the segment from |nodes[begin]| to |nodes[end]| matches the
+// original keys in between to within |tolerance|.
+bool SegmentFits(const SplineNode* nodes, size_t begin, size_t end,
+                 float tolerance) {
+  const SplineNode& a = nodes[begin];
+  const SplineNode& b = nodes[end];
+  for (size_t i = begin; i < end; ++i) {
+    const SplineNode& n0 = nodes[i];
+    const SplineNode& n1 = nodes[i + 1];
+    if (i != begin &&
+        std::abs(EvaluateHermite(a, b, n0.time) - n0.value) > tolerance) {
+      return false;
+    }
+    const float mid = (n0.time + n1.time) * 0.5f;
+    if (std::abs(EvaluateHermite(a, b, mid) - EvaluateHermite(n0, n1, mid)) >
+        tolerance) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+QuantizedSpline QuantizeSpline(const SplineNode* nodes, size_t count) {
+  QuantizedSpline spline;
+  if (count == 0) {
+    return spline;
+  }
+  if (count > 1 && nodes[0].time != 0.f) {
+    LOG(DFATAL) << "Splines must start at time 0.";
+  }
+
+  spline.min_value = nodes[0].value;
+  spline.max_value = nodes[0].value;
+  for (size_t i = 1; i < count; ++i) {
+    spline.min_value = std::min(spline.min_value, nodes[i].value);
+    spline.max_value = std::max(spline.max_value, nodes[i].value);
+  }
+  spline.end_time = nodes[count - 1].time;
+
+  const float slope_scale =
+      GetSlopeScale(spline.min_value, spline.max_value, spline.end_time);
+  spline.times.reserve(count);
+  spline.values.reserve(count);
+  spline.angles.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    spline.times.push_back(
+        QuantizeUnit(nodes[i].time, 0.f, spline.end_time, kMaxTime));
+    spline.values.push_back(QuantizeUnit(nodes[i].value, spline.min_value,
+                                         spline.max_value, kMaxValue));
+    const float angle = std::atan(nodes[i].derivative * slope_scale) / kHalfPi;
+    spline.angles.push_back(static_cast<int16_t>(
+        std::round(mathfu::Clamp(angle * kMaxAngle, -kMaxAngle, kMaxAngle))));
+  }
+  return spline;
+}
+
+SplineNode DequantizeSplineNode(float min_value, float max_value,
+                                float end_time, uint16_t time, uint16_t value,
+                                int16_t angle) {
+  const float slope_scale = GetSlopeScale(min_value, max_value, end_time);
+  const float slope =
+      std::tan(static_cast<float>(angle) / kMaxAngle * kHalfPi);
+  const float range = max_value - min_value;
+  return SplineNode(static_cast<float>(time) / kMaxTime * end_time,
+                    min_value + static_cast<float>(value) / kMaxValue * range,
+                    slope / slope_scale);
+}
+
+std::vector<SplineNode> DequantizeSpline(const QuantizedSpline& spline) {
+  const size_t count = spline.times.size();
+  if (spline.values.size() != count || spline.angles.size() != count) {
+    LOG(DFATAL) << "Mismatched quantized spline data.";
+    return std::vector<SplineNode>();
+  }
+
+  std::vector<SplineNode> nodes;
+  nodes.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    nodes.push_back(DequantizeSplineNode(spline.min_value, spline.max_value,
+                                         spline.end_time, spline.times[i],
+                                         spline.values[i], spline.angles[i]));
+  }
+  return nodes;
+}
+
+float EvaluateSpline(const SplineNode* nodes, size_t count, float time) {
+  if (count == 0) {
+    return 0.f;
+  }
+  if (time <= nodes[0].time) {
+    return nodes[0].value;
+  }
+  if (time >= nodes[count - 1].time) {
+    return nodes[count - 1].value;
+  }
+
+  const SplineNode* next = std::upper_bound(
+      nodes, nodes + count, time,
+      [](float t, const SplineNode& node) { return t < node.time; });
+  return EvaluateHermite(*(next - 1), *next, time);
+}
+
+std::vector<SplineNode> ReduceSplineKeys(const SplineNode* nodes, size_t count,
+                                         float tolerance) {
+  std::vector<SplineNode> reduced;
+  if (count == 0) {
+    return reduced;
+  }
+
+  // Greedily extend each segment for as long as it still matches the original
+  // keys that it replaces.
+  reduced.push_back(nodes[0]);
+  size_t anchor = 0;
+  for (size_t i = 1; i + 1 < count; ++i) {
+    if (!SegmentFits(nodes, anchor, i + 1, tolerance)) {
+      reduced.push_back(nodes[i]);
+      anchor = i;
+    }
+  }
+  if (count > 1) {
+    reduced.push_back(nodes[count - 1]);
+  }
+  return reduced;
+}
+
+float MeasureSplineError(const SplineNode* a, size_t a_count,
+                         const SplineNode* b, size_t b_count,
+                         size_t num_samples) {
+  if (a_count == 0 || num_samples == 0) {
+    return 0.f;
+  }
+
+  const float start = a[0].time;
+  const float duration = a[a_count - 1].time - start;
+  float max_error = 0.f;
+  for (size_t i = 0; i < num_samples; ++i) {
+    const float percent =
+        num_samples > 1 ? static_cast<float>(i) / (num_samples - 1) : 0.f;
+    const float time = start + duration * percent;
+    const float error = std::abs(EvaluateSpline(a, a_count, time) -
+                                 EvaluateSpline(b, b_count, time));
+    max_error = std::max(max_error, error);
+  }
+  return max_error;
+}
+
+}  // namespace lull
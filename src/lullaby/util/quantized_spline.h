@@ -0,0 +1,82 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_UTIL_QUANTIZED_SPLINE_H_
+#define LULLABY_UTIL_QUANTIZED_SPLINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace lull {
+
+// A key of a cubic Hermite spline.  |time| is in seconds and |derivative| is
+// the slope of the curve at the key, in value units per second.
+struct SplineNode {
+  SplineNode() {}
+  SplineNode(float time, float value, float derivative)
+      : time(time), value(value), derivative(derivative) {}
+
+  float time = 0.f;
+  float value = 0.f;
+  float derivative = 0.f;
+};
+
+// A spline whose keys are quantized to 16 bits each.  Times are stored as a
+// fraction of |end_time| and values as a fraction of [min_value, max_value].
+// Derivatives are stored as the angle of the slope after normalizing the curve
+// to a unit square, which keeps precision independent of the curve's scale.
+struct QuantizedSpline {
+  float min_value = 0.f;
+  float max_value = 0.f;
+  float end_time = 0.f;
+  std::vector<uint16_t> times;
+  std::vector<uint16_t> values;
+  std::vector<int16_t> angles;
+};
+
+// Quantizes the |count| |nodes|, which must be sorted by time and start at
+// time 0.
+QuantizedSpline QuantizeSpline(const SplineNode* nodes, size_t count);
+
+// Reconstructs a single key from its quantized representation.  This allows
+// keys to be decoded directly from serialized data without first copying them
+// into a QuantizedSpline.
+SplineNode DequantizeSplineNode(float min_value, float max_value,
+                                float end_time, uint16_t time, uint16_t value,
+                                int16_t angle);
+
+// Reconstructs all the keys of |spline|.
+std::vector<SplineNode> DequantizeSpline(const QuantizedSpline& spline);
+
+// Evaluates the spline defined by the |count| |nodes| at |time|.  Times
+// outside of the spline are clamped to its first and last keys.
+float EvaluateSpline(const SplineNode* nodes, size_t count, float time);
+
+// Removes keys from the |count| |nodes| that can be reconstructed from their
+// neighbours to within |tolerance|.  The first and last keys are always kept.
+std::vector<SplineNode> ReduceSplineKeys(const SplineNode* nodes, size_t count,
+                                         float tolerance);
+
+// Returns the maximum difference between the splines |a| and |b|, sampled at
+// |num_samples| uniformly spaced times over the duration of |a|.
+float MeasureSplineError(const SplineNode* a, size_t a_count,
+                         const SplineNode* b, size_t b_count,
+                         size_t num_samples);
+
+}  // namespace lull
+
+#endif  // LULLABY_UTIL_QUANTIZED_SPLINE_H_
@@ -41,13 +41,14 @@ const float RenderView::kDefaultNearClipPlane = 0.2f;
 const float RenderView::kDefaultFarClipPlane = 1000.f;
 
 void PopulateRenderViews(Registry* registry, RenderView* views, size_t num,
-                         float near_clip_plane, float far_clip_plane) {
+                         float near_clip_plane, float far_clip_plane,
+                         bool late_latch_head_pose) {
   if (!registry) {
     LOG(DFATAL) << "PopulateRenderViews called without valid registry.";
     return;
   }
   PopulateRenderViews(registry, views, num, near_clip_plane, far_clip_plane,
-                      mathfu::vec2i(2, 2));
+                      mathfu::vec2i(2, 2), late_latch_head_pose);
   auto* input_manager = registry->Get<InputManager>();
   for (size_t i = 0; i < num; ++i) {
     const InputManager::EyeType eye = static_cast<InputManager::EyeType>(i);
@@ -61,14 +62,18 @@ void PopulateRenderViews(Registry* registry, RenderView* views, size_t num,
 
 void PopulateRenderViews(Registry* registry, RenderView* views, size_t num,
                          float near_clip_plane, float far_clip_plane,
-                         const mathfu::vec2i& render_target_size) {
+                         const mathfu::vec2i& render_target_size,
+                         bool late_latch_head_pose) {
   if (!registry) {
     LOG(DFATAL) << "PopulateRenderViews called without valid registry.";
     return;
   }
   auto* input_manager = registry->Get<InputManager>();
   const mathfu::mat4 start_from_head_transform =
-      input_manager->GetDofWorldFromObjectMatrix(InputManager::kHmd);
+      late_latch_head_pose
+          ? input_manager->GetLatchedDofWorldFromObjectMatrix(
+                InputManager::kHmd)
+          : input_manager->GetDofWorldFromObjectMatrix(InputManager::kHmd);
   for (size_t i = 0; i < num; ++i) {
     const InputManager::EyeType eye = static_cast<InputManager::EyeType>(i);
     const mathfu::vec4i viewport_bounds =
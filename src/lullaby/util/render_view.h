@@ -36,14 +36,20 @@ struct RenderView {
 };
 
 // Populates the RenderView arrays using information from the InputManager.
+// By default the newest head pose is used instead of the one from the start of
+// the frame (see InputManager::GetLatchedDofWorldFromObjectMatrix), so this
+// should be called as close to rendering as possible.  Pass false for
+// |late_latch_head_pose| to use the head pose from the start of the frame.
 void PopulateRenderViews(Registry* registry, RenderView* views, size_t num,
-                         float near_clip_plane, float far_clip_plane);
+                         float near_clip_plane, float far_clip_plane,
+                         bool late_latch_head_pose = true);
 
 // Similar to above, but allows for explicit render target size and clip planes
 // to be used.
 void PopulateRenderViews(Registry* registry, RenderView* views, size_t num,
                          float near_clip_plane, float far_clip_plane,
-                         const mathfu::vec2i& render_target_size);
+                         const mathfu::vec2i& render_target_size,
+                         bool late_latch_head_pose = true);
 
 // Similar to above, but allows for a default near/far clip planes to be used.
 inline void PopulateRenderViews(Registry* registry, RenderView* views,
@@ -0,0 +1,302 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_UTIL_SIMD_H_
+#define LULLABY_UTIL_SIMD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Selects the SIMD instruction set used by Float4.  Define
+// LULLABY_SIMD_DISABLED to force the portable scalar implementation.
+#if defined(LULLABY_SIMD_DISABLED)
+#define LULLABY_SIMD_SCALAR 1
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LULLABY_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define LULLABY_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define LULLABY_SIMD_SCALAR 1
+#endif
+
+namespace lull {
+
+// A minimal wrapper around a 4-wide float register, providing just enough
+// operations to write simple kernels once for SSE2, NEON, and plain C++.
+// Comparisons return lane masks which are only meaningful as the first argument
+// to Select().
+class Float4 {
+ public:
+  static constexpr size_t kNumLanes = 4;
+
+  Float4() {}
+
+  // Loads 4 contiguous, unaligned floats.
+  static Float4 Load(const float* ptr);
+
+  // Sets all lanes to |value|.
+  static Float4 Splat(float value);
+
+  // Sets the lanes to |a|, |b|, |c|, |d|.
+  static Float4 Set(float a, float b, float c, float d) {
+    const float values[kNumLanes] = {a, b, c, d};
+    return Load(values);
+  }
+
+  // Stores 4 contiguous, unaligned floats.
+  void Store(float* ptr) const;
+
+  friend Float4 operator+(const Float4& a, const Float4& b);
+  friend Float4 operator-(const Float4& a, const Float4& b);
+  friend Float4 operator*(const Float4& a, const Float4& b);
+
+  // Returns the per-lane minimum and maximum.
+  static Float4 Min(const Float4& a, const Float4& b);
+  static Float4 Max(const Float4& a, const Float4& b);
+
+  // Returns the per-lane absolute value.
+  static Float4 Abs(const Float4& a);
+
+  // Rounds each lane towards zero.  Only valid for values representable as an
+  // int32_t.
+  static Float4 Truncate(const Float4& a);
+
+  // Per-lane comparisons.
+  static Float4 LessThan(const Float4& a, const Float4& b);
+  static Float4 Equal(const Float4& a, const Float4& b);
+
+  // Returns |a| where |mask| is set and |b| elsewhere.
+  static Float4 Select(const Float4& mask, const Float4& a, const Float4& b);
+
+ private:
+#if LULLABY_SIMD_SSE2
+  explicit Float4(__m128 v) : v_(v) {}
+  __m128 v_;
+#elif LULLABY_SIMD_NEON
+  explicit Float4(float32x4_t v) : v_(v) {}
+  float32x4_t v_;
+#else
+  float v_[kNumLanes];
+#endif
+};
+
+#if LULLABY_SIMD_SSE2
+
+inline Float4 Float4::Load(const float* ptr) { return Float4(_mm_loadu_ps(ptr)); }
+inline Float4 Float4::Splat(float value) { return Float4(_mm_set1_ps(value)); }
+inline void Float4::Store(float* ptr) const { _mm_storeu_ps(ptr, v_); }
+inline Float4 operator+(const Float4& a, const Float4& b) {
+  return Float4(_mm_add_ps(a.v_, b.v_));
+}
+inline Float4 operator-(const Float4& a, const Float4& b) {
+  return Float4(_mm_sub_ps(a.v_, b.v_));
+}
+inline Float4 operator*(const Float4& a, const Float4& b) {
+  return Float4(_mm_mul_ps(a.v_, b.v_));
+}
+inline Float4 Float4::Min(const Float4& a, const Float4& b) {
+  return Float4(_mm_min_ps(a.v_, b.v_));
+}
+inline Float4 Float4::Max(const Float4& a, const Float4& b) {
+  return Float4(_mm_max_ps(a.v_, b.v_));
+}
+inline Float4 Float4::Abs(const Float4& a) {
+  const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  return Float4(_mm_and_ps(a.v_, sign_mask));
+}
+inline Float4 Float4::Truncate(const Float4& a) {
+  return Float4(_mm_cvtepi32_ps(_mm_cvttps_epi32(a.v_)));
+}
+inline Float4 Float4::LessThan(const Float4& a, const Float4& b) {
+  return Float4(_mm_cmplt_ps(a.v_, b.v_));
+}
+inline Float4 Float4::Equal(const Float4& a, const Float4& b) {
+  return Float4(_mm_cmpeq_ps(a.v_, b.v_));
+}
+inline Float4 Float4::Select(const Float4& mask, const Float4& a,
+                             const Float4& b) {
+  return Float4(
+      _mm_or_ps(_mm_and_ps(mask.v_, a.v_), _mm_andnot_ps(mask.v_, b.v_)));
+}
+
+#elif LULLABY_SIMD_NEON
+
+inline Float4 Float4::Load(const float* ptr) { return Float4(vld1q_f32(ptr)); }
+inline Float4 Float4::Splat(float value) { return Float4(vdupq_n_f32(value)); }
+inline void Float4::Store(float* ptr) const { vst1q_f32(ptr, v_); }
+inline Float4 operator+(const Float4& a, const Float4& b) {
+  return Float4(vaddq_f32(a.v_, b.v_));
+}
+inline Float4 operator-(const Float4& a, const Float4& b) {
+  return Float4(vsubq_f32(a.v_, b.v_));
+}
+inline Float4 operator*(const Float4& a, const Float4& b) {
+  return Float4(vmulq_f32(a.v_, b.v_));
+}
+inline Float4 Float4::Min(const Float4& a, const Float4& b) {
+  return Float4(vminq_f32(a.v_, b.v_));
+}
+inline Float4 Float4::Max(const Float4& a, const Float4& b) {
+  return Float4(vmaxq_f32(a.v_, b.v_));
+}
+inline Float4 Float4::Abs(const Float4& a) { return Float4(vabsq_f32(a.v_)); }
+inline Float4 Float4::Truncate(const Float4& a) {
+  return Float4(vcvtq_f32_s32(vcvtq_s32_f32(a.v_)));
+}
+inline Float4 Float4::LessThan(const Float4& a, const Float4& b) {
+  return Float4(vreinterpretq_f32_u32(vcltq_f32(a.v_, b.v_)));
+}
+inline Float4 Float4::Equal(const Float4& a, const Float4& b) {
+  return Float4(vreinterpretq_f32_u32(vceqq_f32(a.v_, b.v_)));
+}
+inline Float4 Float4::Select(const Float4& mask, const Float4& a,
+                             const Float4& b) {
+  return Float4(vbslq_f32(vreinterpretq_u32_f32(mask.v_), a.v_, b.v_));
+}
+
+#else
+
+inline Float4 Float4::Load(const float* ptr) {
+  Float4 r;
+  memcpy(r.v_, ptr, sizeof(r.v_));
+  return r;
+}
+inline Float4 Float4::Splat(float value) {
+  Float4 r;
+  for (size_t i = 0; i < kNumLanes; ++i) {
+    r.v_[i] = value;
+  }
+  return r;
+}
+inline void Float4::Store(float* ptr) const { memcpy(ptr, v_, sizeof(v_)); }
+
+#define LULLABY_FLOAT4_LANEWISE(expr) \
+  Float4 r;                           \
+  for (size_t i = 0; i < kNumLanes; ++i) { \
+    r.v_[i] = (expr);                 \
+  }                                   \
+  return r;
+
+inline Float4 operator+(const Float4& a, const Float4& b) {
+  constexpr size_t kNumLanes = Float4::kNumLanes;
+  LULLABY_FLOAT4_LANEWISE(a.v_[i] + b.v_[i]);
+}
+inline Float4 operator-(const Float4& a, const Float4& b) {
+  constexpr size_t kNumLanes = Float4::kNumLanes;
+  LULLABY_FLOAT4_LANEWISE(a.v_[i] - b.v_[i]);
+}
+inline Float4 operator*(const Float4& a, const Float4& b) {
+  constexpr size_t kNumLanes = Float4::kNumLanes;
+  LULLABY_FLOAT4_LANEWISE(a.v_[i] * b.v_[i]);
+}
+inline Float4 Float4::Min(const Float4& a, const Float4& b) {
+  LULLABY_FLOAT4_LANEWISE(a.v_[i] < b.v_[i] ? a.v_[i] : b.v_[i]);
+}
+inline Float4 Float4::Max(const Float4& a, const Float4& b) {
+  LULLABY_FLOAT4_LANEWISE(a.v_[i] > b.v_[i] ? a.v_[i] : b.v_[i]);
+}
+inline Float4 Float4::Abs(const Float4& a) {
+  LULLABY_FLOAT4_LANEWISE(a.v_[i] < 0.f ? -a.v_[i] : a.v_[i]);
+}
+inline Float4 Float4::Truncate(const Float4& a) {
+  LULLABY_FLOAT4_LANEWISE(static_cast<float>(static_cast<int32_t>(a.v_[i])));
+}
+// The scalar masks are stored as 0.f or 1.f rather than as bit patterns.
+inline Float4 Float4::LessThan(const Float4& a, const Float4& b) {
+  LULLABY_FLOAT4_LANEWISE(a.v_[i] < b.v_[i] ? 1.f : 0.f);
+}
+inline Float4 Float4::Equal(const Float4& a, const Float4& b) {
+  LULLABY_FLOAT4_LANEWISE(a.v_[i] == b.v_[i] ? 1.f : 0.f);
+}
+inline Float4 Float4::Select(const Float4& mask, const Float4& a,
+                             const Float4& b) {
+  LULLABY_FLOAT4_LANEWISE(mask.v_[i] != 0.f ? a.v_[i] : b.v_[i]);
+}
+
+#undef LULLABY_FLOAT4_LANEWISE
+
+#endif
+
+// Computes the sine and cosine of each lane of |x| using Cephes-style minimax
+// polynomials after reducing |x| to [-pi/4, pi/4].  Accurate to within a few
+// ulps for |x| < 8192.
+inline void SinCos(const Float4& x, Float4* sin_out, Float4* cos_out) {
+  const Float4 zero = Float4::Splat(0.f);
+  const Float4 one = Float4::Splat(1.f);
+  const Float4 neg_one = Float4::Splat(-1.f);
+  const Float4 two = Float4::Splat(2.f);
+  const Float4 four = Float4::Splat(4.f);
+  const Float4 six = Float4::Splat(6.f);
+  const Float4 eight = Float4::Splat(8.f);
+
+  const Float4 sin_sign = Float4::Select(Float4::LessThan(x, zero), neg_one,
+                                         one);
+  Float4 ax = Float4::Abs(x);
+
+  // j is the nearest even multiple of pi/4, and q is its octant (0, 2, 4, 6).
+  const Float4 four_over_pi = Float4::Splat(1.27323954473516f);
+  const Float4 j =
+      Float4::Truncate((ax * four_over_pi + one) * Float4::Splat(0.5f)) * two;
+  const Float4 q = j - Float4::Truncate(j * Float4::Splat(0.125f)) * eight;
+
+  // Extended precision modular arithmetic: ax - j * pi/4.
+  ax = ax - j * Float4::Splat(0.78515625f);
+  ax = ax - j * Float4::Splat(2.4187564849853515625e-4f);
+  ax = ax - j * Float4::Splat(3.77489497744594108e-8f);
+  const Float4 z = ax * ax;
+
+  const Float4 cos_poly =
+      ((Float4::Splat(2.443315711809948e-5f) * z -
+        Float4::Splat(1.388731625493765e-3f)) *
+           z +
+       Float4::Splat(4.166664568298827e-2f)) *
+          z * z -
+      Float4::Splat(0.5f) * z + one;
+  const Float4 sin_poly =
+      ((Float4::Splat(-1.9515295891e-4f) * z +
+        Float4::Splat(8.3321608736e-3f)) *
+           z -
+       Float4::Splat(1.6666654611e-1f)) *
+          z * ax +
+      ax;
+
+  // Octants 2 and 6 swap the polynomials; the signs follow the quadrant.
+  const Float4 swap = Float4::Select(Float4::Equal(q, two), one,
+                                     Float4::Select(Float4::Equal(q, six), one,
+                                                    zero));
+  const Float4 swap_mask = Float4::Equal(swap, one);
+  const Float4 sin_value = Float4::Select(swap_mask, cos_poly, sin_poly);
+  const Float4 cos_value = Float4::Select(swap_mask, sin_poly, cos_poly);
+
+  const Float4 sin_quadrant_sign =
+      Float4::Select(Float4::LessThan(q, four), one, neg_one);
+  const Float4 cos_negative = Float4::Select(
+      Float4::Equal(q, two), one,
+      Float4::Select(Float4::Equal(q, four), one, zero));
+  const Float4 cos_quadrant_sign =
+      Float4::Select(Float4::Equal(cos_negative, one), neg_one, one);
+
+  *sin_out = sin_value * sin_quadrant_sign * sin_sign;
+  *cos_out = cos_value * cos_quadrant_sign;
+}
+
+}  // namespace lull
+
+#endif  // LULLABY_UTIL_SIMD_H_
@@ -0,0 +1,161 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/texture_container.h"
+
+#include <string.h>
+#include <algorithm>
+
+#include "lullaby/util/image_util.h"
+#include "lullaby/util/logging.h"
+
+namespace lull {
+namespace {
+
+const uint8_t kKtxIdentifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31,
+                                    0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+// Written in the writer's byte order, so readers can detect a mismatch.
+constexpr uint32_t kKtxEndianness = 0x04030201;
+
+// The KTX header, which follows the identifier.
+struct KtxHeader {
+  uint32_t endianness;
+  uint32_t gl_type;
+  uint32_t gl_type_size;
+  uint32_t gl_format;
+  uint32_t gl_internal_format;
+  uint32_t gl_base_internal_format;
+  uint32_t pixel_width;
+  uint32_t pixel_height;
+  uint32_t pixel_depth;
+  uint32_t number_of_array_elements;
+  uint32_t number_of_faces;
+  uint32_t number_of_mipmap_levels;
+  uint32_t bytes_of_key_value_data;
+};
+
+constexpr size_t kHeaderSize = sizeof(kKtxIdentifier) + sizeof(KtxHeader);
+
+// Mip levels are padded to a multiple of 4 bytes.
+inline size_t GetPaddedSize(size_t size) { return (size + 3) & ~size_t(3); }
+
+void Append(const void* data, size_t size, std::vector<uint8_t>* out) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  out->insert(out->end(), bytes, bytes + size);
+}
+
+}  // namespace
+
+const char* const kTextureContainerExtension = ".ktx";
+
+void WriteTextureContainer(const TextureContainer& container,
+                           std::vector<uint8_t>* out) {
+  KtxHeader header;
+  header.endianness = kKtxEndianness;
+  header.gl_type = container.gl_type;
+  header.gl_type_size = 1;
+  header.gl_format = container.gl_format;
+  header.gl_internal_format = container.gl_internal_format;
+  header.gl_base_internal_format = container.gl_base_internal_format;
+  header.pixel_width = static_cast<uint32_t>(container.size.x);
+  header.pixel_height = static_cast<uint32_t>(container.size.y);
+  header.pixel_depth = 0;
+  header.number_of_array_elements = 0;
+  header.number_of_faces = 1;
+  header.number_of_mipmap_levels =
+      static_cast<uint32_t>(container.levels.size());
+  header.bytes_of_key_value_data = 0;
+
+  size_t total_size = kHeaderSize;
+  for (const Span<uint8_t>& level : container.levels) {
+    total_size += sizeof(uint32_t) + GetPaddedSize(level.size());
+  }
+
+  out->clear();
+  out->reserve(total_size);
+  Append(kKtxIdentifier, sizeof(kKtxIdentifier), out);
+  Append(&header, sizeof(header), out);
+  for (const Span<uint8_t>& level : container.levels) {
+    const uint32_t image_size = static_cast<uint32_t>(level.size());
+    Append(&image_size, sizeof(image_size), out);
+    Append(level.data(), level.size(), out);
+    out->resize(out->size() + GetPaddedSize(level.size()) - level.size(), 0);
+  }
+}
+
+bool ParseTextureContainer(Span<uint8_t> data, TextureContainer* container) {
+  if (data.size() < kHeaderSize ||
+      memcmp(data.data(), kKtxIdentifier, sizeof(kKtxIdentifier)) != 0) {
+    LOG(ERROR) << "Texture container is not a KTX file.";
+    return false;
+  }
+  KtxHeader header;
+  memcpy(&header, data.data() + sizeof(kKtxIdentifier), sizeof(header));
+  if (header.endianness != kKtxEndianness) {
+    LOG(ERROR) << "Texture container has the wrong byte order.";
+    return false;
+  }
+  if (header.pixel_width == 0 || header.pixel_height == 0 ||
+      header.pixel_depth != 0 || header.number_of_array_elements != 0 ||
+      header.number_of_faces != 1) {
+    LOG(ERROR) << "Texture container is not a single 2D texture.";
+    return false;
+  }
+
+  container->gl_type = header.gl_type;
+  container->gl_format = header.gl_format;
+  container->gl_internal_format = header.gl_internal_format;
+  container->gl_base_internal_format = header.gl_base_internal_format;
+  container->size = mathfu::vec2i(static_cast<int>(header.pixel_width),
+                                  static_cast<int>(header.pixel_height));
+  container->levels.clear();
+
+  // A level count of 0 requests that mips are generated at load time, but the
+  // file still contains the first level.
+  const uint32_t num_levels = header.number_of_mipmap_levels > 0
+                                  ? header.number_of_mipmap_levels
+                                  : 1;
+  if (num_levels > static_cast<uint32_t>(GetNumMipLevels(container->size))) {
+    LOG(ERROR) << "Texture container has more mip levels than its size "
+                  "allows.";
+    return false;
+  }
+  size_t offset = kHeaderSize;
+  if (header.bytes_of_key_value_data > data.size() - offset) {
+    LOG(ERROR) << "Texture container is truncated.";
+    return false;
+  }
+  offset += header.bytes_of_key_value_data;
+  for (uint32_t i = 0; i < num_levels; ++i) {
+    uint32_t image_size = 0;
+    if (data.size() - offset < sizeof(image_size)) {
+      LOG(ERROR) << "Texture container is truncated.";
+      return false;
+    }
+    memcpy(&image_size, data.data() + offset, sizeof(image_size));
+    offset += sizeof(image_size);
+    if (image_size > data.size() - offset) {
+      LOG(ERROR) << "Texture container is truncated.";
+      return false;
+    }
+    container->levels.emplace_back(data.data() + offset, image_size);
+    offset += std::min(GetPaddedSize(image_size), data.size() - offset);
+  }
+  return true;
+}
+
+}  // namespace lull
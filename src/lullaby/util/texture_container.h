@@ -0,0 +1,68 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_UTIL_TEXTURE_CONTAINER_H_
+#define LULLABY_UTIL_TEXTURE_CONTAINER_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "mathfu/glsl_mappings.h"
+#include "lullaby/util/span.h"
+
+namespace lull {
+
+// The file extension of texture containers.
+extern const char* const kTextureContainerExtension;
+
+// A texture whose mip levels are stored ready to be uploaded to the GPU, so
+// that loading it requires no decoding.  Texture containers are serialized
+// using the KTX 1.1 file format.  Only single 2D textures are supported (ie.
+// no cube maps, arrays or 3D textures).
+struct TextureContainer {
+  // Returns true if the texture data is in a compressed format, which must be
+  // uploaded using glCompressedTexImage2D.
+  bool IsCompressed() const { return gl_type == 0; }
+
+  // The GL enums describing the texture data, as passed to glTexImage2D or
+  // glCompressedTexImage2D.  |gl_type| and |gl_format| are 0 for compressed
+  // formats.
+  uint32_t gl_type = 0;
+  uint32_t gl_format = 0;
+  uint32_t gl_internal_format = 0;
+  uint32_t gl_base_internal_format = 0;
+
+  // The size of the first mip level.  Each following level is half the size of
+  // the previous one, rounded down, with a minimum of 1.
+  mathfu::vec2i size = mathfu::vec2i(0, 0);
+
+  // The data of each mip level, starting with the full size image.  When
+  // parsed, these reference the parsed data.
+  std::vector<Span<uint8_t>> levels;
+};
+
+// Serializes |container| into |out|, replacing its contents.
+void WriteTextureContainer(const TextureContainer& container,
+                           std::vector<uint8_t>* out);
+
+// Parses a texture container from |data|, without copying the texture data.
+// The |container| references |data|, which must outlive it.  Returns false if
+// |data| is not a valid KTX file or uses unsupported features.
+bool ParseTextureContainer(Span<uint8_t> data, TextureContainer* container);
+
+}  // namespace lull
+
+#endif  // LULLABY_UTIL_TEXTURE_CONTAINER_H_
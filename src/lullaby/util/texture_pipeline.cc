@@ -0,0 +1,154 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/texture_pipeline.h"
+
+#include "lullaby/util/etc2_encoder.h"
+#include "lullaby/util/image_util.h"
+#include "lullaby/util/logging.h"
+#include "lullaby/util/texture_container.h"
+
+namespace lull {
+namespace {
+
+constexpr uint32_t kGlUnsignedByte = 0x1401;
+constexpr uint32_t kGlRgb = 0x1907;
+constexpr uint32_t kGlRgba = 0x1908;
+constexpr uint32_t kGlRgba8 = 0x8058;
+
+// Returns the number of bytes in a |size| level of |container|, or 0 if the
+// container's format is not one written by ProcessTexture.
+size_t GetTextureContainerLevelSize(const TextureContainer& container,
+                                    const mathfu::vec2i& size) {
+  if (container.IsCompressed()) {
+    switch (container.gl_internal_format) {
+      case kGlCompressedRgb8Etc2:
+        return GetEtc2ImageSize(size, false);
+      case kGlCompressedRgba8Etc2Eac:
+        return GetEtc2ImageSize(size, true);
+      default:
+        return 0;
+    }
+  }
+  if (container.gl_type == kGlUnsignedByte && container.gl_format == kGlRgba) {
+    return GetRgbaImageSize(size);
+  }
+  return 0;
+}
+
+}  // namespace
+
+bool ProcessTexture(const uint8_t* rgba_ptr, const mathfu::vec2i& size,
+                    const TextureProcessingOptions& options,
+                    std::vector<uint8_t>* out, JobProcessor* processor) {
+  if (rgba_ptr == nullptr || out == nullptr) {
+    LOG(DFATAL) << "ProcessTexture requires an image and an output buffer.";
+    return false;
+  }
+  if (size.x <= 0 || size.y <= 0) {
+    LOG(ERROR) << "Cannot process a texture of size " << size.x << "x"
+               << size.y;
+    return false;
+  }
+
+  std::vector<uint8_t> premultiplied;
+  const uint8_t* base_ptr = rgba_ptr;
+  if (options.premultiply_alpha) {
+    premultiplied.resize(GetRgbaImageSize(size));
+    PremultiplyAlphaRgba8888(rgba_ptr, size, premultiplied.data(), processor);
+    base_ptr = premultiplied.data();
+  }
+
+  std::vector<uint8_t> mips;
+  const int num_levels = options.generate_mips ? GetNumMipLevels(size) : 1;
+  if (num_levels > 1) {
+    GenerateMipmapsRgba8888(base_ptr, size, &mips, processor);
+  }
+
+  TextureContainer container;
+  container.size = size;
+  switch (options.encoding) {
+    case TextureEncoding::kRgba8888:
+      container.gl_type = kGlUnsignedByte;
+      container.gl_format = kGlRgba;
+      container.gl_internal_format = kGlRgba8;
+      container.gl_base_internal_format = kGlRgba;
+      break;
+    case TextureEncoding::kEtc2Rgb8:
+      container.gl_internal_format = kGlCompressedRgb8Etc2;
+      container.gl_base_internal_format = kGlRgb;
+      break;
+    case TextureEncoding::kEtc2Rgba8:
+      container.gl_internal_format = kGlCompressedRgba8Etc2Eac;
+      container.gl_base_internal_format = kGlRgba;
+      break;
+  }
+
+  // Compressed levels are encoded one after another into a single buffer.
+  const bool has_alpha = options.encoding == TextureEncoding::kEtc2Rgba8;
+  std::vector<uint8_t> encoded;
+  if (container.IsCompressed()) {
+    size_t total_size = 0;
+    mathfu::vec2i level_size = size;
+    for (int i = 0; i < num_levels; ++i) {
+      total_size += GetEtc2ImageSize(level_size, has_alpha);
+      level_size = GetHalvedImageSize(level_size);
+    }
+    encoded.resize(total_size);
+  }
+
+  const uint8_t* level_ptr = base_ptr;
+  mathfu::vec2i level_size = size;
+  size_t encoded_offset = 0;
+  for (int i = 0; i < num_levels; ++i) {
+    const size_t rgba_size = GetRgbaImageSize(level_size);
+    if (container.IsCompressed()) {
+      const size_t encoded_size = GetEtc2ImageSize(level_size, has_alpha);
+      EncodeEtc2(level_ptr, level_size, has_alpha,
+                 encoded.data() + encoded_offset, processor);
+      container.levels.emplace_back(encoded.data() + encoded_offset,
+                                    encoded_size);
+      encoded_offset += encoded_size;
+    } else {
+      container.levels.emplace_back(level_ptr, rgba_size);
+    }
+    // The mips follow each other in |mips|, starting with level 1.
+    level_ptr = i == 0 ? mips.data() : level_ptr + rgba_size;
+    level_size = GetHalvedImageSize(level_size);
+  }
+
+  WriteTextureContainer(container, out);
+  return true;
+}
+
+bool IsTextureContainerUploadable(const TextureContainer& container) {
+  if (container.levels.empty() ||
+      GetTextureContainerLevelSize(container, container.size) == 0) {
+    return false;
+  }
+  // GL reads each level's size from its dimensions, so every level must hold
+  // exactly that much data.
+  mathfu::vec2i level_size = container.size;
+  for (const Span<uint8_t>& level : container.levels) {
+    if (level.size() != GetTextureContainerLevelSize(container, level_size)) {
+      return false;
+    }
+    level_size = GetHalvedImageSize(level_size);
+  }
+  return true;
+}
+
+}  // namespace lull
@@ -0,0 +1,68 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_UTIL_TEXTURE_PIPELINE_H_
+#define LULLABY_UTIL_TEXTURE_PIPELINE_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "mathfu/glsl_mappings.h"
+#include "lullaby/base/job_processor.h"
+#include "lullaby/util/texture_container.h"
+
+namespace lull {
+
+// The formats in which processed textures can be stored.
+enum class TextureEncoding {
+  kRgba8888,   // Uncompressed, 4 bytes per pixel.
+  kEtc2Rgb8,   // ETC2 compressed, 0.5 bytes per pixel, opaque.
+  kEtc2Rgba8,  // ETC2 compressed with EAC alpha, 1 byte per pixel.
+};
+
+struct TextureProcessingOptions {
+  TextureEncoding encoding = TextureEncoding::kRgba8888;
+
+  // Whether to store the full mipmap chain.
+  bool generate_mips = true;
+
+  // Whether to multiply colors by their alpha, matching the textures loaded by
+  // the RenderSystem by default.  This is done before the mipmaps are
+  // generated, so that transparent pixels don't bleed their color into the
+  // smaller levels.
+  bool premultiply_alpha = true;
+};
+
+// Processes the |size|.x() x |size|.y() RGBA image at |rgba_ptr| offline into
+// a texture container (see texture_container.h), which is written to |out|.
+// The container can then be loaded by the RenderSystem without any decoding or
+// mipmap generation at runtime.  If |processor| is provided, the work for each
+// level is split across its worker threads.  Returns false if the image is
+// invalid.
+bool ProcessTexture(const uint8_t* rgba_ptr, const mathfu::vec2i& size,
+                    const TextureProcessingOptions& options,
+                    std::vector<uint8_t>* out,
+                    JobProcessor* processor = nullptr);
+
+// Returns true if |container| uses one of the formats written by
+// ProcessTexture and each of its levels holds exactly the data for its size,
+// so that its levels can be uploaded to GL as is.  The RenderSystem loads any
+// other container through fplbase instead.
+bool IsTextureContainerUploadable(const TextureContainer& container);
+
+}  // namespace lull
+
+#endif  // LULLABY_UTIL_TEXTURE_PIPELINE_H_
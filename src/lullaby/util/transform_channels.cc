@@ -84,7 +84,13 @@ void PositionChannel::Set(Entity e, const float* values, size_t len) {
   updated_sqt.translation.x = values[0];
   updated_sqt.translation.y = values[1];
   updated_sqt.translation.z = values[2];
-  transform_system_->SetSqt(e, updated_sqt);
+  transform_system_->SetSqtDeferred(e, updated_sqt);
+}
+
+void PositionChannel::SetBatch(const Entity* entities, const float* values,
+                               size_t count) {
+  AnimationChannel::SetBatch(entities, values, count);
+  transform_system_->UpdateDeferredTransforms();
 }
 
 PositionXChannel::PositionXChannel(Registry* registry, size_t pool_size)
@@ -121,7 +127,13 @@ void PositionXChannel::Set(Entity entity, const float* values, size_t len) {
   }
   Sqt updated_sqt = *sqt;
   updated_sqt.translation.x = values[0];
-  transform_system_->SetSqt(entity, updated_sqt);
+  transform_system_->SetSqtDeferred(entity, updated_sqt);
+}
+
+void PositionXChannel::SetBatch(const Entity* entities, const float* values,
+                                size_t count) {
+  AnimationChannel::SetBatch(entities, values, count);
+  transform_system_->UpdateDeferredTransforms();
 }
 
 PositionZChannel::PositionZChannel(Registry* registry, size_t pool_size)
@@ -158,7 +170,13 @@ void PositionZChannel::Set(Entity entity, const float* values, size_t len) {
   }
   Sqt updated_sqt = *sqt;
   updated_sqt.translation.z = values[0];
-  transform_system_->SetSqt(entity, updated_sqt);
+  transform_system_->SetSqtDeferred(entity, updated_sqt);
+}
+
+void PositionZChannel::SetBatch(const Entity* entities, const float* values,
+                                size_t count) {
+  AnimationChannel::SetBatch(entities, values, count);
+  transform_system_->UpdateDeferredTransforms();
 }
 
 RotationChannel::RotationChannel(Registry* registry, size_t pool_size)
@@ -200,10 +218,16 @@ void RotationChannel::Set(Entity e, const float* values, size_t len) {
 
     Sqt updated_sqt = *sqt;
     updated_sqt.rotation = mathfu::quat::FromEulerAngles(angles);
-    transform_system_->SetSqt(e, updated_sqt);
+    transform_system_->SetSqtDeferred(e, updated_sqt);
   }
 }
 
+void RotationChannel::SetBatch(const Entity* entities, const float* values,
+                               size_t count) {
+  AnimationChannel::SetBatch(entities, values, count);
+  transform_system_->UpdateDeferredTransforms();
+}
+
 ScaleChannel::ScaleChannel(Registry* registry, size_t pool_size)
     : AnimationChannel(registry, 3, pool_size) {
   transform_system_ = registry->Get<TransformSystem>();
@@ -242,10 +266,16 @@ void ScaleChannel::Set(Entity e, const float* values, size_t len) {
     updated_sqt.scale.x = values[0];
     updated_sqt.scale.y = values[1];
     updated_sqt.scale.z = values[2];
-    transform_system_->SetSqt(e, updated_sqt);
+    transform_system_->SetSqtDeferred(e, updated_sqt);
   }
 }
 
+void ScaleChannel::SetBatch(const Entity* entities, const float* values,
+                            size_t count) {
+  AnimationChannel::SetBatch(entities, values, count);
+  transform_system_->UpdateDeferredTransforms();
+}
+
 ScaleFromRigChannel::ScaleFromRigChannel(Registry* registry, size_t pool_size)
     : AnimationChannel(registry, 0, pool_size) {
   transform_system_ = registry->Get<TransformSystem>();
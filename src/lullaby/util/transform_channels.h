@@ -25,6 +25,11 @@ namespace lull {
 
 class TransformSystem;
 
+// The position, rotation and scale channels below update transforms with
+// TransformSystem::SetSqtDeferred, and propagate the changes once the whole
+// batch of entities has been set, so a parent and child animated by the same
+// channel are only updated once.
+
 // Channel for animating Transform position.
 class PositionChannel : public AnimationChannel {
  public:
@@ -39,6 +44,8 @@ class PositionChannel : public AnimationChannel {
  private:
   bool Get(Entity e, float* values, size_t len) const override;
   void Set(Entity e, const float* values, size_t len) override;
+  void SetBatch(const Entity* entities, const float* values,
+                size_t count) override;
   TransformSystem* transform_system_;
 };
 
@@ -56,6 +63,8 @@ class PositionXChannel : public AnimationChannel {
  private:
   bool Get(Entity e, float* values, size_t len) const override;
   void Set(Entity e, const float* values, size_t len) override;
+  void SetBatch(const Entity* entities, const float* values,
+                size_t count) override;
   TransformSystem* transform_system_;
 };
 
@@ -73,6 +82,8 @@ class PositionZChannel : public AnimationChannel {
  private:
   bool Get(Entity e, float* values, size_t len) const override;
   void Set(Entity e, const float* values, size_t len) override;
+  void SetBatch(const Entity* entities, const float* values,
+                size_t count) override;
   TransformSystem* transform_system_;
 };
 
@@ -90,6 +101,8 @@ class RotationChannel : public AnimationChannel {
  private:
   bool Get(Entity e, float* values, size_t len) const override;
   void Set(Entity e, const float* values, size_t len) override;
+  void SetBatch(const Entity* entities, const float* values,
+                size_t count) override;
   TransformSystem* transform_system_;
 };
 
@@ -107,6 +120,8 @@ class ScaleChannel : public AnimationChannel {
  private:
   bool Get(Entity e, float* values, size_t len) const override;
   void Set(Entity e, const float* values, size_t len) override;
+  void SetBatch(const Entity* entities, const float* values,
+                size_t count) override;
   TransformSystem* transform_system_;
 };
 
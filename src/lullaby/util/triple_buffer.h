@@ -0,0 +1,111 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef LULLABY_UTIL_TRIPLE_BUFFER_H_
+#define LULLABY_UTIL_TRIPLE_BUFFER_H_
+
+#include <stdint.h>
+#include <atomic>
+
+namespace lull {
+
+/// The TripleBuffer class passes values of type |T| from a single writer thread
+/// to a single reader thread without either thread ever waiting for the other.
+/// Unlike BufferedData, no locks are used.
+///
+/// The writer and reader each own one of three buffers, and the third buffer is
+/// shared between them.  The shared buffer is exchanged atomically:
+/// - The writer fills its buffer (see |GetWriteBuffer|) and then calls
+/// |Publish|.  This swaps the write buffer with the shared buffer, making it
+/// the newest value.
+///
+/// - The reader calls |Acquire| to swap its buffer with the shared buffer if a
+/// newer value has been published, and then reads it (see |GetReadBuffer|).
+///
+/// The reader only ever sees the most recently published value, so values
+/// published in between two calls to |Acquire| are skipped.  After |Publish|,
+/// the write buffer holds a stale value, so the writer should overwrite it
+/// completely.
+template <typename T>
+class TripleBuffer {
+ public:
+  TripleBuffer() : shared_index_(kInitialSharedIndex) {}
+
+  /// Initializes all three buffers to |value|.
+  explicit TripleBuffer(const T& value) : shared_index_(kInitialSharedIndex) {
+    for (T& buffer : buffers_) {
+      buffer = value;
+    }
+  }
+
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  /// Returns the buffer to which the writer should write the next value.  Must
+  /// only be called by the writer.
+  T& GetWriteBuffer() { return buffers_[write_index_]; }
+
+  /// Publishes the value in the write buffer to the reader.  Must only be
+  /// called by the writer.
+  void Publish() {
+    const uint8_t published = static_cast<uint8_t>(write_index_) | kFreshBit;
+    write_index_ =
+        shared_index_.exchange(published, std::memory_order_acq_rel) &
+        kIndexMask;
+  }
+
+  /// Returns true if a value has been published that the reader has not yet
+  /// acquired.  Can be called by either thread.
+  bool HasPublishedValue() const {
+    return (shared_index_.load(std::memory_order_acquire) & kFreshBit) != 0;
+  }
+
+  /// Makes the most recently published value available in the read buffer.
+  /// Returns false (and leaves the read buffer unchanged) if no value has been
+  /// published since the last call.  Must only be called by the reader.
+  bool Acquire() {
+    if (!HasPublishedValue()) {
+      return false;
+    }
+    read_index_ = shared_index_.exchange(static_cast<uint8_t>(read_index_),
+                                         std::memory_order_acq_rel) &
+                  kIndexMask;
+    return true;
+  }
+
+  /// Returns the buffer holding the most recently acquired value.  Must only be
+  /// called by the reader.
+  T& GetReadBuffer() { return buffers_[read_index_]; }
+  const T& GetReadBuffer() const { return buffers_[read_index_]; }
+
+ private:
+  static const uint8_t kIndexMask = 0x3;
+  static const uint8_t kFreshBit = 0x4;
+  static const uint8_t kInitialSharedIndex = 2;
+
+  T buffers_[3];
+  /// The index of the shared buffer, combined with kFreshBit if it holds a
+  /// value that the reader has not yet acquired.
+  std::atomic<uint8_t> shared_index_;
+  /// The index of the buffer owned by the reader.
+  int read_index_ = 0;
+  /// The index of the buffer owned by the writer.
+  int write_index_ = 1;
+};
+
+}  // namespace lull
+
+#endif  // LULLABY_UTIL_TRIPLE_BUFFER_H_
@@ -96,19 +96,21 @@ size_t UTF8String::Insert(size_t index, const std::string& str) {
   }
 
   const size_t start_offset = index < size ? char_offsets_[index] : ByteSize();
-  size_t utf8_index = index;
 
-  // Insert new offsets.
+  // Shift the offsets after the insertion point, then insert the offsets of
+  // |str| in a single pass so that long strings aren't shifted once per
+  // inserted character.
+  std::vector<size_t> offsets;
   const char* p = str.c_str();
   while (*p) {
-    char_offsets_.insert(char_offsets_.begin() + utf8_index++,
-                         start_offset + p - str.c_str());
+    offsets.push_back(start_offset + p - str.c_str());
     p += OneCharLen(p);
   }
-  // Shift values after |str| insertion.
-  while (utf8_index < char_offsets_.size()) {
-    char_offsets_[utf8_index++] += str.size();
+  for (size_t i = index; i < size; ++i) {
+    char_offsets_[i] += str.size();
   }
+  char_offsets_.insert(char_offsets_.begin() + index, offsets.begin(),
+                       offsets.end());
   string_.insert(start_offset, str);
 
   return CharSize() - size;
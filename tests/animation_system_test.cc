@@ -17,6 +17,7 @@ limitations under the License.
 #include "lullaby/systems/animation/animation_system.h"
 #include "gtest/gtest.h"
 #include "lullaby/base/entity_factory.h"
+#include "lullaby/base/job_processor.h"
 #include "lullaby/systems/render/render_system.h"
 #include "lullaby/systems/transform/transform_system.h"
 #include "lullaby/util/transform_channels.h"
@@ -83,6 +84,117 @@ TEST_F(AnimationSystemTest, Create) {
   EXPECT_NEAR(sqt->scale.z, 30.f, kEpsilon);
 }
 
+TEST_F(AnimationSystemTest, ParallelEvaluationMatchesSerial) {
+  // Enough animations to be evaluated on the JobProcessor.
+  constexpr int kNumEntities = 200;
+
+  // Sets up |registry| like SetUp, then creates and animates the entities.
+  auto create_entities = [&](Registry* registry) {
+    auto* entity_factory = registry->Create<EntityFactory>(registry);
+    entity_factory->CreateSystem<TransformSystem>();
+    entity_factory->CreateSystem<AnimationSystem>();
+    entity_factory->CreateSystem<RenderSystem>();
+    entity_factory->Initialize();
+    PositionChannel::Setup(registry, 32);
+    ScaleChannel::Setup(registry, 32);
+
+    Blueprint blueprint(512);
+    {
+      TransformDefT transform;
+      blueprint.Write(&transform);
+    }
+
+    std::vector<Entity> entities;
+    auto* animation_system = registry->Get<AnimationSystem>();
+    for (int i = 0; i < kNumEntities; ++i) {
+      const Entity entity = entity_factory->Create(&blueprint);
+      const float f = static_cast<float>(i);
+      const mathfu::vec3 target_pos(f, 2.f * f, -f);
+      const mathfu::vec3 target_scale(1.f + f, 1.f, 2.f);
+      animation_system->SetTarget(entity, PositionChannel::kChannelName,
+                                  &target_pos.x, 3,
+                                  std::chrono::milliseconds(100 + i));
+      animation_system->SetTarget(entity, ScaleChannel::kChannelName,
+                                  &target_scale.x, 3,
+                                  std::chrono::milliseconds(300 - i));
+      entities.push_back(entity);
+    }
+    return entities;
+  };
+
+  Registry serial_registry;
+  Registry parallel_registry;
+  parallel_registry.Create<JobProcessor>(/* num_worker_threads = */ 3);
+  const std::vector<Entity> serial_entities =
+      create_entities(&serial_registry);
+  const std::vector<Entity> parallel_entities =
+      create_entities(&parallel_registry);
+
+  auto* serial_animation_system = serial_registry.Get<AnimationSystem>();
+  auto* parallel_animation_system = parallel_registry.Get<AnimationSystem>();
+  const auto* serial_transform_system = serial_registry.Get<TransformSystem>();
+  const auto* parallel_transform_system =
+      parallel_registry.Get<TransformSystem>();
+  for (int frame = 0; frame < 20; ++frame) {
+    serial_animation_system->AdvanceFrame(std::chrono::milliseconds(16));
+    parallel_animation_system->AdvanceFrame(std::chrono::milliseconds(16));
+
+    for (int i = 0; i < kNumEntities; ++i) {
+      const Sqt* serial = serial_transform_system->GetSqt(serial_entities[i]);
+      const Sqt* parallel =
+          parallel_transform_system->GetSqt(parallel_entities[i]);
+      ASSERT_NE(serial, nullptr);
+      ASSERT_NE(parallel, nullptr);
+      EXPECT_EQ(serial->translation.x, parallel->translation.x);
+      EXPECT_EQ(serial->translation.y, parallel->translation.y);
+      EXPECT_EQ(serial->translation.z, parallel->translation.z);
+      EXPECT_EQ(serial->scale.x, parallel->scale.x);
+      EXPECT_EQ(serial->scale.y, parallel->scale.y);
+      EXPECT_EQ(serial->scale.z, parallel->scale.z);
+    }
+  }
+}
+
+TEST_F(AnimationSystemTest, ChannelUpdateUpdatesWorldTransforms) {
+  Blueprint blueprint(512);
+  {
+    TransformDefT transform;
+    blueprint.Write(&transform);
+  }
+
+  auto* entity_factory = registry_->Get<EntityFactory>();
+  auto* transform_system = registry_->Get<TransformSystem>();
+  const Entity parent = entity_factory->Create(&blueprint);
+  const Entity child = entity_factory->Create(&blueprint);
+  transform_system->AddChild(parent, child);
+
+  // Update the channel directly rather than through AdvanceFrame.  The world
+  // transforms must still be up to date once it returns.
+  PositionChannel channel(registry_.get(), 4);
+  motive::MotiveEngine engine;
+  const mathfu::vec3 target_pos(1.f, 2.f, 3.f);
+  channel.Play(parent, &engine, 1, &target_pos.x, 3,
+               std::chrono::milliseconds(10));
+  engine.AdvanceFrame(
+      AnimationSystem::GetMotiveTime(std::chrono::milliseconds(100)));
+  std::vector<AnimationId> completed;
+  channel.Update(&completed);
+
+  static const float kEpsilon = 0.001f;
+  const mathfu::mat4* parent_mat =
+      transform_system->GetWorldFromEntityMatrix(parent);
+  const mathfu::mat4* child_mat =
+      transform_system->GetWorldFromEntityMatrix(child);
+  ASSERT_NE(parent_mat, nullptr);
+  ASSERT_NE(child_mat, nullptr);
+  EXPECT_NEAR((*parent_mat)(0, 3), 1.f, kEpsilon);
+  EXPECT_NEAR((*parent_mat)(1, 3), 2.f, kEpsilon);
+  EXPECT_NEAR((*parent_mat)(2, 3), 3.f, kEpsilon);
+  EXPECT_NEAR((*child_mat)(0, 3), 1.f, kEpsilon);
+  EXPECT_NEAR((*child_mat)(1, 3), 2.f, kEpsilon);
+  EXPECT_NEAR((*child_mat)(2, 3), 3.f, kEpsilon);
+}
+
 TEST(AnimationSystemDeathTest, SplitListFilenameAndIndex) {
   std::string filename;
   int index = 0;
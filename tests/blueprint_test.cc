@@ -142,6 +142,60 @@ TEST(BlueprintDeathTest, MultiWrite) {
   EXPECT_THAT(count, Eq(4));
 }
 
+TEST(Blueprint, Reset) {
+  Blueprint bp;
+
+  DataIntT data_int;
+  data_int.value = 123;
+  bp.Write(&data_int);
+  bp.Write(&data_int);
+  bp.FinishWriting();
+
+  bp.Reset();
+
+  DataStringT data_str;
+  data_str.value = "Hello";
+  bp.Write(&data_str);
+
+  int count = 0;
+  bp.ForEachComponent([&](const Blueprint& blueprint) {
+    EXPECT_TRUE(blueprint.Is<DataStringT>());
+    DataStringT tmp;
+    blueprint.Read(&tmp);
+    EXPECT_THAT(tmp.value, Eq("Hello"));
+    ++count;
+  });
+  EXPECT_THAT(count, Eq(1));
+}
+
+TEST(Blueprint, BufferPool) {
+  InwardBufferPool pool;
+  {
+    Blueprint bp(&pool);
+    DataStringT data;
+    data.value = "Hello";
+    bp.Write(&data);
+
+    int count = 0;
+    bp.ForEachComponent([&](const Blueprint& blueprint) {
+      DataStringT tmp;
+      blueprint.Read(&tmp);
+      EXPECT_THAT(tmp.value, Eq("Hello"));
+      ++count;
+    });
+    EXPECT_THAT(count, Eq(1));
+    EXPECT_THAT(pool.Size(), Eq(0u));
+  }
+
+  // The buffer is returned to the pool when the Blueprint is destroyed.
+  EXPECT_THAT(pool.Size(), Eq(1u));
+
+  Blueprint other(&pool);
+  DataBoolT data;
+  other.Write(&data);
+  EXPECT_THAT(pool.Size(), Eq(0u));
+}
+
 TEST(BlueprintDeathTest, Legacy) {
   DataStringT data;
   data.value = "Hello";
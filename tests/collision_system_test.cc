@@ -212,6 +212,115 @@ TEST_F(CollisionSystemTest, CheckForPointCollisions) {
   }
 }
 
+TEST_F(CollisionSystemTest, CollisionCandidates) {
+  auto* entity_factory = registry_->Get<EntityFactory>();
+  auto* collision_system = registry_->Get<CollisionSystem>();
+  auto* transform_system = registry_->Get<TransformSystem>();
+
+  // Create an entity in front of the ray and one off to its side.
+  Blueprint blueprint1;
+  {
+    TransformDefT transform;
+    transform.position = mathfu::vec3(0.f, 0.f, -4.f);
+    CollisionDefT collision;
+    blueprint1.Write(&transform);
+    blueprint1.Write(&collision);
+  }
+  const Entity entity1 = entity_factory->Create(&blueprint1);
+  transform_system->SetAabb(entity1, Aabb(-mathfu::kOnes3f, mathfu::kOnes3f));
+
+  Blueprint blueprint2;
+  {
+    TransformDefT transform;
+    transform.position = mathfu::vec3(4.f, 0.f, -4.f);
+    CollisionDefT collision;
+    blueprint2.Write(&transform);
+    blueprint2.Write(&collision);
+  }
+  const Entity entity2 = entity_factory->Create(&blueprint2);
+  transform_system->SetAabb(entity2, Aabb(-mathfu::kOnes3f, mathfu::kOnes3f));
+
+  const Ray ray(mathfu::kZeros3f, -mathfu::kAxisZ3f);
+  {
+    const auto candidates = collision_system->GetCollisionCandidates(
+        ray, 5.f * kDegreesToRadians, 0.f);
+    EXPECT_EQ(candidates.size(), static_cast<size_t>(1));
+    EXPECT_EQ(candidates[0], entity1);
+
+    // Testing only the candidates gives the same result as testing everything.
+    const auto result = collision_system->CheckForCollision(ray, candidates);
+    EXPECT_EQ(result.entity, entity1);
+    EXPECT_NEAR(result.distance, 3.f, 0.001f);
+  }
+
+  // A wider angle includes the second entity.
+  {
+    const auto candidates = collision_system->GetCollisionCandidates(
+        ray, 45.f * kDegreesToRadians, 0.f);
+    EXPECT_EQ(candidates.size(), static_cast<size_t>(2));
+  }
+
+  // Entities with collision disabled are never candidates.
+  collision_system->DisableCollision(entity1);
+  {
+    const auto candidates = collision_system->GetCollisionCandidates(
+        ray, 45.f * kDegreesToRadians, 0.f);
+    EXPECT_EQ(candidates.size(), static_cast<size_t>(1));
+    EXPECT_EQ(candidates[0], entity2);
+  }
+}
+
+TEST_F(CollisionSystemTest, ChangeCount) {
+  auto* entity_factory = registry_->Get<EntityFactory>();
+  auto* collision_system = registry_->Get<CollisionSystem>();
+  auto* transform_system = registry_->Get<TransformSystem>();
+
+  Blueprint blueprint;
+  {
+    TransformDefT transform;
+    CollisionDefT collision;
+    blueprint.Write(&transform);
+    blueprint.Write(&collision);
+  }
+  const Entity collider = entity_factory->Create(&blueprint);
+
+  Blueprint other_blueprint;
+  {
+    TransformDefT transform;
+    other_blueprint.Write(&transform);
+  }
+  const Entity other = entity_factory->Create(&other_blueprint);
+
+  uint32_t count = collision_system->GetChangeCount();
+
+  // Changes to entities without collision don't affect the count.
+  transform_system->SetLocalTranslation(other, mathfu::kOnes3f);
+  EXPECT_EQ(collision_system->GetChangeCount(), count);
+
+  transform_system->SetLocalTranslation(collider, mathfu::kOnes3f);
+  EXPECT_NE(collision_system->GetChangeCount(), count);
+  count = collision_system->GetChangeCount();
+
+  transform_system->SetAabb(collider, Aabb(-mathfu::kOnes3f, mathfu::kOnes3f));
+  EXPECT_NE(collision_system->GetChangeCount(), count);
+  count = collision_system->GetChangeCount();
+
+  transform_system->Disable(collider);
+  EXPECT_NE(collision_system->GetChangeCount(), count);
+  count = collision_system->GetChangeCount();
+
+  // Changes to the parent of a collider affect the count.
+  transform_system->Enable(collider);
+  transform_system->AddChild(other, collider);
+  count = collision_system->GetChangeCount();
+  transform_system->SetLocalTranslation(other, mathfu::kZeros3f);
+  EXPECT_NE(collision_system->GetChangeCount(), count);
+  count = collision_system->GetChangeCount();
+
+  collision_system->DisableCollision(collider);
+  EXPECT_NE(collision_system->GetChangeCount(), count);
+}
+
 TEST_F(CollisionSystemTest, DefaultInteraction) {
   TransformDefT transform;
   CollisionDefT collision;
@@ -16,6 +16,10 @@ limitations under the License.
 
 #include "lullaby/util/config.h"
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "lullaby/generated/config_def_generated.h"
@@ -105,5 +109,85 @@ TEST(ConfigTest, SetFromVariantMap) {
   EXPECT_THAT(cfg.Get(Hash("hash_key"), HashValue(0)), Eq(Hash("world")));
 }
 
+TEST(ConfigTest, SetValues) {
+  VariantMap values;
+  values[Hash("int_key")] = 123;
+  values[Hash("float_key")] = 456.f;
+
+  Config cfg;
+  cfg.Set(Hash("int_key"), 12);
+  cfg.Set(Hash("other_key"), 34);
+  cfg.SetValues(values);
+  EXPECT_THAT(cfg.Get(Hash("int_key"), 0), Eq(123));
+  EXPECT_THAT(cfg.Get(Hash("float_key"), 0.f), Eq(456.f));
+  EXPECT_THAT(cfg.Get(Hash("other_key"), 0), Eq(34));
+}
+
+TEST(ConfigTest, Handle) {
+  const HashValue key = Hash("key");
+
+  Config cfg;
+  Config::Handle<int> handle(&cfg, key, 12);
+  EXPECT_THAT(handle.Get(), Eq(12));
+
+  cfg.Set(key, 34);
+  EXPECT_THAT(handle.Get(), Eq(34));
+
+  cfg.Set(Hash("other_key"), 56);
+  EXPECT_THAT(handle.Get(), Eq(34));
+
+  // Values of the wrong type are ignored.
+  cfg.Set(key, 78.f);
+  EXPECT_THAT(handle.Get(), Eq(12));
+
+  cfg.Set(key, 90);
+  cfg.Remove(key);
+  EXPECT_THAT(handle.Get(), Eq(12));
+}
+
+TEST(ConfigTest, HandleOnChange) {
+  const HashValue key = Hash("key");
+
+  Config cfg;
+  std::vector<int> changes;
+  {
+    Config::Handle<int> handle(&cfg, key, 12,
+                               [&](const int& value) {
+                                 changes.push_back(value);
+                               });
+    cfg.Set(key, 34);
+    cfg.Set(Hash("other_key"), 56);
+    cfg.Remove(key);
+    EXPECT_THAT(changes, ::testing::ElementsAre(34, 12));
+  }
+
+  // Destroyed handles are no longer notified.
+  cfg.Set(key, 78);
+  EXPECT_THAT(changes.size(), Eq(2U));
+}
+
+TEST(ConfigTest, ConcurrentReads) {
+  const HashValue key = Hash("key");
+
+  Config cfg;
+  cfg.Set(key, 0);
+  std::atomic<bool> done(false);
+  std::thread reader([&]() {
+    Config::Handle<int> handle(&cfg, key, -1);
+    int last = 0;
+    while (!done) {
+      const int value = handle.Get();
+      EXPECT_GE(value, last);
+      last = value;
+    }
+  });
+  for (int i = 1; i <= 1000; ++i) {
+    cfg.Set(key, i);
+  }
+  done = true;
+  reader.join();
+  EXPECT_THAT(cfg.Get(key, -1), Eq(1000));
+}
+
 }  // namespace
 }  // namespace lull
@@ -64,6 +64,10 @@ class DeformSystemTest : public ::testing::Test {
         .WillByDefault(Invoke([&](Entity e, RenderSystem::Deformation d) {
           deformation_fns_[e] = d;
         }));
+    ON_CALL(*mock_render_system_, SetDeformationKeyFunction(_, _))
+        .WillByDefault(Invoke([&](Entity e, RenderSystem::DeformationKey k) {
+          deformation_key_fns_[e] = k;
+        }));
 
     entity_factory_->Initialize();
   }
@@ -142,6 +146,28 @@ class DeformSystemTest : public ::testing::Test {
     ExpectExactTransform(deformed, expected_pos, expected_rot);
   }
 
+  // Returns the deformation key the render system would use to share |e|'s
+  // deformed mesh, or an empty key if the mesh shouldn't be shared.
+  std::vector<uint8_t> GetDeformationKey(Entity e) {
+    // A single quad, as x, y, z per vertex.
+    static const float kVertices[] = {
+        -0.5f, -0.5f, 0.f,
+        0.5f, -0.5f, 0.f,
+        0.5f, 0.5f, 0.f,
+        -0.5f, 0.5f, 0.f,
+    };
+    std::vector<uint8_t> key;
+    auto iter = deformation_key_fns_.find(e);
+    if (iter == deformation_key_fns_.end() || !iter->second) {
+      ADD_FAILURE() << "No deformation key function set for entity.";
+      return key;
+    }
+    if (!iter->second(kVertices, sizeof(kVertices) / sizeof(float), 3, &key)) {
+      key.clear();
+    }
+    return key;
+  }
+
   // Creates an entity for the given deformer with the given translation
   Entity CreateWaypointDeformed(const Entity deformer, const Entity parent,
                                 const mathfu::vec3& translation,
@@ -164,6 +190,7 @@ class DeformSystemTest : public ::testing::Test {
 
   RenderSystemImpl* mock_render_system_;
   std::map<Entity, RenderSystem::Deformation> deformation_fns_;
+  std::map<Entity, RenderSystem::DeformationKey> deformation_key_fns_;
   ion::base::LogChecker log_checker_;
 };
 
@@ -609,5 +636,109 @@ TEST_F(DeformSystemTest, WaypointDeformerMultiPath) {
                          mathfu::kZeros3f);
 }
 
+TEST_F(DeformSystemTest, DeformationKeyMatchesAroundCylinder) {
+  Blueprint deformer_blueprint;
+  {
+    TransformDefT transform;
+    deformer_blueprint.Write(&transform);
+
+    DeformerDefT deformer;
+    deformer.horizontal_radius = kDeformRadius;
+    deformer_blueprint.Write(&deformer);
+  }
+  const Entity deformer = entity_factory_->Create(&deformer_blueprint);
+
+  // Creates a deformed child of |deformer| at |position|.
+  auto create_deformed = [&](const mathfu::vec3& position) {
+    Blueprint blueprint;
+    TransformDefT transform;
+    transform.position = position;
+    blueprint.Write(&transform);
+    DeformedDefT deformed;
+    blueprint.Write(&deformed);
+    const Entity entity = entity_factory_->Create(&blueprint);
+    transform_system_->AddChild(deformer, entity);
+    return entity;
+  };
+
+  const Entity deformed1 = create_deformed(mathfu::vec3(1.0f, 0.0f, 0.0f));
+  const Entity deformed2 = create_deformed(mathfu::vec3(1.0f, 0.0f, 0.0f));
+  const Entity deformed3 = create_deformed(mathfu::vec3(-1.0f, 0.5f, 0.0f));
+  ExpectDeformedMesh(deformed1);
+  ExpectDeformedMesh(deformed3);
+
+  const std::vector<uint8_t> key1 = GetDeformationKey(deformed1);
+  EXPECT_FALSE(key1.empty());
+
+  // Identical meshes at the same position share a key.
+  EXPECT_THAT(GetDeformationKey(deformed2), Eq(key1));
+
+  // Moving a mesh around or along the cylinder only moves the deformed result,
+  // so it shares the key as well.
+  EXPECT_THAT(GetDeformationKey(deformed3), Eq(key1));
+}
+
+TEST_F(DeformSystemTest, DeformationKeyDiffersWithDeformation) {
+  // Creates a deformer with the given |radius| and a deformed child offset
+  // from it by |position|, returning the child.
+  auto create_deformed = [&](float radius, const mathfu::vec3& position) {
+    Blueprint deformer_blueprint;
+    {
+      TransformDefT transform;
+      deformer_blueprint.Write(&transform);
+
+      DeformerDefT deformer;
+      deformer.horizontal_radius = radius;
+      deformer_blueprint.Write(&deformer);
+    }
+    const Entity deformer = entity_factory_->Create(&deformer_blueprint);
+
+    Blueprint blueprint;
+    {
+      TransformDefT transform;
+      transform.position = position;
+      blueprint.Write(&transform);
+
+      DeformedDefT deformed;
+      blueprint.Write(&deformed);
+    }
+    const Entity entity = entity_factory_->Create(&blueprint);
+    transform_system_->AddChild(deformer, entity);
+    return entity;
+  };
+
+  const mathfu::vec3 offset(1.0f, 0.0f, 0.0f);
+  const Entity deformed = create_deformed(kDeformRadius, offset);
+  const std::vector<uint8_t> key = GetDeformationKey(deformed);
+  EXPECT_FALSE(key.empty());
+
+  // A different radius bends the mesh differently.
+  const Entity larger_radius = create_deformed(2.0f * kDeformRadius, offset);
+  const std::vector<uint8_t> larger_radius_key =
+      GetDeformationKey(larger_radius);
+  EXPECT_FALSE(larger_radius_key.empty());
+  EXPECT_THAT(larger_radius_key, Not(Eq(key)));
+
+  // So does a different distance from the cylinder's axis.
+  const Entity farther = create_deformed(
+      kDeformRadius, offset + mathfu::vec3(0.0f, 0.0f, 0.5f));
+  const std::vector<uint8_t> farther_key = GetDeformationKey(farther);
+  EXPECT_FALSE(farther_key.empty());
+  EXPECT_THAT(farther_key, Not(Eq(key)));
+
+  // And a deformed entity without a deformer isn't shared at all.
+  Blueprint blueprint;
+  {
+    TransformDefT transform;
+    transform.position = offset;
+    blueprint.Write(&transform);
+
+    DeformedDefT deformed_def;
+    blueprint.Write(&deformed_def);
+  }
+  const Entity undeformed = entity_factory_->Create(&blueprint);
+  EXPECT_TRUE(GetDeformationKey(undeformed).empty());
+}
+
 }  // namespace
 }  // namespace lull
@@ -68,6 +68,7 @@ class DisplayListTest : public ::testing::Test {
     RenderPass pass;
     RenderSystem::SortOrder sort_order;
     RenderSystem::SortOrder sort_order_offset;
+    std::vector<float> lod_screen_sizes;
   };
 
   using DisplayList = detail::DisplayList<RenderComponent>;
@@ -200,5 +201,72 @@ TEST_F(DisplayListTest, AverageSpaceOriginBackToFront) {
   }
 }
 
+TEST_F(DisplayListTest, SelectLod) {
+  const std::vector<float> lod_screen_sizes = {0.5f, 0.25f, 0.1f};
+
+  EXPECT_EQ(DisplayList::SelectLod(lod_screen_sizes, 1.f), 0U);
+  EXPECT_EQ(DisplayList::SelectLod(lod_screen_sizes, 0.5f), 0U);
+  EXPECT_EQ(DisplayList::SelectLod(lod_screen_sizes, 0.4f), 1U);
+  EXPECT_EQ(DisplayList::SelectLod(lod_screen_sizes, 0.2f), 2U);
+  EXPECT_EQ(DisplayList::SelectLod(lod_screen_sizes, 0.01f), 3U);
+  EXPECT_EQ(DisplayList::SelectLod(std::vector<float>(), 0.01f), 0U);
+}
+
+TEST_F(DisplayListTest, CalculateScreenSize) {
+  const RenderSystem::View view = GetDefaultView();
+
+  // With an identity projection, a sphere of radius 1 at distance 2 covers
+  // half of the view.
+  const float half = DisplayList::CalculateScreenSize(
+      mathfu::vec3(0, 0, -2), 1.f, &view, 1);
+  EXPECT_NEAR(half, 0.5f, 0.0001f);
+
+  // Doubling the distance halves the screen size.
+  const float quarter = DisplayList::CalculateScreenSize(
+      mathfu::vec3(0, 0, -4), 1.f, &view, 1);
+  EXPECT_NEAR(quarter, 0.25f, 0.0001f);
+
+  // The view being inside the sphere should always select the full detail.
+  const float inside = DisplayList::CalculateScreenSize(
+      mathfu::vec3(0, 0, -0.5f), 1.f, &view, 1);
+  EXPECT_GT(inside, 1.f);
+}
+
+TEST_F(DisplayListTest, PopulateSelectsLods) {
+  auto* transform_system = registry_->Get<TransformSystem>();
+  for (Entity e : entities_) {
+    transform_system->SetAabb(
+        e, Aabb(mathfu::vec3(-1, -1, -1), mathfu::vec3(1, 1, 1)));
+    pool_->GetComponent(e)->lod_screen_sizes = {0.1f, 0.01f};
+  }
+
+  const RenderSystem::View view = GetDefaultView();
+
+  DisplayList list(registry_.get());
+  list.Populate(*pool_, &view, 1);
+
+  const std::vector<DisplayList::Entry> contents = *list.GetContents();
+  EXPECT_EQ(contents.size(), entities_.size());
+  for (const auto& info : contents) {
+    EXPECT_EQ(info.lod, DisplayList::SelectLod(
+                            info.component->lod_screen_sizes, info.screen_size));
+  }
+}
+
+TEST_F(DisplayListTest, PopulateWithoutViewsSelectsFullDetail) {
+  for (Entity e : entities_) {
+    pool_->GetComponent(e)->lod_screen_sizes = {0.1f, 0.01f};
+  }
+
+  DisplayList list(registry_.get());
+  list.Populate(*pool_, nullptr, 0);
+
+  const std::vector<DisplayList::Entry> contents = *list.GetContents();
+  EXPECT_EQ(contents.size(), entities_.size());
+  for (const auto& info : contents) {
+    EXPECT_EQ(info.lod, 0U);
+  }
+}
+
 }  // namespace
 }  // namespace lull
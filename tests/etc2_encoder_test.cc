@@ -0,0 +1,239 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/etc2_encoder.h"
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "lullaby/base/job_processor.h"
+
+namespace lull {
+namespace {
+
+const int kColorModifiers[8][2] = {
+    {2, 8},   {5, 17},  {9, 29},  {13, 42},
+    {18, 60}, {24, 80}, {33, 106}, {47, 183},
+};
+
+const int kAlphaModifiers[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14},  {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12},  {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11},  {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10},  {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},   {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},   {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},   {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},    {-3, -5, -7, -9, 2, 4, 6, 8},
+};
+
+int Clamp255(int value) { return std::min(std::max(value, 0), 255); }
+
+uint64_t LoadBigEndian(const uint8_t* data) {
+  uint64_t bits = 0;
+  for (int i = 0; i < 8; ++i) {
+    bits = (bits << 8) | data[i];
+  }
+  return bits;
+}
+
+uint32_t GetBits(uint64_t bits, int shift, int count) {
+  return static_cast<uint32_t>((bits >> shift) & ((uint64_t(1) << count) - 1));
+}
+
+// Decodes an ETC2 RGB block into the RGB channels of |rgba|, a 4x4 block of
+// pixels in row-major order.  Only the ETC1 compatible modes are supported.
+void DecodeColorBlock(const uint8_t* data, uint8_t rgba[16][4]) {
+  const uint64_t bits = LoadBigEndian(data);
+  const bool differential = GetBits(bits, 33, 1) != 0;
+  const bool flip = GetBits(bits, 32, 1) != 0;
+  int colors[2][3];
+  for (int c = 0; c < 3; ++c) {
+    if (differential) {
+      const int base = static_cast<int>(GetBits(bits, 59 - 8 * c, 5));
+      int delta = static_cast<int>(GetBits(bits, 56 - 8 * c, 3));
+      delta = delta >= 4 ? delta - 8 : delta;
+      // Overflows would select the ETC2 T, H, or planar modes.
+      ASSERT_GE(base + delta, 0);
+      ASSERT_LE(base + delta, 31);
+      colors[0][c] = (base << 3) | (base >> 2);
+      colors[1][c] = ((base + delta) << 3) | ((base + delta) >> 2);
+    } else {
+      colors[0][c] = static_cast<int>(GetBits(bits, 60 - 8 * c, 4)) * 17;
+      colors[1][c] = static_cast<int>(GetBits(bits, 56 - 8 * c, 4)) * 17;
+    }
+  }
+  const int tables[2] = {static_cast<int>(GetBits(bits, 37, 3)),
+                         static_cast<int>(GetBits(bits, 34, 3))};
+  for (int x = 0; x < 4; ++x) {
+    for (int y = 0; y < 4; ++y) {
+      const int i = x * 4 + y;
+      const int subblock = flip ? (y >= 2) : (x >= 2);
+      const int msb = static_cast<int>(GetBits(bits, 16 + i, 1));
+      const int lsb = static_cast<int>(GetBits(bits, i, 1));
+      int modifier = kColorModifiers[tables[subblock]][lsb];
+      modifier = msb ? -modifier : modifier;
+      for (int c = 0; c < 3; ++c) {
+        rgba[y * 4 + x][c] =
+            static_cast<uint8_t>(Clamp255(colors[subblock][c] + modifier));
+      }
+    }
+  }
+}
+
+// Decodes an EAC alpha block into the alpha channel of |rgba|.
+void DecodeAlphaBlock(const uint8_t* data, uint8_t rgba[16][4]) {
+  const uint64_t bits = LoadBigEndian(data);
+  const int base = static_cast<int>(GetBits(bits, 56, 8));
+  const int multiplier = static_cast<int>(GetBits(bits, 52, 4));
+  const int table = static_cast<int>(GetBits(bits, 48, 4));
+  for (int x = 0; x < 4; ++x) {
+    for (int y = 0; y < 4; ++y) {
+      const int shift = 45 - 3 * (x * 4 + y);
+      const int index = static_cast<int>(GetBits(bits, shift, 3));
+      rgba[y * 4 + x][3] = static_cast<uint8_t>(
+          Clamp255(base + kAlphaModifiers[table][index] * multiplier));
+    }
+  }
+}
+
+// Decodes an entire ETC2 image into RGBA pixels.
+std::vector<uint8_t> Decode(const std::vector<uint8_t>& data,
+                            const mathfu::vec2i& size, bool has_alpha) {
+  std::vector<uint8_t> rgba(4 * size.x * size.y);
+  const uint8_t* block_data = data.data();
+  for (int block_y = 0; block_y < (size.y + 3) / 4; ++block_y) {
+    for (int block_x = 0; block_x < (size.x + 3) / 4; ++block_x) {
+      uint8_t block[16][4];
+      for (auto& pixel : block) {
+        pixel[3] = 255;
+      }
+      if (has_alpha) {
+        DecodeAlphaBlock(block_data, block);
+        block_data += 8;
+      }
+      DecodeColorBlock(block_data, block);
+      block_data += 8;
+
+      for (int y = 0; y < 4 && block_y * 4 + y < size.y; ++y) {
+        for (int x = 0; x < 4 && block_x * 4 + x < size.x; ++x) {
+          const int dst = (block_y * 4 + y) * size.x + block_x * 4 + x;
+          std::copy(block[y * 4 + x], block[y * 4 + x] + 4, &rgba[4 * dst]);
+        }
+      }
+    }
+  }
+  return rgba;
+}
+
+std::vector<uint8_t> Encode(const std::vector<uint8_t>& rgba,
+                            const mathfu::vec2i& size, bool has_alpha,
+                            JobProcessor* processor = nullptr) {
+  std::vector<uint8_t> data(GetEtc2ImageSize(size, has_alpha));
+  EncodeEtc2(rgba.data(), size, has_alpha, data.data(), processor);
+  return data;
+}
+
+// Returns the peak signal to noise ratio of channel |c| of |actual|.
+double GetPsnr(const std::vector<uint8_t>& expected,
+               const std::vector<uint8_t>& actual, int c) {
+  double error = 0.0;
+  for (size_t i = c; i < expected.size(); i += 4) {
+    const double difference = expected[i] - actual[i];
+    error += difference * difference;
+  }
+  const double mean_error = error / (expected.size() / 4);
+  return mean_error == 0.0 ? INFINITY
+                           : 10.0 * log10(255.0 * 255.0 / mean_error);
+}
+
+// Returns a smooth image, similar to a photograph.
+std::vector<uint8_t> MakeGradient(const mathfu::vec2i& size) {
+  std::vector<uint8_t> rgba(4 * size.x * size.y);
+  for (int y = 0; y < size.y; ++y) {
+    for (int x = 0; x < size.x; ++x) {
+      uint8_t* pixel = &rgba[4 * (y * size.x + x)];
+      pixel[0] = static_cast<uint8_t>(255 * x / size.x);
+      pixel[1] = static_cast<uint8_t>(255 * y / size.y);
+      pixel[2] = static_cast<uint8_t>(128 + 100 * sin(0.1 * (x + y)));
+      pixel[3] = static_cast<uint8_t>(255 * (x + y) / (size.x + size.y));
+    }
+  }
+  return rgba;
+}
+
+TEST(Etc2Encoder, ImageSize) {
+  EXPECT_EQ(GetEtc2ImageSize(mathfu::vec2i(0, 4), false), 0u);
+  EXPECT_EQ(GetEtc2ImageSize(mathfu::vec2i(1, 1), false), 8u);
+  EXPECT_EQ(GetEtc2ImageSize(mathfu::vec2i(1, 1), true), 16u);
+  EXPECT_EQ(GetEtc2ImageSize(mathfu::vec2i(8, 5), false), 32u);
+  EXPECT_EQ(GetEtc2ImageSize(mathfu::vec2i(8, 5), true), 64u);
+}
+
+TEST(Etc2Encoder, SolidColors) {
+  const mathfu::vec2i size(4, 4);
+  const uint8_t kColors[][4] = {
+      {0, 0, 0, 255},    {255, 255, 255, 0}, {200, 100, 50, 128},
+      {17, 230, 99, 1},  {128, 128, 128, 77},
+  };
+  for (const uint8_t* color : kColors) {
+    std::vector<uint8_t> rgba;
+    for (int i = 0; i < size.x * size.y; ++i) {
+      rgba.insert(rgba.end(), color, color + 4);
+    }
+    const std::vector<uint8_t> decoded =
+        Decode(Encode(rgba, size, true), size, true);
+    for (size_t i = 0; i < rgba.size(); i += 4) {
+      EXPECT_NEAR(decoded[i + 0], color[0], 4);
+      EXPECT_NEAR(decoded[i + 1], color[1], 4);
+      EXPECT_NEAR(decoded[i + 2], color[2], 4);
+      // A constant alpha is always encoded exactly.
+      EXPECT_EQ(decoded[i + 3], color[3]);
+    }
+  }
+}
+
+TEST(Etc2Encoder, Gradient) {
+  // The size is not a multiple of 4, so the edge blocks are padded.
+  const mathfu::vec2i size(61, 30);
+  const std::vector<uint8_t> rgba = MakeGradient(size);
+
+  const std::vector<uint8_t> rgb_decoded =
+      Decode(Encode(rgba, size, false), size, false);
+  const std::vector<uint8_t> rgba_decoded =
+      Decode(Encode(rgba, size, true), size, true);
+  for (int c = 0; c < 3; ++c) {
+    EXPECT_GT(GetPsnr(rgba, rgb_decoded, c), 30.0);
+    EXPECT_GT(GetPsnr(rgba, rgba_decoded, c), 30.0);
+  }
+  EXPECT_GT(GetPsnr(rgba, rgba_decoded, 3), 40.0);
+  for (size_t i = 3; i < rgb_decoded.size(); i += 4) {
+    EXPECT_EQ(rgb_decoded[i], 255);
+  }
+}
+
+TEST(Etc2Encoder, Parallel) {
+  const mathfu::vec2i size(256, 128);
+  const std::vector<uint8_t> rgba = MakeGradient(size);
+
+  JobProcessor job_processor(/* num_worker_threads = */ 3);
+  EXPECT_EQ(Encode(rgba, size, true), Encode(rgba, size, true, &job_processor));
+}
+
+}  // namespace
+}  // namespace lull
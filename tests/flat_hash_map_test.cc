@@ -0,0 +1,148 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "lullaby/base/flat_hash_map.h"
+
+#include <string>
+#include <unordered_map>
+#include "gtest/gtest.h"
+
+namespace lull {
+namespace {
+
+using TestMap = FlatHashMap<uint32_t, std::string>;
+
+TEST(FlatHashMap, Empty) {
+  TestMap map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.size(), 0U);
+  EXPECT_EQ(map.begin(), map.end());
+  EXPECT_EQ(map.find(1), map.end());
+  EXPECT_EQ(map.count(1), 0U);
+  EXPECT_EQ(map.erase(1), 0U);
+}
+
+TEST(FlatHashMap, Emplace) {
+  TestMap map;
+  auto result = map.emplace(1, "one");
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(result.first->first, 1U);
+  EXPECT_EQ(result.first->second, "one");
+
+  // Emplacing an existing key doesn't replace its value.
+  result = map.emplace(1, "uno");
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(result.first->second, "one");
+  EXPECT_EQ(map.size(), 1U);
+
+  map[2] = "two";
+  EXPECT_EQ(map.size(), 2U);
+  EXPECT_EQ(map.find(2)->second, "two");
+  EXPECT_EQ(map.count(2), 1U);
+}
+
+TEST(FlatHashMap, InitializerList) {
+  const TestMap map = {{1, "one"}, {2, "two"}, {3, "three"}};
+  EXPECT_EQ(map.size(), 3U);
+  EXPECT_EQ(map.find(3)->second, "three");
+
+  const TestMap copy = map;
+  EXPECT_EQ(copy.size(), 3U);
+  EXPECT_EQ(copy.find(1)->second, "one");
+}
+
+// Checks that |map| holds the same pairs as |expected|.
+void ExpectEqual(const TestMap& map,
+                 const std::unordered_map<uint32_t, std::string>& expected) {
+  EXPECT_EQ(map.size(), expected.size());
+  size_t count = 0;
+  for (const auto& kv : map) {
+    const auto iter = expected.find(kv.first);
+    ASSERT_NE(iter, expected.end());
+    EXPECT_EQ(kv.second, iter->second);
+    ++count;
+  }
+  EXPECT_EQ(count, expected.size());
+  for (const auto& kv : expected) {
+    const auto iter = map.find(kv.first);
+    ASSERT_NE(iter, map.end());
+    EXPECT_EQ(iter->second, kv.second);
+  }
+}
+
+TEST(FlatHashMap, ManyKeys) {
+  // Use both sequential keys (like Entities) and scattered keys (like
+  // HashValues) so that both small and large maps are exercised.
+  TestMap map;
+  std::unordered_map<uint32_t, std::string> expected;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    const uint32_t key = (i % 2 == 0) ? i : i * 2654435761U;
+    map[key] = std::to_string(i);
+    expected[key] = std::to_string(i);
+    if (i % 100 == 0 || i < 2 * TestMap::kMaxLinearSize) {
+      ExpectEqual(map, expected);
+    }
+  }
+  ExpectEqual(map, expected);
+
+  // Remove keys in an interleaved order, checking that the remaining ones can
+  // still be found.
+  for (uint32_t i = 0; i < 1000; i += 3) {
+    const uint32_t key = (i % 2 == 0) ? i : i * 2654435761U;
+    EXPECT_EQ(map.erase(key), 1U);
+    expected.erase(key);
+  }
+  ExpectEqual(map, expected);
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.find(2), map.end());
+}
+
+TEST(FlatHashMap, EraseWhileIterating) {
+  TestMap map;
+  std::unordered_map<uint32_t, std::string> expected;
+  for (uint32_t i = 0; i < 20; ++i) {
+    map[i] = std::to_string(i);
+    if (i % 2 == 1) {
+      expected[i] = std::to_string(i);
+    }
+  }
+
+  for (auto iter = map.begin(); iter != map.end();) {
+    if (iter->first % 2 == 0) {
+      iter = map.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  ExpectEqual(map, expected);
+}
+
+TEST(FlatHashMap, Reserve) {
+  TestMap map;
+  map.reserve(100);
+  const auto* data = &*map.emplace(0, "zero").first;
+  for (uint32_t i = 1; i < 100; ++i) {
+    map.emplace(i, std::to_string(i));
+  }
+  EXPECT_EQ(data, map.begin());
+  EXPECT_EQ(map.find(99)->second, "99");
+}
+
+}  // namespace
+}  // namespace lull
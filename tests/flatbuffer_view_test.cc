@@ -0,0 +1,122 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+#include "lullaby/util/flatbuffer_view.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "lullaby/generated/render_def_generated.h"
+#include "lullaby/util/flatbuffer_writer.h"
+#include "lullaby/util/inward_buffer.h"
+
+namespace lull {
+namespace {
+
+using ::testing::Eq;
+
+TEST(FlatbufferView, Null) {
+  const RenderDefView view;
+  EXPECT_TRUE(view.IsNull());
+  EXPECT_THAT(view.pass(), Eq(RenderPass_Main));
+  EXPECT_TRUE(view.mesh().empty());
+  EXPECT_TRUE(view.font().IsNull());
+  EXPECT_THAT(view.font().edge_threshold(), Eq(0.5f));
+  EXPECT_TRUE(view.uniforms().empty());
+}
+
+TEST(FlatbufferView, ReadsFields) {
+  RenderDefT def;
+  def.pass = RenderPass_Opaque;
+  def.mesh = "mesh";
+  def.sort_order_offset = 3;
+  def.font.emplace();
+  def.font->font = "font";
+  def.font->fonts = {"a", "bc"};
+  def.font->size = 12;
+  def.uniforms.resize(2);
+  def.uniforms[0].name = "u0";
+  def.uniforms[0].float_value = {1.f, 2.f, 3.f};
+  def.uniforms[1].name = "u1";
+  def.uniforms[1].count = 4;
+
+  InwardBuffer buffer(256);
+  const void* flatbuffer = WriteFlatbuffer(&def, &buffer);
+  const RenderDefView view = RenderDefView::FromBuffer(flatbuffer);
+  ASSERT_FALSE(view.IsNull());
+
+  EXPECT_THAT(view.pass(), Eq(RenderPass_Opaque));
+  EXPECT_THAT(view.mesh().to_string(), Eq("mesh"));
+  EXPECT_TRUE(view.texture().empty());
+  EXPECT_THAT(view.sort_order_offset(), Eq(3));
+  EXPECT_FALSE(view.hidden());
+
+  const FontDefView font = view.font();
+  ASSERT_FALSE(font.IsNull());
+  EXPECT_THAT(font.font().to_string(), Eq("font"));
+  EXPECT_THAT(font.size(), Eq(12));
+  ASSERT_THAT(font.fonts().size(), Eq(2u));
+  EXPECT_THAT(font.fonts()[0].to_string(), Eq("a"));
+  EXPECT_THAT(font.fonts()[1].to_string(), Eq("bc"));
+
+  const auto uniforms = view.uniforms();
+  ASSERT_THAT(uniforms.size(), Eq(2u));
+  EXPECT_THAT(uniforms[0].name().to_string(), Eq("u0"));
+  const Span<float> values = uniforms[0].float_value();
+  ASSERT_THAT(values.size(), Eq(3u));
+  EXPECT_THAT(values[0], Eq(1.f));
+  EXPECT_THAT(values[1], Eq(2.f));
+  EXPECT_THAT(values[2], Eq(3.f));
+  EXPECT_THAT(uniforms[0].count(), Eq(1));
+  EXPECT_THAT(uniforms[1].name().to_string(), Eq("u1"));
+  EXPECT_TRUE(uniforms[1].float_value().empty());
+  EXPECT_THAT(uniforms[1].count(), Eq(4));
+}
+
+TEST(FlatbufferView, MatchesTableAccessors) {
+  RenderDefT def;
+  def.pass = RenderPass_Opaque;
+  def.mesh = "mesh";
+  def.sort_order_offset = -2;
+  def.hidden = true;
+  def.uniforms.resize(1);
+  def.uniforms[0].name = "u0";
+  def.uniforms[0].float_value = {4.f, 5.f};
+
+  InwardBuffer buffer(256);
+  const void* flatbuffer = WriteFlatbuffer(&def, &buffer);
+  const RenderDef* table = flatbuffers::GetRoot<RenderDef>(flatbuffer);
+  const RenderDefView view(table);
+  ASSERT_THAT(view.GetFlatBuffer(), Eq(table));
+
+  EXPECT_THAT(view.pass(), Eq(table->pass()));
+  EXPECT_THAT(view.mesh().to_string(), Eq(table->mesh()->str()));
+  EXPECT_THAT(view.sort_order_offset(), Eq(table->sort_order_offset()));
+  EXPECT_THAT(view.hidden(), Eq(table->hidden()));
+  EXPECT_TRUE(view.font().IsNull());
+  EXPECT_THAT(table->font(), Eq(nullptr));
+
+  ASSERT_THAT(view.uniforms().size(), Eq(table->uniforms()->size()));
+  const UniformDef* uniform = table->uniforms()->Get(0);
+  EXPECT_THAT(view.uniforms()[0].name().to_string(),
+              Eq(uniform->name()->str()));
+  const Span<float> values = view.uniforms()[0].float_value();
+  ASSERT_THAT(values.size(), Eq(uniform->float_value()->size()));
+  EXPECT_THAT(values[0], Eq(uniform->float_value()->Get(0)));
+  EXPECT_THAT(values[1], Eq(uniform->float_value()->Get(1)));
+}
+
+}  // namespace
+}  // namespace lull
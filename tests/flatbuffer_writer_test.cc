@@ -651,6 +651,39 @@ TEST(FlatbufferWriter, All) {
   EXPECT_THAT(ds->value()->str(), Eq("baz"));
 }
 
+TEST(FlatbufferWriter, EstimateSize) {
+  ComplexT obj;
+  obj.name = "hello";
+  obj.basic.str = "world";
+  obj.basics.resize(3);
+  obj.basics[1].str = "foo";
+  obj.numbers = {1, 2, 3};
+  obj.names = {"a", "bc", "def"};
+  obj.outs.resize(2);
+  obj.vec3 = {3.f, 4.f, 5.f};
+  obj.quats = {
+      {10.f, 11.f, 12.f, 13.f}, {10.01f, 11.11f, 12.21f, 13.31f},
+  };
+  obj.nullable_table.emplace();
+  obj.variant.set<DataStringT>()->value = "baz";
+
+  const size_t estimate = EstimateFlatbufferSize(&obj);
+  InwardBuffer buffer(estimate);
+  const size_t capacity = buffer.Capacity();
+  const void* mem = buffer.FrontAt(0);
+  WriteFlatbuffer(&obj, &buffer);
+
+  // The estimate is large enough that the buffer was never reallocated.
+  EXPECT_THAT(buffer.Capacity(), Eq(capacity));
+  EXPECT_THAT(buffer.FrontAt(0), Eq(mem));
+  EXPECT_LE(buffer.BackSize(), estimate);
+
+  const Complex* c = flatbuffers::GetRoot<Complex>(buffer.BackAt(
+      buffer.BackSize()));
+  EXPECT_THAT(c->name()->str(), Eq("hello"));
+  EXPECT_THAT(c->basics()->size(), Eq(3u));
+}
+
 TEST(FlatbufferWriter, Manual) {
   InwardBuffer buffer(32);
   FlatbufferWriter writer(&buffer);
@@ -191,4 +191,58 @@ TEST_F(FunctionRegistryTest, UnregisteredFunctionError) {
       "ERROR", "Unknown function: Concat"));
 }
 
+TEST_F(FunctionRegistryTest, TypedHandle) {
+  fn_binder_->RegisterFunction(
+      "Concat", [](std::string a, std::string b) { return a + b; });
+
+  // Arguments passed by value and by const reference are interchangeable.
+  TypedFunctionHandle<std::string(const std::string&, const std::string&)>
+      concat(fn_registry_, "Concat");
+  EXPECT_TRUE(concat.IsValid());
+  EXPECT_TRUE(concat.IsTyped());
+  EXPECT_EQ("abcdef", concat.Call("abc", "def"));
+  EXPECT_FALSE(log_checker_->HasAnyMessages());
+}
+
+TEST_F(FunctionRegistryTest, TypedHandleFallback) {
+  fn_binder_->RegisterFunction("Add", [](int a, int b) { return a + b; });
+
+  // A handle with a different signature converts through Variants.
+  TypedFunctionHandle<Variant(int, int)> add(fn_registry_, "Add");
+  EXPECT_FALSE(add.IsTyped());
+  EXPECT_EQ(3, *add.Call(1, 2).Get<int>());
+
+  TypedFunctionHandle<float(int, int)> add_float(fn_registry_, "Add");
+  EXPECT_EQ(0.f, add_float.Call(1, 2));
+  EXPECT_TRUE(log_checker_->HasMessage("ERROR",
+                                       "Add is expected to return float"));
+}
+
+TEST_F(FunctionRegistryTest, TypedHandleReregistered) {
+  TypedFunctionHandle<int(int)> fn(fn_registry_, "Fn");
+  EXPECT_FALSE(fn.IsValid());
+  EXPECT_EQ(0, fn.Call(1));
+  EXPECT_TRUE(log_checker_->HasMessage("ERROR", "Unknown function: Fn"));
+
+  fn_binder_->RegisterFunction("Fn", [](int a) { return a + 1; });
+  EXPECT_TRUE(fn.IsTyped());
+  EXPECT_EQ(2, fn.Call(1));
+
+  fn_binder_->UnregisterFunction("Fn");
+  fn_binder_->RegisterFunction("Fn", [](int a) { return a * 10; });
+  EXPECT_EQ(10, fn.Call(1));
+}
+
+TEST_F(FunctionRegistryTest, TypedHandleNonConstRefArgs) {
+  // Functions taking arguments by non-const reference can't be called through
+  // a const reference, so they are only called through Variants.
+  fn_binder_->RegisterFunction("Increment", [](int& a) { return ++a; });
+
+  TypedFunctionHandle<int(int)> increment(fn_registry_, "Increment");
+  EXPECT_TRUE(increment.IsValid());
+  EXPECT_FALSE(increment.IsTyped());
+  EXPECT_EQ(2, increment.Call(1));
+  EXPECT_FALSE(log_checker_->HasAnyMessages());
+}
+
 }  // namespace lull
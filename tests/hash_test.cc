@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "lullaby/generated/tests/portable_test_macros.h"
 #include "lullaby/util/string_view.h"
 
 namespace lull {
@@ -50,12 +51,46 @@ TEST(Hash, Uniqueness) {
 TEST(Hash, CaseInsensitive) {
   EXPECT_THAT(HashCaseInsensitive("hello_world", 5),
               Eq(HashCaseInsensitive("HELLO_World", 5)));
+  EXPECT_THAT(HashCaseInsensitive("hello_world", 11),
+              Eq(HashCaseInsensitive("HELLO_World", 11)));
+  EXPECT_THAT(HashCaseInsensitive("hello_world", 11), Eq(Hash("hello_world")));
 }
 
 TEST(Hash, ConstHash) { EXPECT_THAT(ConstHash("Hello"), Eq(Hash("Hello"))); }
 
+TEST(Hash, ConstHashLong) {
+  // Covers strings made of several whole words plus a partial one.
+  EXPECT_THAT(ConstHash("hello_world"), Eq(Hash("hello_world")));
+  EXPECT_THAT(ConstHash("abcdefgh"), Eq(Hash("abcdefgh")));
+  EXPECT_THAT(ConstHash("abcdefghijklmnopqrstuvwxyz0123456789"),
+              Eq(Hash("abcdefghijklmnopqrstuvwxyz0123456789")));
+}
+
+TEST(Hash, ConstHashIsConstexpr) {
+  constexpr HashValue value = ConstHash("Hello");
+  EXPECT_THAT(value, Eq(Hash("Hello")));
+}
+
+TEST(Hash, Width) {
+#if LULLABY_HASH_64
+  EXPECT_THAT(sizeof(HashValue), Eq(8u));
+#else
+  EXPECT_THAT(sizeof(HashValue), Eq(4u));
+#endif
+}
+
 TEST(Hash, ConstHashEmpty) { EXPECT_THAT(ConstHash(""), Eq(HashValue(0))); }
 
+#if LULLABY_HASH_64
+TEST(Hash, ConstHashWordBoundaries) {
+  // Strings just short of, exactly at, and just past a whole 8-byte word.
+  EXPECT_THAT(ConstHash(""), Eq(Hash("")));
+  EXPECT_THAT(ConstHash("abcdefg"), Eq(Hash("abcdefg")));
+  EXPECT_THAT(ConstHash("abcdefgh"), Eq(Hash("abcdefgh")));
+  EXPECT_THAT(ConstHash("abcdefghi"), Eq(Hash("abcdefghi")));
+}
+#endif
+
 TEST(Hash, StringView) {
   EXPECT_THAT(Hash(string_view("Hello")), Eq(Hash("Hello")));
 }
@@ -64,5 +99,33 @@ TEST(Hash, Hasher) {
   EXPECT_THAT(Hasher<string_view>()("Hello"), Eq(Hash("Hello")));
 }
 
+TEST(Hash, HashBytes) {
+#if !LULLABY_HASH_64
+  // The 64-bit string hash is computed a word at a time, so only matches the
+  // bytewise hash in 32-bit mode.
+  EXPECT_THAT(HashBytes("hello", 5), Eq(Hash("hello")));
+#endif
+  EXPECT_THAT(HashBytes("hello", 0), Eq(kHashOffsetBasis));
+
+  // Unlike Hash(), HashBytes() continues past embedded zeros.
+  const char data[] = {'a', 0, 'b'};
+  EXPECT_THAT(HashBytes(data, 3), Not(Eq(HashBytes(data, 1))));
+}
+
+TEST(Hash, HashBytesCombine) {
+  EXPECT_THAT(HashBytes("lo", 2, HashBytes("hel", 3)),
+              Eq(HashBytes("hello", 5)));
+}
+
+TEST(HashDeathTest, RegisterHash) {
+  RegisterHash(Hash("hash_test_first"), "hash_test_first");
+
+  // Registering the same string again is fine.
+  RegisterHash(Hash("hash_test_first"), "hash_test_first");
+
+  PORT_EXPECT_DEBUG_DEATH(
+      RegisterHash(Hash("hash_test_first"), "hash_test_second"), "");
+}
+
 }  // namespace
 }  // namespace lull
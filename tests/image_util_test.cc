@@ -0,0 +1,178 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/image_util.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "lullaby/base/job_processor.h"
+
+namespace lull {
+namespace {
+
+// Returns |num_bytes| of arbitrary but deterministic image data.
+std::vector<uint8_t> MakeImage(size_t num_bytes) {
+  std::vector<uint8_t> image(num_bytes);
+  uint32_t value = 12345;
+  for (uint8_t& byte : image) {
+    value = value * 1103515245 + 12345;
+    byte = static_cast<uint8_t>(value >> 16);
+  }
+  return image;
+}
+
+// The sizes are chosen to cover both the vectorized and the scalar code paths.
+const mathfu::vec2i kSizes[] = {
+    mathfu::vec2i(1, 1),  mathfu::vec2i(3, 1),   mathfu::vec2i(1, 5),
+    mathfu::vec2i(17, 3), mathfu::vec2i(32, 32), mathfu::vec2i(33, 19),
+};
+
+TEST(ImageUtil, ConvertRgb888ToRgba8888) {
+  for (const mathfu::vec2i& size : kSizes) {
+    const size_t num_pixels = static_cast<size_t>(size.x * size.y);
+    const std::vector<uint8_t> rgb = MakeImage(3 * num_pixels);
+    std::vector<uint8_t> rgba(4 * num_pixels);
+    ConvertRgb888ToRgba8888(rgb.data(), size, rgba.data());
+
+    for (size_t i = 0; i < num_pixels; ++i) {
+      EXPECT_EQ(rgba[4 * i + 0], rgb[3 * i + 0]);
+      EXPECT_EQ(rgba[4 * i + 1], rgb[3 * i + 1]);
+      EXPECT_EQ(rgba[4 * i + 2], rgb[3 * i + 2]);
+      EXPECT_EQ(rgba[4 * i + 3], 255);
+    }
+  }
+}
+
+TEST(ImageUtil, ConvertBgra8888ToRgba8888) {
+  for (const mathfu::vec2i& size : kSizes) {
+    const size_t num_pixels = static_cast<size_t>(size.x * size.y);
+    const std::vector<uint8_t> bgra = MakeImage(4 * num_pixels);
+    std::vector<uint8_t> rgba(4 * num_pixels);
+    ConvertBgra8888ToRgba8888(bgra.data(), size, rgba.data());
+
+    for (size_t i = 0; i < num_pixels; ++i) {
+      EXPECT_EQ(rgba[4 * i + 0], bgra[4 * i + 2]);
+      EXPECT_EQ(rgba[4 * i + 1], bgra[4 * i + 1]);
+      EXPECT_EQ(rgba[4 * i + 2], bgra[4 * i + 0]);
+      EXPECT_EQ(rgba[4 * i + 3], bgra[4 * i + 3]);
+    }
+
+    // Converting in place back to BGRA restores the original image.
+    ConvertRgba8888ToBgra8888(rgba.data(), size, rgba.data());
+    EXPECT_EQ(rgba, bgra);
+  }
+}
+
+TEST(ImageUtil, PremultiplyAlphaRgba8888) {
+  for (const mathfu::vec2i& size : kSizes) {
+    const size_t num_pixels = static_cast<size_t>(size.x * size.y);
+    const std::vector<uint8_t> rgba = MakeImage(4 * num_pixels);
+    std::vector<uint8_t> result = rgba;
+    PremultiplyAlphaRgba8888(result.data(), size, result.data());
+
+    for (size_t i = 0; i < num_pixels; ++i) {
+      const int alpha = rgba[4 * i + 3];
+      for (size_t c = 0; c < 3; ++c) {
+        const int expected = (rgba[4 * i + c] * alpha * 2 + 255) / (2 * 255);
+        EXPECT_EQ(result[4 * i + c], expected);
+      }
+      EXPECT_EQ(result[4 * i + 3], alpha);
+    }
+  }
+}
+
+TEST(ImageUtil, HalveRgba8888) {
+  for (const mathfu::vec2i& size : kSizes) {
+    const std::vector<uint8_t> rgba =
+        MakeImage(4 * static_cast<size_t>(size.x * size.y));
+    const mathfu::vec2i out_size = GetHalvedImageSize(size);
+    EXPECT_EQ(out_size.x, std::max(size.x / 2, 1));
+    EXPECT_EQ(out_size.y, std::max(size.y / 2, 1));
+
+    std::vector<uint8_t> result(4 * static_cast<size_t>(out_size.x *
+                                                        out_size.y));
+    HalveRgba8888(rgba.data(), size, result.data());
+
+    for (int y = 0; y < out_size.y; ++y) {
+      const int y0 = 2 * y;
+      const int y1 = std::min(2 * y + 1, size.y - 1);
+      for (int x = 0; x < out_size.x; ++x) {
+        const int x0 = 2 * x;
+        const int x1 = std::min(2 * x + 1, size.x - 1);
+        for (int c = 0; c < 4; ++c) {
+          const int sum = rgba[4 * (y0 * size.x + x0) + c] +
+                          rgba[4 * (y0 * size.x + x1) + c] +
+                          rgba[4 * (y1 * size.x + x0) + c] +
+                          rgba[4 * (y1 * size.x + x1) + c];
+          EXPECT_EQ(result[4 * (y * out_size.x + x) + c], (sum + 2) / 4);
+        }
+      }
+    }
+  }
+}
+
+TEST(ImageUtil, GenerateMipmapsRgba8888) {
+  EXPECT_EQ(GetNumMipLevels(mathfu::vec2i(0, 0)), 0);
+  EXPECT_EQ(GetNumMipLevels(mathfu::vec2i(1, 1)), 1);
+  EXPECT_EQ(GetNumMipLevels(mathfu::vec2i(256, 256)), 9);
+  EXPECT_EQ(GetNumMipLevels(mathfu::vec2i(1, 300)), 9);
+
+  const mathfu::vec2i size(12, 5);
+  const std::vector<uint8_t> rgba =
+      MakeImage(4 * static_cast<size_t>(size.x * size.y));
+  std::vector<uint8_t> mips;
+  GenerateMipmapsRgba8888(rgba.data(), size, &mips);
+
+  // Levels: 6x2, 3x1, 1x1.
+  ASSERT_EQ(mips.size(), 4u * (6 * 2 + 3 * 1 + 1 * 1));
+  std::vector<uint8_t> level1(4 * 6 * 2);
+  HalveRgba8888(rgba.data(), size, level1.data());
+  std::vector<uint8_t> level2(4 * 3 * 1);
+  HalveRgba8888(level1.data(), mathfu::vec2i(6, 2), level2.data());
+  std::vector<uint8_t> level3(4);
+  HalveRgba8888(level2.data(), mathfu::vec2i(3, 1), level3.data());
+
+  std::vector<uint8_t> expected = level1;
+  expected.insert(expected.end(), level2.begin(), level2.end());
+  expected.insert(expected.end(), level3.begin(), level3.end());
+  EXPECT_EQ(mips, expected);
+}
+
+TEST(ImageUtil, Parallel) {
+  // Large enough to be split across multiple jobs.
+  const mathfu::vec2i size(640, 480);
+  const size_t num_pixels = static_cast<size_t>(size.x * size.y);
+  const std::vector<uint8_t> rgba = MakeImage(4 * num_pixels);
+
+  JobProcessor job_processor(/* num_worker_threads = */ 3);
+
+  std::vector<uint8_t> serial(4 * num_pixels);
+  std::vector<uint8_t> parallel(4 * num_pixels);
+  PremultiplyAlphaRgba8888(rgba.data(), size, serial.data());
+  PremultiplyAlphaRgba8888(rgba.data(), size, parallel.data(), &job_processor);
+  EXPECT_EQ(serial, parallel);
+
+  std::vector<uint8_t> serial_mips;
+  std::vector<uint8_t> parallel_mips;
+  GenerateMipmapsRgba8888(rgba.data(), size, &serial_mips);
+  GenerateMipmapsRgba8888(rgba.data(), size, &parallel_mips, &job_processor);
+  EXPECT_EQ(serial_mips, parallel_mips);
+}
+
+}  // namespace
+}  // namespace lull
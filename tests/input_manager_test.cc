@@ -16,6 +16,9 @@ limitations under the License.
 
 #include "lullaby/base/input_manager.h"
 
+#include <atomic>
+#include <thread>
+
 #include "ion/base/logchecker.h"
 #include "gtest/gtest.h"
 #include "lullaby/util/bits.h"
@@ -497,6 +500,39 @@ TEST(InputManagerDeathTest, DegreesOfFreedom) {
   EXPECT_TRUE(!input.IsConnected(device));
 }
 
+TEST(InputManager, PredictedPoseUsesSampleTimes) {
+  const float kEpsilon = 0.00001f;
+  InputManager input;
+  const auto device = InputManager::kHmd;
+  InputManager::DeviceParams params;
+  params.has_position_dof = true;
+  input.ConnectDevice(device, params);
+
+  const Clock::time_point start = Clock::now();
+  const Clock::duration interval = std::chrono::milliseconds(10);
+  input.UpdatePosition(device, mathfu::vec3(0, 0, 0), start);
+  input.UpdatePosition(device, mathfu::vec3(1, 0, 0), start + interval);
+  // Samples older than the latest one update the state but not the history.
+  input.UpdatePosition(device, mathfu::vec3(5, 0, 0), start);
+
+  // Poses are not available for prediction until the next frame.
+  EXPECT_NEAR(input.GetDofPredictedPose(device, start).position.x, 0,
+              kEpsilon);
+  input.AdvanceFrame(kDeltaTime);
+
+  EXPECT_NEAR(input.GetDofPosition(device).x, 5, kEpsilon);
+  EXPECT_NEAR(input.GetDofPredictedPose(device, start).position.x, 0,
+              kEpsilon);
+  EXPECT_NEAR(
+      input.GetDofPredictedPose(device, start + interval / 2).position.x, 0.5f,
+      kEpsilon);
+  EXPECT_NEAR(
+      input.GetDofPredictedPose(device, start + interval).position.x, 1,
+      kEpsilon);
+
+  input.DisconnectDevice(device);
+}
+
 TEST(InputManagerDeathTest, Eye) {
   InputManager input;
   const auto device = InputManager::kHmd;
@@ -859,5 +895,71 @@ TEST(InputManagerDeathTest, Scroll) {
   EXPECT_TRUE(!input.IsConnected(device));
 }
 
+TEST(InputManager, UpdateFromOtherThread) {
+  InputManager input;
+  const auto device = InputManager::kHmd;
+  const int kNumUpdates = 1000;
+
+  InputManager::DeviceParams params;
+  params.has_position_dof = true;
+  input.ConnectDevice(device, params);
+  input.AdvanceFrame(kDeltaTime);
+
+  // Advancing while another thread is updating the device must only ever
+  // expose positions that were fully written.
+  std::thread writer([&input, device]() {
+    for (int i = 1; i <= kNumUpdates; ++i) {
+      const float value = static_cast<float>(i);
+      input.UpdatePosition(device, mathfu::vec3(value, value, value));
+    }
+  });
+  for (int i = 0; i < kNumUpdates; ++i) {
+    input.AdvanceFrame(kDeltaTime);
+    const mathfu::vec3 position = input.GetDofPosition(device);
+    EXPECT_EQ(position.x, position.y);
+    EXPECT_EQ(position.x, position.z);
+  }
+  writer.join();
+
+  input.AdvanceFrame(kDeltaTime);
+  EXPECT_EQ(input.GetDofPosition(device).x, static_cast<float>(kNumUpdates));
+}
+
+TEST(InputManager, ReconnectWhileLatching) {
+  InputManager input;
+  const auto device = InputManager::kHmd;
+  const int kNumReconnects = 1000;
+
+  InputManager::DeviceParams params;
+  params.has_position_dof = true;
+  input.ConnectDevice(device, params);
+  input.AdvanceFrame(kDeltaTime);
+
+  // Reconnecting a device must not free its buffer while another thread is
+  // still latching poses from it.
+  std::atomic<bool> done(false);
+  std::thread reader([&input, &done, device]() {
+    while (!done) {
+      const mathfu::mat4 matrix =
+          input.GetLatchedDofWorldFromObjectMatrix(device);
+      const mathfu::vec3 position = matrix.TranslationVector3D();
+      EXPECT_EQ(position.x, position.y);
+      EXPECT_EQ(position.x, position.z);
+    }
+  });
+  for (int i = 1; i <= kNumReconnects; ++i) {
+    const float value = static_cast<float>(i);
+    input.UpdatePosition(device, mathfu::vec3(value, value, value));
+    input.AdvanceFrame(kDeltaTime);
+    input.DisconnectDevice(device);
+    input.ConnectDevice(device, params);
+  }
+  done = true;
+  reader.join();
+
+  input.AdvanceFrame(kDeltaTime);
+  EXPECT_TRUE(input.IsConnected(device));
+}
+
 }  // namespace
 }  // namespace lull
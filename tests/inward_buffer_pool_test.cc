@@ -0,0 +1,95 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/inward_buffer_pool.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace lull {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Ge;
+
+TEST(InwardBufferPool, AcquireNew) {
+  InwardBufferPool pool;
+  InwardBuffer buffer = pool.Acquire(64);
+  EXPECT_THAT(buffer.Capacity(), Ge(64u));
+  EXPECT_THAT(buffer.FrontSize(), Eq(0u));
+  EXPECT_THAT(buffer.BackSize(), Eq(0u));
+  EXPECT_THAT(pool.Size(), Eq(0u));
+}
+
+TEST(InwardBufferPool, ReuseReleased) {
+  InwardBufferPool pool;
+  InwardBuffer buffer = pool.Acquire(64);
+  buffer.WriteBack<uint32_t>(123);
+  const void* mem = buffer.FrontAt(0);
+  pool.Release(std::move(buffer));
+  EXPECT_THAT(pool.Size(), Eq(1u));
+
+  // The released memory is reused and the buffer is emptied.
+  InwardBuffer reused = pool.Acquire(32);
+  EXPECT_THAT(reused.FrontAt(0), Eq(mem));
+  EXPECT_THAT(reused.BackSize(), Eq(0u));
+  EXPECT_THAT(pool.Size(), Eq(0u));
+}
+
+TEST(InwardBufferPool, PrefersSmallestFit) {
+  InwardBufferPool pool;
+  pool.Release(InwardBuffer(256));
+  pool.Release(InwardBuffer(64));
+  pool.Release(InwardBuffer(16));
+
+  InwardBuffer buffer = pool.Acquire(48);
+  EXPECT_THAT(buffer.Capacity(), Eq(64u));
+  EXPECT_THAT(pool.Size(), Eq(2u));
+}
+
+TEST(InwardBufferPool, GrowsLargest) {
+  InwardBufferPool pool;
+  pool.Release(InwardBuffer(16));
+  pool.Release(InwardBuffer(32));
+
+  InwardBuffer buffer = pool.Acquire(128);
+  EXPECT_THAT(buffer.Capacity(), Ge(128u));
+  ASSERT_THAT(pool.Size(), Eq(1u));
+
+  InwardBuffer remaining = pool.Acquire(0);
+  EXPECT_THAT(remaining.Capacity(), Eq(16u));
+}
+
+TEST(InwardBufferPool, MaxBuffers) {
+  InwardBufferPool pool(2);
+  pool.Release(InwardBuffer(16));
+  pool.Release(InwardBuffer(32));
+  pool.Release(InwardBuffer(64));
+  EXPECT_THAT(pool.Size(), Eq(2u));
+
+  // The smallest buffer was dropped to make room.
+  EXPECT_THAT(pool.Acquire(0).Capacity(), Eq(32u));
+  EXPECT_THAT(pool.Acquire(0).Capacity(), Eq(64u));
+}
+
+TEST(InwardBufferPool, Clear) {
+  InwardBufferPool pool;
+  pool.Release(InwardBuffer(16));
+  pool.Clear();
+  EXPECT_THAT(pool.Size(), Eq(0u));
+}
+
+}  // namespace
+}  // namespace lull
@@ -210,6 +210,32 @@ TEST(InwardBuffer, Realloc) {
   EXPECT_THAT(*reinterpret_cast<uint8_t*>(buffer.BackAt(6)), Eq('w'));
 }
 
+TEST(InwardBuffer, Reserve) {
+  InwardBuffer buffer(8);
+  const char front_data[] = "hi";
+  const char back_data[] = "yo";
+  buffer.WriteFront(front_data, sizeof(front_data));
+  buffer.WriteBack(back_data, sizeof(back_data));
+
+  buffer.Reserve(4);
+  EXPECT_THAT(buffer.Capacity(), Eq(8u));
+
+  buffer.Reserve(100);
+  EXPECT_GE(buffer.Capacity(), 100u);
+  EXPECT_THAT(buffer.FrontSize(), Eq(3u));
+  EXPECT_THAT(*reinterpret_cast<uint8_t*>(buffer.FrontAt(0)), Eq('h'));
+  EXPECT_THAT(*reinterpret_cast<uint8_t*>(buffer.FrontAt(1)), Eq('i'));
+  EXPECT_THAT(buffer.BackSize(), Eq(3u));
+  EXPECT_THAT(*reinterpret_cast<uint8_t*>(buffer.BackAt(2)), Eq('o'));
+  EXPECT_THAT(*reinterpret_cast<uint8_t*>(buffer.BackAt(3)), Eq('y'));
+
+  // No reallocation is needed to fill the reserved capacity.
+  const void* mem = buffer.FrontAt(0);
+  buffer.AllocBack(buffer.Capacity() - buffer.FrontSize() -
+                   buffer.BackSize());
+  EXPECT_THAT(buffer.FrontAt(0), Eq(mem));
+}
+
 TEST(InwardBuffer, MoveConstructor) {
   InwardBuffer buffer(32);
   const char data[] = "hi";
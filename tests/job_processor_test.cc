@@ -17,6 +17,7 @@ limitations under the License.
 #include "lullaby/base/job_processor.h"
 
 #include <future>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -53,5 +54,38 @@ TEST(JobProcessorTest, ManyJobs) {
   }
 }
 
+TEST(JobProcessorTest, RunJobsForRange) {
+  static const size_t kCount = 1000;
+
+  JobProcessor job_processor(/* num_worker_threads = */ 4);
+
+  std::vector<int> values(kCount, 0);
+  RunJobsForRange(&job_processor, kCount, /* min_range_size = */ 100,
+                  /* max_jobs = */ 4, [&values](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                      ++values[i];
+                    }
+                  });
+
+  for (size_t i = 0; i < kCount; ++i) {
+    EXPECT_THAT(values[i], Eq(1));
+  }
+}
+
+TEST(JobProcessorTest, RunJobsForRangeSmallRange) {
+  JobProcessor job_processor(/* num_worker_threads = */ 4);
+
+  int num_calls = 0;
+  size_t total = 0;
+  RunJobsForRange(&job_processor, 50, /* min_range_size = */ 100,
+                  /* max_jobs = */ 4, [&](size_t begin, size_t end) {
+                    ++num_calls;
+                    total += end - begin;
+                  });
+
+  EXPECT_THAT(num_calls, Eq(1));
+  EXPECT_THAT(total, Eq(50U));
+}
+
 }  // namespace
 }  // namespace lull
@@ -712,5 +712,31 @@ TEST_F(QueuedLayoutSystemTest, ActualBoxClosestSource_Second) {
                      actual_sources_);
 }
 
+// Test that the LayoutSystem skips passes that wouldn't change anything, but
+// still sends the LayoutChangedEvent.
+TEST_F(QueuedLayoutSystemTest, SkipUnchangedPass) {
+  const Entity parent = CreateParent();
+  const Entity child = CreateChild(parent, 1.0f);
+
+  dispatcher_->Dispatch();
+  const Aabb box(mathfu::vec3(-1.f, -1.f, 0.f), mathfu::vec3(1.f, 1.f, 0.f));
+  layout_box_system_->SetActualBox(child, kNullEntity, box);
+  dispatcher_->Dispatch();
+  const size_t num_passes = layout_system_->GetLayoutPassCount();
+  EXPECT_GT(num_passes, 0u);
+  ClearListeners();
+
+  layout_box_system_->SetActualBox(child, kNullEntity, box);
+  dispatcher_->Dispatch();
+  EXPECT_EQ(num_passes, layout_system_->GetLayoutPassCount());
+  AssertListenerMatch({ {parent, 1} }, layouts_changed_);
+  AssertListenerMatch({ {child, 1} }, actual_boxes_);
+
+  // Changing the params always requires a new pass.
+  layout_system_->SetSpacingX(parent, 0.1f);
+  dispatcher_->Dispatch();
+  EXPECT_EQ(num_passes + 1, layout_system_->GetLayoutPassCount());
+}
+
 }  // namespace
 }  // namespace lull
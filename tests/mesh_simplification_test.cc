@@ -0,0 +1,139 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "gtest/gtest.h"
+#include "mathfu/glsl_mappings.h"
+#include "lullaby/util/mesh_simplification.h"
+#include "lullaby/util/mesh_util.h"
+#include "lullaby/util/vertex.h"
+#include "lullaby/generated/tests/mathfu_matchers.h"
+#include "lullaby/generated/tests/portable_test_macros.h"
+
+namespace lull {
+namespace {
+
+constexpr float kEpsilon = 1.0E-5f;
+
+using testing::NearMathfu;
+
+MeshData CreateGrid(int num_verts) {
+  return CreateQuadMesh<VertexPT>(2.f, 2.f, num_verts, num_verts, 0.f, 0);
+}
+
+// Creates a closed, subdivided box by projecting a grid onto each face.
+MeshData CreateBox(int num_verts) {
+  const int num_faces = 6;
+  const size_t verts_per_face = num_verts * num_verts;
+  const std::vector<uint16_t> face_indices =
+      CalculateTesselatedQuadIndices(num_verts, num_verts, 0);
+  MeshData mesh(
+      MeshData::kTriangles, VertexP::kFormat,
+      DataContainer::CreateHeapDataContainer(num_faces * verts_per_face *
+                                             sizeof(VertexP)),
+      DataContainer::CreateHeapDataContainer(num_faces * face_indices.size() *
+                                             sizeof(uint16_t)));
+
+  const mathfu::vec3 axes[num_faces] = {
+      mathfu::kAxisX3f, -mathfu::kAxisX3f, mathfu::kAxisY3f,
+      -mathfu::kAxisY3f, mathfu::kAxisZ3f, -mathfu::kAxisZ3f,
+  };
+  for (const mathfu::vec3& normal : axes) {
+    const mathfu::vec3 u = mathfu::vec3(normal.y, normal.z, normal.x);
+    const mathfu::vec3 v = mathfu::vec3::CrossProduct(normal, u);
+    const MeshData::Index base = mesh.GetNumVertices();
+    for (int x = 0; x < num_verts; ++x) {
+      for (int y = 0; y < num_verts; ++y) {
+        const float s = 2.f * x / (num_verts - 1) - 1.f;
+        const float t = 2.f * y / (num_verts - 1) - 1.f;
+        const mathfu::vec3 p = normal + u * s + v * t;
+        mesh.AddVertex<VertexP>(p.x, p.y, p.z);
+      }
+    }
+    for (uint16_t index : face_indices) {
+      mesh.AddIndex(static_cast<MeshData::Index>(base + index));
+    }
+  }
+  return mesh;
+}
+
+TEST(MeshSimplification, FlatGrid) {
+  const MeshData grid = CreateGrid(10);
+  const size_t num_triangles = grid.GetNumIndices() / 3;
+  EXPECT_EQ(num_triangles, 162U);
+
+  const MeshData simplified = SimplifyMesh(grid, 20);
+  EXPECT_EQ(simplified.GetPrimitiveType(), MeshData::kTriangles);
+  EXPECT_EQ(simplified.GetVertexFormat(), VertexPT::kFormat);
+  EXPECT_LE(simplified.GetNumIndices() / 3, 20U);
+  EXPECT_GT(simplified.GetNumIndices(), 0U);
+  EXPECT_LT(simplified.GetNumVertices(), grid.GetNumVertices());
+
+  // The boundary of a flat grid can be simplified without error, so the
+  // extents should be unchanged.
+  const Aabb before = grid.GetAabb();
+  const Aabb after = simplified.GetAabb();
+  EXPECT_THAT(after.min, NearMathfu(before.min, kEpsilon));
+  EXPECT_THAT(after.max, NearMathfu(before.max, kEpsilon));
+}
+
+TEST(MeshSimplification, AllIndicesValid) {
+  const MeshData simplified = SimplifyMesh(CreateBox(8), 40);
+  const MeshData::Index* indices = simplified.GetIndexData();
+  for (size_t i = 0; i < simplified.GetNumIndices(); ++i) {
+    EXPECT_LT(indices[i], simplified.GetNumVertices());
+  }
+}
+
+TEST(MeshSimplification, MaxErrorLimitsCollapses) {
+  const MeshData box = CreateBox(6);
+  const size_t num_triangles = box.GetNumIndices() / 3;
+
+  // Every face is flat, so collapsing within faces is free, but the corners
+  // of the box can't be removed without error.
+  const MeshData simplified = SimplifyMesh(box, 0, 0.f);
+  EXPECT_LT(simplified.GetNumIndices() / 3, num_triangles);
+  EXPECT_GT(simplified.GetNumIndices(), 0U);
+
+  const Aabb before = box.GetAabb();
+  const Aabb after = simplified.GetAabb();
+  EXPECT_THAT(after.min, NearMathfu(before.min, kEpsilon));
+  EXPECT_THAT(after.max, NearMathfu(before.max, kEpsilon));
+}
+
+TEST(MeshSimplification, GenerateMeshLods) {
+  const MeshData box = CreateBox(10);
+  const std::vector<MeshData> lods = GenerateMeshLods(box, 3, 0.5f);
+  ASSERT_EQ(lods.size(), 3U);
+
+  size_t prev_num_triangles = box.GetNumIndices() / 3;
+  for (const MeshData& lod : lods) {
+    const size_t num_triangles = lod.GetNumIndices() / 3;
+    EXPECT_LE(num_triangles, prev_num_triangles / 2);
+    EXPECT_GT(num_triangles, 0U);
+    prev_num_triangles = num_triangles;
+  }
+}
+
+TEST(MeshSimplificationDeathTest, UnsupportedMeshes) {
+  MeshData strip(MeshData::kTriangleStrip, VertexP::kFormat,
+                 DataContainer::CreateHeapDataContainer(0),
+                 DataContainer::CreateHeapDataContainer(0));
+  PORT_EXPECT_DEBUG_DEATH(SimplifyMesh(strip, 1), "");
+  PORT_EXPECT_DEBUG_DEATH(GenerateMeshLods(CreateGrid(4), 1, 1.f), "");
+}
+
+}  // namespace
+}  // namespace lull
@@ -361,6 +361,42 @@ TEST(Deformation, ExtraDataUntouched) {
   EXPECT_EQ(list[1], mathfu::vec4(-10, -12, -14, 8));
 }
 
+TEST(Deformation, CylinderBendMatchesScalar) {
+  const float kRadius = 2.5f;
+  const mathfu::mat4 deformed_from_mesh =
+      mathfu::mat4::FromTranslationVector(mathfu::vec3(0.5f, -1.f, -kRadius)) *
+      mathfu::mat4::FromScaleVector(mathfu::vec3(1.f, 2.f, 1.f));
+  const mathfu::mat4 mesh_from_deformed =
+      mathfu::mat4::FromTranslationVector(mathfu::vec3(0.f, 0.f, kRadius));
+
+  // Use a vertex count which isn't a multiple of the SIMD width so that the
+  // scalar tail is also exercised.
+  std::vector<VertexPT> vertices;
+  for (int i = 0; i < 37; ++i) {
+    const float t = static_cast<float>(i) * 0.37f;
+    vertices.emplace_back(t - 6.f, sinf(t), cosf(t), 0.1f * t, 0.2f * t);
+  }
+  std::vector<VertexPT> expected = vertices;
+
+  const size_t stride = sizeof(VertexPT) / sizeof(float);
+  ApplyCylinderBendDeformation(reinterpret_cast<float*>(vertices.data()),
+                               vertices.size() * stride, stride,
+                               deformed_from_mesh, kRadius, mesh_from_deformed);
+  ApplyDeformation(reinterpret_cast<float*>(expected.data()),
+                   expected.size() * stride, stride,
+                   [&](const mathfu::vec3& pos) {
+                     return mesh_from_deformed *
+                            DeformPoint(deformed_from_mesh * pos, kRadius);
+                   });
+
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    EXPECT_THAT(GetPosition(vertices[i]),
+                NearMathfu(GetPosition(expected[i]), 1.0E-4f));
+    EXPECT_EQ(vertices[i].u0, expected[i].u0);
+    EXPECT_EQ(vertices[i].v0, expected[i].v0);
+  }
+}
+
 TEST(ApplyDeformation, MeshData) {
   VertexPT vertices[] = {
       VertexPT(1.0f, 2.0f, 3.0f, 0.1f, 0.2f),
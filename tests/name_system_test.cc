@@ -19,6 +19,8 @@ limitations under the License.
 #include "gtest/gtest.h"
 #include "lullaby/generated/name_def_generated.h"
 #include "lullaby/base/blueprint.h"
+#include "lullaby/base/dispatcher.h"
+#include "lullaby/base/queued_dispatcher.h"
 #include "lullaby/systems/transform/transform_system.h"
 #include "lullaby/generated/tests/portable_test_macros.h"
 
@@ -130,6 +132,7 @@ TEST_F(NameSystemTest, FindDescendant) {
   transform_system->AddChild(kRootEntity, kParentEntity2);
   transform_system->AddChild(kParentEntity1, kChildEntity1);
   NameSystem* name_system = registry_.Create<NameSystem>(&registry_);
+  name_system->Initialize();
   name_system->SetName(kChildEntity1, "child1");
   name_system->SetName(kParentEntity1, "parent1");
 
@@ -166,6 +169,7 @@ TEST_F(NameSystemTest, FindDescendantWithDuplicateNames) {
   transform_system->AddChild(kParentEntity2, kChildEntity2);
   auto* name_system =
       registry_.Create<NameSystem>(&registry_, kAllowDuplicateNames);
+  name_system->Initialize();
   name_system->SetName(kChildEntity1, "left_button");
   name_system->SetName(kChildEntity2, "left_button");
   name_system->SetName(kChildEntity3, "child3");
@@ -183,5 +187,187 @@ TEST_F(NameSystemTest, FindDescendantWithDuplicateNames) {
               Eq(kChildEntity2));
 }
 
+TEST_F(NameSystemTest, FindEntityWithDuplicateNames) {
+  const bool kAllowDuplicateNames = true;
+  auto* name_system =
+      registry_.Create<NameSystem>(&registry_, kAllowDuplicateNames);
+  name_system->Initialize();
+  name_system->SetName(1, "left_button");
+  name_system->SetName(2, "right_button");
+  name_system->SetName(3, "left_button");
+
+  EXPECT_THAT(name_system->FindEntity("right_button"), Eq(2U));
+  EXPECT_THAT(name_system->FindEntity("missing"), Eq(kNullEntity));
+
+  name_system->SetName(2, "up_button");
+  EXPECT_THAT(name_system->FindEntity("right_button"), Eq(kNullEntity));
+  EXPECT_THAT(name_system->FindEntity("up_button"), Eq(2U));
+
+  name_system->Destroy(2);
+  EXPECT_THAT(name_system->FindEntity("up_button"), Eq(kNullEntity));
+}
+
+TEST_F(NameSystemTest, FindPath) {
+  const bool kAllowDuplicateNames = true;
+  const Entity kRootEntity = 1;
+  const Entity kPanelEntity = 2;
+  const Entity kListEntity = 3;
+  const Entity kItemEntity1 = 4;
+  const Entity kItemEntity2 = 5;
+  const Entity kOtherListEntity = 6;
+  const Entity kOtherItemEntity = 7;
+  Sqt sqt;
+  auto* transform_system = registry_.Create<TransformSystem>(&registry_);
+  for (Entity entity = kRootEntity; entity <= kOtherItemEntity; ++entity) {
+    transform_system->Create(entity, sqt);
+  }
+  transform_system->AddChild(kRootEntity, kPanelEntity);
+  transform_system->AddChild(kPanelEntity, kListEntity);
+  transform_system->AddChild(kListEntity, kItemEntity1);
+  transform_system->AddChild(kListEntity, kItemEntity2);
+  transform_system->AddChild(kRootEntity, kOtherListEntity);
+  transform_system->AddChild(kOtherListEntity, kOtherItemEntity);
+  auto* name_system =
+      registry_.Create<NameSystem>(&registry_, kAllowDuplicateNames);
+  name_system->Initialize();
+  name_system->SetName(kPanelEntity, "panel");
+  name_system->SetName(kListEntity, "list");
+  name_system->SetName(kItemEntity1, "item1");
+  name_system->SetName(kItemEntity2, "item2");
+  name_system->SetName(kOtherListEntity, "list");
+  name_system->SetName(kOtherItemEntity, "item1");
+
+  const NameSystem::Path path("panel/list/item1");
+  EXPECT_THAT(path.Size(), Eq(3U));
+  EXPECT_THAT(name_system->FindPath(kRootEntity, path), Eq(kItemEntity1));
+  EXPECT_THAT(name_system->FindPath(kRootEntity, "panel/item2"),
+              Eq(kItemEntity2));
+  EXPECT_THAT(name_system->FindPath(kRootEntity, "/panel//list/"),
+              Eq(kListEntity));
+  EXPECT_THAT(name_system->FindPath(kPanelEntity, "list/item1"),
+              Eq(kItemEntity1));
+  EXPECT_THAT(name_system->FindPath(kRootEntity, ""), Eq(kRootEntity));
+  EXPECT_THAT(name_system->FindPath(kRootEntity, "panel/missing"),
+              Eq(kNullEntity));
+  // Later names must be strict descendants of earlier ones.
+  EXPECT_THAT(name_system->FindPath(kRootEntity, "panel/panel"),
+              Eq(kNullEntity));
+}
+
+TEST_F(NameSystemTest, ReparentUpdatesIndex) {
+  const Entity kRootEntity = 1;
+  const Entity kParentEntity1 = 2;
+  const Entity kParentEntity2 = 3;
+  const Entity kChildEntity = 4;
+  const Entity kGrandchildEntity = 5;
+  registry_.Create<Dispatcher>();
+  Sqt sqt;
+  auto* transform_system = registry_.Create<TransformSystem>(&registry_);
+  auto* name_system = registry_.Create<NameSystem>(&registry_);
+  name_system->Initialize();
+  for (Entity entity = kRootEntity; entity <= kGrandchildEntity; ++entity) {
+    transform_system->Create(entity, sqt);
+  }
+  name_system->SetName(kChildEntity, "child");
+  name_system->SetName(kGrandchildEntity, "grandchild");
+  transform_system->AddChild(kRootEntity, kParentEntity1);
+  transform_system->AddChild(kRootEntity, kParentEntity2);
+  transform_system->AddChild(kParentEntity1, kChildEntity);
+  transform_system->AddChild(kChildEntity, kGrandchildEntity);
+
+  EXPECT_THAT(name_system->FindDescendant(kParentEntity1, "grandchild"),
+              Eq(kGrandchildEntity));
+  EXPECT_THAT(name_system->FindDescendant(kParentEntity2, "grandchild"),
+              Eq(kNullEntity));
+
+  // Moving the child moves its whole subtree.
+  transform_system->AddChild(kParentEntity2, kChildEntity);
+  EXPECT_THAT(name_system->FindDescendant(kParentEntity1, "grandchild"),
+              Eq(kNullEntity));
+  EXPECT_THAT(name_system->FindDescendant(kParentEntity2, "grandchild"),
+              Eq(kGrandchildEntity));
+  EXPECT_THAT(name_system->FindDescendant(kRootEntity, "child"),
+              Eq(kChildEntity));
+
+  transform_system->RemoveParent(kChildEntity);
+  EXPECT_THAT(name_system->FindDescendant(kRootEntity, "child"),
+              Eq(kNullEntity));
+  EXPECT_THAT(name_system->FindDescendant(kChildEntity, "grandchild"),
+              Eq(kGrandchildEntity));
+  EXPECT_THAT(name_system->FindEntity("grandchild"), Eq(kGrandchildEntity));
+}
+
+TEST_F(NameSystemTest, FindAfterReparentingInSameFrame) {
+  const Entity kRootEntity = 1;
+  const Entity kParentEntity1 = 2;
+  const Entity kParentEntity2 = 3;
+  const Entity kChildEntity = 4;
+  auto* dispatcher = new QueuedDispatcher();
+  registry_.Register(std::unique_ptr<Dispatcher>(dispatcher));
+  Sqt sqt;
+  auto* transform_system = registry_.Create<TransformSystem>(&registry_);
+  auto* name_system = registry_.Create<NameSystem>(&registry_);
+  name_system->Initialize();
+  for (Entity entity = kRootEntity; entity <= kChildEntity; ++entity) {
+    transform_system->Create(entity, sqt);
+  }
+  name_system->SetName(kChildEntity, "child");
+  transform_system->AddChild(kRootEntity, kParentEntity1);
+  transform_system->AddChild(kRootEntity, kParentEntity2);
+  transform_system->AddChild(kParentEntity1, kChildEntity);
+
+  // The index is updated before the queued ParentChangedEvents are
+  // dispatched.
+  EXPECT_THAT(name_system->FindDescendant(kRootEntity, "child"),
+              Eq(kChildEntity));
+  EXPECT_THAT(name_system->FindPath(kRootEntity, "child"), Eq(kChildEntity));
+  dispatcher->Dispatch();
+  EXPECT_THAT(name_system->FindDescendant(kParentEntity1, "child"),
+              Eq(kChildEntity));
+
+  // Reparenting removes the entity from its old ancestors' index
+  // immediately.
+  transform_system->AddChild(kParentEntity2, kChildEntity);
+  EXPECT_THAT(name_system->FindDescendant(kParentEntity1, "child"),
+              Eq(kNullEntity));
+  EXPECT_THAT(name_system->FindDescendant(kParentEntity2, "child"),
+              Eq(kChildEntity));
+  dispatcher->Dispatch();
+  EXPECT_THAT(name_system->FindDescendant(kParentEntity1, "child"),
+              Eq(kNullEntity));
+  EXPECT_THAT(name_system->FindDescendant(kParentEntity2, "child"),
+              Eq(kChildEntity));
+}
+
+TEST_F(NameSystemTest, FindDuplicateNamesAfterReparentingInSameFrame) {
+  const bool kAllowDuplicateNames = true;
+  const Entity kRootEntity = 1;
+  const Entity kParentEntity = 2;
+  const Entity kChildEntity1 = 3;
+  const Entity kChildEntity2 = 4;
+  auto* dispatcher = new QueuedDispatcher();
+  registry_.Register(std::unique_ptr<Dispatcher>(dispatcher));
+  Sqt sqt;
+  auto* transform_system = registry_.Create<TransformSystem>(&registry_);
+  auto* name_system =
+      registry_.Create<NameSystem>(&registry_, kAllowDuplicateNames);
+  name_system->Initialize();
+  for (Entity entity = kRootEntity; entity <= kChildEntity2; ++entity) {
+    transform_system->Create(entity, sqt);
+  }
+  name_system->SetName(kParentEntity, "parent");
+  name_system->SetName(kChildEntity1, "item");
+  name_system->SetName(kChildEntity2, "item");
+  transform_system->AddChild(kRootEntity, kParentEntity);
+  transform_system->AddChild(kParentEntity, kChildEntity2);
+
+  EXPECT_THAT(name_system->FindDescendant(kRootEntity, "item"),
+              Eq(kChildEntity2));
+  EXPECT_THAT(name_system->FindPath(kRootEntity, "parent/item"),
+              Eq(kChildEntity2));
+  EXPECT_THAT(name_system->FindPath(kRootEntity, "parent/parent"),
+              Eq(kNullEntity));
+}
+
 }  // namespace
 }  // namespace lull
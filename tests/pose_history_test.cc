@@ -0,0 +1,128 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/pose_history.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "lullaby/util/math.h"
+#include "lullaby/generated/tests/mathfu_matchers.h"
+
+namespace lull {
+namespace {
+
+using testing::NearMathfu;
+
+constexpr float kEpsilon = 1.0E-4f;
+
+Clock::time_point TimeFromMilliseconds(int ms) {
+  return Clock::time_point(std::chrono::milliseconds(ms));
+}
+
+mathfu::quat RotationAboutY(float degrees) {
+  return mathfu::quat::FromAngleAxis(degrees * kDegreesToRadians,
+                                     mathfu::kAxisY3f);
+}
+
+TEST(PoseHistory, Empty) {
+  PoseHistory history;
+  EXPECT_TRUE(history.Empty());
+
+  const TimedPose pose = history.Predict(TimeFromMilliseconds(10));
+  EXPECT_THAT(pose.position, NearMathfu(mathfu::kZeros3f, kEpsilon));
+  EXPECT_THAT(pose.rotation, NearMathfu(mathfu::quat::identity, kEpsilon));
+}
+
+TEST(PoseHistory, ReplacesSameTime) {
+  PoseHistory history;
+  history.Add(TimeFromMilliseconds(10), mathfu::kOnes3f,
+              mathfu::quat::identity);
+  history.Add(TimeFromMilliseconds(10), mathfu::kZeros3f,
+              mathfu::quat::identity);
+  EXPECT_EQ(history.Size(), 1U);
+  EXPECT_THAT(history.GetLatest().position,
+              NearMathfu(mathfu::kZeros3f, kEpsilon));
+}
+
+TEST(PoseHistory, Capacity) {
+  PoseHistory history;
+  for (int i = 0; i < 20; ++i) {
+    history.Add(TimeFromMilliseconds(i * 10), mathfu::vec3(i, 0, 0),
+                mathfu::quat::identity);
+  }
+  EXPECT_EQ(history.Size(), PoseHistory::kCapacity);
+  EXPECT_THAT(history.GetLatest().position,
+              NearMathfu(mathfu::vec3(19, 0, 0), kEpsilon));
+
+  // Times before the oldest sample are clamped to it.
+  const TimedPose pose = history.Predict(TimeFromMilliseconds(0));
+  EXPECT_THAT(pose.position,
+              NearMathfu(mathfu::vec3(20 - PoseHistory::kCapacity, 0, 0),
+                         kEpsilon));
+}
+
+TEST(PoseHistory, Interpolate) {
+  PoseHistory history;
+  history.Add(TimeFromMilliseconds(0), mathfu::kZeros3f, RotationAboutY(0));
+  history.Add(TimeFromMilliseconds(10), mathfu::vec3(1, 0, 0),
+              RotationAboutY(10));
+  history.Add(TimeFromMilliseconds(20), mathfu::vec3(3, 0, 0),
+              RotationAboutY(20));
+
+  const TimedPose pose = history.Predict(TimeFromMilliseconds(15));
+  EXPECT_THAT(pose.position, NearMathfu(mathfu::vec3(2, 0, 0), kEpsilon));
+  EXPECT_THAT(pose.rotation, NearMathfu(RotationAboutY(15), kEpsilon));
+}
+
+TEST(PoseHistory, Predict) {
+  PoseHistory history;
+  history.Add(TimeFromMilliseconds(0), mathfu::kZeros3f, RotationAboutY(0));
+  history.Add(TimeFromMilliseconds(10), mathfu::vec3(1, 0, 0),
+              RotationAboutY(10));
+
+  const TimedPose pose = history.Predict(TimeFromMilliseconds(30));
+  EXPECT_THAT(pose.position, NearMathfu(mathfu::vec3(3, 0, 0), kEpsilon));
+  EXPECT_THAT(pose.rotation, NearMathfu(RotationAboutY(30), kEpsilon));
+}
+
+TEST(PoseHistory, PredictionIsLimited) {
+  PoseHistory history;
+  history.Add(TimeFromMilliseconds(0), mathfu::kZeros3f,
+              mathfu::quat::identity);
+  history.Add(TimeFromMilliseconds(10), mathfu::vec3(1, 0, 0),
+              mathfu::quat::identity);
+
+  const TimedPose pose = history.Predict(TimeFromMilliseconds(10000));
+  EXPECT_THAT(pose.position, NearMathfu(mathfu::vec3(11, 0, 0), kEpsilon));
+}
+
+TEST(PoseHistory, VelocityIgnoresCloseSamples) {
+  PoseHistory history;
+  history.Add(TimeFromMilliseconds(0), mathfu::kZeros3f,
+              mathfu::quat::identity);
+  history.Add(TimeFromMilliseconds(10), mathfu::vec3(1, 0, 0),
+              mathfu::quat::identity);
+  // A sample just after the previous one only updates the rotation, so it
+  // shouldn't imply that the device stopped moving.
+  history.Add(TimeFromMilliseconds(11), mathfu::vec3(1.1f, 0, 0),
+              RotationAboutY(0));
+
+  const TimedPose pose = history.Predict(TimeFromMilliseconds(21));
+  EXPECT_THAT(pose.position, NearMathfu(mathfu::vec3(2.1f, 0, 0), kEpsilon));
+}
+
+}  // namespace
+}  // namespace lull
@@ -0,0 +1,100 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "lullaby/util/quantized_spline.h"
+
+namespace lull {
+namespace {
+
+constexpr float kEpsilon = 1.0E-3f;
+constexpr size_t kNumSamples = 1000;
+
+std::vector<SplineNode> CreateSineSpline(size_t num_nodes, float amplitude) {
+  std::vector<SplineNode> nodes;
+  for (size_t i = 0; i < num_nodes; ++i) {
+    const float t = static_cast<float>(i) / (num_nodes - 1) * 2.f;
+    nodes.emplace_back(t, amplitude * std::sin(2.f * t),
+                       2.f * amplitude * std::cos(2.f * t));
+  }
+  return nodes;
+}
+
+TEST(QuantizedSpline, RoundTrip) {
+  const std::vector<SplineNode> nodes = CreateSineSpline(101, 3.f);
+  const QuantizedSpline quantized = QuantizeSpline(nodes.data(), nodes.size());
+  EXPECT_EQ(quantized.times.size(), nodes.size());
+  EXPECT_EQ(quantized.values.size(), nodes.size());
+  EXPECT_EQ(quantized.angles.size(), nodes.size());
+  EXPECT_EQ(quantized.end_time, 2.f);
+
+  const std::vector<SplineNode> decoded = DequantizeSpline(quantized);
+  ASSERT_EQ(decoded.size(), nodes.size());
+  EXPECT_EQ(decoded.front().time, 0.f);
+  EXPECT_EQ(decoded.back().time, 2.f);
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    EXPECT_NEAR(decoded[i].value, nodes[i].value, kEpsilon);
+  }
+  EXPECT_LT(MeasureSplineError(nodes.data(), nodes.size(), decoded.data(),
+                               decoded.size(), kNumSamples),
+            kEpsilon);
+}
+
+TEST(QuantizedSpline, ConstantSpline) {
+  const std::vector<SplineNode> nodes = {SplineNode(0.f, 2.f, 0.f),
+                                         SplineNode(1.f, 2.f, 0.f)};
+  const std::vector<SplineNode> decoded =
+      DequantizeSpline(QuantizeSpline(nodes.data(), nodes.size()));
+  ASSERT_EQ(decoded.size(), 2U);
+  EXPECT_EQ(decoded[0].value, 2.f);
+  EXPECT_EQ(decoded[1].value, 2.f);
+  EXPECT_EQ(decoded[0].derivative, 0.f);
+}
+
+TEST(QuantizedSpline, EvaluateSpline) {
+  const std::vector<SplineNode> nodes = {SplineNode(0.f, 0.f, 1.f),
+                                         SplineNode(1.f, 1.f, 1.f)};
+  EXPECT_NEAR(EvaluateSpline(nodes.data(), nodes.size(), 0.25f), 0.25f,
+              kEpsilon);
+  EXPECT_EQ(EvaluateSpline(nodes.data(), nodes.size(), -1.f), 0.f);
+  EXPECT_EQ(EvaluateSpline(nodes.data(), nodes.size(), 2.f), 1.f);
+}
+
+TEST(QuantizedSpline, ReduceLinearKeys) {
+  const std::vector<SplineNode> nodes = {SplineNode(0.f, 0.f, 1.f),
+                                         SplineNode(0.5f, 0.5f, 1.f),
+                                         SplineNode(1.f, 1.f, 1.f)};
+  const std::vector<SplineNode> reduced =
+      ReduceSplineKeys(nodes.data(), nodes.size(), kEpsilon);
+  ASSERT_EQ(reduced.size(), 2U);
+  EXPECT_EQ(reduced[0].time, 0.f);
+  EXPECT_EQ(reduced[1].time, 1.f);
+}
+
+TEST(QuantizedSpline, ReduceWithinTolerance) {
+  const std::vector<SplineNode> nodes = CreateSineSpline(101, 3.f);
+  const std::vector<SplineNode> reduced =
+      ReduceSplineKeys(nodes.data(), nodes.size(), kEpsilon);
+  EXPECT_LT(reduced.size(), nodes.size() / 4);
+  EXPECT_LE(MeasureSplineError(nodes.data(), nodes.size(), reduced.data(),
+                               reduced.size(), kNumSamples),
+            kEpsilon);
+}
+
+}  // namespace
+}  // namespace lull
@@ -0,0 +1,142 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/systems/collision/raycast_cache.h"
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "lullaby/generated/collision_def_generated.h"
+#include "lullaby/base/blueprint.h"
+#include "lullaby/base/dispatcher.h"
+#include "lullaby/base/entity_factory.h"
+#include "lullaby/systems/transform/transform_system.h"
+#include "lullaby/generated/transform_def_generated.h"
+
+namespace lull {
+namespace {
+
+const float kEpsilon = 0.001f;
+
+// Returns a ray from the origin, rotated about +Y from -Z towards +X.
+Ray RayAtAngle(float degrees) {
+  const float radians = degrees * kDegreesToRadians;
+  return Ray(mathfu::kZeros3f,
+             mathfu::vec3(std::sin(radians), 0.f, -std::cos(radians)));
+}
+
+class RaycastCacheTest : public testing::Test {
+ public:
+  void SetUp() override {
+    registry_.reset(new Registry());
+    registry_->Create<Dispatcher>();
+
+    auto* entity_factory = registry_->Create<EntityFactory>(registry_.get());
+    entity_factory->CreateSystem<CollisionSystem>();
+    entity_factory->CreateSystem<TransformSystem>();
+    entity_factory->Initialize();
+  }
+
+ protected:
+  Entity CreateCollider(const mathfu::vec3& position, float size) {
+    Blueprint blueprint;
+    TransformDefT transform;
+    transform.position = position;
+    CollisionDefT collision;
+    blueprint.Write(&transform);
+    blueprint.Write(&collision);
+
+    const Entity entity = registry_->Get<EntityFactory>()->Create(&blueprint);
+    const mathfu::vec3 half_size = 0.5f * size * mathfu::kOnes3f;
+    registry_->Get<TransformSystem>()->SetAabb(entity,
+                                               Aabb(-half_size, half_size));
+    return entity;
+  }
+
+  std::unique_ptr<Registry> registry_;
+};
+
+TEST_F(RaycastCacheTest, ReusesResult) {
+  const Entity entity = CreateCollider(mathfu::vec3(0.f, 0.f, -4.f), 2.f);
+  auto* collision_system = registry_->Get<CollisionSystem>();
+
+  RaycastCache cache;
+  for (int i = 0; i < 4; ++i) {
+    const auto result = cache.Raycast(collision_system, RayAtAngle(0.f));
+    EXPECT_EQ(result.entity, entity);
+    EXPECT_NEAR(result.distance, 3.f, kEpsilon);
+  }
+  EXPECT_EQ(cache.GetStats().num_raycasts, 4U);
+  EXPECT_EQ(cache.GetStats().num_reused, 3U);
+  EXPECT_EQ(cache.GetStats().num_narrowed, 0U);
+  EXPECT_NEAR(cache.GetHitRate(), 0.75f, kEpsilon);
+
+  cache.ResetStats();
+  EXPECT_EQ(cache.GetStats().num_raycasts, 0U);
+  EXPECT_EQ(cache.GetHitRate(), 0.f);
+}
+
+TEST_F(RaycastCacheTest, NarrowsNearbyRays) {
+  const Entity back = CreateCollider(mathfu::vec3(0.f, 0.f, -4.f), 2.f);
+  // A small entity just beside the initial ray.
+  const Entity front = CreateCollider(
+      mathfu::vec3(2.f * std::tan(4.f * kDegreesToRadians), 0.f, -2.f), 0.2f);
+  auto* collision_system = registry_->Get<CollisionSystem>();
+
+  RaycastCache cache;
+  EXPECT_EQ(cache.Raycast(collision_system, RayAtAngle(0.f)).entity, back);
+
+  // Moving the ray slightly onto the front entity finds it by only testing
+  // entities near the original ray.
+  EXPECT_EQ(cache.Raycast(collision_system, RayAtAngle(4.f)).entity, front);
+  EXPECT_EQ(cache.Raycast(collision_system, RayAtAngle(-2.f)).entity, back);
+  EXPECT_EQ(cache.GetStats().num_narrowed, 2U);
+
+  // Moving the ray further requires testing everything.
+  cache.Raycast(collision_system, RayAtAngle(30.f));
+  EXPECT_EQ(cache.GetStats().num_narrowed, 2U);
+  EXPECT_EQ(cache.GetStats().num_reused, 0U);
+}
+
+TEST_F(RaycastCacheTest, InvalidatedByChanges) {
+  const Entity entity = CreateCollider(mathfu::vec3(0.f, 0.f, -4.f), 2.f);
+  auto* collision_system = registry_->Get<CollisionSystem>();
+  auto* transform_system = registry_->Get<TransformSystem>();
+
+  RaycastCache cache;
+  EXPECT_EQ(cache.Raycast(collision_system, RayAtAngle(0.f)).entity, entity);
+
+  transform_system->SetLocalTranslation(entity, mathfu::vec3(4.f, 0.f, -4.f));
+  EXPECT_EQ(cache.Raycast(collision_system, RayAtAngle(0.f)).entity,
+            kNullEntity);
+
+  // A new entity in front of the ray is found, even though the ray hasn't
+  // moved.
+  const Entity other = CreateCollider(mathfu::vec3(0.f, 0.f, -2.f), 1.f);
+  const auto result = cache.Raycast(collision_system, RayAtAngle(0.f));
+  EXPECT_EQ(result.entity, other);
+  EXPECT_NEAR(result.distance, 1.5f, kEpsilon);
+
+  transform_system->Disable(other);
+  EXPECT_EQ(cache.Raycast(collision_system, RayAtAngle(0.f)).entity,
+            kNullEntity);
+
+  EXPECT_EQ(cache.GetStats().num_reused, 0U);
+  EXPECT_EQ(cache.GetStats().num_narrowed, 0U);
+}
+
+}  // namespace
+}  // namespace lull
@@ -118,5 +118,23 @@ TEST(ResourceManagerTest, RecreateAlive) {
   EXPECT_EQ(res, res2);
 }
 
+TEST(ResourceManagerTest, RecreateExpired) {
+  ResourceManager<TestResource> manager;
+  manager.Create(123, []() {
+    return std::shared_ptr<TestResource>(new TestResource(456));
+  });
+  manager.Release(123);
+
+  auto res = manager.Create(123, []() {
+    return std::shared_ptr<TestResource>(new TestResource(789));
+  });
+  EXPECT_EQ(789, res->value);
+  manager.Release(123);
+
+  // The recreated object should still be found while it is alive externally.
+  auto res2 = manager.Find(123);
+  EXPECT_EQ(res, res2);
+}
+
 }  // namespace
 }  // namespace lull
@@ -0,0 +1,289 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/systems/scroll/scroll_virtual_layout_system.h"
+
+#include <set>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "lullaby/generated/scroll_def_generated.h"
+#include "lullaby/generated/transform_def_generated.h"
+#include "lullaby/base/asset_loader.h"
+#include "lullaby/base/dispatcher.h"
+#include "lullaby/base/entity_factory.h"
+#include "lullaby/systems/animation/animation_system.h"
+#include "lullaby/systems/dispatcher/dispatcher_system.h"
+#include "lullaby/systems/scroll/scroll_system.h"
+#include "lullaby/systems/transform/transform_system.h"
+#include "lullaby/util/flatbuffer_writer.h"
+#include "lullaby/util/inward_buffer.h"
+
+namespace lull {
+namespace {
+
+// The view is 4 units tall.
+constexpr float kViewLength = 4.f;
+constexpr size_t kNumItems = 20;
+constexpr float kEpsilon = 1e-5f;
+
+// The test has no generated entity schema, so the cell blueprint is loaded
+// through these minimal stand-ins for the EntityDef and ComponentDef classes.
+// The only component type is TransformDef.
+const char* const kComponentDefNames[] = {"TransformDef", nullptr};
+
+struct CellComponentDef {
+  int def_type() const { return 0; }
+  const void* def() const { return table; }
+
+  const void* table;
+};
+
+struct CellComponentDefs {
+  const CellComponentDef* Get(int index) const { return &defs[index]; }
+  size_t size() const { return defs.size(); }
+
+  std::vector<CellComponentDef> defs;
+};
+
+struct CellEntityDef {
+  const CellComponentDefs* components() const { return &component_defs; }
+
+  CellComponentDefs component_defs;
+};
+
+class ScrollVirtualLayoutSystemTest : public testing::Test {
+ public:
+  void SetUp() override {
+    registry_.reset(new Registry());
+    dispatcher_ = new Dispatcher();
+    registry_->Register(std::unique_ptr<Dispatcher>(dispatcher_));
+
+    // Cells are created from the "cell" blueprint, which only contains a
+    // default TransformDef.  Its contents don't matter since the loader below
+    // always returns |cell_def_|.
+    registry_->Create<AssetLoader>([](const char* filename, std::string* out) {
+      if (std::string(filename) != "cell.bin") {
+        return false;
+      }
+      out->assign("\0\0\0\0ENTS", 8);
+      return true;
+    });
+    TransformDefT cell_transform;
+    const void* cell_transform_data =
+        WriteFlatbuffer(&cell_transform, &cell_buffer_);
+    cell_def_.component_defs.defs.push_back(
+        {flatbuffers::GetRoot<TransformDef>(cell_transform_data)});
+
+    entity_factory_ = registry_->Create<EntityFactory>(registry_.get());
+    entity_factory_->CreateSystem<AnimationSystem>();
+    entity_factory_->CreateSystem<DispatcherSystem>();
+    scroll_system_ = entity_factory_->CreateSystem<ScrollSystem>();
+    transform_system_ = entity_factory_->CreateSystem<TransformSystem>();
+    layout_system_ = entity_factory_->CreateSystem<ScrollVirtualLayoutSystem>();
+    entity_factory_->Initialize(kComponentDefNames);
+    entity_factory_->InitializeLoader<CellEntityDef, CellComponentDef>(
+        [this](const void* data) { return &cell_def_; });
+  }
+
+ protected:
+  Entity CreateLayout(float margin) {
+    TransformDefT transform;
+    transform.aabb.min = mathfu::vec3(-1.f, -0.5f * kViewLength, 0.f);
+    transform.aabb.max = mathfu::vec3(1.f, 0.5f * kViewLength, 0.f);
+    ScrollDefT scroll;
+    ScrollVirtualLayoutDefT layout;
+    layout.cell_blueprint = "cell";
+    layout.margin = margin;
+
+    Blueprint blueprint;
+    blueprint.Write(&transform);
+    blueprint.Write(&scroll);
+    blueprint.Write(&layout);
+    const Entity entity = entity_factory_->Create(&blueprint);
+
+    ScrollVirtualLayoutSystem::DataSource source;
+    source.count = kNumItems;
+    source.get_extent = [this](size_t index) { return extent_; };
+    source.bind = [this](Entity cell, size_t index) {
+      binds_.emplace_back(cell, index);
+    };
+    layout_system_->SetDataSource(entity, source);
+    return entity;
+  }
+
+  // Scrolls a vertical layout so that |position| is at the top of the view.
+  void ScrollTo(Entity entity, float position) {
+    scroll_system_->ForceViewOffset(entity, mathfu::vec2(0.f, -position));
+  }
+
+  // Expects the cell of every bound item to be centered on its item, given
+  // that the view has scrolled to |position|.
+  void ExpectCellsPlaced(Entity entity, float position) const {
+    const float top = 0.5f * kViewLength;
+    for (size_t i = 0; i < kNumItems; ++i) {
+      const Entity cell = layout_system_->GetCell(entity, i);
+      if (cell == kNullEntity) {
+        continue;
+      }
+      EXPECT_EQ(transform_system_->GetParent(cell), entity);
+      EXPECT_TRUE(transform_system_->IsEnabled(cell));
+      const Sqt* sqt = transform_system_->GetSqt(cell);
+      ASSERT_NE(sqt, nullptr);
+      const float center = (static_cast<float>(i) + 0.5f) * extent_;
+      EXPECT_NEAR(sqt->translation.x, 0.f, kEpsilon);
+      EXPECT_NEAR(sqt->translation.y, top - center + position, kEpsilon)
+          << "item " << i;
+    }
+  }
+
+  // Returns the indices of all items that currently have a cell.
+  std::set<size_t> GetBoundItems(Entity entity) const {
+    std::set<size_t> items;
+    for (size_t i = 0; i < kNumItems; ++i) {
+      if (layout_system_->GetCell(entity, i) != kNullEntity) {
+        items.insert(i);
+      }
+    }
+    return items;
+  }
+
+  std::unique_ptr<Registry> registry_;
+  Dispatcher* dispatcher_ = nullptr;
+  EntityFactory* entity_factory_ = nullptr;
+  ScrollSystem* scroll_system_ = nullptr;
+  TransformSystem* transform_system_ = nullptr;
+  ScrollVirtualLayoutSystem* layout_system_ = nullptr;
+  InwardBuffer cell_buffer_{256};
+  CellEntityDef cell_def_;
+  std::vector<std::pair<Entity, size_t>> binds_;
+  float extent_ = 1.f;
+};
+
+TEST_F(ScrollVirtualLayoutSystemTest, BindsVisibleItems) {
+  const Entity entity = CreateLayout(0.f);
+
+  // Item 4 starts exactly at the trailing edge of the view, so is not shown.
+  const std::set<size_t> expected = {0, 1, 2, 3};
+  EXPECT_EQ(GetBoundItems(entity), expected);
+  EXPECT_EQ(layout_system_->GetNumCells(entity), 4u);
+  ASSERT_EQ(binds_.size(), 4u);
+  for (const auto& bind : binds_) {
+    EXPECT_EQ(layout_system_->GetCell(entity, bind.second), bind.first);
+  }
+  ExpectCellsPlaced(entity, 0.f);
+}
+
+TEST_F(ScrollVirtualLayoutSystemTest, BindsItemsWithinMargin) {
+  const Entity entity = CreateLayout(0.5f);
+
+  // The margin extends the view to [-0.5, 4.5], which reaches into item 4.
+  const std::set<size_t> expected = {0, 1, 2, 3, 4};
+  EXPECT_EQ(GetBoundItems(entity), expected);
+  EXPECT_EQ(layout_system_->GetNumCells(entity), 5u);
+}
+
+TEST_F(ScrollVirtualLayoutSystemTest, BindsPartiallyVisibleItems) {
+  const Entity entity = CreateLayout(0.f);
+
+  // Items 2 and 6 are each only partially inside [2.5, 6.5].
+  ScrollTo(entity, 2.5f);
+  std::set<size_t> expected = {2, 3, 4, 5, 6};
+  EXPECT_EQ(GetBoundItems(entity), expected);
+  ExpectCellsPlaced(entity, 2.5f);
+
+  // Item 1 ends exactly at the leading edge of the view, so is not shown.
+  ScrollTo(entity, 2.f);
+  expected = {2, 3, 4, 5};
+  EXPECT_EQ(GetBoundItems(entity), expected);
+  ExpectCellsPlaced(entity, 2.f);
+
+  // The content bounds stop the view at the last full page of items.
+  ScrollTo(entity, 18.5f);
+  EXPECT_NEAR(scroll_system_->GetViewOffset(entity).y, -16.f, kEpsilon);
+  expected = {16, 17, 18, 19};
+  EXPECT_EQ(GetBoundItems(entity), expected);
+  ExpectCellsPlaced(entity, 16.f);
+}
+
+TEST_F(ScrollVirtualLayoutSystemTest, RecyclesCellsWhenScrolling) {
+  const Entity entity = CreateLayout(0.f);
+  std::set<Entity> cells;
+  for (const auto& bind : binds_) {
+    cells.insert(bind.first);
+  }
+  binds_.clear();
+
+  // Scrolling by whole items never needs more cells than the initial view.
+  for (size_t i = 1; i + 4 <= kNumItems; ++i) {
+    ScrollTo(entity, static_cast<float>(i));
+    EXPECT_EQ(layout_system_->GetNumCells(entity), 4u);
+    EXPECT_EQ(GetBoundItems(entity).size(), 4u);
+
+    // Only the item scrolled into view is bound, using the cell that was
+    // released by the item scrolled out of view.
+    ASSERT_EQ(binds_.size(), 1u);
+    EXPECT_EQ(binds_[0].second, i + 3);
+    EXPECT_EQ(cells.count(binds_[0].first), 1u);
+    binds_.clear();
+    ExpectCellsPlaced(entity, static_cast<float>(i));
+  }
+
+  // A partial scroll shows an extra item, which needs one new cell.
+  ScrollTo(entity, 15.5f);
+  EXPECT_EQ(GetBoundItems(entity).size(), 5u);
+  EXPECT_EQ(layout_system_->GetNumCells(entity), 5u);
+  ExpectCellsPlaced(entity, 15.5f);
+
+  // Jumping back to the start reuses the existing cells.
+  binds_.clear();
+  ScrollTo(entity, 0.f);
+  const std::set<size_t> expected = {0, 1, 2, 3};
+  EXPECT_EQ(GetBoundItems(entity), expected);
+  EXPECT_EQ(layout_system_->GetNumCells(entity), 5u);
+  EXPECT_EQ(binds_.size(), 4u);
+  ExpectCellsPlaced(entity, 0.f);
+}
+
+TEST_F(ScrollVirtualLayoutSystemTest, RebindsOnDataChanged) {
+  const Entity entity = CreateLayout(0.f);
+  binds_.clear();
+
+  // Doubling the item size halves the number of visible items.  Every visible
+  // item is bound afresh, reusing the existing cells.
+  extent_ = 2.f;
+  layout_system_->NotifyDataChanged(entity);
+
+  const std::set<size_t> expected = {0, 1};
+  EXPECT_EQ(GetBoundItems(entity), expected);
+  EXPECT_EQ(layout_system_->GetNumCells(entity), 4u);
+  ASSERT_EQ(binds_.size(), 2u);
+  std::set<size_t> rebound;
+  for (const auto& bind : binds_) {
+    rebound.insert(bind.second);
+    EXPECT_EQ(layout_system_->GetCell(entity, bind.second), bind.first);
+  }
+  EXPECT_EQ(rebound, expected);
+  ExpectCellsPlaced(entity, 0.f);
+
+  // Rebinding happens even if nothing visible changed.
+  binds_.clear();
+  layout_system_->NotifyDataChanged(entity);
+  EXPECT_EQ(binds_.size(), 2u);
+}
+
+}  // namespace
+}  // namespace lull
@@ -109,6 +109,29 @@ TEST(Serialize, SaveLoad) {
   EXPECT_EQ(obj1.derived.derived_value, obj2.derived.derived_value);
 }
 
+TEST(Serialize, SaveLoadVectors) {
+  std::vector<float> floats = {1.f, 2.f, 3.f};
+  std::vector<int> empty;
+
+  std::vector<uint8_t> buffer;
+  SaveToBuffer saver(&buffer);
+  saver(&floats, 0);
+  saver(&empty, 0);
+
+  // Vectors of fundamental types are stored as their size followed by the
+  // elements' raw bytes.
+  EXPECT_EQ(buffer.size(), 2 * sizeof(size_t) + sizeof(float) * floats.size());
+
+  std::vector<float> loaded_floats;
+  std::vector<int> loaded_empty = {1};
+  LoadFromBuffer loader(buffer.data(), buffer.size());
+  loader(&loaded_floats, 0);
+  loader(&loaded_empty, 0);
+  EXPECT_EQ(floats, loaded_floats);
+  EXPECT_TRUE(loaded_empty.empty());
+  EXPECT_EQ(loader.Remaining(), 0U);
+}
+
 TEST(SerializeDeathTest, LoadOutOfBounds) {
   std::vector<uint8_t> buffer;
 
@@ -0,0 +1,158 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/systems/text/flatui/text_buffer_cache.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace lull {
+namespace {
+
+// Stands in for a TextBuffer, which requires a flatui::FontManager.
+struct FakeBuffer {
+  explicit FakeBuffer(size_t size) : size(size) {}
+
+  size_t GetSizeInBytes() const { return size; }
+  bool IsReady() const { return ready; }
+
+  size_t size;
+  bool ready = true;
+};
+
+using FakeBufferPtr = std::shared_ptr<FakeBuffer>;
+using Cache = BasicTextBufferCache<FakeBuffer>;
+
+// Returns a key with the given |hash| and data that is unique to |hash|.
+TextBufferCacheKey Key(HashValue hash) {
+  TextBufferCacheKey key;
+  key.hash = hash;
+  key.data = std::to_string(hash);
+  return key;
+}
+
+TEST(TextBufferCache, FindAndInsert) {
+  Cache cache(100);
+  EXPECT_EQ(cache.Find(Key(1)), nullptr);
+
+  const FakeBufferPtr buffer = std::make_shared<FakeBuffer>(10);
+  cache.Insert(Key(1), buffer);
+  EXPECT_EQ(cache.Find(Key(1)), buffer);
+  EXPECT_EQ(cache.Find(Key(2)), nullptr);
+  EXPECT_EQ(cache.GetSizeInBytes(), 10U);
+
+  // Inserting the same key replaces the previous buffer.
+  const FakeBufferPtr replacement = std::make_shared<FakeBuffer>(20);
+  cache.Insert(Key(1), replacement);
+  EXPECT_EQ(cache.Find(Key(1)), replacement);
+  EXPECT_EQ(cache.Size(), 1U);
+  EXPECT_EQ(cache.GetSizeInBytes(), 20U);
+
+  cache.Clear();
+  EXPECT_EQ(cache.Find(Key(1)), nullptr);
+  EXPECT_EQ(cache.GetSizeInBytes(), 0U);
+}
+
+TEST(TextBufferCache, EvictsLeastRecentlyUsed) {
+  Cache cache(30);
+  cache.Insert(Key(1), std::make_shared<FakeBuffer>(10));
+  cache.Insert(Key(2), std::make_shared<FakeBuffer>(10));
+  cache.Insert(Key(3), std::make_shared<FakeBuffer>(10));
+  EXPECT_EQ(cache.GetSizeInBytes(), 30U);
+
+  // Finding a buffer marks it as recently used, so 2 is now the oldest.
+  EXPECT_NE(cache.Find(Key(1)), nullptr);
+  cache.Insert(Key(4), std::make_shared<FakeBuffer>(10));
+  EXPECT_EQ(cache.Find(Key(2)), nullptr);
+  EXPECT_NE(cache.Find(Key(1)), nullptr);
+  EXPECT_NE(cache.Find(Key(3)), nullptr);
+  EXPECT_NE(cache.Find(Key(4)), nullptr);
+  EXPECT_EQ(cache.GetSizeInBytes(), 30U);
+}
+
+TEST(TextBufferCache, StaysWithinByteLimit) {
+  Cache cache(25);
+  for (HashValue key = 1; key <= 10; ++key) {
+    cache.Insert(Key(key), std::make_shared<FakeBuffer>(10));
+    EXPECT_LE(cache.GetSizeInBytes(), 25U);
+  }
+  EXPECT_EQ(cache.Size(), 2U);
+  EXPECT_NE(cache.Find(Key(9)), nullptr);
+  EXPECT_NE(cache.Find(Key(10)), nullptr);
+
+  // A buffer larger than the limit evicts every unused buffer.
+  cache.Insert(Key(11), std::make_shared<FakeBuffer>(50));
+  EXPECT_EQ(cache.Size(), 1U);
+  EXPECT_NE(cache.Find(Key(11)), nullptr);
+}
+
+TEST(TextBufferCache, KeepsBuffersInUse) {
+  Cache cache(20);
+  const FakeBufferPtr in_use = std::make_shared<FakeBuffer>(10);
+  cache.Insert(Key(1), in_use);
+  cache.Insert(Key(2), std::make_shared<FakeBuffer>(10));
+  cache.Insert(Key(3), std::make_shared<FakeBuffer>(10));
+
+  // Buffer 1 is the oldest, but it is still referenced outside the cache, so
+  // the unused buffer 2 is evicted instead.
+  EXPECT_EQ(cache.Find(Key(1)), in_use);
+  EXPECT_EQ(cache.Find(Key(2)), nullptr);
+  EXPECT_NE(cache.Find(Key(3)), nullptr);
+
+  // If every buffer is in use, the cache may exceed its limit.
+  const FakeBufferPtr also_in_use = std::make_shared<FakeBuffer>(10);
+  const FakeBufferPtr third_in_use = std::make_shared<FakeBuffer>(10);
+  cache.Clear();
+  cache.Insert(Key(1), in_use);
+  cache.Insert(Key(2), also_in_use);
+  cache.Insert(Key(3), third_in_use);
+  EXPECT_EQ(cache.Size(), 3U);
+  EXPECT_EQ(cache.GetSizeInBytes(), 30U);
+}
+
+TEST(TextBufferCache, DropsBuffersThatArentReady) {
+  Cache cache(100);
+  const FakeBufferPtr buffer = std::make_shared<FakeBuffer>(10);
+  cache.Insert(Key(1), buffer);
+  buffer->ready = false;
+  EXPECT_EQ(cache.Find(Key(1)), nullptr);
+  EXPECT_EQ(cache.Size(), 0U);
+  EXPECT_EQ(cache.GetSizeInBytes(), 0U);
+}
+
+TEST(TextBufferCache, DoesntShareCollidingKeys) {
+  Cache cache(100);
+  const TextBufferCacheKey key = Key(1);
+  TextBufferCacheKey colliding = key;
+  colliding.data = "different layout";
+
+  const FakeBufferPtr buffer = std::make_shared<FakeBuffer>(10);
+  cache.Insert(key, buffer);
+  EXPECT_EQ(cache.Find(colliding), nullptr);
+  EXPECT_EQ(cache.Find(key), buffer);
+
+  // Inserting the colliding key replaces the buffer with the same hash.
+  const FakeBufferPtr other = std::make_shared<FakeBuffer>(20);
+  cache.Insert(colliding, other);
+  EXPECT_EQ(cache.Find(colliding), other);
+  EXPECT_EQ(cache.Find(key), nullptr);
+  EXPECT_EQ(cache.Size(), 1U);
+  EXPECT_EQ(cache.GetSizeInBytes(), 20U);
+}
+
+}  // namespace
+}  // namespace lull
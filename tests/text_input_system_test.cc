@@ -20,9 +20,12 @@ limitations under the License.
 #include "gtest/gtest.h"
 #include "lullaby/base/dispatcher.h"
 #include "lullaby/base/entity_factory.h"
+#include "lullaby/base/input_manager.h"
+#include "lullaby/events/text_events.h"
 #include "lullaby/systems/dispatcher/dispatcher_system.h"
 #include "lullaby/systems/render/render_system.h"
 #include "lullaby/systems/render/testing/mock_render_system_impl.h"
+#include "lullaby/systems/text/text_system.h"
 #include "lullaby/systems/text_input/text_input_system.h"
 #include "lullaby/systems/transform/transform_system.h"
 #include "lullaby/util/math.h"
@@ -32,6 +35,45 @@ limitations under the License.
 namespace lull {
 namespace {
 
+using ::testing::_;
+
+// A TextSystemImpl whose layouts complete only when the test says so.
+class FakeTextSystemImpl : public TextSystemImpl {
+ public:
+  explicit FakeTextSystemImpl(Registry* registry) : TextSystemImpl(registry) {}
+
+  void CreateEmpty(Entity entity) override {}
+  void CreateFromRenderDef(Entity entity,
+                           const RenderDef& render_def) override {}
+  FontPtr LoadFonts(const std::vector<std::string>& names) override {
+    return nullptr;
+  }
+  void SetFont(Entity entity, FontPtr font) override {}
+  const std::string* GetText(Entity entity) const override { return nullptr; }
+  void SetText(Entity entity, const std::string& text) override {}
+  void SetFontSize(Entity entity, float size) override {}
+  void SetBounds(Entity entity, const mathfu::vec2& bounds) override {}
+  void SetWrapMode(Entity entity, TextWrapMode wrap_mode) override {}
+  void SetEllipsis(Entity entity, const std::string& ellipsis) override {}
+  void SetHorizontalAlignment(Entity entity,
+                              HorizontalAlignment horizontal) override {}
+  void SetVerticalAlignment(Entity entity,
+                            VerticalAlignment vertical) override {}
+  void SetTextDirection(TextDirection direction) override {}
+  const std::vector<LinkTag>* GetLinkTags(Entity entity) const override {
+    return nullptr;
+  }
+  const std::vector<mathfu::vec3>* GetCaretPositions(
+      Entity entity) const override {
+    return nullptr;
+  }
+  bool IsTextReady(Entity entity) const override { return ready; }
+  void ProcessTasks() override {}
+  void WaitForAllTasks() override {}
+
+  bool ready = true;
+};
+
 class TextInputSystemTest : public ::testing::Test {
  protected:
   TextInputSystemTest() {
@@ -99,5 +141,49 @@ TEST_F(TextInputSystemTest, SetAndGet) {
   EXPECT_EQ(end, test_string.size());
 }
 
+TEST_F(TextInputSystemTest, CoalescesEditsWhileLayoutInFlight) {
+  registry_->Create<InputManager>();
+  auto* text_impl = new FakeTextSystemImpl(registry_.get());
+  entity_factory_->CreateSystem<TextSystem>(
+      std::unique_ptr<TextSystemImpl>(text_impl));
+
+  Blueprint blueprint;
+  TextInputDefT text_input_def;
+  text_input_def.activate_immediately = true;
+  blueprint.Write(&text_input_def);
+
+  mathfu::vec4 dont_care(1, 1, 1, 1);
+  EXPECT_CALL(*mock_render_system_, GetDefaultColor(_))
+      .WillRepeatedly(::testing::ReturnRef(dont_care));
+  EXPECT_CALL(*mock_render_system_, SetText(_, _))
+      .Times(::testing::AnyNumber());
+  const Entity text_entity = entity_factory_->Create(&blueprint);
+  ::testing::Mock::VerifyAndClearExpectations(mock_render_system_);
+  EXPECT_CALL(*mock_render_system_, GetDefaultColor(_))
+      .WillRepeatedly(::testing::ReturnRef(dont_care));
+
+  // The first edit is sent for layout right away, while the following edits
+  // wait for it to complete and are then laid out together.
+  {
+    ::testing::InSequence sequence;
+    EXPECT_CALL(*mock_render_system_, SetText(text_entity, "a"));
+    EXPECT_CALL(*mock_render_system_, SetText(text_entity, "abc"));
+  }
+  text_input_system_->SetText(text_entity, "a");
+  text_impl->ready = false;
+  text_input_system_->Insert("b");
+  text_input_system_->Insert("c");
+  text_input_system_->AdvanceFrame(Clock::duration(0));
+
+  // The text is current even though it hasn't been laid out yet.
+  EXPECT_EQ(text_input_system_->GetText(text_entity), "abc");
+  EXPECT_EQ(text_input_system_->GetCaretPosition(), 3UL);
+
+  text_impl->ready = true;
+  registry_->Get<DispatcherSystem>()->Send(text_entity,
+                                           TextReadyEvent(text_entity));
+  text_input_system_->AdvanceFrame(Clock::duration(0));
+}
+
 }  // namespace
 }  // namespace lull
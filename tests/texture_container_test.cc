@@ -0,0 +1,146 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/texture_container.h"
+
+#include "gtest/gtest.h"
+
+namespace lull {
+namespace {
+
+constexpr uint32_t kGlUnsignedByte = 0x1401;
+constexpr uint32_t kGlRgba = 0x1908;
+constexpr uint32_t kGlRgba8 = 0x8058;
+
+// The offsets of fields in the KTX header.
+constexpr size_t kEndiannessOffset = 12;
+constexpr size_t kPixelDepthOffset = 44;
+constexpr size_t kNumFacesOffset = 52;
+constexpr size_t kNumMipLevelsOffset = 56;
+constexpr size_t kHeaderSize = 64;
+
+void SetHeaderField(std::vector<uint8_t>* file, size_t offset,
+                    uint32_t value) {
+  memcpy(file->data() + offset, &value, sizeof(value));
+}
+
+std::vector<uint8_t> WriteTestContainer() {
+  // A 3x2 image with 2 levels.  The first level's size is not a multiple of 4.
+  const std::vector<uint8_t> level0(3 * 2 * 4 - 2, 1);
+  const std::vector<uint8_t> level1(4, 2);
+  TextureContainer container;
+  container.gl_type = kGlUnsignedByte;
+  container.gl_format = kGlRgba;
+  container.gl_internal_format = kGlRgba8;
+  container.gl_base_internal_format = kGlRgba;
+  container.size = mathfu::vec2i(3, 2);
+  container.levels.emplace_back(level0);
+  container.levels.emplace_back(level1);
+
+  std::vector<uint8_t> file;
+  WriteTextureContainer(container, &file);
+  return file;
+}
+
+TEST(TextureContainer, RoundTrip) {
+  const std::vector<uint8_t> file = WriteTestContainer();
+  EXPECT_EQ(file.size(), kHeaderSize + 4 + 24 + 4 + 4);
+
+  TextureContainer container;
+  ASSERT_TRUE(ParseTextureContainer(file, &container));
+  EXPECT_FALSE(container.IsCompressed());
+  EXPECT_EQ(container.gl_type, kGlUnsignedByte);
+  EXPECT_EQ(container.gl_format, kGlRgba);
+  EXPECT_EQ(container.gl_internal_format, kGlRgba8);
+  EXPECT_EQ(container.gl_base_internal_format, kGlRgba);
+  EXPECT_EQ(container.size.x, 3);
+  EXPECT_EQ(container.size.y, 2);
+  ASSERT_EQ(container.levels.size(), 2U);
+  ASSERT_EQ(container.levels[0].size(), 22U);
+  ASSERT_EQ(container.levels[1].size(), 4U);
+  EXPECT_EQ(container.levels[0][0], 1);
+  EXPECT_EQ(container.levels[0][21], 1);
+  EXPECT_EQ(container.levels[1][0], 2);
+
+  // The levels reference the file rather than copying it.
+  EXPECT_GE(container.levels[0].data(), file.data());
+  EXPECT_LT(container.levels[1].data(), file.data() + file.size());
+}
+
+TEST(TextureContainer, ZeroMipLevels) {
+  std::vector<uint8_t> file = WriteTestContainer();
+  SetHeaderField(&file, kNumMipLevelsOffset, 0);
+
+  TextureContainer container;
+  ASSERT_TRUE(ParseTextureContainer(file, &container));
+  EXPECT_EQ(container.levels.size(), 1U);
+}
+
+TEST(TextureContainer, RejectsInvalidFiles) {
+  const std::vector<uint8_t> valid = WriteTestContainer();
+  TextureContainer container;
+
+  EXPECT_FALSE(ParseTextureContainer(Span<uint8_t>(), &container));
+
+  std::vector<uint8_t> file = valid;
+  file[1] = 'X';
+  EXPECT_FALSE(ParseTextureContainer(file, &container));
+
+  file = valid;
+  SetHeaderField(&file, kEndiannessOffset, 0x01020304);
+  EXPECT_FALSE(ParseTextureContainer(file, &container));
+
+  file = valid;
+  SetHeaderField(&file, kPixelDepthOffset, 1);
+  EXPECT_FALSE(ParseTextureContainer(file, &container));
+
+  file = valid;
+  SetHeaderField(&file, kNumFacesOffset, 6);
+  EXPECT_FALSE(ParseTextureContainer(file, &container));
+
+  file = valid;
+  SetHeaderField(&file, kNumMipLevelsOffset, 3);
+  EXPECT_FALSE(ParseTextureContainer(file, &container));
+
+  for (size_t size = 0; size < valid.size() - 4; ++size) {
+    const Span<uint8_t> truncated(valid.data(), size);
+    EXPECT_FALSE(ParseTextureContainer(truncated, &container)) << size;
+  }
+}
+
+TEST(TextureContainer, RejectsTooManyMipLevels) {
+  // A 1x1 image only has a single level, even if the file contains more.
+  const std::vector<uint8_t> level(4, 1);
+  TextureContainer container;
+  container.gl_type = kGlUnsignedByte;
+  container.gl_format = kGlRgba;
+  container.gl_internal_format = kGlRgba8;
+  container.gl_base_internal_format = kGlRgba;
+  container.size = mathfu::vec2i(1, 1);
+  container.levels.emplace_back(level);
+  container.levels.emplace_back(level);
+
+  std::vector<uint8_t> file;
+  WriteTextureContainer(container, &file);
+  EXPECT_FALSE(ParseTextureContainer(file, &container));
+
+  SetHeaderField(&file, kNumMipLevelsOffset, 1);
+  EXPECT_TRUE(ParseTextureContainer(file, &container));
+  EXPECT_EQ(container.levels.size(), 1U);
+}
+
+}  // namespace
+}  // namespace lull
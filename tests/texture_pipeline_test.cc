@@ -0,0 +1,189 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/texture_pipeline.h"
+
+#include "gtest/gtest.h"
+#include "lullaby/util/etc2_encoder.h"
+#include "lullaby/util/image_util.h"
+#include "lullaby/util/texture_container.h"
+
+namespace lull {
+namespace {
+
+std::vector<uint8_t> CreateImage(const mathfu::vec2i& size, uint8_t alpha) {
+  std::vector<uint8_t> image(size.x * size.y * 4);
+  for (size_t i = 0; i < image.size(); i += 4) {
+    image[i + 0] = static_cast<uint8_t>(i);
+    image[i + 1] = 200;
+    image[i + 2] = 100;
+    image[i + 3] = alpha;
+  }
+  return image;
+}
+
+TEST(TexturePipeline, Rgba) {
+  const mathfu::vec2i size(10, 6);
+  const std::vector<uint8_t> image = CreateImage(size, 255);
+  TextureProcessingOptions options;
+  options.premultiply_alpha = false;
+
+  std::vector<uint8_t> file;
+  ASSERT_TRUE(ProcessTexture(image.data(), size, options, &file));
+  TextureContainer container;
+  ASSERT_TRUE(ParseTextureContainer(file, &container));
+  EXPECT_FALSE(container.IsCompressed());
+  EXPECT_EQ(container.size.x, size.x);
+  EXPECT_EQ(container.size.y, size.y);
+  ASSERT_EQ(container.levels.size(),
+            static_cast<size_t>(GetNumMipLevels(size)));
+
+  // The first level is the original image, followed by its mips.
+  ASSERT_EQ(container.levels[0].size(), image.size());
+  EXPECT_EQ(memcmp(container.levels[0].data(), image.data(), image.size()), 0);
+  std::vector<uint8_t> mips;
+  GenerateMipmapsRgba8888(image.data(), size, &mips);
+  size_t offset = 0;
+  for (size_t i = 1; i < container.levels.size(); ++i) {
+    const Span<uint8_t>& level = container.levels[i];
+    ASSERT_LE(offset + level.size(), mips.size());
+    EXPECT_EQ(memcmp(level.data(), mips.data() + offset, level.size()), 0);
+    offset += level.size();
+  }
+  EXPECT_EQ(offset, mips.size());
+}
+
+TEST(TexturePipeline, PremultiplyAlpha) {
+  const mathfu::vec2i size(4, 4);
+  const std::vector<uint8_t> image = CreateImage(size, 128);
+  TextureProcessingOptions options;
+  options.generate_mips = false;
+
+  std::vector<uint8_t> file;
+  ASSERT_TRUE(ProcessTexture(image.data(), size, options, &file));
+  TextureContainer container;
+  ASSERT_TRUE(ParseTextureContainer(file, &container));
+  ASSERT_EQ(container.levels.size(), 1U);
+
+  std::vector<uint8_t> expected(image.size());
+  PremultiplyAlphaRgba8888(image.data(), size, expected.data());
+  ASSERT_EQ(container.levels[0].size(), expected.size());
+  EXPECT_EQ(
+      memcmp(container.levels[0].data(), expected.data(), expected.size()), 0);
+}
+
+TEST(TexturePipeline, Etc2) {
+  const mathfu::vec2i size(13, 8);
+  const std::vector<uint8_t> image = CreateImage(size, 255);
+  const bool kHasAlpha[] = {false, true};
+  for (bool has_alpha : kHasAlpha) {
+    TextureProcessingOptions options;
+    options.encoding = has_alpha ? TextureEncoding::kEtc2Rgba8
+                                 : TextureEncoding::kEtc2Rgb8;
+
+    std::vector<uint8_t> file;
+    ASSERT_TRUE(ProcessTexture(image.data(), size, options, &file));
+    TextureContainer container;
+    ASSERT_TRUE(ParseTextureContainer(file, &container));
+    EXPECT_TRUE(container.IsCompressed());
+    EXPECT_EQ(container.gl_internal_format,
+              has_alpha ? kGlCompressedRgba8Etc2Eac : kGlCompressedRgb8Etc2);
+    ASSERT_EQ(container.levels.size(),
+              static_cast<size_t>(GetNumMipLevels(size)));
+
+    mathfu::vec2i level_size = size;
+    for (const Span<uint8_t>& level : container.levels) {
+      EXPECT_EQ(level.size(), GetEtc2ImageSize(level_size, has_alpha));
+      level_size = GetHalvedImageSize(level_size);
+    }
+
+    // The base level matches encoding the image directly.
+    std::vector<uint8_t> expected(GetEtc2ImageSize(size, has_alpha));
+    EncodeEtc2(image.data(), size, has_alpha, expected.data());
+    EXPECT_EQ(memcmp(container.levels[0].data(), expected.data(),
+                     expected.size()),
+              0);
+  }
+}
+
+TEST(TexturePipeline, InvalidSize) {
+  const std::vector<uint8_t> image = CreateImage(mathfu::vec2i(1, 1), 255);
+  std::vector<uint8_t> file;
+  EXPECT_FALSE(ProcessTexture(image.data(), mathfu::vec2i(0, 4),
+                              TextureProcessingOptions(), &file));
+}
+
+TEST(TexturePipeline, ProcessedContainersAreUploadable) {
+  const mathfu::vec2i size(10, 6);
+  const std::vector<uint8_t> image = CreateImage(size, 128);
+  for (const TextureEncoding encoding :
+       {TextureEncoding::kRgba8888, TextureEncoding::kEtc2Rgb8,
+        TextureEncoding::kEtc2Rgba8}) {
+    for (const bool generate_mips : {false, true}) {
+      TextureProcessingOptions options;
+      options.encoding = encoding;
+      options.generate_mips = generate_mips;
+
+      std::vector<uint8_t> file;
+      ASSERT_TRUE(ProcessTexture(image.data(), size, options, &file));
+      TextureContainer container;
+      ASSERT_TRUE(ParseTextureContainer(file, &container));
+      EXPECT_TRUE(IsTextureContainerUploadable(container));
+    }
+  }
+}
+
+TEST(TexturePipeline, OtherContainersFallBack) {
+  // The RenderSystem loads containers that can't be uploaded as is through
+  // fplbase instead.
+  const mathfu::vec2i size(4, 4);
+  const std::vector<uint8_t> image = CreateImage(size, 255);
+  std::vector<uint8_t> file;
+  ASSERT_TRUE(
+      ProcessTexture(image.data(), size, TextureProcessingOptions(), &file));
+  TextureContainer valid;
+  ASSERT_TRUE(ParseTextureContainer(file, &valid));
+  ASSERT_TRUE(IsTextureContainerUploadable(valid));
+
+  // An uncompressed format not written by ProcessTexture.
+  TextureContainer container = valid;
+  container.gl_type = 0x1405;  // GL_UNSIGNED_INT
+  EXPECT_FALSE(IsTextureContainerUploadable(container));
+
+  // A compressed format not written by ProcessTexture.
+  container = valid;
+  container.gl_type = 0;
+  container.gl_format = 0;
+  container.gl_internal_format = 0x93B0;  // GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+  EXPECT_FALSE(IsTextureContainerUploadable(container));
+
+  // Levels that don't match the size of the image.
+  container = valid;
+  container.size = mathfu::vec2i(8, 8);
+  EXPECT_FALSE(IsTextureContainerUploadable(container));
+
+  container = valid;
+  container.levels[1] = Span<uint8_t>(container.levels[1].data(),
+                                      container.levels[1].size() - 1);
+  EXPECT_FALSE(IsTextureContainerUploadable(container));
+
+  container = valid;
+  container.levels.clear();
+  EXPECT_FALSE(IsTextureContainerUploadable(container));
+}
+
+}  // namespace
+}  // namespace lull
@@ -756,6 +756,91 @@ TEST_F(TransformSystemTest, ForAllDescendants) {
   EXPECT_THAT(count, Eq(35));
 }
 
+TEST_F(TransformSystemTest, SubtreeIndex) {
+  for (Entity entity = 1; entity <= 6; ++entity) {
+    CreateDefaultTransform(entity);
+  }
+
+  auto* transform_system = registry_.Get<TransformSystem>();
+  transform_system->SetSubtreeIndexEnabled(true);
+  transform_system->AddChild(1, 2);
+  transform_system->AddChild(2, 3);
+  transform_system->AddChild(2, 4);
+  transform_system->AddChild(4, 5);
+
+  EXPECT_TRUE(transform_system->IsAncestorOf(1, 5));
+  EXPECT_TRUE(transform_system->IsAncestorOf(2, 3));
+  EXPECT_FALSE(transform_system->IsAncestorOf(3, 4));
+  EXPECT_FALSE(transform_system->IsAncestorOf(2, 2));
+  EXPECT_FALSE(transform_system->IsAncestorOf(5, 1));
+  EXPECT_FALSE(transform_system->IsAncestorOf(1, 6));
+
+  // Descendants are visited in pre-order, following the order of children.
+  std::vector<Entity> visited;
+  auto fn = [&](Entity entity) { visited.push_back(entity); };
+  transform_system->ForAllDescendants(1, fn);
+  EXPECT_THAT(visited, Eq(std::vector<Entity>{1, 2, 3, 4, 5}));
+
+  // Changes to the hierarchy are reflected in later queries.
+  transform_system->MoveChild(4, 0);
+  transform_system->AddChild(6, 4);
+  visited.clear();
+  transform_system->ForAllDescendants(1, fn);
+  EXPECT_THAT(visited, Eq(std::vector<Entity>{1, 2, 3}));
+  EXPECT_FALSE(transform_system->IsAncestorOf(1, 5));
+  EXPECT_TRUE(transform_system->IsAncestorOf(6, 5));
+
+  transform_system->RemoveParent(2);
+  EXPECT_FALSE(transform_system->IsAncestorOf(1, 3));
+
+  // Changing the hierarchy while iterating still visits the original
+  // descendants.
+  visited.clear();
+  transform_system->ForAllDescendants(6, [&](Entity entity) {
+    visited.push_back(entity);
+    if (entity == 4) {
+      transform_system->RemoveParent(5);
+      EXPECT_FALSE(transform_system->IsAncestorOf(6, 5));
+    }
+  });
+  EXPECT_THAT(visited, Eq(std::vector<Entity>{6, 4, 5}));
+
+  transform_system->SetSubtreeIndexEnabled(false);
+  EXPECT_TRUE(transform_system->IsAncestorOf(6, 4));
+  EXPECT_FALSE(transform_system->IsAncestorOf(6, 5));
+
+  // The same holds when walking the hierarchy without the index.
+  transform_system->AddChild(4, 5);
+  visited.clear();
+  transform_system->ForAllDescendants(6, [&](Entity entity) {
+    visited.push_back(entity);
+    if (entity == 4) {
+      transform_system->RemoveParent(5);
+    }
+  });
+  EXPECT_THAT(visited, Eq(std::vector<Entity>{6, 4, 5}));
+  EXPECT_FALSE(transform_system->IsAncestorOf(6, 5));
+
+  // Disabling (or re-enabling) the index while iterating it still visits the
+  // original descendants.
+  transform_system->SetSubtreeIndexEnabled(true);
+  transform_system->AddChild(6, 5);
+  visited.clear();
+  transform_system->ForAllDescendants(6, [&](Entity entity) {
+    visited.push_back(entity);
+    if (entity == 6) {
+      transform_system->SetSubtreeIndexEnabled(false);
+    } else if (entity == 4) {
+      transform_system->SetSubtreeIndexEnabled(true);
+      transform_system->RemoveParent(5);
+      EXPECT_FALSE(transform_system->IsAncestorOf(6, 5));
+    }
+  });
+  EXPECT_THAT(visited, Eq(std::vector<Entity>{6, 4, 5}));
+  EXPECT_TRUE(transform_system->IsAncestorOf(6, 4));
+  EXPECT_FALSE(transform_system->IsAncestorOf(6, 5));
+}
+
 TEST_F(TransformSystemTest, Parenting) {
   SetupEventHandlers();
 
@@ -836,6 +921,39 @@ TEST_F(TransformSystemTest, Parenting) {
   EXPECT_FALSE(transform_system->IsAncestorOf(parent, grand_child));
 }
 
+TEST_F(TransformSystemTest, SetSqtDeferred) {
+  TransformDefT transform;
+  transform.position = mathfu::vec3(1.f, 0.f, 0.f);
+  transform.rotation = mathfu::vec3(0.f, 0.f, 0.f);
+  transform.scale = mathfu::vec3(1.f, 1.f, 1.f);
+  Blueprint blueprint(&transform);
+
+  const Entity parent = 1;
+  const Entity child = 2;
+  auto* transform_system = registry_.Get<TransformSystem>();
+  transform_system->CreateComponent(parent, blueprint);
+  transform_system->CreateComponent(child, blueprint);
+  transform_system->AddChild(parent, child);
+
+  Sqt sqt;
+  sqt.translation = mathfu::vec3(2.f, 0.f, 0.f);
+  transform_system->SetSqtDeferred(child, sqt);
+  sqt.translation = mathfu::vec3(3.f, 0.f, 0.f);
+  transform_system->SetSqtDeferred(parent, sqt);
+
+  // The local transforms are updated immediately, but the world transforms
+  // aren't updated until UpdateDeferredTransforms.
+  EXPECT_NEAR(transform_system->GetSqt(child)->translation.x, 2.f, kEpsilon);
+  EXPECT_NEAR((*transform_system->GetWorldFromEntityMatrix(child))(0, 3), 2.f,
+              kEpsilon);
+
+  transform_system->UpdateDeferredTransforms();
+  EXPECT_NEAR((*transform_system->GetWorldFromEntityMatrix(parent))(0, 3), 3.f,
+              kEpsilon);
+  EXPECT_NEAR((*transform_system->GetWorldFromEntityMatrix(child))(0, 3), 5.f,
+              kEpsilon);
+}
+
 TEST_F(TransformSystemTest, ParentingWithNullParents) {
   SetupEventHandlers();
 
@@ -1167,5 +1285,91 @@ void TransformSystemTest::ExpectTransformsCount(int n) {
   EXPECT_EQ(count, n);
 }
 
+TEST_F(TransformSystemTest, SnapshotRoundTrip) {
+  // Creates a new world containing an EntityFactory and a TransformSystem.
+  auto create_world = []() {
+    std::unique_ptr<Registry> registry(new Registry());
+    registry->Create<Dispatcher>();
+    auto* entity_factory = registry->Create<EntityFactory>(registry.get());
+    entity_factory->CreateSystem<TransformSystem>();
+    entity_factory->Initialize();
+    return registry;
+  };
+
+  Sqt parent_sqt;
+  parent_sqt.translation = mathfu::vec3(1.f, 2.f, 3.f);
+  Sqt child_sqt;
+  child_sqt.translation = mathfu::vec3(0.f, 1.f, 0.f);
+  child_sqt.scale = mathfu::vec3(2.f, 2.f, 2.f);
+  const Aabb box(mathfu::vec3(-1.f, -1.f, -1.f), mathfu::vec3(1.f, 1.f, 1.f));
+
+  std::vector<uint8_t> snapshot;
+  Entity parent = kNullEntity;
+  Entity child = kNullEntity;
+  Entity grandchild = kNullEntity;
+  TransformSystem::TransformFlags flag = TransformSystem::kInvalidFlag;
+  {
+    auto registry = create_world();
+    auto* entity_factory = registry->Get<EntityFactory>();
+    auto* transform_system = registry->Get<TransformSystem>();
+    flag = transform_system->RequestFlag();
+    parent = entity_factory->Create();
+    child = entity_factory->Create();
+    grandchild = entity_factory->Create();
+    transform_system->Create(parent, parent_sqt);
+    transform_system->Create(child, child_sqt);
+    transform_system->Create(grandchild, Sqt());
+    transform_system->AddChild(parent, child);
+    transform_system->AddChild(child, grandchild);
+    transform_system->SetAabb(child, box);
+    transform_system->SetFlag(child, flag);
+    transform_system->Disable(grandchild);
+    entity_factory->SaveSnapshot(&snapshot);
+  }
+
+  auto registry = create_world();
+  auto* transform_system = registry->Get<TransformSystem>();
+  EXPECT_THAT(transform_system->RequestFlag(), Eq(flag));
+  ASSERT_TRUE(registry->Get<EntityFactory>()->LoadSnapshot(snapshot));
+
+  EXPECT_THAT(transform_system->GetParent(parent), Eq(kNullEntity));
+  EXPECT_THAT(transform_system->GetParent(child), Eq(parent));
+  EXPECT_THAT(transform_system->GetParent(grandchild), Eq(child));
+  ASSERT_THAT(transform_system->GetChildren(parent), NotNull());
+  EXPECT_THAT(*transform_system->GetChildren(parent),
+              Eq(std::vector<Entity>{child}));
+
+  const Sqt* sqt = transform_system->GetSqt(child);
+  ASSERT_THAT(sqt, NotNull());
+  EXPECT_THAT(sqt->translation, EqualsMathfuVec3(child_sqt.translation));
+  EXPECT_THAT(sqt->scale, EqualsMathfuVec3(child_sqt.scale));
+  ASSERT_THAT(transform_system->GetAabb(child), NotNull());
+  EXPECT_THAT(transform_system->GetAabb(child)->min,
+              EqualsMathfuVec3(box.min));
+  EXPECT_THAT(transform_system->GetAabb(child)->max,
+              EqualsMathfuVec3(box.max));
+  EXPECT_TRUE(transform_system->HasFlag(child, flag));
+  EXPECT_FALSE(transform_system->HasFlag(parent, flag));
+  EXPECT_TRUE(transform_system->IsEnabled(child));
+  EXPECT_FALSE(transform_system->IsEnabled(grandchild));
+  EXPECT_FALSE(transform_system->IsLocallyEnabled(grandchild));
+
+  const mathfu::mat4* world_from_child =
+      transform_system->GetWorldFromEntityMatrix(child);
+  ASSERT_THAT(world_from_child, NotNull());
+  EXPECT_NEAR((*world_from_child)(1, 3), 3.f, kEpsilon);
+
+  std::vector<Entity> descendants;
+  transform_system->ForAllDescendants(
+      parent, [&](Entity e) { descendants.push_back(e); });
+  EXPECT_THAT(descendants, Eq(std::vector<Entity>{parent, child, grandchild}));
+
+  // The restored hierarchy keeps propagating changes.
+  parent_sqt.translation = mathfu::vec3(0.f, 0.f, 0.f);
+  transform_system->SetSqt(parent, parent_sqt);
+  EXPECT_NEAR((*transform_system->GetWorldFromEntityMatrix(grandchild))(1, 3),
+              1.f, kEpsilon);
+}
+
 }  // namespace
 }  // namespace lull
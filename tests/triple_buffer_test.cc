@@ -0,0 +1,87 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/util/triple_buffer.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace lull {
+namespace {
+
+TEST(TripleBuffer, InitialValue) {
+  TripleBuffer<int> buffer(5);
+  EXPECT_FALSE(buffer.HasPublishedValue());
+  EXPECT_FALSE(buffer.Acquire());
+  EXPECT_EQ(buffer.GetReadBuffer(), 5);
+}
+
+TEST(TripleBuffer, AcquireLatest) {
+  TripleBuffer<int> buffer(0);
+  buffer.GetWriteBuffer() = 1;
+  buffer.Publish();
+  buffer.GetWriteBuffer() = 2;
+  buffer.Publish();
+  EXPECT_TRUE(buffer.HasPublishedValue());
+
+  // Only the most recently published value is seen.
+  EXPECT_TRUE(buffer.Acquire());
+  EXPECT_EQ(buffer.GetReadBuffer(), 2);
+  EXPECT_FALSE(buffer.HasPublishedValue());
+
+  // The read value is kept until another value is published.
+  EXPECT_FALSE(buffer.Acquire());
+  EXPECT_EQ(buffer.GetReadBuffer(), 2);
+
+  buffer.GetWriteBuffer() = 3;
+  buffer.Publish();
+  EXPECT_TRUE(buffer.Acquire());
+  EXPECT_EQ(buffer.GetReadBuffer(), 3);
+}
+
+TEST(TripleBuffer, Threaded) {
+  struct Value {
+    int a = 0;
+    int b = 0;
+  };
+  const int kNumValues = 10000;
+  TripleBuffer<Value> buffer;
+
+  std::thread writer([&buffer]() {
+    for (int i = 1; i <= kNumValues; ++i) {
+      Value& value = buffer.GetWriteBuffer();
+      value.a = i;
+      value.b = -i;
+      buffer.Publish();
+    }
+  });
+
+  // Values must never be torn and must never go backwards.
+  int last = 0;
+  while (last < kNumValues) {
+    if (buffer.Acquire()) {
+      const Value& value = buffer.GetReadBuffer();
+      EXPECT_EQ(value.a, -value.b);
+      EXPECT_GT(value.a, last);
+      last = value.a;
+    }
+  }
+  writer.join();
+}
+
+}  // namespace
+}  // namespace lull
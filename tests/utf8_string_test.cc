@@ -75,5 +75,19 @@ TEST(UTF8StringTest, Simple) {
   EXPECT_EQ(tos, cats);
 }
 
+TEST(UTF8StringTest, InsertMultipleChars) {
+  UTF8String text("ad");
+  EXPECT_EQ(2U, text.Insert(1, "\xC3\x8E\x72"));
+  EXPECT_EQ(4U, text.CharSize());
+  EXPECT_EQ("a", text.CharAt(0));
+  EXPECT_EQ("\xC3\x8E", text.CharAt(1));
+  EXPECT_EQ("\x72", text.CharAt(2));
+  EXPECT_EQ("d", text.CharAt(3));
+
+  text.DeleteChars(1, 1);
+  EXPECT_EQ(UTF8String("ard"), text);
+  EXPECT_EQ("d", text.CharAt(2));
+}
+
 }  // namespace
 }  // namespace lull
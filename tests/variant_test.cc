@@ -423,10 +423,48 @@ TEST(Variant, CopyCountOrderedMapOfVariants) {
   EXPECT_EQ(3, CopyCounter::copies);
   EXPECT_EQ(0, CopyCounter::moves);
 
-  // Move constructing a map should move the elements.
+  // Move constructing a map should move the elements.  The CopyCounters are
+  // stored out-of-line, so moving their Variants doesn't move them.
   Variant v2 = std::move(map);
   EXPECT_EQ(3, CopyCounter::copies);
-  EXPECT_EQ(3, CopyCounter::moves);
+  EXPECT_EQ(0, CopyCounter::moves);
+}
+
+struct alignas(32) OverAlignedTestClass {
+  int value = 0;
+};
+
+TEST(Variant, Storage) {
+  EXPECT_LE(sizeof(Variant), 24U);
+
+  // Small values are stored inline.
+  Variant small = mathfu::vec2(1.f, 2.f);
+  const void* small_data = small.Get<mathfu::vec2>();
+  EXPECT_GE(small_data, static_cast<const void*>(&small));
+  EXPECT_LT(small_data, static_cast<const void*>(&small + 1));
+
+  // Large values are stored out-of-line, and moving the Variant transfers
+  // ownership of that storage.
+  Variant large = std::string(100, 'a');
+  const std::string* large_data = large.Get<std::string>();
+  Variant moved = std::move(large);
+  EXPECT_TRUE(large.Empty());
+  EXPECT_EQ(large_data, moved.Get<std::string>());
+  EXPECT_EQ(std::string(100, 'a'), *moved.Get<std::string>());
+
+  Variant copied = moved;
+  EXPECT_NE(large_data, copied.Get<std::string>());
+  EXPECT_EQ(*large_data, *copied.Get<std::string>());
+
+  // Over-aligned values keep their alignment.
+  OverAlignedTestClass aligned;
+  aligned.value = 123;
+  Variant over_aligned = aligned;
+  const OverAlignedTestClass* aligned_data =
+      over_aligned.Get<OverAlignedTestClass>();
+  ASSERT_NE(nullptr, aligned_data);
+  EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(aligned_data) % 32);
+  EXPECT_EQ(123, aligned_data->value);
 }
 
 }  // namespace
@@ -435,3 +473,4 @@ TEST(Variant, CopyCountOrderedMapOfVariants) {
 LULLABY_SETUP_TYPEID(VariantTestClass);
 LULLABY_SETUP_TYPEID(MoveOnlyVariantTestClass);
 LULLABY_SETUP_TYPEID(CopyCounter);
+LULLABY_SETUP_TYPEID(OverAlignedTestClass);
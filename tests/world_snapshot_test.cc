@@ -0,0 +1,179 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lullaby/base/world_snapshot.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "lullaby/base/entity_factory.h"
+#include "lullaby/base/registry.h"
+#include "lullaby/generated/tests/portable_test_macros.h"
+
+namespace {
+
+struct SnapshotComponent : lull::Component {
+  explicit SnapshotComponent(lull::Entity e) : Component(e) {}
+
+  float value = 0.f;
+  int count = 0;
+};
+
+// A System that stores its components in a ComponentPool and saves them in
+// world snapshots.
+class SnapshotSystem : public lull::System {
+ public:
+  explicit SnapshotSystem(lull::Registry* registry)
+      : System(registry), components_(4) {}
+
+  void SetValue(lull::Entity entity, float value, int count) {
+    SnapshotComponent* component = components_.Get(entity);
+    if (component == nullptr) {
+      component = components_.Emplace(entity);
+    }
+    component->value = value;
+    component->count = count;
+  }
+
+  const SnapshotComponent* Get(lull::Entity entity) const {
+    return components_.Get(entity);
+  }
+
+  void Destroy(lull::Entity entity) override { components_.Destroy(entity); }
+
+  uint32_t GetSnapshotVersion() const override { return version_; }
+
+  void SaveSnapshot(lull::SaveToBuffer* serializer) override {
+    lull::SaveComponentPool(serializer, components_);
+  }
+
+  bool LoadSnapshot(lull::LoadFromBuffer* serializer) override {
+    return lull::LoadComponentPool(serializer, &components_);
+  }
+
+  void SetSnapshotVersion(uint32_t version) { version_ = version; }
+
+ private:
+  lull::ComponentPool<SnapshotComponent> components_;
+  uint32_t version_ = 1;
+};
+
+}  // namespace
+
+LULLABY_SETUP_TYPEID(SnapshotSystem);
+
+namespace lull {
+namespace {
+
+class WorldSnapshotTest : public testing::Test {
+ protected:
+  // Creates a new world containing an EntityFactory and a SnapshotSystem.
+  std::unique_ptr<Registry> CreateWorld() {
+    std::unique_ptr<Registry> registry(new Registry());
+    auto* entity_factory = registry->Create<EntityFactory>(registry.get());
+    entity_factory->CreateSystem<SnapshotSystem>();
+    entity_factory->Initialize();
+    return registry;
+  }
+};
+
+TEST_F(WorldSnapshotTest, ComponentPool) {
+  ComponentPool<SnapshotComponent> pool(2);
+  for (Entity entity = 1; entity <= 5; ++entity) {
+    SnapshotComponent* component = pool.Emplace(entity);
+    component->value = static_cast<float>(entity) * 0.5f;
+    component->count = static_cast<int>(entity) * 2;
+  }
+
+  std::vector<uint8_t> buffer;
+  SaveToBuffer saver(&buffer);
+  SaveComponentPool(&saver, pool);
+
+  ComponentPool<SnapshotComponent> loaded(2);
+  LoadFromBuffer loader(&buffer);
+  EXPECT_TRUE(LoadComponentPool(&loader, &loaded));
+  EXPECT_EQ(loader.Remaining(), 0U);
+
+  EXPECT_EQ(loaded.Size(), pool.Size());
+  for (Entity entity = 1; entity <= 5; ++entity) {
+    const SnapshotComponent* component = loaded.Get(entity);
+    ASSERT_NE(component, nullptr);
+    EXPECT_EQ(component->GetEntity(), entity);
+    EXPECT_EQ(component->value, static_cast<float>(entity) * 0.5f);
+    EXPECT_EQ(component->count, static_cast<int>(entity) * 2);
+  }
+}
+
+TEST_F(WorldSnapshotTest, SaveLoad) {
+  std::vector<uint8_t> snapshot;
+  Entity last = kNullEntity;
+  {
+    auto registry = CreateWorld();
+    auto* entity_factory = registry->Get<EntityFactory>();
+    auto* system = registry->Get<SnapshotSystem>();
+    for (int i = 0; i < 3; ++i) {
+      last = entity_factory->Create();
+      system->SetValue(last, static_cast<float>(i), i);
+    }
+    entity_factory->SaveSnapshot(&snapshot);
+  }
+
+  auto registry = CreateWorld();
+  auto* entity_factory = registry->Get<EntityFactory>();
+  EXPECT_TRUE(entity_factory->LoadSnapshot(snapshot));
+
+  auto* system = registry->Get<SnapshotSystem>();
+  for (int i = 0; i < 3; ++i) {
+    const Entity entity = last - 2 + static_cast<Entity>(i);
+    const SnapshotComponent* component = system->Get(entity);
+    ASSERT_NE(component, nullptr);
+    EXPECT_EQ(component->value, static_cast<float>(i));
+    EXPECT_EQ(component->count, i);
+  }
+
+  // New Entities must not reuse the IDs of the Entities in the snapshot.
+  EXPECT_GT(entity_factory->Create(), last);
+}
+
+TEST_F(WorldSnapshotTest, SkipsChangedVersion) {
+  std::vector<uint8_t> snapshot;
+  Entity entity = kNullEntity;
+  {
+    auto registry = CreateWorld();
+    auto* entity_factory = registry->Get<EntityFactory>();
+    entity = entity_factory->Create();
+    registry->Get<SnapshotSystem>()->SetValue(entity, 1.f, 1);
+    entity_factory->SaveSnapshot(&snapshot);
+  }
+
+  auto registry = CreateWorld();
+  auto* system = registry->Get<SnapshotSystem>();
+  system->SetSnapshotVersion(2);
+  EXPECT_TRUE(registry->Get<EntityFactory>()->LoadSnapshot(snapshot));
+  EXPECT_EQ(system->Get(entity), nullptr);
+}
+
+TEST_F(WorldSnapshotTest, InvalidData) {
+  auto registry = CreateWorld();
+  auto* entity_factory = registry->Get<EntityFactory>();
+
+  std::vector<uint8_t> data = {1, 2, 3, 4, 5, 6, 7, 8};
+  EXPECT_FALSE(entity_factory->LoadSnapshot(data));
+  EXPECT_FALSE(entity_factory->LoadSnapshot(Span<uint8_t>()));
+}
+
+}  // namespace
+}  // namespace lull
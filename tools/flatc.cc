@@ -43,6 +43,10 @@ limitations under the License.
 //   std::unique_ptr.  This is useful for supporting cyclical data dependencies
 //   (eg. Table X has a field of table X) and is the same as the default
 //   flatbuffer gen-object-api support.
+// * Every table also gets a lightweight "View" class (eg. TransformDefView)
+//   which wraps a pointer to the table in the flatbuffer and exposes the same
+//   field names.  Strings are returned as lull::string_view and vectors of
+//   scalars and structs as lull::Span, so nothing is copied out of the buffer.
 class CodeGenerator : public flatbuffers::BaseGenerator {
  public:
   CodeGenerator(const flatbuffers::Parser& parser, const std::string& path,
@@ -59,6 +63,8 @@ class CodeGenerator : public flatbuffers::BaseGenerator {
   void SetNameSpace(const flatbuffers::Namespace* ns);
   std::string NativeName(const std::string& name) const;
   std::string NativeFullName(const flatbuffers::Definition& def) const;
+  std::string ViewName(const std::string& name) const;
+  std::string ViewFullName(const flatbuffers::Definition& def) const;
   std::string GetType(const flatbuffers::Type& type,
                       const flatbuffers::FieldDef* field) const;
   std::string GetDefaultValue(const flatbuffers::FieldDef& field) const;
@@ -73,6 +79,10 @@ class CodeGenerator : public flatbuffers::BaseGenerator {
   void GenerateStructFunctions(const flatbuffers::StructDef& def);
   void GenerateRegisterTypeId(const flatbuffers::Definition& def);
   void GenerateMemberSerialize(const flatbuffers::FieldDef& field);
+  void GenerateViewFwdDecl(const flatbuffers::StructDef& def);
+  void GenerateViewDecl(const flatbuffers::StructDef& def);
+  void GenerateViewMember(const flatbuffers::FieldDef& field);
+  void GenerateViewFunctions(const flatbuffers::StructDef& def);
 
   flatbuffers::CodeWriter code_;
   flatbuffers::Namespace root_namespace_;
@@ -160,6 +170,17 @@ std::string CodeGenerator::NativeFullName(
   return NativeName(WrapInNameSpace(def));
 }
 
+// Generates the class name for the read-only "view" of a given flatbuffer
+// table by appending "View" to the given name.
+std::string CodeGenerator::ViewName(const std::string& name) const {
+  return name + "View";
+}
+
+std::string CodeGenerator::ViewFullName(
+    const flatbuffers::Definition& def) const {
+  return ViewName(WrapInNameSpace(def));
+}
+
 std::string GetBasicType(const flatbuffers::BaseType& base_type) {
   switch (base_type) {
     case flatbuffers::BASE_TYPE_NONE:
@@ -665,6 +686,191 @@ void CodeGenerator::GenerateMemberSerialize(
   }
 }
 
+// Checks whether or not a View class is generated for the given type.  Views
+// are only generated for tables; structs are already plain data that can be
+// read directly from the flatbuffer.
+bool HasView(const flatbuffers::StructDef& def) {
+  return !def.fixed && GetAttribute(def, "native_type") == nullptr;
+}
+
+// Generates the forward declaration for the View of the given table.
+void CodeGenerator::GenerateViewFwdDecl(const flatbuffers::StructDef& def) {
+  code_.SetValue("VIEW_NAME", ViewName(def.name));
+  code_ += "class {{VIEW_NAME}};";
+}
+
+// Generates the entire View class declaration for a given flatbuffer table.
+void CodeGenerator::GenerateViewDecl(const flatbuffers::StructDef& def) {
+  code_.SetValue("FB_TYPE", def.name);
+  code_.SetValue("VIEW_NAME", ViewName(def.name));
+
+  code_ += "class {{VIEW_NAME}} {";
+  code_ += " public:";
+  code_ += "  using FlatBufferType = {{FB_TYPE}};";
+  code_ += "";
+  code_ += "  {{VIEW_NAME}}() : table_(nullptr) {}";
+  code_ += "  explicit {{VIEW_NAME}}(const {{FB_TYPE}}* table) "
+           ": table_(table) {}";
+  code_ += "";
+  code_ += "  static {{VIEW_NAME}} FromBuffer(const void* buffer) {";
+  code_ += "    return {{VIEW_NAME}}(";
+  code_ += "        buffer ? flatbuffers::GetRoot<{{FB_TYPE}}>(buffer) "
+           ": nullptr);";
+  code_ += "  }";
+  code_ += "";
+  code_ += "  bool IsNull() const { return table_ == nullptr; }";
+  code_ += "  const {{FB_TYPE}}* GetFlatBuffer() const { return table_; }";
+  code_ += "";
+  for (const auto& field : def.fields.vec) {
+    GenerateViewMember(*field);
+  }
+  code_ += "";
+  code_ += " private:";
+  code_ += "  const {{FB_TYPE}}* table_;";
+  code_ += "};";
+  code_ += "";
+}
+
+// Generates the accessor for a field of a View class.  Accessors that return
+// other View types are only declared here and are defined by
+// GenerateViewFunctions once all View classes are complete.
+void CodeGenerator::GenerateViewMember(const flatbuffers::FieldDef& field) {
+  if (field.deprecated) {
+    return;
+  }
+
+  const flatbuffers::Type& type = field.value.type;
+  code_.SetValue("FIELD_NAME", field.name);
+
+  switch (type.base_type) {
+    case flatbuffers::BASE_TYPE_NONE:
+      break;
+    case flatbuffers::BASE_TYPE_UTYPE:
+    case flatbuffers::BASE_TYPE_BOOL:
+    case flatbuffers::BASE_TYPE_CHAR:
+    case flatbuffers::BASE_TYPE_UCHAR:
+    case flatbuffers::BASE_TYPE_SHORT:
+    case flatbuffers::BASE_TYPE_USHORT:
+    case flatbuffers::BASE_TYPE_INT:
+    case flatbuffers::BASE_TYPE_UINT:
+    case flatbuffers::BASE_TYPE_LONG:
+    case flatbuffers::BASE_TYPE_ULONG:
+    case flatbuffers::BASE_TYPE_FLOAT:
+    case flatbuffers::BASE_TYPE_DOUBLE: {
+      code_.SetValue("FIELD_TYPE", GetType(type, &field));
+      code_.SetValue("FIELD_DEFAULT", GetDefaultValue(field));
+      code_ += "  {{FIELD_TYPE}} {{FIELD_NAME}}() const {";
+      code_ += "    return table_ ? table_->{{FIELD_NAME}}()";
+      code_ += "                  : static_cast<{{FIELD_TYPE}}>("
+               "{{FIELD_DEFAULT}});";
+      code_ += "  }";
+      break;
+    }
+    case flatbuffers::BASE_TYPE_STRING: {
+      code_ += "  lull::string_view {{FIELD_NAME}}() const {";
+      code_ += "    return lull::FlatbufferStringView(";
+      code_ += "        table_ ? table_->{{FIELD_NAME}}() : nullptr);";
+      code_ += "  }";
+      break;
+    }
+    case flatbuffers::BASE_TYPE_VECTOR: {
+      const flatbuffers::Type element = type.VectorType();
+      if (element.base_type == flatbuffers::BASE_TYPE_STRING) {
+        code_.SetValue("FIELD_TYPE", "lull::FlatbufferStringVectorView");
+        code_.SetValue("FIELD_WRAPPER", "lull::FlatbufferStringVectorView");
+      } else if (element.base_type == flatbuffers::BASE_TYPE_UNION) {
+        break;
+      } else if (element.base_type == flatbuffers::BASE_TYPE_STRUCT &&
+                 HasView(*element.struct_def)) {
+        code_.SetValue("VIEW_TYPE", ViewFullName(*element.struct_def));
+        code_ += "  lull::FlatbufferTableVectorView<{{VIEW_TYPE}}> "
+                 "{{FIELD_NAME}}() const;";
+        break;
+      } else if (element.base_type == flatbuffers::BASE_TYPE_STRUCT &&
+                 !element.struct_def->fixed) {
+        code_.SetValue("FB_ELEMENT", WrapInNameSpace(*element.struct_def));
+        code_ += "  const flatbuffers::Vector<flatbuffers::Offset<"
+                 "{{FB_ELEMENT}}>>* {{FIELD_NAME}}() const {";
+        code_ += "    return table_ ? table_->{{FIELD_NAME}}() : nullptr;";
+        code_ += "  }";
+        break;
+      } else if (element.base_type == flatbuffers::BASE_TYPE_STRUCT) {
+        code_.SetValue("FIELD_TYPE", "lull::Span<" +
+                                         WrapInNameSpace(*element.struct_def) +
+                                         ">");
+        code_.SetValue("FIELD_WRAPPER", "lull::FlatbufferSpan");
+      } else {
+        // Vectors of enums store the underlying type, and vectors of bools
+        // are stored as bytes.
+        const bool is_bool = element.base_type == flatbuffers::BASE_TYPE_BOOL;
+        code_.SetValue(
+            "FIELD_TYPE",
+            "lull::Span<" +
+                (is_bool ? "uint8_t" : GetBasicType(element.base_type)) + ">");
+        code_.SetValue("FIELD_WRAPPER", "lull::FlatbufferSpan");
+      }
+      code_ += "  {{FIELD_TYPE}} {{FIELD_NAME}}() const {";
+      code_ += "    return {{FIELD_WRAPPER}}(";
+      code_ += "        table_ ? table_->{{FIELD_NAME}}() : nullptr);";
+      code_ += "  }";
+      break;
+    }
+    case flatbuffers::BASE_TYPE_STRUCT: {
+      const flatbuffers::StructDef& def = *type.struct_def;
+      if (HasView(def)) {
+        code_.SetValue("VIEW_TYPE", ViewFullName(def));
+        code_ += "  {{VIEW_TYPE}} {{FIELD_NAME}}() const;";
+      } else {
+        code_.SetValue("FB_ELEMENT", WrapInNameSpace(def));
+        code_ += "  const {{FB_ELEMENT}}* {{FIELD_NAME}}() const {";
+        code_ += "    return table_ ? table_->{{FIELD_NAME}}() : nullptr;";
+        code_ += "  }";
+      }
+      break;
+    }
+    case flatbuffers::BASE_TYPE_UNION: {
+      // The type of the union is available from the accessor generated for
+      // its UTYPE field (eg. foo_type() for the union foo).
+      code_ += "  const void* {{FIELD_NAME}}() const {";
+      code_ += "    return table_ ? table_->{{FIELD_NAME}}() : nullptr;";
+      code_ += "  }";
+      break;
+    }
+  }
+}
+
+// Generates the definitions of the View accessors that return other Views.
+void CodeGenerator::GenerateViewFunctions(const flatbuffers::StructDef& def) {
+  code_.SetValue("VIEW_NAME", ViewName(def.name));
+
+  for (const auto& field : def.fields.vec) {
+    if (field->deprecated) {
+      continue;
+    }
+
+    const flatbuffers::Type& type = field->value.type;
+    if (type.base_type == flatbuffers::BASE_TYPE_STRUCT &&
+        HasView(*type.struct_def)) {
+      code_.SetValue("VIEW_TYPE", ViewFullName(*type.struct_def));
+    } else if (type.base_type == flatbuffers::BASE_TYPE_VECTOR &&
+               type.VectorType().base_type == flatbuffers::BASE_TYPE_STRUCT &&
+               HasView(*type.VectorType().struct_def)) {
+      code_.SetValue("VIEW_TYPE",
+                     "lull::FlatbufferTableVectorView<" +
+                         ViewFullName(*type.VectorType().struct_def) + ">");
+    } else {
+      continue;
+    }
+
+    code_.SetValue("FIELD_NAME", field->name);
+    code_ += "inline {{VIEW_TYPE}} {{VIEW_NAME}}::{{FIELD_NAME}}() const {";
+    code_ += "  return {{VIEW_TYPE}}(";
+    code_ += "      table_ ? table_->{{FIELD_NAME}}() : nullptr);";
+    code_ += "}";
+    code_ += "";
+  }
+}
+
 // Generates the LULLABY_SETUP_TYPEID call for the given type.
 void CodeGenerator::GenerateRegisterTypeId(const flatbuffers::Definition& def) {
   code_.SetValue("TYPE_NAME", NativeFullName(def));
@@ -738,6 +944,7 @@ bool CodeGenerator::generate() {
   code_ += "#include \"{{INCLUDE_FILE}}\"";
   code_ += "#include \"lullaby/base/common_types.h\"";
   code_ += "#include \"lullaby/util/color.h\"";
+  code_ += "#include \"lullaby/util/flatbuffer_view.h\"";
   code_ += "#include \"lullaby/util/math.h\"";
   code_ += "#include \"lullaby/util/optional.h\"";
   code_ += "#include \"lullaby/util/typeid.h\"";
@@ -751,6 +958,9 @@ bool CodeGenerator::generate() {
       const flatbuffers::StructDef& def = *type_def->struct_def;
       SetNameSpace(def.defined_namespace);
       GenerateFwdDecl(def);
+      if (HasView(def)) {
+        GenerateViewFwdDecl(def);
+      }
     } else if (type_def->enum_def) {
       const flatbuffers::EnumDef& def = *type_def->enum_def;
       SetNameSpace(def.defined_namespace);
@@ -763,6 +973,9 @@ bool CodeGenerator::generate() {
       const flatbuffers::StructDef& def = *type_def->struct_def;
       SetNameSpace(def.defined_namespace);
       GenerateStructDecl(def);
+      if (HasView(def)) {
+        GenerateViewDecl(def);
+      }
     } else if (type_def->enum_def) {
       const flatbuffers::EnumDef& def = *type_def->enum_def;
       SetNameSpace(def.defined_namespace);
@@ -775,6 +988,9 @@ bool CodeGenerator::generate() {
       const flatbuffers::StructDef& def = *type_def->struct_def;
       SetNameSpace(def.defined_namespace);
       GenerateStructFunctions(def);
+      if (HasView(def)) {
+        GenerateViewFunctions(def);
+      }
     } else if (type_def->enum_def) {
       const flatbuffers::EnumDef& def = *type_def->enum_def;
       SetNameSpace(def.defined_namespace);
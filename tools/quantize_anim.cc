@@ -0,0 +1,127 @@
+/*
+Copyright 2017 Google Inc. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS-IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "flatbuffers/flatbuffers.h"
+#include "flatbuffers/util.h"
+#include "motive/spline_anim_generated.h"
+#include "lullaby/generated/quantized_anim_def_generated.h"
+#include "lullaby/util/quantized_spline.h"
+
+// Converts a spline animation file (a motive::CompactSplineAnimFloatFb) into a
+// quantized .lullanim file (a lull::QuantizedSplineAnimDef) and reports the
+// resulting size reduction and error.
+//
+// Usage: quantize_anim <input> <output> [tolerance]
+//
+// Keys that can be reconstructed from their neighbours to within |tolerance|
+// (in value units, default 0) are removed before quantizing.
+namespace {
+
+// Number of samples used to measure the error of each spline.
+constexpr size_t kNumErrorSamples = 1000;
+
+std::vector<lull::SplineNode> GetNodes(
+    const motive::CompactSplineFloatFb* spline) {
+  std::vector<lull::SplineNode> nodes;
+  if (spline->nodes() == nullptr) {
+    return nodes;
+  }
+  nodes.reserve(spline->nodes()->size());
+  for (const motive::CompactSplineFloatNodeFb* node : *spline->nodes()) {
+    nodes.emplace_back(node->time(), node->value(), node->derivative());
+  }
+  return nodes;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <input> <output> [tolerance]"
+              << std::endl;
+    return 1;
+  }
+  const char* input_file = argv[1];
+  const char* output_file = argv[2];
+  const float tolerance = argc > 3 ? static_cast<float>(atof(argv[3])) : 0.f;
+
+  std::string input;
+  if (!flatbuffers::LoadFile(input_file, true, &input)) {
+    std::cerr << "Unable to load " << input_file << std::endl;
+    return 1;
+  }
+  flatbuffers::Verifier verifier(
+      reinterpret_cast<const uint8_t*>(input.data()), input.size());
+  if (!motive::VerifyCompactSplineAnimFloatFbBuffer(verifier)) {
+    std::cerr << input_file << " is not a valid spline animation" << std::endl;
+    return 1;
+  }
+  const motive::CompactSplineAnimFloatFb* src =
+      motive::GetCompactSplineAnimFloatFb(input.data());
+
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<flatbuffers::Offset<lull::QuantizedSplineDef>> splines;
+  size_t total_keys = 0;
+  size_t total_reduced_keys = 0;
+  float max_error = 0.f;
+  const int num_splines = src->splines() ? src->splines()->size() : 0;
+  for (int i = 0; i < num_splines; ++i) {
+    const std::vector<lull::SplineNode> nodes =
+        GetNodes(src->splines()->Get(i));
+    const std::vector<lull::SplineNode> reduced =
+        lull::ReduceSplineKeys(nodes.data(), nodes.size(), tolerance);
+    const lull::QuantizedSpline quantized =
+        lull::QuantizeSpline(reduced.data(), reduced.size());
+
+    const std::vector<lull::SplineNode> decoded =
+        lull::DequantizeSpline(quantized);
+    const float error =
+        lull::MeasureSplineError(nodes.data(), nodes.size(), decoded.data(),
+                                 decoded.size(), kNumErrorSamples);
+    std::cout << "Spline " << i << ": " << nodes.size() << " -> "
+              << reduced.size() << " keys, max error " << error << std::endl;
+
+    total_keys += nodes.size();
+    total_reduced_keys += reduced.size();
+    max_error = std::max(max_error, error);
+    splines.push_back(lull::CreateQuantizedSplineDefDirect(
+        fbb, quantized.min_value, quantized.max_value, quantized.end_time,
+        &quantized.times, &quantized.values, &quantized.angles));
+  }
+  lull::FinishQuantizedSplineAnimDefBuffer(
+      fbb, lull::CreateQuantizedSplineAnimDefDirect(fbb, &splines));
+
+  if (!flatbuffers::SaveFile(
+          output_file, reinterpret_cast<const char*>(fbb.GetBufferPointer()),
+          fbb.GetSize(), true)) {
+    std::cerr << "Unable to save " << output_file << std::endl;
+    return 1;
+  }
+
+  std::cout << "Keys: " << total_keys << " -> " << total_reduced_keys
+            << std::endl;
+  std::cout << "Size: " << input.size() << " -> " << fbb.GetSize()
+            << " bytes (" << (100.f * fbb.GetSize() / input.size()) << "%)"
+            << std::endl;
+  std::cout << "Max error: " << max_error << std::endl;
+  return 0;
+}